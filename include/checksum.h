@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <gauge_field.h>
+#include <color_spinor_field.h>
+
+namespace quda {
+
+  /**
+     @brief Number of checkerboard sites hashed per checksum chunk.
+     Chunks are the unit of work for the threaded checksum, and the
+     granularity at which the incremental checksum tracks changes.
+  */
+  constexpr int checksum_chunk_size = 4096;
+
+  /**
+     @brief Incremental XOR-based checksum of a host gauge or
+     color-spinor field.  The checksum of every chunk of sites is
+     cached, and only the chunks that have been marked as touched
+     since the previous call to checksum() are rehashed.  Since the
+     chunk checksums are combined with XOR, the result is identical
+     to that of the full Checksum() of the same field, regardless of
+     the thread count or process grid.
+
+     The caller is responsible for marking any modified sites with
+     touch() before requesting the checksum.
+  */
+  class IncrementalChecksum {
+
+    const GaugeField *u;
+    const ColorSpinorField *v;
+    const int volumeCB;
+    const int nParity;
+    const int nChunk; // number of chunks per parity
+    std::vector<uint64_t> chunk;
+    std::vector<char> dirty;
+
+  public:
+    /**
+       @brief Create an incremental checksum for a host gauge field
+       @param[in] u The gauge field to checksum
+    */
+    IncrementalChecksum(const GaugeField &u);
+
+    /**
+       @brief Create an incremental checksum for a host color-spinor field
+       @param[in] v The color-spinor field to checksum
+    */
+    IncrementalChecksum(const ColorSpinorField &v);
+
+    /**
+       @brief Mark the sites [begin, end) of a given parity as touched
+       @param[in] parity Parity of the touched sites (0 for single-parity fields)
+       @param[in] begin First checkerboard site index touched
+       @param[in] end One past the last checkerboard site index touched
+    */
+    void touch(int parity, int begin, int end);
+
+    /**
+       @brief Mark the entire field as touched
+    */
+    void touch();
+
+    /**
+       @brief Rehash all touched chunks and return the global checksum
+       @return The checksum of the field
+    */
+    uint64_t checksum();
+  };
+
+} // namespace quda
@@ -311,6 +311,24 @@ namespace quda {
   */
   void cloverInvert(CloverField &clover, bool computeTraceLog, QudaFieldLocation location);
 
+  /**
+     @brief Driver for computing the clover field and its inverse from
+     the field strength tensor.  On the host, both the construction and
+     the Cholesky inversion of each chiral block are done in a single
+     threaded pass over the lattice, and the trace log is accumulated
+     in the same pass; device-resident fields are staged through
+     pinned host memory for this.  On the device this is equivalent to
+     calling computeClover followed by cloverInvert.
+
+     @param clover The clover field (contains both the field itself and its inverse)
+     @param fmunu The field strength tensor
+     @param coeff The clover coefficient
+     @param computeTraceLog Whether to compute the trace logarithm of the clover term
+     @param location The location of the field
+  */
+  void computeCloverAndInvert(CloverField &clover, const GaugeField &fmunu, double coeff,
+			      bool computeTraceLog, QudaFieldLocation location);
+
   /**
      @brief This function adds a real scalar onto the clover diagonal (only to the direct field not the inverse)
 
@@ -434,6 +434,16 @@ namespace quda {
 
     virtual void PrintVector(unsigned int x) = 0;
 
+    /**
+       @brief Compute the XOR-based checksum of this field (host fields only)
+       @param[in] mini Whether to compute a mini checksum or global checksum.
+       A mini checksum only computes the checksum over a subset of the lattice
+       sites and is to be used for online comparisons, e.g., checking
+       a field has changed with a global update algorithm.
+       @return checksum value
+    */
+    uint64_t checksum(bool mini=false) const;
+
     /**
      * Compute the n-dimensional site index given the 1-d offset index
      * @param y n-dimensional site index
@@ -725,12 +735,10 @@ namespace quda {
     friend class cudaColorSpinorField;
 
   public:
-    static void* fwdGhostFaceBuffer[QUDA_MAX_DIM]; //cpu memory
-    static void* backGhostFaceBuffer[QUDA_MAX_DIM]; //cpu memory
-    static void* fwdGhostFaceSendBuffer[QUDA_MAX_DIM]; //cpu memory
-    static void* backGhostFaceSendBuffer[QUDA_MAX_DIM]; //cpu memory
-    static int initGhostFaceBuffer;
-    static size_t ghostFaceBytes[QUDA_MAX_DIM];
+    mutable void* fwdGhostFaceBuffer[QUDA_MAX_DIM] = { }; // receive buffer from forwards neighbor
+    mutable void* backGhostFaceBuffer[QUDA_MAX_DIM] = { }; // receive buffer from backwards neighbor
+    mutable void* fwdGhostFaceSendBuffer[QUDA_MAX_DIM] = { }; // send buffer to forwards neighbor
+    mutable void* backGhostFaceSendBuffer[QUDA_MAX_DIM] = { }; // send buffer to backwards neighbor
 
     private:
     //void *v; // the field elements
@@ -738,9 +746,21 @@ namespace quda {
     bool init;
     bool reference; // whether the field is a reference or not
 
+    mutable void *ghost_buffer_h = nullptr; // allocation backing this field's send and receive buffers
+    mutable int ghost_nFace = 0; // halo depth the ghost buffers and message handles were created for
+    mutable MsgHandle *mh_recv_ghost_fwd[QUDA_MAX_DIM] = { };
+    mutable MsgHandle *mh_recv_ghost_back[QUDA_MAX_DIM] = { };
+    mutable MsgHandle *mh_send_ghost_fwd[QUDA_MAX_DIM] = { };
+    mutable MsgHandle *mh_send_ghost_back[QUDA_MAX_DIM] = { };
+
     void create(const QudaFieldCreate);
     void destroy();
 
+    /**
+       @brief Halo exchange of the dimensions [dim_begin, dim_end)
+    */
+    void exchangeGhostRange(QudaParity parity, int nFace, int dagger, int dim_begin, int dim_end) const;
+
     public:
     //cpuColorSpinorField();
     cpuColorSpinorField(const cpuColorSpinorField&);
@@ -758,11 +778,18 @@ namespace quda {
     void PrintVector(unsigned int x);
 
     /**
-       @brief Allocate the ghost buffers
+       @brief Allocate this field's persistent ghost send and receive
+       buffers and declare the message handles that exchange them.
+       This is a no-op if they already exist for the requested halo
+       depth.
        @param[in] nFace Depth of each halo
     */
     void allocateGhostBuffer(int nFace) const;
-    static void freeGhostBuffer(void);
+
+    /**
+       @brief Free this field's ghost buffers and message handles
+    */
+    void freeGhostBuffer() const;
 
     void packGhost(void **ghost, const QudaParity parity, const int nFace, const int dagger) const;
     void unpackGhost(void* ghost_spinor, const int dim,
@@ -787,6 +814,16 @@ namespace quda {
     void exchangeGhost(QudaParity parity, int nFace, int dagger, const MemoryLocation *pack_destination=nullptr,
 		       const MemoryLocation *halo_location=nullptr, bool gdr_send=false, bool gdr_recv=false) const;
 
+    /**
+       @brief Halo exchange restricted to a single dimension, for
+       operators that only read the ghost zone along one direction.
+       @param[in] parity Field parity
+       @param[in] nFace Depth of halo exchange
+       @param[in] dagger Is this for a dagger operator (only relevant for spin projected Wilson)
+       @param[in] dim The dimension whose halo is exchanged
+     */
+    void exchangeGhostDim(QudaParity parity, int nFace, int dagger, int dim) const;
+
     /**
        @brief Backs up the cudaColorSpinorField
     */
@@ -805,8 +842,41 @@ namespace quda {
   int genericCompare(const cpuColorSpinorField &a, const cpuColorSpinorField &b, int tol);
   void genericPrintVector(cpuColorSpinorField &a, unsigned int x);
 
+  /**
+     @brief Compute the XOR-based checksum of a host color-spinor
+     field: each 64-bit word is hashed with its position, given by
+     the global site index and its spin and color component, and the
+     hashes are XORed together, with the sites processed in parallel
+     chunks.  The result detects values that are swapped between
+     sites or components, and is independent of the thread count, the
+     process grid and whether the field is in space-spin-color or
+     space-color-spin order.
+     @param[in] v The field we are computing the checksum of
+     @param[in] mini Whether to compute a mini checksum or global checksum
+     @return checksum value
+  */
+  uint64_t Checksum(const ColorSpinorField &v, bool mini=false);
+
   void wuppertalStep(ColorSpinorField &out, const ColorSpinorField &in, int parity, const GaugeField& U, double A, double B);
   void wuppertalStep(ColorSpinorField &out, const ColorSpinorField &in, int parity, const GaugeField& U, double alpha);
+  void wuppertalStep(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, int parity,
+                     const GaugeField& U, double A, double B);
+  void wuppertalStep(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, int parity,
+                     const GaugeField& U, double alpha);
+
+  /**
+     @brief Shift a color-spinor field along a given dimension,
+     dst(x) = src(x + shift * dim_hat).  Partitioned dimensions read
+     from a ghost zone of depth |shift|.  Single-parity fields are
+     treated as the parity of the destination, with the source taken
+     to have the opposite parity for odd shifts.
+     @param[out] dst The shifted field
+     @param[in] src The field we are shifting
+     @param[in] parity The destination parity (single-parity fields only)
+     @param[in] dim The dimension we are shifting along
+     @param[in] shift The number of sites we shift by (may be negative)
+  */
+  void shiftColorSpinorField(ColorSpinorField &dst, const ColorSpinorField &src, int parity, int dim, int shift);
 
   void exchangeExtendedGhost(cudaColorSpinorField* spinor, int R[], int parity, cudaStream_t *stream_p);
 
@@ -816,7 +886,8 @@ namespace quda {
   /**
      @brief Generic ghost packing routine
 
-     @param[out] ghost Array of packed ghosts with array ordering [2*dim+dir]
+     @param[out] ghost Array of packed ghosts with array ordering [2*dim+dir].
+     Dimensions whose ghost pointers are null are not packed.
      @param[in] a Input field that is being packed
      @param[in] parity Which parity are we packing
      @param[in] dagger Is for a dagger operator (presently ignored)
@@ -825,6 +896,12 @@ namespace quda {
   void genericPackGhost(void **ghost, const ColorSpinorField &a, QudaParity parity,
 			int nFace, int dagger, MemoryLocation *destination=nullptr);
 
+  /**
+     @brief Free the face-to-bulk index tables cached by host ghost
+     packing, one per lattice geometry seen (called by endQuda)
+  */
+  void freeGhostFaceTables();
+
   /*Generate a gaussian distributed spinor
    * @param src The spinorfield
    * @param seed Seed
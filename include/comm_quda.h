@@ -6,6 +6,7 @@ extern "C" {
 #endif
 
   typedef struct MsgHandle_s MsgHandle;
+  typedef struct ReduceHandle_s ReduceHandle;
   typedef struct Topology_s Topology;
 
   /* defined in quda.h; redefining here to avoid circular references */ 
@@ -111,6 +112,14 @@ extern "C" {
   comm_declare_strided_receive_relative_(__func__, __FILE__, __LINE__, buffer, dim, dir, blksize, nblocks, stride)
 
   void comm_finalize(void);
+
+  /**
+     @brief Release any resources held by the communications backend
+     (e.g., the intranode shared-memory transport).  Called by
+     comm_finalize.
+  */
+  void comm_backend_finalize(void);
+
   void comm_dim_partitioned_set(int dim);
   int comm_dim_partitioned(int dim);
 
@@ -257,6 +266,56 @@ extern "C" {
   void comm_allreduce_array(double* data, size_t size);
   void comm_allreduce_int(int* data);
   void comm_allreduce_xor(uint64_t *data);
+
+  /**
+     @brief Create a persistent handle for batched non-blocking sum
+     reductions.  Any number of scalars and arrays can be appended to
+     the handle, and these are then reduced together in a single
+     message, allowing the reduction to overlap with local work.  The
+     packing buffers are retained between batches.
+     @return The reduction handle
+  */
+  ReduceHandle *comm_declare_allreduce(void);
+
+  /**
+     @brief Free a reduction handle, completing any pending reduction
+     @param rh The reduction handle
+  */
+  void comm_free_allreduce(ReduceHandle *rh);
+
+  /**
+     @brief Append an array to the next batch of the reduction
+     handle.  The data are read when the reduction is started and
+     overwritten by the global sum when it is completed, so they must
+     remain valid until comm_allreduce_wait has returned.
+     @param rh The reduction handle
+     @param data The array to be summed over all processes
+     @param size The length of the array
+  */
+  void comm_allreduce_append(ReduceHandle *rh, double *data, size_t size);
+
+  /**
+     @brief Start the reduction of all data appended since the last
+     completed batch
+     @param rh The reduction handle
+  */
+  void comm_allreduce_start(ReduceHandle *rh);
+
+  /**
+     @brief Complete the reduction, write the results back to the
+     appended arrays and reset the handle for the next batch
+     @param rh The reduction handle
+  */
+  void comm_allreduce_wait(ReduceHandle *rh);
+
+  /**
+     @brief Query whether the reduction has completed.  The results
+     are only written back by comm_allreduce_wait.
+     @param rh The reduction handle
+     @return Whether the reduction has completed
+  */
+  int comm_allreduce_query(ReduceHandle *rh);
+
   void comm_broadcast(void *data, size_t nbytes);
   void comm_barrier(void);
   void comm_abort(int status);
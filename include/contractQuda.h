@@ -3,10 +3,34 @@
 
 #include <quda_internal.h>
 #include <quda.h>
+#include <vector>
 
 namespace quda {
   void contractCuda(const cudaColorSpinorField &x, const cudaColorSpinorField &y, void *result, const QudaContractType contract_type, const QudaParity parity, TimeProfile &profile);
   void contractCuda(const cudaColorSpinorField &x, const cudaColorSpinorField &y, void *result, const QudaContractType contract_type, const int tSlice, const QudaParity parity, TimeProfile &profile);
+
+  /**
+     Host contraction of two color-spinor fields projected onto a list
+     of spatial momenta, computed in a single pass over the lattice.
+     For each momentum p and global timeslice t this returns the 16
+     spin components
+
+       result[(m*T + t)*16 + mu*4 + nu] = sum_{x in t} exp(-i p.x) sum_c x^*_{mu c}(x) y_{nu c}(x)
+
+     with the same spin ordering as contractCuda, so any gamma
+     structure can be reconstructed from them.  The partial sums of
+     all ranks are combined with a single allreduce.
+
+     @param[out] result The projected correlators, resized to nMom * T * 16
+     @param[in] x The daggered input field
+     @param[in] y The second input field
+     @param[in] mom Integer momenta (p_x, p_y, p_z), three entries per momentum
+     @param[in] parity The parity of single-parity fields (ignored for full fields)
+     @param[in] profile The profiler
+  */
+  void contractMomentumProject(std::vector<Complex> &result, const ColorSpinorField &x, const ColorSpinorField &y,
+                               const std::vector<int> &mom, const QudaParity parity, TimeProfile &profile);
+
   void covDev(cudaColorSpinorField *out, cudaGaugeField &gauge, const cudaColorSpinorField *in, const int parity, const int mu, TimeProfile &profile);
 
   class CovD {
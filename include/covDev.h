@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 namespace quda {
 
   /**
@@ -19,4 +21,19 @@ namespace quda {
   */
   void ApplyCovDev(ColorSpinorField &out, const ColorSpinorField &in, const GaugeField &U, int parity, int mu);
 
+  /**
+     @brief Driver for applying the covariant derivative to a set of
+     vectors.  Host fields are processed together, with each link
+     loaded once per site for all the vectors and the sites
+     distributed over threads.  Device fields are processed one
+     vector at a time.
+
+     @param[out] out The output result fields
+     @param[in] in The input fields
+     @param[in] U The gauge field used for the covariant derivative
+     @param[in] mu Direction of the derivative. For mu > 3 it goes backwards
+  */
+  void ApplyCovDev(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, const GaugeField &U,
+		   int parity, int mu);
+
 } // namespace quda
@@ -125,6 +125,15 @@ namespace quda {
      */
     void increment(ColorSpinorField &V, int nev);
 
+    /**
+       Checks a deflation space expansion, run by increment when
+       run_verify is set: the new vectors must be orthonormal to the
+       whole space and the projection matrix must be Hermitian.
+       @param first_idx index of the first new vector
+       @param nev number of new vectors
+     */
+    void verifyIncrement(int first_idx, int nev);
+
     /**
        In the incremental eigcg: reduce deflation space 
        based on the following criteria:    
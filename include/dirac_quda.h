@@ -913,6 +913,15 @@ namespace quda {
     virtual void M(ColorSpinorField &out, const ColorSpinorField &in) const;
     virtual void MdagM(ColorSpinorField &out, const ColorSpinorField &in) const;
 
+    /**
+       @brief Apply the full Laplace operator to a set of vectors.
+       Host fields are processed together, reusing each gauge link
+       across the vectors.
+       @param[out] out The output fields
+       @param[in] in The input fields
+    */
+    void M(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in) const;
+
     virtual void prepare(ColorSpinorField* &src, ColorSpinorField* &sol,
 			 ColorSpinorField &x, ColorSpinorField &b,
 			 const QudaSolutionType) const;
@@ -958,6 +967,16 @@ namespace quda {
     virtual void MCD(ColorSpinorField &out, const ColorSpinorField &in, const int mu) const;
     virtual void MdagMCD(ColorSpinorField &out, const ColorSpinorField &in, const int mu) const;
 
+    /**
+       @brief Apply the covariant derivative to a set of vectors.
+       Host fields are processed together, reusing each link across
+       the vectors.
+       @param[out] out The output fields
+       @param[in] in The input fields
+       @param[in] mu Direction of the derivative (mu > 3 goes backwards)
+    */
+    void MCD(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, const int mu) const;
+
 
     virtual void Dslash(ColorSpinorField &out, const ColorSpinorField &in, const QudaParity parity) const;
     virtual void DslashXpay(ColorSpinorField &out, const ColorSpinorField &in,
@@ -580,7 +580,12 @@ namespace quda {
 
   /**
      Compute XOR-based checksum of this gauge field: each gauge field entry is
-     converted to type uint64_t, and compute the cummulative XOR of these values.
+     converted to type uint64_t and hashed together with its position
+     (global site index and component), and we compute the cummulative XOR of
+     these values, so moving values between sites changes the checksum.
+     Sites are processed in parallel chunks; since XOR is order independent
+     and the positions are global the result does not depend on the thread
+     count or process grid.
      @param[in] mini Whether to compute a mini checksum or global checksum.
      A mini checksum only computes over a subset of the lattice
      sites and is to be used for online comparisons, e.g., checking
@@ -13,9 +13,12 @@ namespace quda {
      @param[in] path_coeff Coefficient of each path
      @param[in] num_paths Numer of paths
      @param[in] max_length Maximum length of each path
+     @param[in] location Where the force is computed; device fields
+     are staged through host memory when this is QUDA_CPU_FIELD_LOCATION
    */
   void gaugeForce(GaugeField& mom, const GaugeField& u, double coeff, int ***input_path,
-		  int *length, double *path_coeff, int num_paths, int max_length);
+		  int *length, double *path_coeff, int num_paths, int max_length,
+		  QudaFieldLocation location=QUDA_CUDA_FIELD_LOCATION);
 } // namespace quda
 
 
@@ -15,8 +15,8 @@ namespace quda {
 
 
   /** Generate Gaussian distributed GaugeField
-   * @param dataDs The GaugeField
-   * @param rngstate random states
+   * @param dataDs The GaugeField, either on the device or on the host
+   * @param rngstate random states, on the host only the seed and stream counter are used
    */
 
   void gaugeGauss(GaugeField &dataDs, RNG &rngstate);
@@ -58,7 +58,10 @@ namespace quda {
 
   /**
    * @brief Gauge fixing with overrelaxation with support for single and multi GPU.
-   * @param[in,out] data, quda gauge field
+   * Host fields are fixed with threaded SU(2)-subgroup hits; in a
+   * partitioned dimension the field must be extended, and its halo
+   * is refreshed with the extended ghost exchange after each parity.
+   * @param[in,out] data, quda gauge field, either on the device or on the host
    * @param[in] gauge_dir, 3 for Coulomb gauge fixing, other for Landau gauge fixing
    * @param[in] Nsteps, maximum number of steps to perform gauge fixing
    * @param[in] verbose_interval, print gauge fixing info when iteration count is a multiple of this
@@ -69,7 +72,7 @@ namespace quda {
    * @param[in] reunit_interval, reunitarize gauge field when iteration count is a multiple of this
    * @param[in] stopWtheta, 0 for MILC criterium and 1 to use the theta value
    */
-  void gaugefixingOVR( cudaGaugeField& data,
+  void gaugefixingOVR( GaugeField& data,
 		       const int gauge_dir,
                        const int Nsteps,
 		       const int verbose_interval,
@@ -79,9 +82,20 @@ namespace quda {
 		       const int stopWtheta);
 
 
+  /**
+   * @brief Measure the gauge fixing quality, as reported by the gauge
+   * fixing routines.  Device fields are measured on a host copy.
+   * @param[in] data, quda gauge field, either on the device or on the host
+   * @param[in] gauge_dir, 3 for Coulomb gauge fixing, other for Landau gauge fixing
+   * @return The gauge fixing functional in x and theta in y
+   */
+  double2 gaugeFixQuality(const GaugeField& data, const int gauge_dir);
+
+
   /**
    * @brief Gauge fixing with Steepest descent method with FFTs with support for single GPU only.
-   * @param[in,out] data, quda gauge field
+   * Host fields use a threaded host FFT in place of CUFFT.
+   * @param[in,out] data, quda gauge field, either on the device or on the host
    * @param[in] gauge_dir, 3 for Coulomb gauge fixing, other for Landau gauge fixing
    * @param[in] Nsteps, maximum number of steps to perform gauge fixing
    * @param[in] verbose_interval, print gauge fixing info when iteration count is a multiple of this
@@ -92,7 +106,7 @@ namespace quda {
    * maximum number of steps defined by Nsteps
    * @param[in] stopWtheta, 0 for MILC criterium and 1 to use the theta value
    */
-  void gaugefixingFFT( cudaGaugeField& data, const int gauge_dir,
+  void gaugefixingFFT( GaugeField& data, const int gauge_dir,
 		       const int Nsteps,
 		       const int verbose_interval,
 		       const double alpha,
@@ -84,6 +84,9 @@ namespace quda {
     /**< Enable pipeline solver */
     int pipeline;
 
+    /**< Use the pipelined multi-shift CG for a single right-hand side */
+    int multishift_pipeline;
+
     /**< Solver tolerance in the L2 residual norm */
     double tol;
 
@@ -222,6 +225,7 @@ namespace quda {
       solution_accumulator_pipeline(param.solution_accumulator_pipeline),
       max_res_increase(param.max_res_increase), max_res_increase_total(param.max_res_increase_total),
       heavy_quark_check(param.heavy_quark_check), pipeline(param.pipeline),
+      multishift_pipeline(param.multishift_pipeline),
       tol(param.tol), tol_restart(param.tol_restart), tol_hq(param.tol_hq),
       compute_true_res(param.compute_true_res), true_res(param.true_res),
       true_res_hq(param.true_res_hq), maxiter(param.maxiter), iter(param.iter),
@@ -256,6 +260,7 @@ namespace quda {
       solution_accumulator_pipeline(param.solution_accumulator_pipeline),
       max_res_increase(param.max_res_increase), max_res_increase_total(param.max_res_increase_total),
       heavy_quark_check(param.heavy_quark_check), pipeline(param.pipeline),
+      multishift_pipeline(param.multishift_pipeline),
       tol(param.tol), tol_restart(param.tol_restart), tol_hq(param.tol_hq),
       compute_true_res(param.compute_true_res), true_res(param.true_res),
       true_res_hq(param.true_res_hq), maxiter(param.maxiter), iter(param.iter),
@@ -747,11 +752,44 @@ namespace quda {
     const DiracMatrix &mat;
     const DiracMatrix &matSloppy;
 
+    /**
+       Pipelined multi-shift CG, using the pipelined CG recurrence of
+       Ghysels and Vanroose (Parallel Computing 40, 2014) for the
+       unshifted system.  The two inner products of each iteration
+       are computed locally, and their global sum, batched over all
+       right-hand sides, is overlapped with the operator application.
+       The right-hand sides are advanced in lockstep, so each
+       iteration applies the operator to every unconverged source
+       back to back and completes with a single reduction.  The
+       shifted solutions and gradient vectors are updated with the
+       multi-blas axpyBzpcx, one iteration behind the unshifted
+       system.
+       @param out out[i][j] is the solution for source i and shift j
+       @param in The right-hand sides
+    */
+    void pipelinedSolve(std::vector<std::vector<ColorSpinorField*> > &out, std::vector<ColorSpinorField*> &in);
+
   public:
     MultiShiftCG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile);
     virtual ~MultiShiftCG();
 
+    /**
+       Solve the shifted systems for a single right-hand side.  The
+       pipelined solver is used if param.multishift_pipeline is set.
+       @param out The solution for each shift
+       @param in The right-hand side
+    */
     void operator()(std::vector<ColorSpinorField*> out, ColorSpinorField &in);
+
+    /**
+       Solve the shifted systems for several right-hand sides at
+       once, e.g., the pseudofermions of a rational HMC force, using
+       the pipelined solver.  The reported residuals in param are the
+       maximum over the right-hand sides.
+       @param out out[i][j] is the solution for source i and shift j
+       @param in The right-hand sides
+    */
+    void operator()(std::vector<std::vector<ColorSpinorField*> > out, std::vector<ColorSpinorField*> in);
   };
 
 
@@ -23,8 +23,8 @@ namespace quda {
   Eig_Solver(QudaEigParam &eigParam, TimeProfile &profile) : eigParam(eigParam), profile(profile) { ; }
     virtual ~Eig_Solver() { ; }
 
-    virtual void operator()(double *alpha, double *beta, cudaColorSpinorField **Eig_Vec, 
-                            cudaColorSpinorField &r, cudaColorSpinorField &Apsi, int k0, int m) = 0;
+    virtual void operator()(double *alpha, double *beta, ColorSpinorField **Eig_Vec,
+                            ColorSpinorField &r, ColorSpinorField &Apsi, int k0, int m) = 0;
 
     // solver factory
     static Eig_Solver* create(QudaEigParam &param, RitzMat &ritz_mat, TimeProfile &profile);
@@ -51,11 +51,13 @@ namespace quda {
     /**
     Do the GrandSchmit orthogonalization and check the orthogonality of eigen vectors
     */
-    void GrandSchm_test(cudaColorSpinorField &psi, cudaColorSpinorField **Eig_Vec, int Nvec, double *delta);
+    void GrandSchm_test(ColorSpinorField &psi, ColorSpinorField **Eig_Vec, int Nvec, double *delta);
   };
 
   /**
-  Basic Lanczos algorithm 
+  Basic Lanczos algorithm.  The Lanczos vectors are only
+  reorthogonalized once the loss of orthogonality, as estimated by
+  the omega recurrence, exceeds the square root of the precision.
   */
   class Lanczos : public Eig_Solver {
 
@@ -66,15 +68,24 @@ namespace quda {
     Lanczos(RitzMat &ritz_mat, QudaEigParam &eigParam, TimeProfile &profile);
     virtual ~Lanczos();
 
-    void operator()(double *alpha, double *beta, cudaColorSpinorField **Eig_Vec, 
-                    cudaColorSpinorField &r, cudaColorSpinorField &Apsi, int k0, int m);
+    void operator()(double *alpha, double *beta, ColorSpinorField **Eig_Vec,
+                    ColorSpinorField &r, ColorSpinorField &Apsi, int k0, int m);
   };
-    
-#if 0
+
   /**
-     Not implemented yet!!!, Implicitely restarted Lanczos algoritm can rapidly approach the solution than normal Lanczos, Chebychev acceleration and implicite restart processes are needed. At this moment external program call can do this.
+     Thick-restart Lanczos (Wu and Simon, SIAM J. Matrix Anal. Appl.
+     22, 2000), which is equivalent to implicitly restarted Lanczos
+     with exact shifts.  The eigParam.nk largest eigenpairs of the
+     Ritz operator are computed using a basis of m vectors, which
+     with Chebyshev acceleration correspond to the low modes of the
+     Dirac operator.  On every restart the wanted Ritz vectors are
+     kept, together with up to (m-nk)/2 converged Ritz vectors
+     beyond the wanted ones, and the Lanczos recurrence is continued
+     from the residual, until the wanted Ritz pairs have converged
+     to eigParam.Stp_residual or eigParam.max_restarts
+     restarts have been made.  The basis may reside on either the
+     host or the device.
   */
-
   class ImpRstLanczos : public Eig_Solver {
 
   private:
@@ -84,10 +95,18 @@ namespace quda {
     ImpRstLanczos(RitzMat &ritz_mat, QudaEigParam &eigParam, TimeProfile &profile);
     virtual ~ImpRstLanczos();
 
-    void operator()(double *alpha, double *beta, cudaColorSpinorField **Eig_Vec, 
-                    cudaColorSpinorField &r, cudaColorSpinorField &Apsi, int k0, int m);
+    /**
+       @param[out] alpha The eigParam.nk Ritz values, in descending order
+       @param[out] beta The residual norms of the Ritz pairs
+       @param[in,out] Eig_Vec Basis of m vectors, the first eigParam.nk of which hold the Ritz vectors on return
+       @param[in] r The starting vector
+       @param[in] Apsi Temporary vector
+       @param[in] k0 Must be zero
+       @param[in] m The basis size
+    */
+    void operator()(double *alpha, double *beta, ColorSpinorField **Eig_Vec,
+                    ColorSpinorField &r, ColorSpinorField &Apsi, int k0, int m);
   };
-#endif
 
 } // namespace quda
 
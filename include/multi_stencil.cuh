@@ -0,0 +1,158 @@
+#pragma once
+
+#include <vector>
+#include <color_spinor_field.h>
+#include <color_spinor.h>
+#include <quda_matrix.h>
+#include <index_helper.cuh>
+
+/**
+   Host driver shared by the nearest-neighbour stencils (Wuppertal
+   smearing, gauged Laplace and covariant derivative) when they are
+   applied to a batch of vectors.  The links touched at a site are
+   loaded once and applied to every vector in the batch, and the
+   sites are distributed over threads.
+*/
+
+namespace quda {
+
+  /**
+     @brief Parameter structure for applying a stencil to a batch of
+     vectors on the host.  Operators derive from this and add their
+     own coefficients together with a store() method that combines
+     the neighbour sum with the local term and writes the result.
+   */
+  template <typename Float, typename F, typename G>
+  struct MultiStencilArg {
+    std::vector<F> out;   // output vector fields
+    std::vector<F> in;    // input vector fields
+    const G U;            // the gauge field
+    const int nVec;       // number of vectors in the batch
+    const int parity;     // only use this for single parity fields
+    const int nParity;    // number of parities we're working on
+    const int nFace;      // hard code to 1 for now
+    const int dim[5];     // full lattice dimensions
+    const int commDim[4]; // whether a given dimension is partitioned or not
+    const int volumeCB;   // checkerboarded volume
+
+    MultiStencilArg(std::vector<ColorSpinorField*> &out_, const std::vector<ColorSpinorField*> &in_, const G &U,
+                    int parity)
+      : U(U), nVec(in_.size()), parity(parity), nParity(in_[0]->SiteSubset()), nFace(1),
+        dim{ (3-nParity) * in_[0]->X(0), in_[0]->X(1), in_[0]->X(2), in_[0]->X(3), 1 },
+      commDim{comm_dim_partitioned(0), comm_dim_partitioned(1), comm_dim_partitioned(2), comm_dim_partitioned(3)},
+      volumeCB(in_[0]->VolumeCB())
+    {
+      for (int i=0; i<nVec; i++) {
+        Float **ghost = reinterpret_cast<Float**>(const_cast<void**>(in_[i]->Ghost()));
+        out.push_back(F(*out_[i]));
+        in.push_back(F(*in_[i], nFace, 0, 0, ghost));
+      }
+    }
+  };
+
+  /**
+     Computes out[v] += \sum_mu U_mu(x)in_v(x+mu) + U^\dagger_mu(x-mu)in_v(x-mu)
+     for every vector v in the batch, with mu running over [dir_begin, dir_end)
+     @param[in,out] out The accumulators, one per vector
+     @param[in] arg The batched stencil arguments
+     @param[in] x_cb The checkerboarded site index
+     @param[in] parity The site parity
+     @param[in] dir_begin The first direction in the sum
+     @param[in] dir_end One past the last direction in the sum
+     @param[in] forward Whether to include the forward hops
+     @param[in] backward Whether to include the backward hops
+  */
+  template <typename Float, int nColor, typename Vector, typename Arg>
+  inline void computeMultiNeighborSum(Vector *out, Arg &arg, int x_cb, int parity,
+                                      int dir_begin, int dir_end, bool forward, bool backward)
+  {
+    typedef Matrix<complex<Float>,nColor> Link;
+    const int their_spinor_parity = (arg.nParity == 2) ? 1-parity : 0;
+
+    int coord[5];
+    getCoords(coord, x_cb, arg.dim, parity);
+    coord[4] = 0;
+
+    for (int d = dir_begin; d < dir_end; d++) {
+      Link U;
+      Vector in;
+
+      if (forward) {
+        //Forward gather - compute fwd offset for vector fetch
+        arg.U.load((Float*)U.data, x_cb, d, parity);
+        if ( arg.commDim[d] && (coord[d] + arg.nFace >= arg.dim[d]) ) {
+          const int ghost_idx = ghostFaceIndex<1>(coord, arg.dim, d, arg.nFace);
+          for (int v=0; v<arg.nVec; v++) {
+            arg.in[v].loadGhost((Float*)in.data, ghost_idx, d, 1, their_spinor_parity);
+            out[v] += U * in;
+          }
+        } else {
+          const int fwd_idx = linkIndexP1(coord, arg.dim, d);
+          for (int v=0; v<arg.nVec; v++) {
+            arg.in[v].load((Float*)in.data, fwd_idx, their_spinor_parity);
+            out[v] += U * in;
+          }
+        }
+      }
+
+      if (backward) {
+        //Backward gather - compute back offset for spinor and gauge fetch
+        if ( arg.commDim[d] && (coord[d] - arg.nFace < 0) ) {
+          const int ghost_idx = ghostFaceIndex<0>(coord, arg.dim, d, arg.nFace);
+          arg.U.loadGhost((Float*)U.data, ghost_idx, d, 1-parity);
+          for (int v=0; v<arg.nVec; v++) {
+            arg.in[v].loadGhost((Float*)in.data, ghost_idx, d, 0, their_spinor_parity);
+            out[v] += conj(U) * in;
+          }
+        } else {
+          const int back_idx = linkIndexM1(coord, arg.dim, d);
+          arg.U.load((Float*)U.data, back_idx, d, 1-parity);
+          for (int v=0; v<arg.nVec; v++) {
+            arg.in[v].load((Float*)in.data, back_idx, their_spinor_parity);
+            out[v] += conj(U) * in;
+          }
+        }
+      }
+    }
+  }
+
+  /**
+     Host kernel for applying a stencil to a batch of vectors.  At
+     each site the neighbour sum is accumulated for all the vectors
+     and then handed to arg.store(out, x_cb, spinor_parity).
+     @param[in] arg The batched stencil arguments
+     @param[in] dir_begin The first direction of the stencil
+     @param[in] dir_end One past the last direction of the stencil
+     @param[in] forward Whether the stencil has forward hops
+     @param[in] backward Whether the stencil has backward hops
+  */
+  template <typename Float, int nSpin, int nColor, typename Arg>
+  void multiStencilCPU(Arg &arg, int dir_begin, int dir_end, bool forward, bool backward)
+  {
+    typedef ColorSpinor<Float,nColor,nSpin> Vector;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      std::vector<Vector> out(arg.nVec);
+
+#ifdef _OPENMP
+#pragma omp for collapse(2) schedule(static)
+#endif
+      for (int p = 0; p < arg.nParity; p++) {
+        for (int x_cb = 0; x_cb < arg.volumeCB; x_cb++) { // 4-d volume
+          // for full fields then set parity from loop else use arg setting
+          const int parity = (arg.nParity == 2) ? p : arg.parity;
+          const int my_spinor_parity = (arg.nParity == 2) ? parity : 0;
+
+          for (int v=0; v<arg.nVec; v++) out[v] = Vector();
+          computeMultiNeighborSum<Float,nColor>(out.data(), arg, x_cb, parity, dir_begin, dir_end, forward, backward);
+          arg.store(out.data(), x_cb, my_spinor_parity);
+        } // 4-d volumeCB
+      } // parity
+    }
+
+  }
+
+} // namespace quda
@@ -13,13 +13,19 @@ namespace quda {
 
   /** @brief Perform heatbath and overrelaxation. Performs nhb heatbath steps followed by nover overrelaxation steps.
    *
-   * @param[in,out] data Gauge field
+   * On the host the field must be in a host order without
+   * reconstruction, and the random numbers come from a counter-based
+   * generator seeded with rngstate.Seed(), so the CURAND states need
+   * not be initialized and the ensemble is reproducible for any
+   * number of threads.
+   *
+   * @param[in,out] data Gauge field, either on the device or on the host
    * @param[in,out] rngstate state of the CURAND random number generator
    * @param[in] Beta inverse of the gauge coupling, beta = 2 Nc / g_0^2
    * @param[in] nhb number of heatbath steps
    * @param[in] nover number of overrelaxation steps
    */
-  void Monte( cudaGaugeField& data, RNG &rngstate, double Beta, int nhb, int nover);
+  void Monte( GaugeField& data, RNG &rngstate, double Beta, int nhb, int nover);
 
   /** @brief Perform a cold start to the gauge field, identity SU(3) matrix, also fills the ghost links in multi-GPU case (no need to exchange data)
    *
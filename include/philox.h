@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+   @file philox.h
+
+   @brief Counter-based Philox4x32-10 random number generator
+   (Salmon et al, "Parallel random numbers: as easy as 1, 2, 3",
+   SC11).  Unlike a stateful generator, each random draw is a pure
+   function of a key (the seed) and a counter, so fields can be
+   filled in any order, by any number of threads, and on any process
+   grid, while producing bit-identical results as long as the counter
+   is derived from global quantities (global site index, spin, color,
+   etc.).
+ */
+
+namespace quda {
+
+  class Philox {
+
+    static constexpr uint32_t M0 = 0xD2511F53;
+    static constexpr uint32_t M1 = 0xCD9E8D57;
+    static constexpr uint32_t W0 = 0x9E3779B9; // golden ratio
+    static constexpr uint32_t W1 = 0xBB67AE85; // sqrt(3)-1
+    static constexpr int rounds = 10;
+
+    uint32_t key[2];
+
+    __device__ __host__ static inline void mulhilo(uint32_t a, uint32_t b, uint32_t &hi, uint32_t &lo) {
+#ifdef __CUDA_ARCH__
+      hi = __umulhi(a, b);
+      lo = a*b;
+#else
+      uint64_t product = static_cast<uint64_t>(a) * b;
+      hi = static_cast<uint32_t>(product >> 32);
+      lo = static_cast<uint32_t>(product);
+#endif
+    }
+
+  public:
+    /**
+       @brief Construct the generator
+       @param[in] seed The 64-bit key of the generator
+    */
+    __device__ __host__ Philox(uint64_t seed) {
+      key[0] = static_cast<uint32_t>(seed);
+      key[1] = static_cast<uint32_t>(seed >> 32);
+    }
+
+    /**
+       @brief Apply the Philox bijection to a 128-bit counter
+       @param[out] out The four 32-bit random words
+       @param[in] ctr The four 32-bit counter words
+    */
+    __device__ __host__ inline void operator()(uint32_t out[4], const uint32_t ctr[4]) const {
+      uint32_t c[4] = {ctr[0], ctr[1], ctr[2], ctr[3]};
+      uint32_t k[2] = {key[0], key[1]};
+
+      for (int r=0; r<rounds; r++) {
+	uint32_t hi0, lo0, hi1, lo1;
+	mulhilo(M0, c[0], hi0, lo0);
+	mulhilo(M1, c[2], hi1, lo1);
+	c[0] = hi1 ^ c[1] ^ k[0];
+	c[1] = lo1;
+	c[2] = hi0 ^ c[3] ^ k[1];
+	c[3] = lo0;
+	k[0] += W0;
+	k[1] += W1;
+      }
+
+      for (int i=0; i<4; i++) out[i] = c[i];
+    }
+
+    /**
+       @brief Return two uniform random numbers in [0,1), with 53
+       bits of randomness each, for the given counter.
+       @param[out] u The pair of random numbers
+       @param[in] index Primary counter, typically the global lattice site index
+       @param[in] element Secondary counter, typically the component (spin, color, direction, etc.)
+       @param[in] stream Tertiary counter, used to decorrelate successive fields
+    */
+    __device__ __host__ inline void uniform(double u[2], uint64_t index, uint32_t element, uint32_t stream=0) const {
+      const uint32_t ctr[4] = {static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32), element, stream};
+      uint32_t out[4];
+      (*this)(out, ctr);
+
+      const double twoneg53 = 1.1102230246251565e-16;
+      u[0] = ((static_cast<uint64_t>(out[0]) << 21) ^ (out[1] >> 11)) * twoneg53;
+      u[1] = ((static_cast<uint64_t>(out[2]) << 21) ^ (out[3] >> 11)) * twoneg53;
+    }
+
+  };
+
+} // namespace quda
@@ -79,6 +79,8 @@ extern "C" {
     size_t mom_offset; /**< Offset into MILC site struct to the momentum field (only if gauge_order=MILC_SITE_GAUGE_ORDER) */
     size_t site_size; /**< Size of MILC site struct (only if gauge_order=MILC_SITE_GAUGE_ORDER) */
 
+    QudaFieldLocation force_compute_location; /**< Where computeGaugeForceQuda evaluates the force */
+
   } QudaGaugeParam;
 
 
@@ -143,6 +145,8 @@ extern "C" {
 
     int pipeline; /**< Whether to use a pipelined solver with less global sums */
 
+    int multishift_pipeline; /**< Whether the single-source multi-shift CG uses the pipelined solver (always used with several sources) */
+
     int num_offset; /**< Number of offsets in the multi-shift solver */
 
     int num_src; /**< Number of sources in the multiple source solver */
@@ -215,6 +219,7 @@ extern "C" {
     int compute_clover_inverse;            /**< Whether to compute the clover inverse field */
     int return_clover;                     /**< Whether to copy back the clover matrix field */
     int return_clover_inverse;             /**< Whether to copy back the inverted clover matrix field */
+    QudaFieldLocation clover_compute_location; /**< Where the clover field and its inverse are computed when compute_clover is set */
 
     QudaVerbosity verbosity;               /**< The verbosity setting to use in the solver */
 
@@ -356,6 +361,10 @@ extern "C" {
     int np;
     int f_size;
     double eigen_shift;
+
+    /** Maximum number of restarts of the thick-restart Lanczos
+        (QUDA_IMP_RST_LANCZOS) before returning unconverged Ritz pairs */
+    int max_restarts;
 //more general stuff:
     /** Whether to load eigenvectors */
     QudaBoolean import_vectors;
@@ -363,13 +372,24 @@ extern "C" {
     /** The precision of the Ritz vectors */
     QudaPrecision cuda_prec_ritz;
 
+    /** The precision in which the deflation space is stored (defaults
+        to cuda_prec_ritz).  A lower precision keeps the space compressed,
+        with vectors expanded on the fly during the projection.  This
+        only applies in memory: QIO has no half-precision format, so a
+        half-precision space is saved to and loaded from file in single
+        precision and checkpoints are not reduced below single.
+        Saving or loading a device-resident or half-precision space
+        stages all of its vectors in host memory at once */
+    QudaPrecision cuda_prec_ritz_storage;
+
     /** The memory type used to keep the Ritz vectors */
     QudaMemoryType mem_type_ritz;
 
     /** Location where deflation should be done */
     QudaFieldLocation location;
 
-    /** Whether to run the verification checks once set up is complete */
+    /** Whether to run the verification checks once set up is
+        complete and after each expansion of the deflation space */
     QudaBoolean run_verify;
 
     /** Filename prefix where to load the null-space vectors */
@@ -514,6 +534,14 @@ extern "C" {
    * @param fdata   Any auxiliary data needed by the function
    * @return        MPI rank or QMP node ID cooresponding to the node coordinates
    *
+   * Note that if the environment variable QUDA_ENABLE_NODE_RANK_MAP
+   * is set to 1 and this map is lexicographic (either the default or
+   * one supplied by the application), QUDA may reassign the grid
+   * coordinates of each rank so that neighboring ranks share a host.
+   * Applications that derive neighbor ranks from a lexicographic
+   * layout themselves (e.g., MILC) must leave it unset.  A
+   * non-lexicographic map is always used as is.
+   *
    * @see initCommsGridQuda
    */
   typedef int (*QudaCommsMap)(const int *coords, void *fdata);
@@ -538,7 +566,9 @@ extern "C" {
    *               QMP, the existing logical topology is used if it's been
    *               declared.  With MPI or as a fallback with QMP, the default
    *               ordering is lexicographical with the fourth ("t") index
-   *               varying fastest.
+   *               varying fastest.  A lexicographical map may be replaced
+   *               by a node-aware one if QUDA_ENABLE_NODE_RANK_MAP=1 (see
+   *               QudaCommsMap).
    *
    * @param fdata  Pointer to any data required by "func" (may be NULL)
    *
@@ -677,13 +707,22 @@ extern "C" {
   void freeCloverQuda(void);
 
   /**
-   * Perform the solve, according to the parameters set in param.  It
-   * is assumed that the gauge field has already been loaded via
-   * loadGaugeQuda().
-   * @param h_x    Solution spinor field
-   * @param h_b    Source spinor field
-   * @param param  Contains all metadata regarding host and device
-   *               storage and solver parameters
+   * Run the Lanczos eigensolver selected by eig_param->eig_type on the
+   * Ritz operator.  It is assumed that the gauge field has already
+   * been loaded via loadGaugeQuda().  If eig_param->location is
+   * QUDA_CPU_FIELD_LOCATION (and the input is on the host), the
+   * Lanczos basis is kept in the host vectors, and only the operator
+   * is applied on the device.
+   * @param k0         Lanczos step to start from
+   * @param m          Number of Lanczos vectors
+   * @param hp_Apsi    Temporary spinor field
+   * @param hp_r       Starting vector
+   * @param hp_V       Array of m Lanczos vectors
+   * @param hp_alpha   Diagonal of the Lanczos matrix, or the Ritz
+   *                   values for QUDA_IMP_RST_LANCZOS
+   * @param hp_beta    Off-diagonal of the Lanczos matrix, or the Ritz
+   *                   residual norms for QUDA_IMP_RST_LANCZOS
+   * @param eig_param  Contains all metadata regarding the eigensolver
    */
   void lanczosQuda(int k0, int m, void *hp_Apsi, void *hp_r, void *hp_V,
                    void *hp_alpha, void *hp_beta, QudaEigParam *eig_param);
@@ -720,6 +759,19 @@ extern "C" {
    */
   void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param);
 
+  /**
+   * Solve for multiple shifts (e.g., masses) and multiple sources.
+   * All param->num_src sources are solved together with the
+   * pipelined multi-shift CG, which shares a single global reduction
+   * per iteration between the sources.
+   * @param _hp_x    Array of solution spinor fields, where the solution
+   *                 for source s and shift i is _hp_x[s*num_offset + i]
+   * @param _hp_b    Array of source spinor fields
+   * @param param  Contains all metadata regarding host and device
+   *               storage and solver parameters
+   */
+  void invertMultiSrcMultiShiftQuda(void **_hp_x, void **_hp_b, QudaInvertParam *param);
+
   /**
    * Setup the multigrid solver, according to the parameters set in param.  It
    * is assumed that the gauge field has already been loaded via
@@ -1033,6 +1085,39 @@ extern "C" {
   void performWuppertalnStep(void *h_out, void *h_in, QudaInvertParam *param, 
                              unsigned int nSteps, double alpha);
 
+  /**
+   * Performs Wuppertal smearing on a set of spinors using the gauge
+   * field gaugeSmeared, if it exist, or gaugePrecise if no smeared
+   * field is present.  The spinors are smeared together on the host,
+   * so each link is loaded once per site for the whole set.
+   * @param h_out  Array of nVec result spinor fields
+   * @param h_in   Array of nVec input spinor fields
+   * @param nVec   Number of spinors to smear
+   * @param param  Contains all metadata regarding host and device
+   *               storage and operator which will be applied to the spinors
+   * @param nSteps Number of steps to apply.
+   * @param alpha  Alpha coefficient for Wuppertal smearing.
+   */
+  void performWuppertalnStepMulti(void **h_out, void **h_in, int nVec, QudaInvertParam *param,
+                                  unsigned int nSteps, double alpha);
+
+  /**
+   * Contracts two host spinor fields and projects the result onto a
+   * list of spatial momenta, for every global timeslice.  The result
+   * holds, for momentum m, global timeslice t and spin indices mu, nu,
+   *   result[(m*T + t)*16 + mu*4 + nu] = sum_{x in t} exp(-i p_m.x) sum_c x^*_{mu c}(x) y_{nu c}(x)
+   * as pairs of doubles, where p_m = 2 pi mom[3*m+d] / L_d.  The
+   * lattice dimensions are taken from the loaded gauge field.
+   * @param result Output array of n_mom * T * 16 double complex numbers
+   * @param h_x    Host spinor field that is conjugated in the contraction
+   * @param h_y    Second host spinor field
+   * @param mom    Integer momenta, three entries (x, y, z) per momentum
+   * @param n_mom  Number of momenta
+   * @param param  Contains the precision and ordering of the host spinor fields
+   */
+  void contractMomentumQuda(void *result, void *h_x, void *h_y, const int *mom, int n_mom,
+                            QudaInvertParam *param);
+
   /**
    * Performs APE smearing on gaugePrecise and stores it in gaugeSmeared
    * @param nSteps Number of steps to apply.
@@ -336,6 +336,15 @@ namespace quda{
      * @param inv_param   Contains all metadata regarding host and device storage
      */
 bool canReuseResidentGauge(QudaInvertParam *inv_param);
+
+  /**
+     @brief Generation counter of the resident precise gauge fields
+     (including the fat and long links): this changes whenever any of
+     them is loaded, replaced or freed, so that state derived from the
+     resident fields can be invalidated.
+     @return The current generation
+  */
+uint64_t residentGaugeGeneration();
 }
 
 #endif // _QUDA_INTERNAL_H
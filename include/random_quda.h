@@ -6,6 +6,7 @@
 //#include <string.h>
 //#include <iostream>
 #include <curand_kernel.h>
+#include <philox.h>
 
 namespace quda {
 
@@ -32,6 +33,8 @@ public:
     int Size(){ return rng_size;};
     int Node_Offset(){ return node_offset;};
     int Seed(){ return seed;};
+    /*! @brief return the stream index for the next host pass over the lattice, see hostRNGState */
+    unsigned int HostStream(){ return host_stream++;};
     __host__ __device__ __inline__ cuRNGState* State(){ return state;};
     /*! @brief Restore CURAND array states initialization */
     void restore();
@@ -48,6 +51,8 @@ private:
     int rng_size;  
     /*! @brief offset in the index, in case of multigpus */
     int node_offset;
+    /*! @brief number of host streams handed out so far */
+    unsigned int host_stream;
     int X[4];
     /*! @brief allocate curand rng states array in device memory */
     void AllocateRNG();
@@ -56,7 +61,29 @@ private:
 };
 
 
-
+/**
+    @brief Counter-based random state for host code.  Every draw is a
+    pure function of the seed, the global lattice site, the element
+    (e.g., link direction) and the stream, so the host kernels give
+    the same results for any number of threads.
+*/
+struct hostRNGState {
+    Philox philox;
+    uint64_t site;
+    uint32_t counter; // element in the upper 8 bits, draw number in the lower 24
+    uint32_t stream;
+    double u[2];
+    int n;
+
+    __host__ __device__ hostRNGState(uint64_t seed, uint64_t site, uint32_t element, uint32_t stream)
+      : philox(seed), site(site), counter(element << 24), stream(stream), n(2) { }
+
+    /*! @brief return a uniform random number in (0,1], the same range as curand_uniform */
+    __host__ __device__ inline double uniform(){
+        if (n == 2) { philox.uniform(u, site, counter++, stream); n = 0; }
+        return 1.0 - u[n++];
+    }
+};
 
 
 /**
@@ -82,6 +109,11 @@ inline  __device__ double Random<double>(cuRNGState &state, double a, double b){
     return a + (b - a) * curand_uniform_double(&state);
 }
 
+template<class Real>
+inline  __host__ __device__ Real Random(hostRNGState &state, Real a, Real b){
+    return a + (b - a) * static_cast<Real>(state.uniform());
+}
+
 /**
    @brief Return a random number between 0 and 1
    @param state curand rng state
@@ -103,6 +135,11 @@ inline  __device__ double Random<double>(cuRNGState &state){
     return curand_uniform_double(&state);
 }
 
+template<class Real>
+inline  __host__ __device__ Real Random(hostRNGState &state){
+    return static_cast<Real>(state.uniform());
+}
+
 
 template<class Real>
 struct uniform { };
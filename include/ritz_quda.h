@@ -29,21 +29,40 @@ namespace quda {
     mutable cudaColorSpinorField *tmp1; // temporary hack
     mutable cudaColorSpinorField *tmp2; // temporary hack
 
+    mutable cudaColorSpinorField *d_in;  // device staging for host fields
+    mutable cudaColorSpinorField *d_out; // device staging for host fields
+    const QudaPrecision precision;       // precision of the device staging fields
+
     bool newTmp(cudaColorSpinorField **tmp, const cudaColorSpinorField &a) const;
     void deleteTmp(cudaColorSpinorField **a, const bool &reset) const;
 
+    /**
+       Apply the Chebyshev-accelerated operator to device fields
+    */
+    void apply(cudaColorSpinorField &out, const cudaColorSpinorField &in) const;
+
     public:
     RitzMat(DiracMatrix &d, const QudaEigParam &param) 
       : dirac_mat(d), N_Poly(param.NPoly), shift(param.eigen_shift), 
-        cheby_param(param.MatPoly_param), tmp1(NULL), tmp2(NULL)
+        cheby_param(param.MatPoly_param), tmp1(NULL), tmp2(NULL), d_in(NULL), d_out(NULL),
+        precision(param.invert_param->cuda_prec)
     {;}
     RitzMat(DiracMatrix *d, const QudaEigParam &param)
       : dirac_mat(*d), N_Poly(param.NPoly), shift(param.eigen_shift),
-        cheby_param(param.MatPoly_param), tmp1(NULL), tmp2(NULL)
+        cheby_param(param.MatPoly_param), tmp1(NULL), tmp2(NULL), d_in(NULL), d_out(NULL),
+        precision(param.invert_param->cuda_prec)
     {;}
     virtual ~RitzMat();
 
-    void operator()(cudaColorSpinorField &out, const cudaColorSpinorField &in) const;
+    /**
+       Apply the Ritz operator.  The Dirac operator is only available
+       on the device, so host fields are staged through device copies
+       at the device precision (invert_param->cuda_prec), which are
+       kept for the lifetime of the RitzMat.
+       @param out The result vector
+       @param in The input vector
+    */
+    void operator()(ColorSpinorField &out, const ColorSpinorField &in) const;
 
     //    unsigned long long flops() const { return (dirac_mat->dirac)->Flops(); }
 
@@ -22,4 +22,20 @@ namespace quda {
   void ApplyLaplace(ColorSpinorField &out, const ColorSpinorField &in, const GaugeField &U,
 		    double kappa, const ColorSpinorField *x, int parity);
 
+  /**
+     @brief Driver for applying the Laplace stencil to a set of
+     vectors.  Host fields are processed together, with each gauge
+     link loaded once per site for all the vectors and the sites
+     distributed over threads.  Device fields are processed one
+     vector at a time.
+
+     @param[out] out The output result fields
+     @param[in] in The input fields
+     @param[in] U The gauge field used for the gauge Laplace
+     @param[in] kappa Scale factor applied
+     @param[in] x Vector fields we accumulate onto to (may be null)
+  */
+  void ApplyLaplace(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, const GaugeField &U,
+		    double kappa, const std::vector<ColorSpinorField*> *x, int parity);
+
 } // namespace quda
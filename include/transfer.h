@@ -262,9 +262,11 @@ namespace quda {
      @param[in] geo_bs Geometric block size
      @param[in] fine_to_coarse Fine-to-coarse lookup table (linear indices)
      @param[in] spin_bs Spin block size
+     @return Number of blocks that were too ill-conditioned for
+     Cholesky QR and fell back to Gram-Schmidt
    */
-  void BlockOrthogonalize(ColorSpinorField &V, int Nvec, const int *geo_bs, 
-			  const int *fine_to_coarse, int spin_bs);
+  int BlockOrthogonalize(ColorSpinorField &V, int Nvec, const int *geo_bs, 
+			 const int *fine_to_coarse, int spin_bs);
 
   /**
      @brief Apply the prolongation operator
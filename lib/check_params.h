@@ -119,6 +119,7 @@ void printQudaGaugeParam(QudaGaugeParam *param) {
   P(gauge_offset, 0);
   P(mom_offset, 0);
   P(site_size, 0);
+  P(force_compute_location, QUDA_CUDA_FIELD_LOCATION);
 #else
   P(overwrite_mom, INVALID_INT);
   P(use_resident_gauge, INVALID_INT);
@@ -127,6 +128,7 @@ void printQudaGaugeParam(QudaGaugeParam *param) {
   P(make_resident_mom, INVALID_INT);
   P(return_result_gauge, INVALID_INT);
   P(return_result_mom, INVALID_INT);
+  P(force_compute_location, QUDA_INVALID_FIELD_LOCATION);
 #endif
 
 #ifdef INIT_PARAM
@@ -156,8 +158,10 @@ void printQudaEigParam(QudaEigParam *param) {
   P(np, 0);
   P(f_size, 0);
   P(eigen_shift, 0.0);
+  P(max_restarts, 100);
   P(extlib_type, QUDA_EIGEN_EXTLIB);
   P(mem_type_ritz, QUDA_MEMORY_DEVICE);
+  P(cuda_prec_ritz_storage, QUDA_INVALID_PRECISION);
 #else
   P(NPoly, INVALID_INT);
   P(Stp_residual, INVALID_DOUBLE);
@@ -165,6 +169,7 @@ void printQudaEigParam(QudaEigParam *param) {
   P(np, INVALID_INT);
   P(f_size, INVALID_INT);
   P(eigen_shift, INVALID_DOUBLE);
+  P(max_restarts, INVALID_INT);
   P(extlib_type, QUDA_EXTLIB_INVALID);
   P(mem_type_ritz, QUDA_MEMORY_INVALID);
 #endif
@@ -255,6 +260,7 @@ void printQudaInvertParam(QudaInvertParam *param) {
 
 #ifndef CHECK_PARAM
   P(pipeline, 0); /** Whether to use a pipelined solver */
+  P(multishift_pipeline, 0); /** Whether to use the pipelined multi-shift CG */
   P(num_offset, 0); /**< Number of offsets in the multi-shift solver */
   P(num_src, 1); /**< Number of offsets in the multi-shift solver */
   P(overlap, 0); /**< width of domain overlaps */
@@ -389,6 +395,7 @@ void printQudaInvertParam(QudaInvertParam *param) {
     P(compute_clover_inverse, 0);
     P(return_clover, 0);
     P(return_clover_inverse, 0);
+    P(clover_compute_location, QUDA_CUDA_FIELD_LOCATION);
     P(clover_rho, 0.0);
 #else
     if (param->clover_cuda_prec_sloppy == QUDA_INVALID_PRECISION)
@@ -400,6 +407,7 @@ void printQudaInvertParam(QudaInvertParam *param) {
     P(compute_clover_inverse, QUDA_INVALID_PRECISION);
     P(return_clover, QUDA_INVALID_PRECISION);
     P(return_clover_inverse, QUDA_INVALID_PRECISION);
+    P(clover_compute_location, QUDA_INVALID_FIELD_LOCATION);
     P(clover_rho, INVALID_DOUBLE);
 #endif
     P(clover_order, QUDA_INVALID_CLOVER_ORDER);
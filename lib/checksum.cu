@@ -1,84 +1,273 @@
+#include <algorithm>
 #include <gauge_field_order.h>
+#include <color_spinor_field.h>
+#include <checksum.h>
+#include <index_helper.cuh>
 #include <cub_helper.cuh>
 
 namespace quda {
 
+  /**
+     Hash a 64-bit word together with its position in the field
+     (splitmix64 finalizer).  Since the words are combined with XOR, a
+     plain XOR of the raw words would not change if values were moved
+     between sites; hashing each word with its position makes the
+     checksum sensitive to where each value is stored.
+   */
+  __device__ __host__ inline uint64_t checksumMix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+  }
+
+  __device__ __host__ inline uint64_t checksumMix(uint64_t word, uint64_t position) {
+    return checksumMix(word ^ checksumMix(position + 0x9e3779b97f4a7c15ull));
+  }
+
+  /**
+     Global lexicographical index of a checkerboard site.  This is
+     computed from the global coordinates of the site, so the site
+     positions that are mixed into the checksum, and hence the
+     checksum itself, do not depend on the process grid.  For
+     five-dimensional fields the fifth coordinate varies slowest.
+   */
+  struct ChecksumSite {
+    int X[4];        // local full-lattice dimensions
+    int offset[4];   // global coordinates of the local origin
+    uint64_t G[4];   // global dimensions
+    int volume4CB;   // local four-dimensional checkerboard volume
+
+    ChecksumSite(const int *x, int nParity) {
+      for (int d=0; d<4; d++) {
+	X[d] = (d == 0 && nParity == 1) ? 2*x[d] : x[d];
+	offset[d] = comm_coord(d) * X[d];
+	G[d] = static_cast<uint64_t>(comm_dim(d)) * X[d];
+      }
+      volume4CB = X[0]*X[1]*X[2]*X[3] / 2;
+    }
+
+    __device__ __host__ inline uint64_t operator()(int parity, int x_cb) const {
+      const int s = x_cb / volume4CB;
+      int x[4];
+      getCoords(x, x_cb - s*volume4CB, X, parity);
+      uint64_t index = s;
+      for (int d=3; d>=0; d--) index = index * G[d] + (x[d] + offset[d]);
+      return index;
+    }
+  };
+
   template <typename T, QudaGaugeFieldOrder order, int Nc>
   struct ChecksumArg {
     static constexpr int nColor = Nc;
     typedef typename mapper<T>::type real;
     typedef typename gauge_order_mapper<T,order,Nc>::type G;
     const G U;
+    const int nParity;
+    const ChecksumSite site;
+    ChecksumArg(const GaugeField &U) : U(U), nParity(2), site(U.X(), nParity) { }
+  };
+
+  template <typename T, QudaGaugeFieldOrder order, int Nc>
+  __device__ __host__ inline uint64_t siteChecksum(const ChecksumArg<T,order,Nc> &arg, int parity, int x_cb) {
+    typedef ChecksumArg<T,order,Nc> Arg;
+    typedef Matrix<complex<typename Arg::real>,Arg::nColor> Link;
+    // ensure length is rounded up to 64-bit multiple
+    constexpr int length = (sizeof(Link) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    const uint64_t site = arg.site(parity, x_cb);
+    uint64_t checksum_ = 0;
+    for (int d=0; d<arg.U.geometry; d++) {
+      const Link u = arg.U(d, x_cb, parity);
+      const uint64_t *base = reinterpret_cast<const uint64_t*>(&u);
+      for (int i=0; i<length; i++) checksum_ ^= checksumMix(base[i], (site*arg.U.geometry + d)*length + i);
+    }
+    return checksum_;
+  }
+
+  /**
+     Host color-spinor fields in space-spin-color or space-color-spin
+     order store each site contiguously, so we hash the raw 64-bit
+     words of the site.  Each word is mixed with its logical position,
+     given by the global site index and the (spin, color) component it
+     belongs to, so exchanging two components or two sites changes the
+     checksum, while both field orders give the same checksum.
+   */
+  struct SpinorChecksumArg {
+    const uint64_t *v;
     const int volumeCB;
-    ChecksumArg(const GaugeField &U, bool mini) : U(U), volumeCB(mini ? 1 : U.VolumeCB()) { }
+    const int nParity;
+    const int nSpin;
+    const int nColor;
+    const int wordsPerComplex; // number of 64-bit words per complex number
+    const bool spinColor;      // whether the field is in space-spin-color order
+    const ChecksumSite site;
+    SpinorChecksumArg(const ColorSpinorField &v)
+      : v(static_cast<const uint64_t*>(v.V())), volumeCB(v.VolumeCB()),
+	nParity(v.SiteSubset() == QUDA_FULL_SITE_SUBSET ? 2 : 1),
+	nSpin(v.Nspin()), nColor(v.Ncolor()),
+	wordsPerComplex(2*v.Precision() / sizeof(uint64_t)),
+	spinColor(v.FieldOrder() == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER),
+	site(v.X(), nParity) { }
   };
 
-  template <typename Arg>
-  __device__ __host__ inline uint64_t siteChecksum(const Arg &arg, int d, int parity, int x_cb) {
-    const Matrix<complex<typename Arg::real>,Arg::nColor> u = arg.U(d, x_cb, parity);
-    return u.checksum(); 
+  __device__ __host__ inline uint64_t siteChecksum(const SpinorChecksumArg &arg, int parity, int x_cb) {
+    const int nComplex = arg.nSpin * arg.nColor;
+    const uint64_t *base = arg.v + (static_cast<size_t>(parity)*arg.volumeCB + x_cb) * nComplex * arg.wordsPerComplex;
+    const uint64_t site = arg.site(parity, x_cb);
+    uint64_t checksum_ = 0;
+    for (int j=0; j<nComplex; j++) {
+      // logical component index s*nColor + c of the j-th stored complex number
+      const int k = arg.spinColor ? j : (j % arg.nSpin) * arg.nColor + j / arg.nSpin;
+      for (int w=0; w<arg.wordsPerComplex; w++)
+	checksum_ ^= checksumMix(base[j*arg.wordsPerComplex + w], (site*nComplex + k)*arg.wordsPerComplex + w);
+    }
+    return checksum_;
   }
 
+  /**
+     Compute the checksum of each chunk of checksum_chunk_size sites,
+     storing the result in chunk[parity*nChunk + c].  Each chunk is
+     processed by a single thread, and since the chunks are combined
+     with XOR the final result is independent of the thread count.
+     @param[in] arg The checksum argument struct
+     @param[in] volumeCB The number of checkerboard sites to hash
+     @param[out] chunk The per-chunk checksums
+     @param[in] dirty If non-null, only chunks flagged here are rehashed
+   */
   template <typename Arg>
-  uint64_t ChecksumCPU(const Arg &arg)
+  void ChecksumCPU(const Arg &arg, int volumeCB, uint64_t *chunk, const char *dirty)
   {
-    uint64_t checksum_ = 0;
-    for (int parity=0; parity<2; parity++)
-      for (int x_cb=0; x_cb<arg.volumeCB; x_cb++)
-	for (int d=0; d<arg.U.geometry; d++)
-	  checksum_ ^= siteChecksum(arg, d, parity, x_cb);
-    return checksum_;
+    const int nChunk = (volumeCB + checksum_chunk_size - 1) / checksum_chunk_size;
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2) schedule(dynamic)
+#endif
+    for (int parity=0; parity<arg.nParity; parity++) {
+      for (int c=0; c<nChunk; c++) {
+	if (dirty && !dirty[parity*nChunk + c]) continue;
+	const int begin = c * checksum_chunk_size;
+	const int end = begin + checksum_chunk_size < volumeCB ? begin + checksum_chunk_size : volumeCB;
+	uint64_t checksum_ = 0;
+	for (int x_cb=begin; x_cb<end; x_cb++) checksum_ ^= siteChecksum(arg, parity, x_cb);
+	chunk[parity*nChunk + c] = checksum_;
+      }
+    }
   }
 
   template <typename T, int Nc>
-  uint64_t Checksum(const GaugeField &u, bool mini)
+  void Checksum(const GaugeField &u, int volumeCB, uint64_t *chunk, const char *dirty)
   {
-    uint64_t checksum = 0;
     if (u.Order() == QUDA_QDP_GAUGE_ORDER) {
-      ChecksumArg<T,QUDA_QDP_GAUGE_ORDER,Nc> arg(u,mini);
-      checksum = ChecksumCPU(arg);
+      ChecksumArg<T,QUDA_QDP_GAUGE_ORDER,Nc> arg(u);
+      ChecksumCPU(arg, volumeCB, chunk, dirty);
     } else if (u.Order() == QUDA_QDPJIT_GAUGE_ORDER) {
-      ChecksumArg<T,QUDA_QDPJIT_GAUGE_ORDER,Nc> arg(u,mini);
-      checksum = ChecksumCPU(arg);
+      ChecksumArg<T,QUDA_QDPJIT_GAUGE_ORDER,Nc> arg(u);
+      ChecksumCPU(arg, volumeCB, chunk, dirty);
     } else if (u.Order() == QUDA_MILC_GAUGE_ORDER) {
-      ChecksumArg<T,QUDA_MILC_GAUGE_ORDER,Nc> arg(u,mini);
-      checksum = ChecksumCPU(arg);
+      ChecksumArg<T,QUDA_MILC_GAUGE_ORDER,Nc> arg(u);
+      ChecksumCPU(arg, volumeCB, chunk, dirty);
     } else if (u.Order() == QUDA_BQCD_GAUGE_ORDER) {
-      ChecksumArg<T,QUDA_BQCD_GAUGE_ORDER,Nc> arg(u,mini);
-      checksum = ChecksumCPU(arg);
+      ChecksumArg<T,QUDA_BQCD_GAUGE_ORDER,Nc> arg(u);
+      ChecksumCPU(arg, volumeCB, chunk, dirty);
     } else if (u.Order() == QUDA_TIFR_GAUGE_ORDER) {
-      ChecksumArg<T,QUDA_TIFR_GAUGE_ORDER,Nc> arg(u,mini);
-      checksum = ChecksumCPU(arg);
+      ChecksumArg<T,QUDA_TIFR_GAUGE_ORDER,Nc> arg(u);
+      ChecksumCPU(arg, volumeCB, chunk, dirty);
     } else if (u.Order() == QUDA_TIFR_PADDED_GAUGE_ORDER) {
-      ChecksumArg<T,QUDA_TIFR_PADDED_GAUGE_ORDER,Nc> arg(u,mini);
-      checksum = ChecksumCPU(arg);
+      ChecksumArg<T,QUDA_TIFR_PADDED_GAUGE_ORDER,Nc> arg(u);
+      ChecksumCPU(arg, volumeCB, chunk, dirty);
     } else {
       errorQuda("Checksum not implemented");
-    }    
-
-    return checksum;
+    }
   }
 
   template <typename T>
-  uint64_t Checksum(const GaugeField &u, bool mini)
+  void Checksum(const GaugeField &u, int volumeCB, uint64_t *chunk, const char *dirty)
   {
-    uint64_t checksum = 0;
     switch (u.Ncolor()) {
-    case 3: checksum = Checksum<T,3>(u,mini); break;
+    case 3: Checksum<T,3>(u, volumeCB, chunk, dirty); break;
     default: errorQuda("Unsupported nColor = %d", u.Ncolor());
     }
-    return checksum;
   }
 
-  uint64_t Checksum(const GaugeField &u, bool mini)
+  static void checksumChunks(const GaugeField &u, int volumeCB, uint64_t *chunk, const char *dirty)
   {
-    uint64_t checksum = 0;
     switch (u.Precision()) {
-    case QUDA_DOUBLE_PRECISION: checksum = Checksum<double>(u,mini); break;
-    case QUDA_SINGLE_PRECISION: checksum = Checksum<float>(u,mini); break;
+    case QUDA_DOUBLE_PRECISION: Checksum<double>(u, volumeCB, chunk, dirty); break;
+    case QUDA_SINGLE_PRECISION: Checksum<float>(u, volumeCB, chunk, dirty); break;
     default: errorQuda("Unsupported precision = %d", u.Precision());
     }
+  }
+
+  static void checksumChunks(const ColorSpinorField &v, int volumeCB, uint64_t *chunk, const char *dirty)
+  {
+    if (v.Location() != QUDA_CPU_FIELD_LOCATION)
+      errorQuda("Checksum only supported for host fields");
+    if (v.FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER && v.FieldOrder() != QUDA_SPACE_COLOR_SPIN_FIELD_ORDER)
+      errorQuda("Checksum not implemented for field order %d", v.FieldOrder());
+    if (v.Precision() != QUDA_DOUBLE_PRECISION && v.Precision() != QUDA_SINGLE_PRECISION)
+      errorQuda("Unsupported precision = %d", v.Precision());
+
+    // the parity stride is always the full checkerboard volume, even for a mini checksum
+    SpinorChecksumArg arg(v);
+    ChecksumCPU(arg, volumeCB, chunk, dirty);
+  }
+
+  template <typename Field>
+  uint64_t Checksum(const Field &u, int nParity, bool mini)
+  {
+    const int volumeCB = mini ? 1 : u.VolumeCB();
+    const int nChunk = (volumeCB + checksum_chunk_size - 1) / checksum_chunk_size;
+    std::vector<uint64_t> chunk(nParity*nChunk);
+    checksumChunks(u, volumeCB, chunk.data(), nullptr);
 
+    uint64_t checksum = 0;
+    for (auto c : chunk) checksum ^= c;
+    comm_allreduce_xor(&checksum);
+
+    return checksum;
+  }
+
+  uint64_t Checksum(const GaugeField &u, bool mini)
+  {
+    return Checksum(u, 2, mini);
+  }
+
+  uint64_t Checksum(const ColorSpinorField &v, bool mini)
+  {
+    return Checksum(v, v.SiteSubset() == QUDA_FULL_SITE_SUBSET ? 2 : 1, mini);
+  }
+
+  IncrementalChecksum::IncrementalChecksum(const GaugeField &u)
+    : u(&u), v(nullptr), volumeCB(u.VolumeCB()), nParity(2),
+      nChunk((volumeCB + checksum_chunk_size - 1) / checksum_chunk_size),
+      chunk(nParity*nChunk, 0), dirty(nParity*nChunk, 1) { }
+
+  IncrementalChecksum::IncrementalChecksum(const ColorSpinorField &v)
+    : u(nullptr), v(&v), volumeCB(v.VolumeCB()), nParity(v.SiteSubset() == QUDA_FULL_SITE_SUBSET ? 2 : 1),
+      nChunk((volumeCB + checksum_chunk_size - 1) / checksum_chunk_size),
+      chunk(nParity*nChunk, 0), dirty(nParity*nChunk, 1) { }
+
+  void IncrementalChecksum::touch(int parity, int begin, int end)
+  {
+    if (parity < 0 || parity >= nParity) errorQuda("Invalid parity %d", parity);
+    if (begin < 0 || end > volumeCB || begin > end) errorQuda("Invalid site range [%d, %d)", begin, end);
+    if (begin == end) return;
+    const int first = begin / checksum_chunk_size;
+    const int last = (end - 1) / checksum_chunk_size;
+    for (int c=first; c<=last; c++) dirty[parity*nChunk + c] = 1;
+  }
+
+  void IncrementalChecksum::touch()
+  {
+    std::fill(dirty.begin(), dirty.end(), 1);
+  }
+
+  uint64_t IncrementalChecksum::checksum()
+  {
+    if (u) checksumChunks(*u, volumeCB, chunk.data(), dirty.data());
+    else checksumChunks(*v, volumeCB, chunk.data(), dirty.data());
+    std::fill(dirty.begin(), dirty.end(), 0);
+
+    uint64_t checksum = 0;
+    for (auto c : chunk) checksum ^= c;
     comm_allreduce_xor(&checksum);
 
     return checksum;
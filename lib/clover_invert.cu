@@ -6,6 +6,8 @@
 #include <cub_helper.cuh>
 #include <quda_matrix.h>
 #include <linalg.cuh>
+#include <clover_invert.cuh>
+#include <vector>
 
 namespace quda {
 
@@ -39,20 +41,7 @@ namespace quda {
 
     for (int ch=0; ch<2; ch++) {
       Mat A = arg.clover(x_cb, parity, ch);
-      A *= static_cast<Float>(2.0); // factor of two is inherent to QUDA clover storage
-
-      if (twist) { // Compute (T^2 + mu2) first, then invert
-	A = A.square();
-	A += arg.mu2;
-      }
-
-      // compute the Colesky decomposition
-      linalg::Cholesky<HMatrix,Float,N> cholesky(A);
-
-      // Accumulate trlogA
-      if (computeTrLog) for (int j=0; j<N; j++) trlogA += 2.0*log(cholesky.D(j));
-
-      Mat Ainv = static_cast<Float>(0.5)*cholesky.invert(); // return full inverse
+      Mat Ainv = cloverInvertBlock<Float,N,computeTrLog,twist>(A, arg.mu2, trlogA);
       arg.inverse(x_cb, parity, ch) = Ainv;
     }
 
@@ -61,14 +50,23 @@ namespace quda {
 
   template <typename Float, typename Arg, bool computeTrLog, bool twist>
   void cloverInvert(Arg &arg) {
-    for (int parity=0; parity<2; parity++) {
-      for (int x=0; x<arg.clover.volumeCB; x++) {
-	// should make this thread safe if we ever apply threads to cpu code
-	double trlogA = cloverInvertCompute<Float,Arg,computeTrLog,twist>(arg, x, parity);
-	if (computeTrLog) {
-	  if (parity) arg.result_h[0].y += trlogA;
-	  else arg.result_h[0].x += trlogA;
-	}
+    CloverBatch batch(arg.clover.volumeCB);
+    std::vector<double> trlog(2*batch.nBatch, 0.0);
+
+#pragma omp parallel for schedule(static)
+    for (int b=0; b<2*batch.nBatch; b++) {
+      const int parity = batch.parity(b);
+      double trlogA = 0.0;
+      for (int x=batch.begin(b); x<batch.end(b); x++)
+	trlogA += cloverInvertCompute<Float,Arg,computeTrLog,twist>(arg, x, parity);
+      trlog[b] = trlogA;
+    }
+
+    // reduce in batch order so the result is independent of the thread count
+    if (computeTrLog) {
+      for (int b=0; b<2*batch.nBatch; b++) {
+	if (batch.parity(b)) arg.result_h[0].y += trlog[b];
+	else arg.result_h[0].x += trlog[b];
       }
     }
   }
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <quda_matrix.h>
+#include <linalg.cuh>
+
+namespace quda {
+
+  /**
+     @brief Invert a single chiral block of the clover matrix using a
+     Cholesky decomposition.  For the twisted clover term we invert
+     (A^2 + mu2) instead of A.
+     @param[in] A The chiral block in QUDA clover normalization
+     @param[in] mu2 The twisted-mass term (ignored unless twist)
+     @param[in,out] trlogA Accumulator for the trace log of the block
+     @return The inverse of the chiral block in QUDA clover normalization
+   */
+  template <typename Float, int N, bool computeTrLog, bool twist>
+  __device__ __host__ inline HMatrix<Float,N> cloverInvertBlock(HMatrix<Float,N> A, Float mu2, double &trlogA) {
+    A *= static_cast<Float>(2.0); // factor of two is inherent to QUDA clover storage
+
+    if (twist) { // Compute (T^2 + mu2) first, then invert
+      A = A.square();
+      A += mu2;
+    }
+
+    // compute the Colesky decomposition
+    linalg::Cholesky<HMatrix,Float,N> cholesky(A);
+
+    // Accumulate trlogA
+    if (computeTrLog) for (int j=0; j<N; j++) trlogA += 2.0*log(cholesky.D(j));
+
+    return static_cast<Float>(0.5)*cholesky.invert(); // return full inverse
+  }
+
+  /**
+     @brief Helper for threaded host sweeps over the clover field.
+     The checkerboarded volume of each parity is split into fixed-size
+     batches of sites and each batch is processed by a single thread.
+     Per-batch partial sums (e.g., the trace log) are stored
+     separately and reduced in batch order afterwards, so the result
+     does not depend on the number of threads used.
+   */
+  struct CloverBatch {
+    static constexpr int size = 256; // number of sites per batch
+    const int volumeCB;
+    const int nBatch; // number of batches per parity
+    CloverBatch(int volumeCB) : volumeCB(volumeCB), nBatch((volumeCB + size - 1) / size) { }
+    int begin(int batch) const { return (batch % nBatch) * size; }
+    int end(int batch) const { int e = begin(batch) + size; return e < volumeCB ? e : volumeCB; }
+    int parity(int batch) const { return batch / nBatch; }
+  };
+
+} // namespace quda
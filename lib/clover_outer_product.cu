@@ -7,6 +7,8 @@
 #include <quda_matrix.h>
 #include <color_spinor.h>
 #include <dslash_quda.h>
+#include <color_spinor_field_order.h>
+#include <index_helper.cuh>
 
 namespace quda {
 
@@ -109,7 +111,7 @@ namespace quda {
   };
 
   template <IndexType idxType>
-    static __device__ __forceinline__ void coordsFromIndex(int& idx, int c[4],
+    static __device__ __host__ __forceinline__ void coordsFromIndex(int& idx, int c[4],
         const unsigned int cb_idx, const unsigned int parity, const int X[4])
     {
       const int &LX = X[0];
@@ -167,7 +169,7 @@ namespace quda {
 
 
   // Get the  coordinates for the exterior kernels
-  __device__ static void coordsFromIndex(int x[4], const unsigned int cb_idx, const int X[4], const unsigned int dir, const int displacement, const unsigned int parity)
+  __device__ __host__ static void coordsFromIndex(int x[4], const unsigned int cb_idx, const int X[4], const unsigned int dir, const int displacement, const unsigned int parity)
   {
     int Xh[2] = {X[0]/2, X[1]/2};
     switch(dir){
@@ -207,7 +209,7 @@ namespace quda {
   }
 
 
-  __device__ __forceinline__
+  __device__ __host__ __forceinline__
   int neighborIndex(const unsigned int cb_idx, const int shift[4],  const bool partitioned[4], const unsigned int parity, const int X[4]){
     int full_idx;
     int x[4];
@@ -302,6 +304,91 @@ namespace quda {
     return;
   } // exteriorOprodKernel
 
+  /**
+     Host interior kernel: accumulates the force for every site and
+     direction whose forward neighbor is on this node.
+  */
+  template<typename real, typename Output, typename Gauge, typename InputA, typename InputB, typename InputC, typename InputD>
+  void interiorOprodCPU(CloverForceArg<real, Output, Gauge, InputA, InputB, InputC, InputD> &arg) {
+    typedef complex<real> Complex;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int idx=0; idx<(int)arg.length; idx++) {
+      ColorSpinor<real,3,4> A, B_shift, C, D_shift;
+      Matrix<Complex,3> U, result, temp;
+
+      arg.inA.load(reinterpret_cast<real*>(A.data), idx, 0);
+      arg.inC.load(reinterpret_cast<real*>(C.data), idx, 0);
+
+      for(int dim=0; dim<4; ++dim){
+	int shift[4] = {0,0,0,0};
+	shift[dim] = 1;
+	const int nbr_idx = neighborIndex(idx, shift, arg.partitioned, arg.parity, arg.X);
+
+	if(nbr_idx >= 0){
+	  arg.inB_shift.load(reinterpret_cast<real*>(B_shift.data), nbr_idx, 0);
+	  arg.inD_shift.load(reinterpret_cast<real*>(D_shift.data), nbr_idx, 0);
+
+	  B_shift = (B_shift.project(dim,1)).reconstruct(dim,1);
+	  result = outerProdSpinTrace(B_shift,A);
+
+	  D_shift = (D_shift.project(dim,-1)).reconstruct(dim,-1);
+	  result += outerProdSpinTrace(D_shift,C);
+
+	  arg.force.load(reinterpret_cast<real*>(temp.data), idx, dim, arg.parity);
+	  arg.gauge.load(reinterpret_cast<real*>(U.data), idx, dim, arg.parity);
+	  result = temp + U*result*arg.coeff;
+	  arg.force.save(reinterpret_cast<real*>(result.data), idx, dim, arg.parity);
+	}
+      } // dim
+    } // idx
+  } // interiorOprodCPU
+
+  /**
+     Host exterior kernel: accumulates the force on the last slice of
+     dimension arg.dir, reading the forward neighbors from the host
+     ghost zones.  Host ghosts hold full spinors, so the spin
+     projection is applied after the ghost is loaded.
+  */
+  template<typename real, typename Output, typename Gauge, typename InputA, typename InputB, typename InputC, typename InputD>
+  void exteriorOprodCPU(CloverForceArg<real, Output, Gauge, InputA, InputB, InputC, InputD> &arg) {
+    typedef complex<real> Complex;
+    const int dim = arg.dir;
+    const int X[5] = { arg.X[0], arg.X[1], arg.X[2], arg.X[3], 1 };
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int cb_idx=0; cb_idx<(int)arg.length; cb_idx++) {
+      ColorSpinor<real,3,4> A, B_shift, C, D_shift;
+      Matrix<Complex,3> U, result, temp;
+
+      int x[5];
+      coordsFromIndex(x, cb_idx, arg.X, dim, arg.displacement, arg.parity);
+      x[4] = 0;
+      const int bulk_cb_idx = ((((x[3]*X[2] + x[2])*X[1] + x[1])*X[0] + x[0]) >> 1);
+      arg.inA.load(reinterpret_cast<real*>(A.data), bulk_cb_idx, 0);
+      arg.inC.load(reinterpret_cast<real*>(C.data), bulk_cb_idx, 0);
+
+      const int ghost_idx = ghostFaceIndex<1>(x, X, dim, 1);
+
+      arg.inB_shift.loadGhost(reinterpret_cast<real*>(B_shift.data), ghost_idx, dim, 1, 0);
+      B_shift = (B_shift.project(dim,1)).reconstruct(dim,1);
+      result = outerProdSpinTrace(B_shift,A);
+
+      arg.inD_shift.loadGhost(reinterpret_cast<real*>(D_shift.data), ghost_idx, dim, 1, 0);
+      D_shift = (D_shift.project(dim,-1)).reconstruct(dim,-1);
+      result += outerProdSpinTrace(D_shift,C);
+
+      arg.force.load(reinterpret_cast<real*>(temp.data), bulk_cb_idx, dim, arg.parity);
+      arg.gauge.load(reinterpret_cast<real*>(U.data), bulk_cb_idx, dim, arg.parity);
+      result = temp + U*result*arg.coeff;
+      arg.force.save(reinterpret_cast<real*>(result.data), bulk_cb_idx, dim, arg.parity);
+    }
+  } // exteriorOprodCPU
+
   template<typename Float, typename Output, typename Gauge, typename InputA, typename InputB, typename InputC, typename InputD>
   class CloverForce : public Tunable {
 
@@ -462,6 +549,77 @@ namespace quda {
       } // i=3,..,0
     } // computeCloverForceCuda
 
+  template<typename Float, typename Output, typename Gauge>
+  void computeCloverForceCPU(Output force, Gauge gauge, GaugeField& out,
+			     ColorSpinorField& inA, ColorSpinorField& inB, ColorSpinorField& inC, ColorSpinorField& inD,
+			     const unsigned int parity, const double coeff)
+  {
+    typedef typename colorspinor::SpaceSpinorColorOrder<Float,4,3> Input;
+
+    // host ghost zones hold full spinors so no spin projection on packing
+    inB.exchangeGhost((QudaParity)(1-parity), 1, 0);
+    inD.exchangeGhost((QudaParity)(1-parity), 1, 0);
+
+    Input spinorA(inA);
+    Input spinorB(inB, 1, 0, 0, reinterpret_cast<Float**>(const_cast<void**>(inB.Ghost())));
+    Input spinorC(inC);
+    Input spinorD(inD, 1, 0, 0, reinterpret_cast<Float**>(const_cast<void**>(inD.Ghost())));
+
+    // host ghost zones are indexed from the site coordinates
+    unsigned int ghostOffset[4] = {0,0,0,0};
+
+    CloverForceArg<Float,Output,Gauge,Input,Input,Input,Input> arg(parity, 0, ghostOffset, 1, OPROD_INTERIOR_KERNEL, coeff, spinorA, spinorB, spinorC, spinorD, gauge, force, out);
+
+    arg.kernelType = OPROD_INTERIOR_KERNEL;
+    arg.length = inA.VolumeCB();
+    interiorOprodCPU(arg);
+
+    for (int i=3; i>=0; i--) {
+      if (commDimPartitioned(i)) {
+	// update parameters for this exterior kernel
+	arg.kernelType = OPROD_EXTERIOR_KERNEL;
+	arg.dir = i;
+	arg.length = arg.X[0]*arg.X[1]*arg.X[2]*arg.X[3] / (2*arg.X[i]); // checkerboarded face volume
+	arg.displacement = 1; // forwards displacement
+	exteriorOprodCPU(arg);
+      }
+    } // i=3,..,0
+  } // computeCloverForceCPU
+
+  // template on the gauge field order
+  template<typename Float, typename Output>
+  void computeCloverForceCPU(Output force, const GaugeField &U, GaugeField& out,
+			     ColorSpinorField& inA, ColorSpinorField& inB, ColorSpinorField& inC, ColorSpinorField& inD,
+			     const unsigned int parity, const double coeff)
+  {
+    if (U.Order() == QUDA_QDP_GAUGE_ORDER) {
+      typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,3>::type Gauge;
+      computeCloverForceCPU<Float>(force, Gauge(U), out, inA, inB, inC, inD, parity, coeff);
+    } else if (U.Order() == QUDA_MILC_GAUGE_ORDER) {
+      typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,3>::type Gauge;
+      computeCloverForceCPU<Float>(force, Gauge(U), out, inA, inB, inC, inD, parity, coeff);
+    } else {
+      errorQuda("Unsupported gauge ordering: %d\n", U.Order());
+    }
+  }
+
+  // template on the force field order
+  template<typename Float>
+  void computeCloverForceCPU(GaugeField& force, const GaugeField &U,
+			     ColorSpinorField& inA, ColorSpinorField& inB, ColorSpinorField& inC, ColorSpinorField& inD,
+			     const unsigned int parity, const double coeff)
+  {
+    if (force.Order() == QUDA_QDP_GAUGE_ORDER) {
+      typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,3>::type Output;
+      computeCloverForceCPU<Float>(Output(force), U, force, inA, inB, inC, inD, parity, coeff);
+    } else if (force.Order() == QUDA_MILC_GAUGE_ORDER) {
+      typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,3>::type Output;
+      computeCloverForceCPU<Float>(Output(force), U, force, inA, inB, inC, inD, parity, coeff);
+    } else {
+      errorQuda("Unsupported output ordering: %d\n", force.Order());
+    }
+  }
+
 #endif // GPU_CLOVER_FORCE
 
   void computeCloverForce(GaugeField& force,
@@ -472,6 +630,32 @@ namespace quda {
   {
 
 #ifdef GPU_CLOVER_DIRAC
+    if (force.Location() == QUDA_CPU_FIELD_LOCATION) {
+      if (x[0]->Precision() != force.Precision())
+	errorQuda("Mixed precision not supported: %d %d\n", x[0]->Precision(), force.Precision());
+
+      for (unsigned int i=0; i<x.size(); i++) {
+	if (x[i]->FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER || p[i]->FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER)
+	  errorQuda("Unsupported input ordering: %d %d\n", x[i]->FieldOrder(), p[i]->FieldOrder());
+
+	for (int parity=0; parity<2; parity++) {
+	  ColorSpinorField& inA = (parity&1) ? p[i]->Odd() : p[i]->Even();
+	  ColorSpinorField& inB = (parity&1) ? x[i]->Even(): x[i]->Odd();
+	  ColorSpinorField& inC = (parity&1) ? x[i]->Odd() : x[i]->Even();
+	  ColorSpinorField& inD = (parity&1) ? p[i]->Even(): p[i]->Odd();
+
+	  if (x[0]->Precision() == QUDA_DOUBLE_PRECISION) {
+	    computeCloverForceCPU<double>(force, U, inA, inB, inC, inD, parity, coeff[i]);
+	  } else if (x[0]->Precision() == QUDA_SINGLE_PRECISION) {
+	    computeCloverForceCPU<float>(force, U, inA, inB, inC, inD, parity, coeff[i]);
+	  } else {
+	    errorQuda("Unsupported precision: %d\n", x[0]->Precision());
+	  }
+	}
+      }
+      return;
+    }
+
     if(force.Order() != QUDA_FLOAT2_GAUGE_ORDER)
       errorQuda("Unsupported output ordering: %d\n", force.Order());
 
@@ -5,6 +5,9 @@
 #include <gauge_field.h>
 #include <gauge_field_order.h>
 #include <clover_field_order.h>
+#include <clover_invert.cuh>
+#include <malloc_quda.h>
+#include <vector>
 
 namespace quda {
 
@@ -127,6 +130,7 @@ namespace quda {
 
   template<typename Float, typename Clover, typename Fmunu>
   void cloverComputeCPU(CloverArg<Float,Clover,Fmunu> arg){
+#pragma omp parallel for collapse(2) schedule(static)
     for (int parity = 0; parity<2; parity++) {
       for (int x_cb=0; x_cb<arg.threads; x_cb++){
 	cloverComputeCore<Float>(arg, x_cb, parity);
@@ -134,6 +138,46 @@ namespace quda {
     }
   }
 
+  template<typename Float, typename Clover, typename Fmunu>
+  struct CloverInvertComputeArg : public CloverArg<Float,Clover,Fmunu> {
+    Clover inverse;
+    Float mu2;
+    CloverInvertComputeArg(Clover &clover, Clover &inverse, Fmunu& f, const GaugeField &meta, double cloverCoeff)
+      : CloverArg<Float,Clover,Fmunu>(clover, f, meta, cloverCoeff), inverse(inverse), mu2(clover.Mu2()) { }
+  };
+
+  /**
+     Host engine that constructs the clover term and its inverse in a
+     single pass: each thread builds the 6x6 chiral blocks for a batch
+     of sites and immediately inverts them while they are still in
+     cache, accumulating the trace log per batch.
+  */
+  template<typename Float, bool computeTrLog, bool twist, typename Arg>
+  void cloverComputeInvertCPU(Arg &arg, double trlog[2]) {
+    constexpr int N = 6;
+    CloverBatch batch(arg.threads);
+    std::vector<double> trlog_batch(2*batch.nBatch, 0.0);
+
+#pragma omp parallel for schedule(static)
+    for (int b=0; b<2*batch.nBatch; b++) {
+      const int parity = batch.parity(b);
+      double trlogA = 0.0;
+      for (int x_cb=batch.begin(b); x_cb<batch.end(b); x_cb++) {
+	cloverComputeCore<Float>(arg, x_cb, parity);
+	for (int ch=0; ch<2; ch++) {
+	  HMatrix<Float,N> A = arg.clover(x_cb, parity, ch);
+	  HMatrix<Float,N> Ainv = cloverInvertBlock<Float,N,computeTrLog,twist>(A, arg.mu2, trlogA);
+	  arg.inverse(x_cb, parity, ch) = Ainv;
+	}
+      }
+      trlog_batch[b] = trlogA;
+    }
+
+    // reduce in batch order so the result is independent of the thread count
+    trlog[0] = trlog[1] = 0.0;
+    for (int b=0; b<2*batch.nBatch; b++) trlog[batch.parity(b)] += trlog_batch[b];
+  }
+
 
   template<typename Float, typename Clover, typename Fmunu>
   class CloverCompute : TunableVectorY {
@@ -199,6 +243,50 @@ namespace quda {
     }
   }
 
+  template<typename Float>
+  void computeCloverAndInvert(CloverField &clover, const GaugeField &f, Float cloverCoeff, bool computeTraceLog) {
+    if (f.Order() != QUDA_FLOAT2_GAUGE_ORDER) errorQuda("Fmunu field order %d not supported", f.Order());
+    if (!clover.isNative()) errorQuda("Clover field order %d not supported", clover.Order());
+    if (!clover.V(true)) errorQuda("Clover inverse field not allocated");
+
+    // device-resident fields are staged through pinned host buffers
+    const bool stage = clover.Location() == QUDA_CUDA_FIELD_LOCATION;
+    if (stage != (f.Location() == QUDA_CUDA_FIELD_LOCATION)) errorQuda("Clover and Fmunu fields must share a location");
+    Float *fmunu_h = nullptr, *clover_h = nullptr, *inverse_h = nullptr;
+    if (stage) {
+      fmunu_h = static_cast<Float*>(pool_pinned_malloc(f.Bytes()));
+      clover_h = static_cast<Float*>(pool_pinned_malloc(2*clover.Bytes()));
+      inverse_h = reinterpret_cast<Float*>(reinterpret_cast<char*>(clover_h) + clover.Bytes());
+      qudaMemcpy(fmunu_h, f.Gauge_p(), f.Bytes(), cudaMemcpyDeviceToHost);
+    }
+
+    typedef typename clover_mapper<Float>::type C;
+    typedef gauge::FloatNOrder<Float,18,2,18> F;
+    C direct(clover, 0, clover_h, 0, stage);
+    C inverse(clover, 1, inverse_h, 0, stage);
+    F fmunu(f, fmunu_h, 0, stage);
+    CloverInvertComputeArg<Float,C,F> arg(direct, inverse, fmunu, f, cloverCoeff);
+
+    double trlog[2];
+    if (computeTraceLog) {
+      if (clover.Twisted()) cloverComputeInvertCPU<Float,true,true>(arg, trlog);
+      else cloverComputeInvertCPU<Float,true,false>(arg, trlog);
+      comm_allreduce_array(trlog, 2);
+      clover.TrLog()[0] = trlog[0];
+      clover.TrLog()[1] = trlog[1];
+    } else {
+      if (clover.Twisted()) cloverComputeInvertCPU<Float,false,true>(arg, trlog);
+      else cloverComputeInvertCPU<Float,false,false>(arg, trlog);
+    }
+
+    if (stage) {
+      qudaMemcpy(clover.V(false), clover_h, clover.Bytes(), cudaMemcpyHostToDevice);
+      qudaMemcpy(clover.V(true), inverse_h, clover.Bytes(), cudaMemcpyHostToDevice);
+      pool_pinned_free(clover_h);
+      pool_pinned_free(fmunu_h);
+    }
+  }
+
 #endif
 
   void computeClover(CloverField &clover, const GaugeField& f, double cloverCoeff, QudaFieldLocation location){
@@ -222,5 +310,33 @@ namespace quda {
 
   }
 
+  void computeCloverAndInvert(CloverField &clover, const GaugeField &f, double cloverCoeff,
+			      bool computeTraceLog, QudaFieldLocation location) {
+
+#ifdef GPU_CLOVER_DIRAC
+    if (location == QUDA_CUDA_FIELD_LOCATION) {
+      // on the device the two stages are separate kernels
+      computeClover(clover, f, cloverCoeff, location);
+      cloverInvert(clover, computeTraceLog, location);
+      return;
+    }
+
+    if (clover.Precision() != f.Precision()) {
+      errorQuda("Fmunu precision %d must match gauge precision %d", clover.Precision(), f.Precision());
+    }
+
+    if (clover.Precision() == QUDA_DOUBLE_PRECISION) {
+      computeCloverAndInvert<double>(clover, f, cloverCoeff, computeTraceLog);
+    } else if (clover.Precision() == QUDA_SINGLE_PRECISION) {
+      computeCloverAndInvert<float>(clover, f, cloverCoeff, computeTraceLog);
+    } else {
+      errorQuda("Precision %d not supported", clover.Precision());
+    }
+#else
+    errorQuda("Clover has not been built");
+#endif
+
+  }
+
 } // namespace quda
 
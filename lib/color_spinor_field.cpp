@@ -624,6 +624,10 @@ namespace quda {
     return ghost_buf;
   }
 
+  uint64_t ColorSpinorField::checksum(bool mini) const {
+    return Checksum(*this, mini);
+  }
+
   /*
     Convert from 1-dimensional index to the n-dimensional spatial index.
     With full fields, we assume that the field is even-odd ordered.  The
@@ -3,6 +3,8 @@
 #include <index_helper.cuh>
 #include <tune_quda.h>
 #include <fast_intdiv.h>
+#include <map>
+#include <vector>
 
 namespace quda {
 
@@ -37,8 +39,9 @@ namespace quda {
       X[0] = ((nParity == 1) ? 2 : 1) * a.X(0); // set to full lattice dimensions
       for (int d=1; d<nDim; d++) X[d] = a.X(d);
       X[4] = (nDim == 5) ? a.X(4) : 1; // set fifth dimension correctly
+      // a face is only packed if its dimension is partitioned and a pack buffer is given
       for (int i=0; i<4; i++) {
-	commDim[i] = comm_dim_partitioned(i);
+	commDim[i] = comm_dim_partitioned(i) && (!ghost || (ghost[2*i+0] && ghost[2*i+1]));
       }
     }
   };
@@ -77,15 +80,116 @@ namespace quda {
     }
   }
 
+  /**
+     Face-to-bulk index tables for host ghost packing: index[p][dim][dir][i]
+     is the checkerboard index of the bulk site that is packed into
+     ghost site i of the given face.  The tables only depend on the
+     geometry, so they are built with a single pass over the volume
+     the first time a geometry is seen and cached until
+     freeGhostFaceTables is called.
+   */
+  struct GhostFaceTable {
+    std::vector<int> index[2][4][2];
+  };
+
+  static std::map<std::vector<int>, GhostFaceTable> ghostFaceTableCache;
+
+  void freeGhostFaceTables() { ghostFaceTableCache.clear(); }
+
+  template <int nDim, typename Arg>
+  const GhostFaceTable& getGhostFaceTable(const Arg &arg) {
+    std::map<std::vector<int>, GhostFaceTable> &cache = ghostFaceTableCache;
+
+    int X[5];
+    for (int d=0; d<5; d++) X[d] = arg.X[d];
+    const std::vector<int> key = { X[0], X[1], X[2], X[3], X[4], nDim, arg.nFace,
+				   arg.nParity, arg.parity, static_cast<int>(arg.pc_type) };
+    auto it = cache.find(key);
+    if (it != cache.end()) return it->second;
+
+    GhostFaceTable &table = cache[key];
+    for (int p=0; p<arg.nParity; p++) {
+      const int parity = (arg.nParity == 2) ? p : arg.parity;
+      for (int dim=0; dim<4; dim++) {
+	const int faceVolumeCB = arg.nFace * (X[0]*X[1]*X[2]*X[3]*X[4] / X[dim]) / 2;
+	table.index[p][dim][0].resize(faceVolumeCB);
+	table.index[p][dim][1].resize(faceVolumeCB);
+      }
+
+      // each bulk site maps to a distinct ghost site of a given face
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+      for (int x_cb=0; x_cb<arg.volumeCB; x_cb++) {
+	int x[5] = { };
+	if (nDim == 5) getCoords5(x, x_cb, X, parity, arg.pc_type);
+	else getCoords(x, x_cb, X, parity);
+	for (int dim=0; dim<4; dim++) {
+	  if (x[dim] < arg.nFace) table.index[p][dim][0][ghostFaceIndex<0>(x,X,dim,arg.nFace)] = x_cb;
+	  if (x[dim] >= X[dim] - arg.nFace) table.index[p][dim][1][ghostFaceIndex<1>(x,X,dim,arg.nFace)] = x_cb;
+	}
+      }
+    }
+
+    return table;
+  }
+
+  template <typename Float, int Ns, int Nc, QudaFieldOrder order>
+  inline void packGhostSite(colorspinor::FieldOrderCB<Float,Ns,Nc,1,order> &field,
+			    int dim, int dir, int parity, int ghost_idx, int x_cb) {
+    for (int s=0; s<Ns; s++)
+      for (int c=0; c<Nc; c++)
+	field.Ghost(dim, dir, parity, ghost_idx, s, c) = field(parity, x_cb, s, c);
+  }
+
+  /**
+     In space-spin-color order both the bulk site and the ghost site
+     are contiguous, so the whole spin-color block is copied at once.
+   */
+  template <typename Float, int Ns, int Nc>
+  inline void packGhostSite(colorspinor::FieldOrderCB<Float,Ns,Nc,1,QUDA_SPACE_SPIN_COLOR_FIELD_ORDER> &field,
+			    int dim, int dir, int parity, int ghost_idx, int x_cb) {
+    memcpy(&field.Ghost(dim, dir, parity, ghost_idx, 0, 0), &field(parity, x_cb, 0, 0), Ns*Nc*sizeof(complex<Float>));
+  }
+
+  /**
+     Host ghost packing: rather than testing every site of the volume,
+     only the face sites are visited, using the cached face-to-bulk
+     tables.  All faces of all parities are flattened into a single
+     index space so the threads are balanced across dimension,
+     direction and face site.
+   */
   template <typename Float, int Ns, int Ms, int Nc, int Mc, int nDim, typename Arg>
   void GenericPackGhost(Arg &arg) {
-    for (int parity=0; parity<arg.nParity; parity++) {
-      parity = (arg.nParity == 2) ? parity : arg.parity;
-      const int spinor_parity = (arg.nParity == 2) ? parity : 0;
-      for (int i=0; i<arg.volumeCB; i++)
-	for (int spin_block=0; spin_block<Ns; spin_block+=Ms)
-	  for (int color_block=0; color_block<Nc; color_block+=Mc)
-	    packGhost<Float,Ns,Ms,Nc,Mc,nDim>(arg, i, parity, spinor_parity, spin_block, color_block);
+    const GhostFaceTable &table = getGhostFaceTable<nDim>(arg);
+
+    int nSegment = 0;
+    int segment[2*4*2][3];
+    int begin[2*4*2+1] = { };
+    for (int p=0; p<arg.nParity; p++) {
+      for (int dim=0; dim<4; dim++) {
+	if (!arg.commDim[dim]) continue;
+	for (int dir=0; dir<2; dir++) {
+	  segment[nSegment][0] = p;
+	  segment[nSegment][1] = dim;
+	  segment[nSegment][2] = dir;
+	  begin[nSegment+1] = begin[nSegment] + table.index[p][dim][dir].size();
+	  nSegment++;
+	}
+      }
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i=0; i<begin[nSegment]; i++) {
+      int k = 0;
+      while (i >= begin[k+1]) k++;
+      const int spinor_parity = segment[k][0];
+      const int dim = segment[k][1];
+      const int dir = segment[k][2];
+      const int ghost_idx = i - begin[k];
+      packGhostSite<Float,Ns,Nc>(arg.field, dim, dir, spinor_parity, ghost_idx, table.index[spinor_parity][dim][dir][ghost_idx]);
     }
   }
 
@@ -1,26 +1,67 @@
 #include <color_spinor_field.h>
 #include <color_spinor_field_order.h>
 #include <index_helper.cuh>
+#include <philox.h>
 
 namespace quda {
 
   using namespace colorspinor;
 
   /**
-     Random number insertion over all field elements
+     Random number insertion over all field elements.  We use a
+     counter-based generator keyed on the global lattice site, spin
+     and color, so the field can be filled in parallel and is
+     independent of the process grid.  The parity of the site is
+     implicit in the global site index.  The call count is used as the
+     stream so that successive random fields are decorrelated.
   */
+  static uint32_t random_stream = 0;
+
   template <class T>
   void random(T &t) {
+    const Philox rng(137);
+
+    int X[QUDA_MAX_DIM], G[QUDA_MAX_DIM], offset[QUDA_MAX_DIM];
+    for (int d=0; d<t.Ndim(); d++) X[d] = t.X(d);
+    X[0] *= (t.Nparity() == 1) ? 2 : 1; // need full lattice dims
+    for (int d=0; d<t.Ndim(); d++) {
+      offset[d] = d < 4 ? comm_coord(d) * X[d] : 0;
+      G[d] = d < 4 ? comm_dim(d) * X[d] : X[d];
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2)
+#endif
     for (int parity=0; parity<t.Nparity(); parity++) {
       for (int x_cb=0; x_cb<t.VolumeCB(); x_cb++) {
+	// local coordinates (the parity is that of the 4-d site)
+	int x[QUDA_MAX_DIM];
+	int za = x_cb / (X[0]/2);
+	const int x0h = x_cb - za*(X[0]/2);
+	int sum = parity;
+	for (int d=1; d<t.Ndim(); d++) {
+	  x[d] = za % X[d];
+	  za /= X[d];
+	  if (d < 4) sum += x[d];
+	}
+	x[0] = 2*x0h + (sum & 1);
+
+	// global lexicographical site index
+	uint64_t index = 0;
+	for (int d=t.Ndim()-1; d>=0; d--) index = index * G[d] + (x[d] + offset[d]);
+
 	for (int s=0; s<t.Nspin(); s++) {
 	  for (int c=0; c<t.Ncolor(); c++) {
-	    t(parity,x_cb,s,c).real(comm_drand());
-	    t(parity,x_cb,s,c).imag(comm_drand());
+	    double u[2];
+	    rng.uniform(u, index, s*t.Ncolor() + c, random_stream);
+	    t(parity,x_cb,s,c).real(u[0]);
+	    t(parity,x_cb,s,c).imag(u[1]);
 	  }
 	}
       }
     }
+
+    random_stream++;
   }
 
   /**
@@ -8,6 +8,8 @@
 #include <color_spinor_field.h>
 #include <color_spinor_field_order.h>
 #include <tune_quda.h>
+#include <multi_stencil.cuh>
+#include <vector>
 
 namespace quda {
 
@@ -35,7 +37,7 @@ namespace quda {
       commDim{comm_dim_partitioned(0), comm_dim_partitioned(1), comm_dim_partitioned(2), comm_dim_partitioned(3)},
       volumeCB(in.VolumeCB())
     {
-      if (in.FieldOrder() != QUDA_FLOAT2_FIELD_ORDER || !U.isNative())
+      if (!in.isNative() || !U.isNative())
         errorQuda("Unsupported field order colorspinor=%d gauge=%d combination\n", in.FieldOrder(), U.FieldOrder());
     }
   };
@@ -114,22 +116,6 @@ namespace quda {
     arg.out(x_cb, parity) = out;
   }
 
-  // CPU kernel for applying a wuppertal smearing step to a vector
-  template <typename Float, int Ns, int Nc, typename Arg>
-  void wuppertalStepCPU(Arg arg)
-  {
-
-    for (int parity= 0; parity < arg.nParity; parity++) {
-      // for full fields then set parity from loop else use arg setting
-      parity = (arg.nParity == 2) ? parity : arg.parity;
-
-      for (int x_cb = 0; x_cb < arg.volumeCB; x_cb++) { // 4-d volume
-        computeWupperalStep<Float,Ns,Nc>(arg, x_cb, parity);
-      } // 4-d volumeCB
-    } // parity
-
-  }
-
   // GPU Kernel for applying a wuppertal smearing step to a vector
   template <typename Float, int Ns, int Nc, typename Arg>
   __global__ void wuppertalStepGPU(Arg arg)
@@ -174,12 +160,8 @@ namespace quda {
     virtual ~WuppertalSmearing() { }
 
     void apply(const cudaStream_t &stream) {
-      if (meta.Location() == QUDA_CPU_FIELD_LOCATION) {
-        wuppertalStepCPU<Float,Ns,Nc>(arg);
-      } else {
-        TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
-        wuppertalStepGPU<Float,Ns,Nc> <<<tp.grid,tp.block,tp.shared_bytes,stream>>>(arg);
-      }
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      wuppertalStepGPU<Float,Ns,Nc> <<<tp.grid,tp.block,tp.shared_bytes,stream>>>(arg);
     }
 
     TuneKey tuneKey() const { return TuneKey(meta.VolString(), typeid(*this).name(), aux); }
@@ -258,6 +240,14 @@ namespace quda {
   void wuppertalStep(ColorSpinorField &out, const ColorSpinorField &in, int parity,
 		     const GaugeField& U, double A, double B)
   {
+    // host fields go through the batched kernel
+    if (U.Location() == QUDA_CPU_FIELD_LOCATION) {
+      std::vector<ColorSpinorField*> out_(1, &out);
+      std::vector<ColorSpinorField*> in_(1, const_cast<ColorSpinorField*>(&in));
+      wuppertalStep(out_, in_, parity, U, A, B);
+      return;
+    }
+
     if (in.V() == out.V()) {
       errorQuda("Orign and destination fields must be different pointers");
     }
@@ -293,4 +283,158 @@ namespace quda {
   {
     wuppertalStep(out, in, parity, U, 1./(1.+6.*alpha), alpha/(1.+6.*alpha));
   }
+
+
+  template <typename Float, int Ns, int Nc, typename F, typename G>
+  struct WuppertalSmearingMultiArg : public MultiStencilArg<Float,F,G> {
+    typedef ColorSpinor<Float,Nc,Ns> Vector;
+    const Float A;        // A parameter
+    const Float B;        // B parameter
+
+    WuppertalSmearingMultiArg(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in,
+                              int parity, const G &U, Float A, Float B)
+      : MultiStencilArg<Float,F,G>(out, in, U, parity), A(A), B(B) { }
+
+    //out(x) = A in(x) + B computeMultiNeighborSum(out, x)
+    inline void store(Vector *out, int x_cb, int parity)
+    {
+      for (int v=0; v<this->nVec; v++) {
+        Vector in;
+        this->in[v].load((Float*)in.data, x_cb, parity);
+        out[v] = A*in + B*out[v];
+        this->out[v].save((Float*)out[v].data, x_cb, parity);
+      }
+    }
+  };
+
+  template <typename Float, int Ns, int Nc, typename F, typename G>
+  void wuppertalStepMulti(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, int parity,
+                          const G &U, double A, double B)
+  {
+    WuppertalSmearingMultiArg<Float,Ns,Nc,F,G> arg(out, in, parity, U, A, B);
+    multiStencilCPU<Float,Ns,Nc>(arg, 0, 3, true, true); // spatial directions only
+  }
+
+  // template on the color-spinor field order
+  template <typename Float, int Ns, int Nc, typename G>
+  void wuppertalStepMulti(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, int parity,
+                          const G &U, double A, double B)
+  {
+    if (in[0]->FieldOrder() == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) {
+      typedef typename colorspinor::SpaceSpinorColorOrder<Float,Ns,Nc> F;
+      wuppertalStepMulti<Float,Ns,Nc,F>(out, in, parity, U, A, B);
+    } else if (in[0]->FieldOrder() == QUDA_FLOAT2_FIELD_ORDER) {
+      typedef typename colorspinor_order_mapper<Float,QUDA_FLOAT2_FIELD_ORDER,Ns,Nc>::type F;
+      wuppertalStepMulti<Float,Ns,Nc,F>(out, in, parity, U, A, B);
+    } else {
+      errorQuda("Unsupported field order %d", in[0]->FieldOrder());
+    }
+  }
+
+  // template on the gauge field order
+  template <typename Float, int Ns, int Nc>
+  void wuppertalStepMulti(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, int parity,
+                          const GaugeField &U, double A, double B)
+  {
+    if (U.isNative()) {
+      if (U.Reconstruct() == QUDA_RECONSTRUCT_NO) {
+        typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type G;
+        wuppertalStepMulti<Float,Ns,Nc>(out, in, parity, G(U), A, B);
+      } else if(U.Reconstruct() == QUDA_RECONSTRUCT_12) {
+        typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type G;
+        wuppertalStepMulti<Float,Ns,Nc>(out, in, parity, G(U), A, B);
+      } else if(U.Reconstruct() == QUDA_RECONSTRUCT_8) {
+        typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type G;
+        wuppertalStepMulti<Float,Ns,Nc>(out, in, parity, G(U), A, B);
+      } else {
+        errorQuda("Reconstruction type %d of origin gauge field not supported", U.Reconstruct());
+      }
+    } else if (U.Order() == QUDA_QDP_GAUGE_ORDER) {
+      typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,Nc>::type G;
+      wuppertalStepMulti<Float,Ns,Nc>(out, in, parity, G(U), A, B);
+    } else if (U.Order() == QUDA_MILC_GAUGE_ORDER) {
+      typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,Nc>::type G;
+      wuppertalStepMulti<Float,Ns,Nc>(out, in, parity, G(U), A, B);
+    } else {
+      errorQuda("Gauge field order %d not supported", U.Order());
+    }
+  }
+
+  // template on the number of spins
+  template<typename Float>
+  void wuppertalStepMulti(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, int parity,
+                          const GaugeField& U, double A, double B)
+  {
+    if (in[0]->Ncolor() != 3) errorQuda(" is not implemented for Ncolor!=3");
+
+    if (in[0]->Nspin() == 4 ){
+      wuppertalStepMulti<Float,4,3>(out, in, parity, U, A, B);
+    }else if (in[0]->Nspin() == 1 ){
+      wuppertalStepMulti<Float,1,3>(out, in, parity, U, A, B);
+    }else{
+      errorQuda("Nspin %d not supported", in[0]->Nspin());
+    }
+  }
+
+  /**
+     Apply a generic Wuppertal smearing step to a batch of vectors.
+     Host fields are smeared together, so each link is loaded once per
+     site for the whole batch, while device fields are smeared one
+     vector at a time.
+     @param[out] out The out result fields
+     @param[in] in The in spinor fields
+     @param[in] U The gauge field
+     @param[in] A The scaling factor for in(x)
+     @param[in] B The scaling factor for \sum_mu (U_{-\mu}(x)in(x+mu) + U^\dagger_mu(x-mu)in(x-mu))
+  */
+  void wuppertalStep(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, int parity,
+		     const GaugeField& U, double A, double B)
+  {
+    if (out.size() != in.size()) errorQuda("Number of output %lu and input %lu vectors do not match", out.size(), in.size());
+    if (in.size() == 0) return;
+
+    if (U.Location() == QUDA_CUDA_FIELD_LOCATION) {
+      for (unsigned int i=0; i<in.size(); i++) wuppertalStep(*out[i], *in[i], parity, U, A, B);
+      return;
+    }
+
+    for (unsigned int i=0; i<in.size(); i++) {
+      if (in[i]->V() == out[i]->V()) errorQuda("Orign and destination fields must be different pointers");
+      checkPrecision(*out[i], *in[i], U);
+      checkLocation(*out[i], *in[i], U);
+      if (in[i]->Nspin() != in[0]->Nspin() || out[i]->Nspin() != in[0]->Nspin() ||
+          in[i]->Ncolor() != in[0]->Ncolor() || out[i]->Ncolor() != in[0]->Ncolor())
+        errorQuda("All fields in the batch must have the same number of spins and colors");
+      if (in[i]->FieldOrder() != in[0]->FieldOrder() || out[i]->FieldOrder() != in[0]->FieldOrder())
+        errorQuda("All fields in the batch must have the same field order");
+      if (in[i]->VolumeCB() != in[0]->VolumeCB() || out[i]->VolumeCB() != in[0]->VolumeCB() ||
+          in[i]->SiteSubset() != in[0]->SiteSubset() || out[i]->SiteSubset() != in[0]->SiteSubset())
+        errorQuda("All fields in the batch must have the same volume and site subset");
+    }
+
+    const int nFace = 1;
+    for (unsigned int i=0; i<in.size(); i++) in[i]->exchangeGhost((QudaParity)(1-parity), nFace, 0); // last parameter is dummy
+
+    if (in[0]->Precision() == QUDA_SINGLE_PRECISION){
+      wuppertalStepMulti<float>(out, in, parity, U, A, B);
+    } else if(in[0]->Precision() == QUDA_DOUBLE_PRECISION) {
+      wuppertalStepMulti<double>(out, in, parity, U, A, B);
+    } else {
+      errorQuda("Precision %d not supported", in[0]->Precision());
+    }
+  }
+
+  /**
+     Apply a standard Wuppertal smearing step to a batch of vectors
+     Computes out(x) = 1/(1+6*alpha)*(in(x)  + alpha*\sum_mu (U_{-\mu}(x)in(x+mu) + U^\dagger_mu(x-mu)in(x-mu)))
+     @param[out] out The out result fields
+     @param[in] in The in spinor fields
+     @param[in] U The gauge field
+     @param[in] alpha The smearing parameter
+  */
+  void wuppertalStep(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, int parity,
+		     const GaugeField& U, double alpha)
+  {
+    wuppertalStep(out, in, parity, U, 1./(1.+6.*alpha), alpha/(1.+6.*alpha));
+  }
 } // namespace quda
@@ -88,6 +88,170 @@ double comm_drand(void)
 }
 
 
+/**
+ * Count the halo faces exchanged by all ranks in each dimension,
+ * split into those where the neighbor lives on the same host
+ * (intra-node) and those that must cross the network (inter-node).
+ *
+ * @param topo      Topology to analyze
+ * @param hostnames Hostnames of all ranks (128 bytes each, in rank order)
+ * @param intra     Number of intra-node faces in each dimension
+ * @param inter     Number of inter-node faces in each dimension
+ */
+static void comm_halo_faces(const Topology *topo, const char *hostnames, int *intra, int *inter)
+{
+  const int nodes = comm_size();
+  for (int d = 0; d < topo->ndim; d++) {
+    intra[d] = 0;
+    inter[d] = 0;
+    if (topo->dims[d] == 1) continue; // dimension not partitioned
+
+    for (int rank = 0; rank < nodes; rank++) {
+      for (int dir = -1; dir <= 1; dir += 2) {
+	int x[QUDA_MAX_DIM];
+	for (int i = 0; i < topo->ndim; i++) x[i] = topo->coords[rank][i];
+	x[d] = (x[d] + dir + topo->dims[d]) % topo->dims[d];
+	int neighbor = topo->ranks[index(topo->ndim, topo->dims, x)];
+	if (!strncmp(&hostnames[128*rank], &hostnames[128*neighbor], 128)) intra[d]++;
+	else inter[d]++;
+      }
+    }
+  }
+}
+
+
+static void comm_print_halo_faces(const Topology *topo, const char *hostnames, const char *label)
+{
+  int intra[QUDA_MAX_DIM], inter[QUDA_MAX_DIM];
+  comm_halo_faces(topo, hostnames, intra, inter);
+
+  int intra_total = 0, inter_total = 0;
+  for (int d = 0; d < topo->ndim; d++) {
+    intra_total += intra[d];
+    inter_total += inter[d];
+  }
+
+  printfQuda("%s rank map halo faces (intra-node / inter-node):\n", label);
+  for (int d = 0; d < topo->ndim; d++) printfQuda("  dim %d = %d / %d\n", d, intra[d], inter[d]);
+  printfQuda("  total = %d / %d (%.1f%% inter-node)\n", intra_total, inter_total,
+	     intra_total + inter_total > 0 ? 100.0 * inter_total / (intra_total + inter_total) : 0.0);
+}
+
+
+/**
+ * Recursively search over all sub-grids (blocks) of the process grid
+ * with block[d] dividing dims[d] and a total size equal to the number
+ * of ranks per node, keeping the one with the fewest inter-node faces.
+ */
+static void comm_node_block_search(int ndim, const int *dims, int d, int remaining, int *block,
+				   int ranks_per_node, int *best_block, int *best_cost)
+{
+  if (d == ndim) {
+    if (remaining != 1) return;
+    int cost = 0;
+    for (int i = 0; i < ndim; i++) {
+      // a block spanning a full partitioned dimension keeps the periodic wrap on node
+      if (dims[i] > 1 && block[i] < dims[i]) cost += 2 * ranks_per_node / block[i];
+    }
+    if (*best_cost < 0 || cost < *best_cost) {
+      *best_cost = cost;
+      for (int i = 0; i < ndim; i++) best_block[i] = block[i];
+    }
+    return;
+  }
+
+  for (int b = 1; b <= dims[d]; b++) {
+    if (dims[d] % b != 0 || remaining % b != 0) continue;
+    block[d] = b;
+    comm_node_block_search(ndim, dims, d+1, remaining / b, block, ranks_per_node, best_block, best_cost);
+  }
+}
+
+
+/**
+ * Remap the ranks of the topology such that each host owns a compact
+ * block of the process grid, minimizing the number of halo faces
+ * that must be exchanged between nodes.  This requires that all
+ * hosts run the same number of ranks and that this number can be
+ * tiled onto the process grid; otherwise the topology is left as is.
+ *
+ * @param topo      Topology to remap
+ * @param hostnames Hostnames of all ranks (128 bytes each, in rank order)
+ * @return          Whether the topology was remapped
+ */
+static bool comm_node_rank_map(Topology *topo, const char *hostnames)
+{
+  const int size = comm_size();
+  const int ndim = topo->ndim;
+
+  // group the ranks by host in order of first appearance
+  int *node_id = (int *) safe_malloc(size*sizeof(int));
+  int *node_rank = (int *) safe_malloc(size*sizeof(int)); // rank index within its host
+  int *node_size = (int *) safe_malloc(size*sizeof(int));
+  int nodes = 0;
+  for (int rank = 0; rank < size; rank++) {
+    node_id[rank] = -1;
+    for (int prev = 0; prev < rank; prev++) {
+      if (!strncmp(&hostnames[128*rank], &hostnames[128*prev], 128)) {
+	node_id[rank] = node_id[prev];
+	break;
+      }
+    }
+    if (node_id[rank] < 0) node_size[node_id[rank] = nodes++] = 0;
+    node_rank[rank] = node_size[node_id[rank]]++;
+  }
+
+  const int ranks_per_node = node_size[0];
+  bool uniform = true;
+  for (int n = 1; n < nodes; n++) if (node_size[n] != ranks_per_node) uniform = false;
+
+  int block[QUDA_MAX_DIM], best_block[QUDA_MAX_DIM];
+  int best_cost = -1;
+  if (uniform) comm_node_block_search(ndim, topo->dims, 0, ranks_per_node, block, ranks_per_node, best_block, &best_cost);
+
+  bool remap = true;
+  if (nodes == 1 || ranks_per_node == 1) {
+    remap = false; // nothing to optimize
+  } else if (!uniform) {
+    warningQuda("Node-aware rank map requires the same number of ranks on each host; using default rank map");
+    remap = false;
+  } else if (best_cost < 0) {
+    warningQuda("Unable to tile %d ranks per host onto the process grid; using default rank map", ranks_per_node);
+    remap = false;
+  }
+
+  if (remap) {
+    int node_grid[QUDA_MAX_DIM];
+    for (int d = 0; d < ndim; d++) node_grid[d] = topo->dims[d] / best_block[d];
+
+    for (int rank = 0; rank < size; rank++) {
+      // the host selects the block and the rank within the host the position in the block
+      int n = node_id[rank], r = node_rank[rank];
+      int x[QUDA_MAX_DIM];
+      for (int d = ndim-1; d >= 0; d--) {
+	x[d] = (n % node_grid[d]) * best_block[d] + r % best_block[d];
+	n /= node_grid[d];
+	r /= best_block[d];
+      }
+      topo->ranks[index(ndim, topo->dims, x)] = rank;
+      for (int d = 0; d < ndim; d++) topo->coords[rank][d] = x[d];
+    }
+
+    if (getVerbosity() > QUDA_SILENT) {
+      char block_string[16*QUDA_MAX_DIM] = "";
+      for (int d = 0; d < ndim; d++) snprintf(block_string + strlen(block_string), 16, " %d", best_block[d]);
+      printfQuda("Node-aware rank map: %d hosts with %d ranks each, host block =%s\n", nodes, ranks_per_node, block_string);
+    }
+  }
+
+  host_free(node_size);
+  host_free(node_rank);
+  host_free(node_id);
+
+  return remap;
+}
+
+
 // QudaCommsMap is declared in quda.h:
 //   typedef int (*QudaCommsMap)(const int *coords, void *fdata);
 
@@ -121,6 +285,25 @@ Topology *comm_create_topology(int ndim, const int *dims, QudaCommsMap rank_from
     }
   } while (advance_coords(ndim, dims, x));
 
+  // optionally replace the default lexicographic map by one that places
+  // lattice neighbors on the same host to minimize inter-node halo
+  // traffic; a map chosen by the application is always respected
+  char *enable_node_map_env = getenv("QUDA_ENABLE_NODE_RANK_MAP");
+  bool lex_map = true;
+  for (int i = 0; i < nodes; i++) if (topo->ranks[i] != i) lex_map = false;
+  if (enable_node_map_env && strcmp(enable_node_map_env, "1") == 0 && !lex_map) {
+    warningQuda("QUDA_ENABLE_NODE_RANK_MAP ignored since the application supplied a non-lexicographic rank map");
+  } else if (enable_node_map_env && strcmp(enable_node_map_env, "1") == 0 && comm_size() > 1) {
+    char *hostname_recv_buf = (char *)safe_malloc(128*comm_size());
+    comm_gather_hostname(hostname_recv_buf);
+
+    if (getVerbosity() > QUDA_SILENT) comm_print_halo_faces(topo, hostname_recv_buf, "Default");
+    if (comm_node_rank_map(topo, hostname_recv_buf) && getVerbosity() > QUDA_SILENT)
+      comm_print_halo_faces(topo, hostname_recv_buf, "Node-aware");
+
+    host_free(hostname_recv_buf);
+  }
+
   int my_rank = comm_rank();
   topo->my_rank = my_rank;
   for (int i = 0; i < ndim; i++) {
@@ -557,6 +740,7 @@ MsgHandle *comm_declare_strided_receive_relative_(const char *func, const char *
 
 void comm_finalize(void)
 {
+  comm_backend_finalize();
   Topology *topo = comm_default_topology();
   comm_destroy_topology(topo);
   comm_set_default_topology(NULL);
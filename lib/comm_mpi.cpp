@@ -3,6 +3,7 @@
 #include <string.h>
 #include <mpi.h>
 #include <csignal>
+#include <vector>
 #include <quda_internal.h>
 #include <comm_quda.h>
 
@@ -37,6 +38,59 @@ struct MsgHandle_s {
      determine whether we need to free the datatype or not.
    */
   bool custom;
+
+  /**
+     Whether this message uses the intranode shared-memory transport
+     instead of MPI point-to-point (see comm_shm_declare)
+   */
+  bool shm;
+
+  /**
+     Shared-memory transport: whether this is a send, the node-local
+     rank of the peer, the mailbox slot and its allocation key, the
+     message tag, whether a started send has not yet been copied into
+     the mailbox (or a started receive has not yet been copied out of
+     it), and the (possibly strided) user buffer
+   */
+  bool send;
+  int peer;
+  int slot;
+  int key;
+  int tag;
+  bool pending;
+  char *buffer;
+  size_t blksize;
+  int nblocks;
+  size_t stride;
+};
+
+struct ReduceHandle_s {
+  /**
+     The arrays appended to the current batch and their lengths
+   */
+  std::vector<double*> data;
+  std::vector<size_t> size;
+
+  /**
+     Persistent send and receive buffers, which are only ever grown
+   */
+  std::vector<double> send;
+  std::vector<double> recv;
+
+  /**
+     The number of scalars in the batch that is in flight
+   */
+  size_t count;
+
+  /**
+     The non-blocking reduction request
+   */
+  MPI_Request request;
+
+  /**
+     Whether a reduction has been started and not yet waited on
+   */
+  bool active;
 };
 
 static int rank = -1;
@@ -46,6 +100,9 @@ static int gpuid = -1;
 static char partition_string[16];
 static char topology_string[16];
 
+static void comm_shm_init();
+static void comm_shm_finalize();
+
 
 void comm_gather_hostname(char *hostname_recv_buf) {
   // determine which GPU this rank will use
@@ -113,10 +170,17 @@ void comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *m
 
   host_free(hostname_recv_buf);
 
+  comm_shm_init();
+
   snprintf(partition_string, 16, ",comm=%d%d%d%d", comm_dim_partitioned(0), comm_dim_partitioned(1), comm_dim_partitioned(2), comm_dim_partitioned(3));
   snprintf(topology_string, 16, ",topo=%d%d%d%d", comm_dim(0), comm_dim(1), comm_dim(2), comm_dim(3));
 }
 
+void comm_backend_finalize(void)
+{
+  comm_shm_finalize();
+}
+
 int comm_rank(void)
 {
   return rank;
@@ -145,6 +209,287 @@ static void check_displacement(const int displacement[], int ndim) {
   }
 }
 
+
+/**
+   Intranode shared-memory transport.  When enabled (with
+   QUDA_ENABLE_SHM_COMMS=1), each rank exposes a set of mailboxes for
+   every nearest-neighbor direction in an MPI-3 shared window spanning
+   the ranks of its node.  Each message handle owns its own mailbox:
+   the n-th handle declared for a given peer and direction of travel
+   takes the n-th free mailbox, so matching sends and receives pair up
+   as long as all ranks declare their handles in the same order, as
+   the ghost exchanges do.  Every message carries its tag and size,
+   which the receiver checks.  A started send is copied straight into
+   the receiver's mailbox if it is free, otherwise it is left pending
+   and progressed whenever this rank waits on or queries a message,
+   so comm_start never blocks.  The receiver copies the message out in
+   the first comm_query that finds it posted, or in comm_wait.  Messages that are larger than the mailbox (set with
+   QUDA_SHM_COMMS_BYTES), go off node, are displaced in more than one
+   dimension, or find all QUDA_SHM_COMMS_SLOTS mailboxes of their
+   direction taken use MPI.  Since buffers are accessed with memcpy,
+   the transport is disabled when GPU-Direct RDMA is enabled.
+ */
+struct ShmSlot {
+  volatile uint64_t posted;   // number of messages written by the sender
+  volatile uint64_t bytes;    // size of the last posted message
+  volatile int tag;           // tag of the last posted message
+  char pad0[64 - 2*sizeof(uint64_t) - sizeof(int)];
+  volatile uint64_t consumed; // number of messages read by the receiver
+  char pad1[64 - sizeof(uint64_t)];
+};
+
+static const int shm_dirs = 2*QUDA_MAX_DIM;
+static int shm_dir_slots = 0;      // mailboxes per direction
+static size_t shm_bytes = 0;       // mailbox capacity, zero if disabled
+static size_t shm_slot_stride = 0;
+#if MPI_VERSION >= 3
+static MPI_Comm shm_comm = MPI_COMM_NULL;
+static MPI_Win shm_win;
+#endif
+static char **shm_base = nullptr; // mailbox base address of each node-local rank
+static int *shm_rank = nullptr;   // node-local rank of each global rank (-1 if off node)
+static std::vector<uint64_t> shm_send_used; // mailboxes taken by sends, per (peer, direction)
+static std::vector<uint64_t> shm_recv_used; // mailboxes taken by receives, per (peer, direction)
+static std::vector<MsgHandle*> shm_pending; // started sends not yet copied into their mailbox
+
+static inline ShmSlot *shm_slot(int peer, int slot)
+{ return reinterpret_cast<ShmSlot*>(shm_base[peer] + slot*shm_slot_stride); }
+
+static inline void shm_sync()
+{
+#if MPI_VERSION >= 3
+  MPI_CHECK( MPI_Win_sync(shm_win) );
+#endif
+}
+
+static void comm_shm_init()
+{
+#if MPI_VERSION >= 3
+  char *enable_shm_env = getenv("QUDA_ENABLE_SHM_COMMS");
+  if (!enable_shm_env || strcmp(enable_shm_env, "1") != 0 || comm_gdr_enabled()) return;
+
+  size_t bytes = 2*1024*1024;
+  char *shm_bytes_env = getenv("QUDA_SHM_COMMS_BYTES");
+  if (shm_bytes_env) bytes = atol(shm_bytes_env);
+  shm_dir_slots = 4;
+  char *shm_slots_env = getenv("QUDA_SHM_COMMS_SLOTS");
+  if (shm_slots_env) shm_dir_slots = atoi(shm_slots_env);
+  if (shm_dir_slots < 1 || shm_dir_slots > 64) errorQuda("QUDA_SHM_COMMS_SLOTS=%d must be in [1,64]", shm_dir_slots);
+  shm_slot_stride = sizeof(ShmSlot) + ((bytes + 63) / 64) * 64;
+
+  MPI_CHECK( MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &shm_comm) );
+  int node_size;
+  MPI_CHECK( MPI_Comm_size(shm_comm, &node_size) );
+
+  char *base;
+  MPI_CHECK( MPI_Win_allocate_shared(shm_dirs*shm_dir_slots*shm_slot_stride, 1, MPI_INFO_NULL, shm_comm, &base, &shm_win) );
+  MPI_CHECK( MPI_Win_lock_all(MPI_MODE_NOCHECK, shm_win) );
+
+  shm_base = (char**)safe_malloc(node_size*sizeof(char*));
+  for (int i=0; i<node_size; i++) {
+    MPI_Aint win_size;
+    int disp_unit;
+    MPI_CHECK( MPI_Win_shared_query(shm_win, i, &win_size, &disp_unit, &shm_base[i]) );
+  }
+
+  for (int i=0; i<shm_dirs*shm_dir_slots; i++) {
+    ShmSlot *slot = reinterpret_cast<ShmSlot*>(base + i*shm_slot_stride);
+    slot->posted = 0;
+    slot->bytes = 0;
+    slot->tag = -1;
+    slot->consumed = 0;
+  }
+  shm_sync();
+
+  shm_send_used.assign(node_size*shm_dirs, 0);
+  shm_recv_used.assign(node_size*shm_dirs, 0);
+
+  // map global ranks to node-local ranks
+  MPI_Group world_group, node_group;
+  MPI_CHECK( MPI_Comm_group(MPI_COMM_WORLD, &world_group) );
+  MPI_CHECK( MPI_Comm_group(shm_comm, &node_group) );
+  int *world_ranks = (int*)safe_malloc(size*sizeof(int));
+  shm_rank = (int*)safe_malloc(size*sizeof(int));
+  for (int i=0; i<size; i++) world_ranks[i] = i;
+  MPI_CHECK( MPI_Group_translate_ranks(world_group, size, world_ranks, node_group, shm_rank) );
+  for (int i=0; i<size; i++) if (shm_rank[i] == MPI_UNDEFINED) shm_rank[i] = -1;
+  host_free(world_ranks);
+  MPI_CHECK( MPI_Group_free(&node_group) );
+  MPI_CHECK( MPI_Group_free(&world_group) );
+
+  // all mailboxes must be initialized before anyone sends
+  MPI_CHECK( MPI_Barrier(MPI_COMM_WORLD) );
+  shm_bytes = bytes;
+
+  if (getVerbosity() > QUDA_SILENT)
+    printfQuda("Enabling intranode shared-memory comms with %d %lu byte mailboxes per direction\n",
+	       shm_dir_slots, (unsigned long)shm_bytes);
+#endif
+}
+
+static void comm_shm_finalize()
+{
+#if MPI_VERSION >= 3
+  if (shm_bytes == 0) return;
+  if (!shm_pending.empty()) warningQuda("%lu shared-memory sends still pending at finalize", (unsigned long)shm_pending.size());
+
+  MPI_CHECK( MPI_Win_unlock_all(shm_win) );
+  MPI_CHECK( MPI_Win_free(&shm_win) );
+  MPI_CHECK( MPI_Comm_free(&shm_comm) );
+
+  host_free(shm_rank);
+  host_free(shm_base);
+  shm_rank = nullptr;
+  shm_base = nullptr;
+  shm_send_used.clear();
+  shm_recv_used.clear();
+  shm_pending.clear();
+  shm_bytes = 0;
+#endif
+}
+
+/**
+   Set up the message handle for the shared-memory transport if
+   possible.  Both ends of a message make the same decision, since
+   this only depends on the relative location of the peer, the
+   displacement, the message size and the order in which the handles
+   are declared.
+   @return Whether the shared-memory transport is used
+ */
+static bool comm_shm_declare(MsgHandle *mh, bool send, void *buffer, const int displacement[], int ndim,
+			     int peer_rank, int tag, size_t blksize, int nblocks, size_t stride)
+{
+  mh->shm = false;
+  if (shm_bytes == 0 || shm_rank[peer_rank] < 0 || blksize*nblocks > shm_bytes) return false;
+
+  // only nearest-neighbor messages along a single dimension
+  int dim = -1;
+  for (int i=0; i<ndim; i++) {
+    if (displacement[i] == 0) continue;
+    if (dim >= 0 || abs(displacement[i]) != 1) return false;
+    dim = i;
+  }
+  if (dim < 0) return false;
+
+  // mailboxes are owned by the receiver and indexed by the direction of travel
+  int travel = send ? displacement[dim] : -displacement[dim];
+  int dir = 2*dim + (travel > 0 ? 1 : 0);
+  int key = shm_rank[peer_rank]*shm_dirs + dir;
+  uint64_t &used = send ? shm_send_used[key] : shm_recv_used[key];
+  int k = 0;
+  while (k < shm_dir_slots && (used & (1ull << k))) k++;
+  if (k == shm_dir_slots) return false; // all mailboxes for this direction are taken
+  used |= (1ull << k);
+
+  mh->shm = true;
+  mh->send = send;
+  mh->peer = shm_rank[peer_rank];
+  mh->slot = dir*shm_dir_slots + k;
+  mh->key = key;
+  mh->tag = tag;
+  mh->pending = false;
+  mh->buffer = static_cast<char*>(buffer);
+  mh->blksize = blksize;
+  mh->nblocks = nblocks;
+  mh->stride = stride;
+  mh->request = MPI_REQUEST_NULL;
+  mh->custom = false;
+  return true;
+}
+
+static void comm_shm_release(MsgHandle *mh)
+{
+  if (shm_bytes == 0) return; // the transport has already been torn down
+  uint64_t &used = mh->send ? shm_send_used[mh->key] : shm_recv_used[mh->key];
+  used &= ~(1ull << (mh->slot % shm_dir_slots));
+}
+
+/**
+   Copy a started send into its mailbox if the receiver has consumed
+   the previous message
+   @return Whether the message was posted
+ */
+static bool comm_shm_try_send(MsgHandle *mh)
+{
+  ShmSlot *slot = shm_slot(mh->peer, mh->slot);
+  char *mailbox = reinterpret_cast<char*>(slot) + sizeof(ShmSlot);
+
+  shm_sync();
+  if (slot->consumed != slot->posted) return false;
+
+  for (int i=0; i<mh->nblocks; i++) memcpy(mailbox + i*mh->blksize, mh->buffer + i*mh->stride, mh->blksize);
+  slot->bytes = mh->blksize*mh->nblocks;
+  slot->tag = mh->tag;
+
+  shm_sync();
+  slot->posted = slot->posted + 1;
+  shm_sync();
+  return true;
+}
+
+/**
+   Post any pending sends whose mailboxes have become free
+ */
+static void comm_shm_progress()
+{
+  unsigned int n = 0;
+  for (unsigned int i=0; i<shm_pending.size(); i++) {
+    if (comm_shm_try_send(shm_pending[i])) shm_pending[i]->pending = false;
+    else shm_pending[n++] = shm_pending[i];
+  }
+  shm_pending.resize(n);
+}
+
+static void comm_shm_send_start(MsgHandle *mh)
+{
+  if (mh->pending) errorQuda("Shared-memory send started while the previous one is still pending");
+  if (comm_shm_try_send(mh)) return;
+  mh->pending = true;
+  shm_pending.push_back(mh);
+}
+
+static void comm_shm_send_wait(MsgHandle *mh)
+{
+  while (mh->pending) comm_shm_progress();
+}
+
+/**
+   Complete a started receive by copying the message out of its
+   mailbox and releasing the mailbox to the sender.  This is shared
+   by comm_query and comm_wait, so a receive that has completed in a
+   query is not waited for again, like an inactive MPI request.
+   @param block Whether to wait for the sender to post the message
+   @return Whether the receive has completed
+ */
+static bool comm_shm_receive(MsgHandle *mh, bool block)
+{
+  if (!mh->pending) return true;
+
+  ShmSlot *slot = shm_slot(shm_rank[rank], mh->slot);
+  const char *mailbox = reinterpret_cast<char*>(slot) + sizeof(ShmSlot);
+
+  // wait for the sender to have posted the message, while progressing our own sends
+  shm_sync();
+  while (slot->posted == slot->consumed) {
+    if (!block) return false;
+    comm_shm_progress();
+    shm_sync();
+  }
+
+  if (slot->tag != mh->tag || slot->bytes != mh->blksize*mh->nblocks)
+    errorQuda("Shared-memory message mismatch: received tag %d with %lu bytes, expected tag %d with %lu bytes",
+	      slot->tag, (unsigned long)slot->bytes, mh->tag, (unsigned long)(mh->blksize*mh->nblocks));
+
+  for (int i=0; i<mh->nblocks; i++) memcpy(mh->buffer + i*mh->stride, mailbox + i*mh->blksize, mh->blksize);
+
+  shm_sync();
+  slot->consumed = slot->consumed + 1;
+  shm_sync();
+
+  mh->pending = false;
+  return true;
+}
+
 /**
  * Declare a message handle for sending to a node displaced in (x,y,z,t) according to "displacement"
  */
@@ -161,6 +506,8 @@ MsgHandle *comm_declare_send_displaced(void *buffer, const int displacement[], s
   tag = tag >= 0 ? tag : 2*pow(4*max_displacement,ndim) + tag;
 
   MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
+  if (comm_shm_declare(mh, true, buffer, displacement, ndim, rank, tag, nbytes, 1, nbytes)) return mh;
+
   MPI_CHECK( MPI_Send_init(buffer, nbytes, MPI_BYTE, rank, tag, MPI_COMM_WORLD, &(mh->request)) );
   mh->custom = false;
 
@@ -184,6 +531,8 @@ MsgHandle *comm_declare_receive_displaced(void *buffer, const int displacement[]
   tag = tag >= 0 ? tag : 2*pow(4*max_displacement,ndim) + tag;
 
   MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
+  if (comm_shm_declare(mh, false, buffer, displacement, ndim, rank, tag, nbytes, 1, nbytes)) return mh;
+
   MPI_CHECK( MPI_Recv_init(buffer, nbytes, MPI_BYTE, rank, tag, MPI_COMM_WORLD, &(mh->request)) );
   mh->custom = false;
 
@@ -208,6 +557,7 @@ MsgHandle *comm_declare_strided_send_displaced(void *buffer, const int displacem
   tag = tag >= 0 ? tag : 2*pow(4*max_displacement,ndim) + tag;
 
   MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
+  if (comm_shm_declare(mh, true, buffer, displacement, ndim, rank, tag, blksize, nblocks, stride)) return mh;
 
   // create a new strided MPI type
   MPI_CHECK( MPI_Type_vector(nblocks, blksize, stride, MPI_BYTE, &(mh->datatype)) );
@@ -237,6 +587,7 @@ MsgHandle *comm_declare_strided_receive_displaced(void *buffer, const int displa
   tag = tag >= 0 ? tag : 2*pow(4*max_displacement,ndim) + tag;
 
   MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
+  if (comm_shm_declare(mh, false, buffer, displacement, ndim, rank, tag, blksize, nblocks, stride)) return mh;
 
   // create a new strided MPI type
   MPI_CHECK( MPI_Type_vector(nblocks, blksize, stride, MPI_BYTE, &(mh->datatype)) );
@@ -251,26 +602,52 @@ MsgHandle *comm_declare_strided_receive_displaced(void *buffer, const int displa
 
 void comm_free(MsgHandle *mh)
 {
-  MPI_CHECK(MPI_Request_free(&(mh->request)));
-  if (mh->custom) MPI_CHECK(MPI_Type_free(&(mh->datatype)));
+  // handles owned by fields that outlive MPI_Finalize (or the shared-memory
+  // transport) have nothing left to release but the host-side handle
+  int finalized;
+  MPI_CHECK( MPI_Finalized(&finalized) );
+
+  if (mh->shm) {
+    if (mh->pending && shm_bytes) comm_shm_send_wait(mh);
+    comm_shm_release(mh);
+  } else if (!finalized) {
+    MPI_CHECK(MPI_Request_free(&(mh->request)));
+  }
+  if (mh->custom && !finalized) MPI_CHECK(MPI_Type_free(&(mh->datatype)));
   host_free(mh);
 }
 
 
 void comm_start(MsgHandle *mh)
 {
+  if (mh->shm) {
+    if (mh->send) comm_shm_send_start(mh);
+    else mh->pending = true; // the receive is completed in comm_query or comm_wait
+    return;
+  }
   MPI_CHECK( MPI_Start(&(mh->request)) );
 }
 
 
 void comm_wait(MsgHandle *mh)
 {
+  if (mh->shm) {
+    if (mh->send) comm_shm_send_wait(mh);
+    else comm_shm_receive(mh, true);
+    return;
+  }
   MPI_CHECK( MPI_Wait(&(mh->request), MPI_STATUS_IGNORE) );
 }
 
 
 int comm_query(MsgHandle *mh)
 {
+  if (mh->shm) {
+    comm_shm_progress();
+    if (mh->send) return !mh->pending;
+    return comm_shm_receive(mh, false);
+  }
+
   int query;
   MPI_CHECK( MPI_Test(&(mh->request), &query, MPI_STATUS_IGNORE) );
 
@@ -295,10 +672,10 @@ void comm_allreduce_max(double* data)
 
 void comm_allreduce_array(double* data, size_t size)
 {
-  double *recvbuf = new double[size];
-  MPI_CHECK( MPI_Allreduce(data, recvbuf, size, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD) );
-  memcpy(data, recvbuf, size*sizeof(double));
-  delete []recvbuf;
+  static std::vector<double> recvbuf; // persistent to avoid an allocation per call
+  if (recvbuf.size() < size) recvbuf.resize(size);
+  MPI_CHECK( MPI_Allreduce(data, recvbuf.data(), size, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD) );
+  memcpy(data, recvbuf.data(), size*sizeof(double));
 }
 
 
@@ -318,6 +695,88 @@ void comm_allreduce_xor(uint64_t *data)
 }
 
 
+ReduceHandle *comm_declare_allreduce(void)
+{
+  ReduceHandle *rh = new ReduceHandle;
+  rh->count = 0;
+  rh->request = MPI_REQUEST_NULL;
+  rh->active = false;
+  return rh;
+}
+
+
+void comm_free_allreduce(ReduceHandle *rh)
+{
+  if (rh->active) comm_allreduce_wait(rh);
+  delete rh;
+}
+
+
+void comm_allreduce_append(ReduceHandle *rh, double *data, size_t size)
+{
+  if (rh->active) errorQuda("Cannot append to a reduction that is in flight");
+  rh->data.push_back(data);
+  rh->size.push_back(size);
+}
+
+
+void comm_allreduce_start(ReduceHandle *rh)
+{
+  if (rh->active) errorQuda("Reduction has already been started");
+
+  rh->count = 0;
+  for (unsigned int i=0; i<rh->size.size(); i++) rh->count += rh->size[i];
+  if (rh->send.size() < rh->count) {
+    rh->send.resize(rh->count);
+    rh->recv.resize(rh->count);
+  }
+
+  // pack all pending arrays into a single message
+  size_t offset = 0;
+  for (unsigned int i=0; i<rh->data.size(); i++) {
+    memcpy(rh->send.data() + offset, rh->data[i], rh->size[i]*sizeof(double));
+    offset += rh->size[i];
+  }
+
+  rh->active = true;
+  if (rh->count == 0) return;
+
+#if MPI_VERSION >= 3
+  MPI_CHECK( MPI_Iallreduce(rh->send.data(), rh->recv.data(), rh->count, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &(rh->request)) );
+#else
+  // non-blocking collectives require MPI-3, so batch but do not overlap
+  MPI_CHECK( MPI_Allreduce(rh->send.data(), rh->recv.data(), rh->count, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD) );
+#endif
+}
+
+
+void comm_allreduce_wait(ReduceHandle *rh)
+{
+  if (!rh->active) errorQuda("Reduction has not been started");
+
+  MPI_CHECK( MPI_Wait(&(rh->request), MPI_STATUS_IGNORE) );
+
+  size_t offset = 0;
+  for (unsigned int i=0; i<rh->data.size(); i++) {
+    memcpy(rh->data[i], rh->recv.data() + offset, rh->size[i]*sizeof(double));
+    offset += rh->size[i];
+  }
+
+  rh->data.clear();
+  rh->size.clear();
+  rh->active = false;
+}
+
+
+int comm_allreduce_query(ReduceHandle *rh)
+{
+  if (!rh->active) return 1;
+  int query;
+  MPI_CHECK( MPI_Test(&(rh->request), &query, MPI_STATUS_IGNORE) );
+  return query;
+}
+
+
 /**  broadcast from rank 0 */
 void comm_broadcast(void *data, size_t nbytes)
 {
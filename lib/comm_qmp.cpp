@@ -1,5 +1,6 @@
 #include <qmp.h>
 #include <csignal>
+#include <vector>
 #include <quda_internal.h>
 #include <comm_quda.h>
 
@@ -14,6 +15,15 @@ struct MsgHandle_s {
   QMP_msghandle_t handle;
 };
 
+// QMP has no non-blocking reductions, so the batch is reduced with a
+// single blocking call when the reduction is started
+struct ReduceHandle_s {
+  std::vector<double*> data;
+  std::vector<size_t> size;
+  std::vector<double> buffer;
+  bool active;
+};
+
 static int gpuid = -1;
 
 static char partition_string[16];
@@ -125,6 +135,8 @@ void comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *m
   snprintf(topology_string, 16, ",topo=%d%d%d%d", comm_dim(0), comm_dim(1), comm_dim(2), comm_dim(3));
 }
 
+void comm_backend_finalize(void) {}
+
 int comm_rank(void)
 {
   return QMP_get_node_number();
@@ -227,8 +239,12 @@ MsgHandle *comm_declare_strided_receive_displaced(void *buffer, const int displa
 
 void comm_free(MsgHandle *mh)
 {
-  QMP_free_msghandle(mh->handle);
-  QMP_free_msgmem(mh->mem);
+  // handles owned by fields that outlive QMP_finalize_msg_passing only
+  // have the host-side handle left to release
+  if (QMP_is_initialized()) {
+    QMP_free_msghandle(mh->handle);
+    QMP_free_msgmem(mh->mem);
+  }
   host_free(mh);
 }
 
@@ -280,6 +296,67 @@ void comm_allreduce_xor(uint64_t *data)
   QMP_CHECK( QMP_xor_ulong(data); );
 }
 
+ReduceHandle *comm_declare_allreduce(void)
+{
+  ReduceHandle *rh = new ReduceHandle;
+  rh->active = false;
+  return rh;
+}
+
+
+void comm_free_allreduce(ReduceHandle *rh)
+{
+  if (rh->active) comm_allreduce_wait(rh);
+  delete rh;
+}
+
+
+void comm_allreduce_append(ReduceHandle *rh, double *data, size_t size)
+{
+  if (rh->active) errorQuda("Cannot append to a reduction that is in flight");
+  rh->data.push_back(data);
+  rh->size.push_back(size);
+}
+
+
+void comm_allreduce_start(ReduceHandle *rh)
+{
+  if (rh->active) errorQuda("Reduction has already been started");
+
+  size_t count = 0;
+  for (unsigned int i=0; i<rh->size.size(); i++) count += rh->size[i];
+  if (rh->buffer.size() < count) rh->buffer.resize(count);
+
+  size_t offset = 0;
+  for (unsigned int i=0; i<rh->data.size(); i++) {
+    memcpy(rh->buffer.data() + offset, rh->data[i], rh->size[i]*sizeof(double));
+    offset += rh->size[i];
+  }
+
+  if (count > 0) QMP_CHECK( QMP_sum_double_array(rh->buffer.data(), count) );
+  rh->active = true;
+}
+
+
+void comm_allreduce_wait(ReduceHandle *rh)
+{
+  if (!rh->active) errorQuda("Reduction has not been started");
+
+  size_t offset = 0;
+  for (unsigned int i=0; i<rh->data.size(); i++) {
+    memcpy(rh->data[i], rh->buffer.data() + offset, rh->size[i]*sizeof(double));
+    offset += rh->size[i];
+  }
+
+  rh->data.clear();
+  rh->size.clear();
+  rh->active = false;
+}
+
+
+int comm_allreduce_query(ReduceHandle *rh) { return 1; }
+
+
 void comm_broadcast(void *data, size_t nbytes)
 {
   QMP_CHECK( QMP_broadcast(data, nbytes) );
@@ -16,6 +16,8 @@ void comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *m
   comm_set_default_topology(topo);
 }
 
+void comm_backend_finalize(void) {}
+
 int comm_rank(void) { return 0; }
 
 int comm_size(void) { return 1; }
@@ -62,6 +64,18 @@ void comm_allreduce_int(int* data) {}
 
 void comm_allreduce_xor(uint64_t *data) {}
 
+ReduceHandle *comm_declare_allreduce(void) { return NULL; }
+
+void comm_free_allreduce(ReduceHandle *rh) {}
+
+void comm_allreduce_append(ReduceHandle *rh, double *data, size_t size) {}
+
+void comm_allreduce_start(ReduceHandle *rh) {}
+
+void comm_allreduce_wait(ReduceHandle *rh) {}
+
+int comm_allreduce_query(ReduceHandle *rh) { return 1; }
+
 void comm_broadcast(void *data, size_t nbytes) {}
 
 void comm_barrier(void) {}
@@ -0,0 +1,212 @@
+#include <color_spinor_field.h>
+#include <color_spinor_field_order.h>
+#include <color_spinor.h>
+#include <contractQuda.h>
+#include <comm_quda.h>
+#include <vector>
+
+/**
+   Host meson contraction fused with the momentum projection.  The
+   per-site spin matrix of the color-contracted fields is never stored:
+   each site is projected onto every requested momentum as soon as it
+   is computed and accumulated into per-timeslice sums.
+*/
+
+namespace quda {
+
+#ifdef GPU_CONTRACT
+
+  template <typename Float, typename F>
+  struct ContractMomArg {
+    const F x;            // spinor to be contracted (daggered)
+    const F y;            // spinor to be contracted
+    const int parity;     // only use this for single parity fields
+    const int nParity;    // number of parities we're working on
+    const int nMom;       // number of momenta
+    int X[4];             // full local lattice dimensions
+    int T;                // global temporal extent
+    int tOffset;          // global time coordinate of the first local timeslice
+    std::vector<Complex> phase[3]; // phase[d][m*X[d] + x] = exp(-2 pi i p_d x_d / L_d)
+
+    ContractMomArg(const ColorSpinorField &x, const ColorSpinorField &y, const std::vector<int> &mom, int parity)
+      : x(x), y(y), parity(parity), nParity(x.SiteSubset()), nMom(mom.size()/3)
+    {
+      for (int d=0; d<4; d++) X[d] = x.X(d);
+      X[0] *= (3-nParity);
+      T = X[3] * comm_dim(3);
+      tOffset = X[3] * comm_coord(3);
+
+      for (int d=0; d<3; d++) {
+        const int L = X[d] * comm_dim(d);
+        const int offset = X[d] * comm_coord(d);
+        phase[d].resize(nMom*X[d]);
+        for (int m=0; m<nMom; m++) {
+          for (int s=0; s<X[d]; s++) {
+            // reduce the integer product first to keep the phase exact for large momenta
+            const double theta = -2.0 * M_PI * ((mom[3*m+d] * (offset + s)) % L) / L;
+            phase[d][m*X[d] + s] = Complex(cos(theta), sin(theta));
+          }
+        }
+      }
+    }
+  };
+
+  /**
+     Accumulate the momentum-projected contraction of one (t,z) slab
+     of the local lattice into sum[(m*16 + mu*4 + nu)].  Each slab is
+     processed by a single thread in a fixed order.
+  */
+  template <typename Float, int nColor, typename Arg>
+  void contractMomSlab(Complex *sum, const Arg &arg, int t, int z, Complex *site_phase)
+  {
+    typedef ColorSpinor<Float,nColor,4> Vector;
+
+    for (int y=0; y<arg.X[1]; y++) {
+      for (int x=0; x<arg.X[0]; x++) {
+        const int parity = (x + y + z + t) & 1;
+        if (arg.nParity == 1 && parity != arg.parity) continue;
+        const int x_cb = (((t*arg.X[2] + z)*arg.X[1] + y)*arg.X[0] + x) >> 1;
+        const int spinor_parity = (arg.nParity == 2) ? parity : 0;
+
+        Vector a, b;
+        arg.x.load((Float*)a.data, x_cb, spinor_parity);
+        arg.y.load((Float*)b.data, x_cb, spinor_parity);
+
+        // result_{mu nu} = sum_c conj(x_{mu c}) y_{nu c}
+        Complex M[16];
+        for (int mu=0; mu<4; mu++) {
+          for (int nu=0; nu<4; nu++) {
+            Complex s = 0.0;
+            for (int c=0; c<nColor; c++) {
+              s += Complex(a(mu,c).real(), -a(mu,c).imag()) * Complex(b(nu,c).real(), b(nu,c).imag());
+            }
+            M[mu*4+nu] = s;
+          }
+        }
+
+        for (int m=0; m<arg.nMom; m++) {
+          site_phase[m] = arg.phase[0][m*arg.X[0] + x] * arg.phase[1][m*arg.X[1] + y] * arg.phase[2][m*arg.X[2] + z];
+        }
+
+        for (int m=0; m<arg.nMom; m++) {
+          for (int g=0; g<16; g++) sum[m*16 + g] += site_phase[m] * M[g];
+        }
+      }
+    }
+  }
+
+  template <typename Float, int nColor, typename F>
+  void contractMomentumProject(std::vector<Complex> &result, const ColorSpinorField &x, const ColorSpinorField &y,
+                               const std::vector<int> &mom, int parity)
+  {
+    ContractMomArg<Float,F> arg(x, y, mom, parity);
+    const int nMom = arg.nMom;
+    const int Z = arg.X[2];
+    const int Tlocal = arg.X[3];
+
+    // one partial sum per (t,z) slab so the result does not depend on the thread count
+    std::vector<Complex> partial((size_t)Tlocal*Z*nMom*16, Complex(0.0,0.0));
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      std::vector<Complex> site_phase(nMom);
+#ifdef _OPENMP
+#pragma omp for collapse(2) schedule(static)
+#endif
+      for (int t=0; t<Tlocal; t++) {
+        for (int z=0; z<Z; z++) {
+          contractMomSlab<Float,nColor>(&partial[((size_t)t*Z + z)*nMom*16], arg, t, z, site_phase.data());
+        }
+      }
+    }
+
+    // combine the slabs into the global timeslice array
+    result.assign((size_t)nMom*arg.T*16, Complex(0.0,0.0));
+    for (int t=0; t<Tlocal; t++) {
+      for (int z=0; z<Z; z++) {
+        const Complex *p = &partial[((size_t)t*Z + z)*nMom*16];
+        for (int m=0; m<nMom; m++) {
+          for (int g=0; g<16; g++) result[((size_t)m*arg.T + arg.tOffset + t)*16 + g] += p[m*16 + g];
+        }
+      }
+    }
+
+    // a single batched reduction over all momenta, timeslices and spin components
+    comm_allreduce_array(reinterpret_cast<double*>(result.data()), 2*result.size());
+  }
+
+  // template on the color-spinor field order
+  template <typename Float, int nColor>
+  void contractMomentumProject(std::vector<Complex> &result, const ColorSpinorField &x, const ColorSpinorField &y,
+                               const std::vector<int> &mom, int parity)
+  {
+    if (x.FieldOrder() == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) {
+      typedef typename colorspinor::SpaceSpinorColorOrder<Float,4,nColor> F;
+      contractMomentumProject<Float,nColor,F>(result, x, y, mom, parity);
+    } else if (x.FieldOrder() == QUDA_SPACE_COLOR_SPIN_FIELD_ORDER) {
+      typedef typename colorspinor::SpaceColorSpinorOrder<Float,4,nColor> F;
+      contractMomentumProject<Float,nColor,F>(result, x, y, mom, parity);
+    } else if (x.FieldOrder() == QUDA_FLOAT2_FIELD_ORDER) {
+      typedef typename colorspinor_order_mapper<Float,QUDA_FLOAT2_FIELD_ORDER,4,nColor>::type F;
+      contractMomentumProject<Float,nColor,F>(result, x, y, mom, parity);
+    } else {
+      errorQuda("Unsupported field order %d\n", x.FieldOrder());
+    }
+  }
+
+  // template on the number of colors
+  template <typename Float>
+  void contractMomentumProject(std::vector<Complex> &result, const ColorSpinorField &x, const ColorSpinorField &y,
+                               const std::vector<int> &mom, int parity)
+  {
+    if (x.Ncolor() == 3) {
+      contractMomentumProject<Float,3>(result, x, y, mom, parity);
+    } else {
+      errorQuda("Unsupported number of colors %d\n", x.Ncolor());
+    }
+  }
+
+#endif // GPU_CONTRACT
+
+  void contractMomentumProject(std::vector<Complex> &result, const ColorSpinorField &x, const ColorSpinorField &y,
+                               const std::vector<int> &mom, const QudaParity parity, TimeProfile &profile)
+  {
+#ifdef GPU_CONTRACT
+    profile.TPSTART(QUDA_PROFILE_TOTAL);
+    profile.TPSTART(QUDA_PROFILE_INIT);
+
+    if (x.Location() != QUDA_CPU_FIELD_LOCATION || y.Location() != QUDA_CPU_FIELD_LOCATION)
+      errorQuda("Momentum projected contraction requires host fields");
+    if (x.Nspin() != 4 || y.Nspin() != 4) errorQuda("Unsupported nSpin x = %d, y = %d", x.Nspin(), y.Nspin());
+    if (x.FieldOrder() != y.FieldOrder())
+      errorQuda("Field order mismatch x = %d, y = %d", x.FieldOrder(), y.FieldOrder());
+    if (x.SiteSubset() != y.SiteSubset() || x.VolumeCB() != y.VolumeCB())
+      errorQuda("Site subset or volume mismatch between x and y");
+    if (x.SiteOrder() != QUDA_EVEN_ODD_SITE_ORDER || y.SiteOrder() != QUDA_EVEN_ODD_SITE_ORDER)
+      errorQuda("Unsupported site order x = %d, y = %d", x.SiteOrder(), y.SiteOrder());
+    if (x.SiteSubset() == QUDA_PARITY_SITE_SUBSET && parity != QUDA_EVEN_PARITY && parity != QUDA_ODD_PARITY)
+      errorQuda("Invalid parity %d for a single parity field", parity);
+    if (mom.size() % 3 != 0) errorQuda("Momentum list length %lu is not a multiple of 3", mom.size());
+    checkPrecision(x, y);
+
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+
+    if (x.Precision() == QUDA_DOUBLE_PRECISION) {
+      contractMomentumProject<double>(result, x, y, mom, parity);
+    } else if (x.Precision() == QUDA_SINGLE_PRECISION) {
+      contractMomentumProject<float>(result, x, y, mom, parity);
+    } else {
+      errorQuda("Unsupported precision %d\n", x.Precision());
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+    profile.TPSTOP(QUDA_PROFILE_TOTAL);
+#else
+    errorQuda("Contraction code has not been built");
+#endif
+  }
+
+} // namespace quda
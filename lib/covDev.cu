@@ -4,6 +4,9 @@
 #include <index_helper.cuh>
 #include <stencil.h>
 #include <color_spinor.h>
+#include <covDev.h>
+#include <multi_stencil.cuh>
+#include <vector>
 
 /**
    This is the covariant derivative based on the basic gauged Laplace operator
@@ -126,22 +129,6 @@ namespace quda {
     arg.out(x_cb, parity) = out;
   }
 
-  // CPU kernel for applying the Laplace operator to a vector
-  template <typename Float, int nDim, int nSpin, int nColor, typename Arg>
-  void covDevCPU(Arg arg)
-  {
-
-    for (int parity= 0; parity < arg.nParity; parity++) {
-      // for full fields then set parity from loop else use arg setting
-      parity = (arg.nParity == 2) ? parity : arg.parity;
-
-      for (int x_cb = 0; x_cb < arg.volumeCB; x_cb++) { // 4-d volume
-	covDev<Float,nDim,nSpin,nColor>(arg, x_cb, parity);
-      } // 4-d volumeCB
-    } // parity
-
-  }
-
   // GPU Kernel for applying the Laplace operator to a vector
   template <typename Float, int nDim, int nSpin, int nColor, typename Arg>
   __global__ void covDevGPU(Arg arg)
@@ -193,12 +180,8 @@ namespace quda {
     virtual ~CovDev() { }
 
     void apply(const cudaStream_t &stream) {
-      if (meta.Location() == QUDA_CPU_FIELD_LOCATION) {
-	covDevCPU<Float,nDim,nSpin,nColor>(arg);
-      } else {
-        TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
-	covDevGPU<Float,nDim,nSpin,nColor> <<<tp.grid,tp.block,tp.shared_bytes,stream>>>(arg);
-      }
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      covDevGPU<Float,nDim,nSpin,nColor> <<<tp.grid,tp.block,tp.shared_bytes,stream>>>(arg);
     }
 
     TuneKey tuneKey() const { return TuneKey(meta.VolString(), typeid(*this).name(), aux); }
@@ -250,6 +233,93 @@ namespace quda {
     }
   }
 
+  template <typename Float, int nSpin, int nColor, typename F, typename G>
+  struct CovDevMultiArg : public MultiStencilArg<Float,F,G> {
+    typedef ColorSpinor<Float,nColor,nSpin> Vector;
+
+    CovDevMultiArg(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, const G &U,
+                   const int parity)
+      : MultiStencilArg<Float,F,G>(out, in, U, parity) { }
+
+    inline void store(Vector *out, int x_cb, int parity)
+    {
+      for (int v=0; v<this->nVec; v++) this->out[v].save((Float*)out[v].data, x_cb, parity);
+    }
+  };
+
+  // template on the color-spinor field order
+  template <typename Float, int nSpin, int nColor, typename G>
+    void ApplyCovDev(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, const G &U,
+		     int parity, int mu)
+  {
+    if (in[0]->FieldOrder() == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) {
+      typedef typename colorspinor::SpaceSpinorColorOrder<Float,nSpin,nColor> F;
+      CovDevMultiArg<Float,nSpin,nColor,F,G> arg(out, in, U, parity);
+      multiStencilCPU<Float,nSpin,nColor>(arg, mu%4, mu%4+1, mu < 4, mu >= 4);
+    } else if (in[0]->FieldOrder() == QUDA_FLOAT2_FIELD_ORDER) {
+      typedef typename colorspinor_order_mapper<Float,QUDA_FLOAT2_FIELD_ORDER,nSpin,nColor>::type F;
+      CovDevMultiArg<Float,nSpin,nColor,F,G> arg(out, in, U, parity);
+      multiStencilCPU<Float,nSpin,nColor>(arg, mu%4, mu%4+1, mu < 4, mu >= 4);
+    } else {
+      errorQuda("Unsupported field order %d\n", in[0]->FieldOrder());
+    }
+  }
+
+  // template on the number of spins
+  template <typename Float, int nColor, typename G>
+    void ApplyCovDev(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, const G &U,
+		     int parity, int mu)
+  {
+    if (in[0]->Nspin() == 1) {
+      ApplyCovDev<Float,1,nColor>(out, in, U, parity, mu);
+    } else if (in[0]->Nspin() == 4) {
+      ApplyCovDev<Float,4,nColor>(out, in, U, parity, mu);
+    } else {
+      errorQuda("Unsupported nSpin=%d", in[0]->Nspin());
+    }
+  }
+
+  // template on the gauge field order
+  template <typename Float, int nColor>
+    void ApplyCovDev(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, const GaugeField &U,
+		     int parity, int mu)
+  {
+    if (U.isNative()) {
+      if (U.Reconstruct()== QUDA_RECONSTRUCT_NO) {
+	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type G;
+	ApplyCovDev<Float,nColor>(out, in, G(U), parity, mu);
+      } else if (U.Reconstruct()== QUDA_RECONSTRUCT_12) {
+	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type G;
+	ApplyCovDev<Float,nColor>(out, in, G(U), parity, mu);
+      } else if (U.Reconstruct()== QUDA_RECONSTRUCT_8) {
+	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type G;
+	ApplyCovDev<Float,nColor>(out, in, G(U), parity, mu);
+      } else {
+	errorQuda("Unsupported reconstruct type %d\n", U.Reconstruct());
+      }
+    } else if (U.Order() == QUDA_QDP_GAUGE_ORDER) {
+      typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,nColor>::type G;
+      ApplyCovDev<Float,nColor>(out, in, G(U), parity, mu);
+    } else if (U.Order() == QUDA_MILC_GAUGE_ORDER) {
+      typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,nColor>::type G;
+      ApplyCovDev<Float,nColor>(out, in, G(U), parity, mu);
+    } else {
+      errorQuda("Unsupported gauge order %d\n", U.Order());
+    }
+  }
+
+  // template on the number of colors
+  template <typename Float>
+    void ApplyCovDev(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, const GaugeField &U,
+		     int parity, int mu)
+  {
+    if (in[0]->Ncolor() == 3) {
+      ApplyCovDev<Float,3>(out, in, U, parity, mu);
+    } else {
+      errorQuda("Unsupported number of colors %d\n", U.Ncolor());
+    }
+  }
+
   // this is the Worker pointer that may have issue additional work
   // while we're waiting on communication to finish
   namespace dslash {
@@ -264,6 +334,14 @@ namespace quda {
   void ApplyCovDev(ColorSpinorField &out, const ColorSpinorField &in, const GaugeField &U, int parity, int mu)		    
   {
 #ifdef GPU_CONTRACT
+    // host fields go through the batched kernel
+    if (U.Location() == QUDA_CPU_FIELD_LOCATION) {
+      std::vector<ColorSpinorField*> out_(1, &out);
+      std::vector<ColorSpinorField*> in_(1, const_cast<ColorSpinorField*>(&in));
+      ApplyCovDev(out_, in_, U, parity, mu);
+      return;
+    }
+
     if (in.V() == out.V()) errorQuda("Aliasing pointers");
     if (in.FieldOrder() != out.FieldOrder())
       errorQuda("Field order mismatch in = %d, out = %d", in.FieldOrder(), out.FieldOrder());
@@ -291,4 +369,51 @@ namespace quda {
 #endif
   }
 
+  //Apply the covariant derivative operator to a set of vectors
+  //Host fields are processed together, device fields one at a time
+  void ApplyCovDev(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, const GaugeField &U,
+		   int parity, int mu)
+  {
+#ifdef GPU_CONTRACT
+    if (out.size() != in.size())
+      errorQuda("Number of vectors mismatch in = %lu, out = %lu", in.size(), out.size());
+    if (in.size() == 0) return;
+    if (mu < 0 || mu > 7) errorQuda("Invalid direction mu = %d", mu);
+
+    if (U.Location() == QUDA_CUDA_FIELD_LOCATION) {
+      for (unsigned int i=0; i<in.size(); i++) ApplyCovDev(*out[i], *in[i], U, parity, mu);
+      return;
+    }
+
+    for (unsigned int i=0; i<in.size(); i++) {
+      if (in[i]->V() == out[i]->V()) errorQuda("Aliasing pointers");
+      if (in[i]->FieldOrder() != in[0]->FieldOrder() || out[i]->FieldOrder() != in[0]->FieldOrder())
+	errorQuda("Field order mismatch in = %d, out = %d", in[i]->FieldOrder(), out[i]->FieldOrder());
+      if (in[i]->Nspin() != in[0]->Nspin() || in[i]->VolumeCB() != in[0]->VolumeCB() ||
+	  out[i]->VolumeCB() != in[0]->VolumeCB() || in[i]->SiteSubset() != in[0]->SiteSubset() ||
+	  out[i]->SiteSubset() != in[0]->SiteSubset())
+	errorQuda("Spin, volume or site subset mismatch between vectors");
+
+      // check all precision match
+      checkPrecision(*out[i], *in[i], U);
+
+      // check all locations match
+      checkLocation(*out[i], *in[i], U);
+    }
+
+    const int nFace = 1;
+    for (unsigned int i=0; i<in.size(); i++) in[i]->exchangeGhost((QudaParity)(1-parity), nFace, 0); // last parameter is dummy
+
+    if (U.Precision() == QUDA_DOUBLE_PRECISION) {
+      ApplyCovDev<double>(out, in, U, parity, mu);
+    } else if (U.Precision() == QUDA_SINGLE_PRECISION) {
+      ApplyCovDev<float>(out, in, U, parity, mu);
+    } else {
+      errorQuda("Unsupported precision %d\n", U.Precision());
+    }
+#else
+    errorQuda("Contraction kernels have not been built");
+#endif
+  }
+
 } // namespace quda
@@ -8,14 +8,6 @@
 
 namespace quda {
 
-  int cpuColorSpinorField::initGhostFaceBuffer =0;
-  void* cpuColorSpinorField::fwdGhostFaceBuffer[QUDA_MAX_DIM]; 
-  void* cpuColorSpinorField::backGhostFaceBuffer[QUDA_MAX_DIM];
-  void* cpuColorSpinorField::fwdGhostFaceSendBuffer[QUDA_MAX_DIM]; 
-  void* cpuColorSpinorField::backGhostFaceSendBuffer[QUDA_MAX_DIM];
-
-  size_t cpuColorSpinorField::ghostFaceBytes[QUDA_MAX_DIM] = { };
-
   cpuColorSpinorField::cpuColorSpinorField(const ColorSpinorParam &param) :
     ColorSpinorField(param), init(false), reference(false) {
 
@@ -183,7 +175,9 @@ namespace quda {
   }
 
   void cpuColorSpinorField::destroy() {
-  
+
+    freeGhostBuffer(); // the geometry may change, so the halo is recreated on the next exchange
+
     if (init) {
       if (fieldOrder == QUDA_QOP_DOMAIN_WALL_FIELD_ORDER) 
 	for (int i=0; i<x[nDim-1]; i++) host_free(((void**)v)[i]);
@@ -257,40 +251,62 @@ namespace quda {
 
   void cpuColorSpinorField::allocateGhostBuffer(int nFace) const
   {
-    int spinor_size = 2*nSpin*nColor*precision;
-    bool resize = false;
+    if (ghost_buffer_h && nFace == ghost_nFace) return;
+    freeGhostBuffer();
 
-    // resize face only if requested size is larger than previously allocated one
+    const size_t spinor_size = 2*nSpin*nColor*precision;
+    size_t face_bytes[QUDA_MAX_DIM] = { };
+    size_t total_bytes = 0;
     for (int i=0; i<nDimComms; i++) {
-      size_t nbytes = siteSubset*nFace*surfaceCB[i]*spinor_size;
-      resize = (nbytes > ghostFaceBytes[i]) ? true : resize;
-      ghostFaceBytes[i] = (nbytes > ghostFaceBytes[i]) ? nbytes : ghostFaceBytes[i];
+      if (!comm_dim_partitioned(i)) continue;
+      face_bytes[i] = siteSubset*nFace*surfaceCB[i]*spinor_size;
+      total_bytes += 2*face_bytes[i]; // 2 for fwd/bwd
     }
+    if (total_bytes == 0) return;
 
-    if (!initGhostFaceBuffer || resize) {
-      freeGhostBuffer();
-      for (int i=0; i<nDimComms; i++) {
-	fwdGhostFaceBuffer[i] = safe_malloc(ghostFaceBytes[i]);
-	backGhostFaceBuffer[i] = safe_malloc(ghostFaceBytes[i]);
-	fwdGhostFaceSendBuffer[i] = safe_malloc(ghostFaceBytes[i]);
-	backGhostFaceSendBuffer[i] = safe_malloc(ghostFaceBytes[i]);
-      }
-      initGhostFaceBuffer = 1;
+    // a single allocation per field: all receive buffers followed by all send buffers
+    ghost_buffer_h = safe_malloc(2*total_bytes);
+    char *recv = static_cast<char*>(ghost_buffer_h);
+    char *send = recv + total_bytes;
+    for (int i=0; i<nDimComms; i++) {
+      if (!comm_dim_partitioned(i)) continue;
+      backGhostFaceBuffer[i] = recv;
+      backGhostFaceSendBuffer[i] = send;
+      recv += face_bytes[i];
+      send += face_bytes[i];
+      fwdGhostFaceBuffer[i] = recv;
+      fwdGhostFaceSendBuffer[i] = send;
+      recv += face_bytes[i];
+      send += face_bytes[i];
+
+      mh_recv_ghost_fwd[i] = comm_declare_receive_relative(fwdGhostFaceBuffer[i], i, +1, face_bytes[i]);
+      mh_recv_ghost_back[i] = comm_declare_receive_relative(backGhostFaceBuffer[i], i, -1, face_bytes[i]);
+      mh_send_ghost_fwd[i] = comm_declare_send_relative(fwdGhostFaceSendBuffer[i], i, +1, face_bytes[i]);
+      mh_send_ghost_back[i] = comm_declare_send_relative(backGhostFaceSendBuffer[i], i, -1, face_bytes[i]);
     }
+
+    ghost_nFace = nFace;
   }
 
 
-  void cpuColorSpinorField::freeGhostBuffer(void)
+  void cpuColorSpinorField::freeGhostBuffer() const
   {
-    if(!initGhostFaceBuffer) return;
-
-    for(int i=0; i < 4; i++){  // make nDimComms static?
-      host_free(fwdGhostFaceBuffer[i]); fwdGhostFaceBuffer[i] = NULL;
-      host_free(backGhostFaceBuffer[i]); backGhostFaceBuffer[i] = NULL;
-      host_free(fwdGhostFaceSendBuffer[i]); fwdGhostFaceSendBuffer[i] = NULL;
-      host_free(backGhostFaceSendBuffer[i]);  backGhostFaceSendBuffer[i] = NULL;
-    } 
-    initGhostFaceBuffer = 0;
+    if (!ghost_buffer_h) return;
+
+    for (int i=0; i<QUDA_MAX_DIM; i++) {
+      if (mh_recv_ghost_fwd[i]) { comm_free(mh_recv_ghost_fwd[i]); mh_recv_ghost_fwd[i] = nullptr; }
+      if (mh_recv_ghost_back[i]) { comm_free(mh_recv_ghost_back[i]); mh_recv_ghost_back[i] = nullptr; }
+      if (mh_send_ghost_fwd[i]) { comm_free(mh_send_ghost_fwd[i]); mh_send_ghost_fwd[i] = nullptr; }
+      if (mh_send_ghost_back[i]) { comm_free(mh_send_ghost_back[i]); mh_send_ghost_back[i] = nullptr; }
+      fwdGhostFaceBuffer[i] = nullptr;
+      backGhostFaceBuffer[i] = nullptr;
+      fwdGhostFaceSendBuffer[i] = nullptr;
+      backGhostFaceSendBuffer[i] = nullptr;
+    }
+
+    host_free(ghost_buffer_h);
+    ghost_buffer_h = nullptr;
+    ghost_nFace = 0;
   }
 
 
@@ -310,24 +326,54 @@ namespace quda {
 
   void cpuColorSpinorField::exchangeGhost(QudaParity parity, int nFace, int dagger, const MemoryLocation *dummy1,
 					  const MemoryLocation *dummy2, bool dummy3, bool dummy4) const
+  {
+    exchangeGhostRange(parity, nFace, dagger, 0, nDimComms);
+  }
+
+  void cpuColorSpinorField::exchangeGhostDim(QudaParity parity, int nFace, int dagger, int dim) const
+  {
+    if (dim < 0 || dim >= nDimComms) errorQuda("Invalid ghost exchange dimension %d", dim);
+    exchangeGhostRange(parity, nFace, dagger, dim, dim+1);
+  }
+
+  void cpuColorSpinorField::exchangeGhostRange(QudaParity parity, int nFace, int dagger, int dim_begin, int dim_end) const
   {
     // allocate ghost buffer if not yet allocated
     allocateGhostBuffer(nFace);
 
-    void **sendbuf = static_cast<void**>(safe_malloc(nDimComms * 2 * sizeof(void*)));
-
     for (int i=0; i<nDimComms; i++) {
-      sendbuf[2*i + 0] = backGhostFaceSendBuffer[i];
-      sendbuf[2*i + 1] = fwdGhostFaceSendBuffer[i];
       ghost_buf[2*i + 0] = backGhostFaceBuffer[i];
       ghost_buf[2*i + 1] = fwdGhostFaceBuffer[i];
     }
 
-    packGhost(sendbuf, parity, nFace, dagger);
+    // post all receives up front
+    for (int i=dim_begin; i<dim_end; i++) {
+      if (!comm_dim_partitioned(i)) continue;
+      comm_start(mh_recv_ghost_back[i]);
+      comm_start(mh_recv_ghost_fwd[i]);
+    }
+
+    // pack one dimension at a time directly into its send buffers,
+    // so that its messages are in flight while we pack the next
+    void *sendbuf[2*QUDA_MAX_DIM] = { };
+    for (int i=dim_begin; i<dim_end; i++) {
+      if (!comm_dim_partitioned(i)) continue;
+      sendbuf[2*i + 0] = backGhostFaceSendBuffer[i];
+      sendbuf[2*i + 1] = fwdGhostFaceSendBuffer[i];
+      packGhost(sendbuf, parity, nFace, dagger);
+      sendbuf[2*i + 0] = sendbuf[2*i + 1] = nullptr;
 
-    exchange(ghost_buf, sendbuf, nFace);
+      comm_start(mh_send_ghost_fwd[i]);
+      comm_start(mh_send_ghost_back[i]);
+    }
 
-    host_free(sendbuf);
+    for (int i=dim_begin; i<dim_end; i++) {
+      if (!comm_dim_partitioned(i)) continue;
+      comm_wait(mh_send_ghost_fwd[i]);
+      comm_wait(mh_send_ghost_back[i]);
+      comm_wait(mh_recv_ghost_back[i]);
+      comm_wait(mh_recv_ghost_fwd[i]);
+    }
   }
 
 } // namespace quda
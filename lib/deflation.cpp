@@ -3,6 +3,7 @@
 #include <string.h>
 
 #include <memory>
+#include <algorithm>
 
 
 
@@ -24,6 +25,11 @@ namespace quda {
   static auto pinned_allocator = [] (size_t bytes ) { return static_cast<Complex*>(pool_pinned_malloc(bytes)); };
   static auto pinned_deleter   = [] (Complex *hptr) { pool_pinned_free(hptr); };
 
+  // maximum number of new vectors orthogonalized together in
+  // Deflation::increment: the largest block the multi-blas kernels
+  // handle in a single launch
+  static const int increment_tile = MAX_MULTI_BLAS_N;
+
 
   //static bool debug = false;
 
@@ -34,6 +40,9 @@ namespace quda {
 
     // for reporting level 1 is the fine level but internally use level 0 for indexing
     printfQuda("Creating deflation space of %d vectors.\n", param.tot_dim);
+    if (param.RV->Precision() != param.eig_global.cuda_prec_ritz)
+      printfQuda("Deflation space is stored compressed in precision %d (applied in precision %d)\n",
+                 param.RV->Precision(), param.eig_global.cuda_prec_ritz);
 
     if( param.eig_global.import_vectors ) loadVectors(param.RV);//whether to load eigenvectors
     // create aux fields
@@ -217,70 +226,136 @@ namespace quda {
       return;
     }
 
-    for(int i = 0; i < nev; i++) blas::copy(param.RV->Component(first_idx+i), Vm.Component(i));
-
-    printfQuda("\nConstruct projection matrix..\n");
+    // The panel of new vectors is processed in tiles of at most
+    // increment_tile vectors, so the full-precision workspace does not
+    // grow with nev.  The first slot of each workspace reuses r and
+    // Av_sloppy.
+    const int tile = std::min(nev, increment_tile);
+
+    ColorSpinorParam csParam(*r);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    ColorSpinorParam avParam(*Av_sloppy);
+    avParam.create = QUDA_NULL_FIELD_CREATE;
+
+    std::vector<ColorSpinorField*> w_(1, r), av_(1, Av_sloppy);
+    for(int i = 1; i < tile; i++) {
+      w_.push_back(ColorSpinorField::Create(csParam));
+      av_.push_back(ColorSpinorField::Create(avParam));
+    }
 
-    // Block MGS orthogonalization
-    // The degree to which we interpolate between modified GramSchmidt and GramSchmidt (performance vs stability)
-    const int cdot_pipeline_length  = 4;
+    // a compressed space cannot be passed to the operator directly
+    const bool compressed = param.RV->Precision() != param.eig_global.cuda_prec_ritz;
 
-    for(int i = first_idx; i < (first_idx + nev); i++)
-    {
-      std::unique_ptr<Complex[] > alpha(new Complex[i]);
-
-      ColorSpinorField *accum = param.eig_global.cuda_prec_ritz != QUDA_DOUBLE_PRECISION ? r : &param.RV->Component(i);
-      *accum = param.RV->Component(i);
+    printfQuda("\nConstruct projection matrix..\n");
 
-      int offset = 0;
-      while (offset < i) {
-        
-        const int local_length = (i - offset) > cdot_pipeline_length  ? cdot_pipeline_length : (i - offset);
+    std::unique_ptr<Complex[] > alpha(new Complex[(first_idx+nev)*tile]);
 
-        std::vector<ColorSpinorField*> vj_(param.RV->Components().begin()+offset, param.RV->Components().begin()+offset+local_length);
-        std::vector<ColorSpinorField*> vi_;
-	vi_.push_back(accum);
+    for(int b = 0; b < nev; b += tile) {
+      const int n = std::min(tile, nev - b);
+      const int idx = first_idx + b; // space index of the first vector in this tile
 
-        blas::cDotProduct(alpha.get(), vj_, vi_);
-        for (int j = 0; j < local_length; j++) alpha[j] = -alpha[j];
+      std::vector<ColorSpinorField*> wt_(w_.begin(), w_.begin()+n);
+      for(int i = 0; i < n; i++) blas::copy(*wt_[i], Vm.Component(b+i));
 
-        blas::caxpy(alpha.get(), vj_, vi_); //i-<j,i>j
+      // Blocked classical Gram-Schmidt with reorthogonalization (CGS2):
+      // each pass projects the whole tile against the existing space with
+      // one block inner product and one block update, and the second pass
+      // restores the orthogonality lost to cancellation in the first.
+      std::vector<ColorSpinorField*> v_(param.RV->Components().begin(), param.RV->Components().begin()+idx);
 
-        offset += cdot_pipeline_length;
+      for(int pass = 0; pass < 2 && idx > 0; pass++) {
+        blas::cDotProduct(alpha.get(), v_, wt_);
+        for (int j = 0; j < idx*n; j++) alpha[j] = -alpha[j];
+        blas::caxpy(alpha.get(), v_, wt_); //w-<v,w>v
       }
 
-      alpha[0] = blas::norm2(*accum);
+      // the tile itself is small, so orthonormalize it column by column (again CGS2)
+      for(int i = 0; i < n; i++) {
+        std::vector<ColorSpinorField*> wj_(wt_.begin(), wt_.begin()+i);
+        std::vector<ColorSpinorField*> wi_(wt_.begin()+i, wt_.begin()+i+1);
 
-      if(alpha[0].real() > 1e-16) blas::ax(1.0 /sqrt(alpha[0].real()), *accum);
-      else                        errorQuda("\nCannot orthogonalize %dth vector\n", i);
+        for(int pass = 0; pass < 2 && i > 0; pass++) {
+          blas::cDotProduct(alpha.get(), wj_, wi_);
+          for (int j = 0; j < i; j++) alpha[j] = -alpha[j];
+          blas::caxpy(alpha.get(), wj_, wi_);
+        }
 
-      param.RV->Component(i) = *accum;
+        const double nrm2 = blas::norm2(*wt_[i]);
 
-      param.matDeflation(*Av_sloppy, param.RV->Component(i));//precision must match!
-      //load diagonal:
-      *Av = *Av_sloppy; 
-      param.matProj[i*param.ld+i] = cDotProduct(*accum, *Av);
+        if(nrm2 > 1e-16) blas::ax(1.0 /sqrt(nrm2), *wt_[i]);
+        else             errorQuda("\nCannot orthogonalize %dth vector\n", idx+i);
 
-      if (i>0) {
-        std::vector<ColorSpinorField*> vj_(param.RV->Components().begin(), param.RV->Components().begin()+i);
-        std::vector<ColorSpinorField*> av_;
-	av_.push_back(Av_sloppy);
+        param.RV->Component(idx+i) = *wt_[i];
+      }
 
-	blas::cDotProduct(alpha.get(), vj_, av_);
+      // apply the operator to the vectors as stored, so that the projection matrix matches the space we project onto
+      std::vector<ColorSpinorField*> avt_(av_.begin(), av_.begin()+n);
+      for(int i = 0; i < n; i++) {
+        ColorSpinorField *vi = compressed ? r_sloppy : &param.RV->Component(idx+i);
+        if (compressed) *vi = param.RV->Component(idx+i);
+        param.matDeflation(*avt_[i], *vi);//precision must match!
+      }
+
+      // the new columns of the projection matrix as a single block inner product
+      std::vector<ColorSpinorField*> vj_(param.RV->Components().begin(), param.RV->Components().begin()+idx+n);
+      blas::cDotProduct(alpha.get(), vj_, avt_);
 
+      for(int k = 0; k < n; k++) {
+        const int i = idx + k;
+        param.matProj[i*param.ld+i] = alpha[i*n+k];
         for (int j = 0; j < i; j++) {
-          param.matProj[i*param.ld+j] = alpha[j];
-          param.matProj[j*param.ld+i] = conj(alpha[j]);//conj
+          param.matProj[i*param.ld+j] = alpha[j*n+k];
+          param.matProj[j*param.ld+i] = conj(alpha[j*n+k]);//conj
         }
       }
     }
 
+    for(int i = 1; i < tile; i++) {
+      delete w_[i];
+      delete av_[i];
+    }
+
     param.cur_dim += nev;
 
+    if (param.eig_global.run_verify) verifyIncrement(first_idx, nev);
+
     printfQuda("\nNew curr deflation space dim = %d\n", param.cur_dim);
     return;
   }
 
+  void Deflation::verifyIncrement(int first_idx, int nev) {
+    // the tolerance on the orthonormality follows the storage precision of the space
+    const QudaPrecision prec = param.RV->Precision();
+    const double tol = prec == QUDA_DOUBLE_PRECISION ? 1e-10 : prec == QUDA_SINGLE_PRECISION ? 1e-4 : 1e-2;
+
+    std::vector<ColorSpinorField*> v_(param.RV->Components().begin(), param.RV->Components().begin()+param.cur_dim);
+    std::vector<ColorSpinorField*> w_(param.RV->Components().begin()+first_idx, param.RV->Components().begin()+first_idx+nev);
+
+    std::unique_ptr<Complex[] > gram(new Complex[param.cur_dim*nev]);
+    blas::cDotProduct(gram.get(), v_, w_);
+
+    double orth_dev = 0.0;
+    for (int j = 0; j < param.cur_dim; j++) {
+      for (int k = 0; k < nev; k++) {
+        const Complex delta = gram[j*nev+k] - (j == first_idx+k ? 1.0 : 0.0);
+        orth_dev = std::max(orth_dev, abs(delta));
+      }
+    }
+
+    double herm_dev = 0.0, diag = 0.0;
+    for (int i = 0; i < param.cur_dim; i++) {
+      diag = std::max(diag, abs(param.matProj[i*param.ld+i]));
+      for (int j = 0; j <= i; j++)
+        herm_dev = std::max(herm_dev, abs(param.matProj[i*param.ld+j] - conj(param.matProj[j*param.ld+i])));
+    }
+    if (diag > 0.0) herm_dev /= diag;
+
+    printfQuda("Deflation space increment: orthonormality deviation %e, projection matrix Hermiticity deviation %e\n",
+               orth_dev, herm_dev);
+    if (orth_dev > tol) errorQuda("New deflation vectors are not orthonormal (deviation %e > %e)", orth_dev, tol);
+    if (herm_dev > tol) errorQuda("Projection matrix is not Hermitian (deviation %e > %e)", herm_dev, tol);
+  }
+
 
   void Deflation::reduce(double tol, int max_nev) {
      if(param.cur_dim < max_nev)
@@ -380,10 +455,40 @@ namespace quda {
      return;
   }
 
+  /**
+     Device-resident or half precision deflation spaces cannot be
+     handed to QIO directly, so they are staged through host fields.
+     Half precision vectors are expanded to single precision for I/O
+     so the files stay at the lowest precision QIO supports.
+
+     read_spinor_field and write_spinor_field hand the whole set of
+     vectors to QIO in a single call, so every vector is staged at
+     once: the peak additional host memory is B.size() host vectors at
+     the I/O precision.  This is reported when staging is needed.
+   */
+  static std::vector<ColorSpinorField*> createIOFields(std::vector<ColorSpinorField*> &B) {
+    std::vector<ColorSpinorField*> io;
+    if (B[0]->Location() == QUDA_CPU_FIELD_LOCATION && B[0]->Precision() != QUDA_HALF_PRECISION) return io;
+
+    ColorSpinorParam csParam(*B[0]);
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+    csParam.location = QUDA_CPU_FIELD_LOCATION;
+    csParam.is_composite = false;
+    csParam.is_component = false;
+    csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+    if (csParam.nSpin == 4) csParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+    csParam.setPrecision(B[0]->Precision() == QUDA_HALF_PRECISION ? QUDA_SINGLE_PRECISION : B[0]->Precision());
+
+    for (unsigned int i=0; i<B.size(); i++) io.push_back(ColorSpinorField::Create(csParam));
+    printfQuda("Staging %lu deflation vectors through %.3f GiB of host memory for I/O\n",
+               B.size(), B.size() * (double)io[0]->Bytes() / (1 << 30));
+    return io;
+  }
+
   //supports seperate reading or single file read
   void Deflation::loadVectors(ColorSpinorField *RV) {
 
-    if(RV->IsComposite()) errorQuda("\nNot a composite field.\n");
+    if(!RV->IsComposite()) errorQuda("\nNot a composite field.\n");
 
     profile.TPSTOP(QUDA_PROFILE_INIT);
     profile.TPSTART(QUDA_PROFILE_IO);
@@ -391,25 +496,35 @@ namespace quda {
     std::string vec_infile(param.eig_global.vec_infile);
 
     std::vector<ColorSpinorField*> &B = RV->Components(); 
+    std::vector<ColorSpinorField*> io = createIOFields(B);
+    std::vector<ColorSpinorField*> &V_ = io.size() ? io : B;
 
     const int Nvec = B.size();
     printfQuda("Start loading %d vectors from %s\n", Nvec, vec_infile.c_str());
 
     void **V = new void*[Nvec];
     for (int i=0; i<Nvec; i++) { 
-      V[i] = B[i]->V();
+      V[i] = V_[i]->V();
       if (V[i] == NULL) {
 	printfQuda("Could not allocate V[%d]\n", i);
       }
     }
 
     if (strcmp(vec_infile.c_str(),"")!=0) {
-      read_spinor_field(vec_infile.c_str(), &V[0], B[0]->Precision(), B[0]->X(),
-			B[0]->Ncolor(), B[0]->Nspin(), Nvec, 0,  (char**)0);
+      read_spinor_field(vec_infile.c_str(), &V[0], V_[0]->Precision(), V_[0]->X(),
+			V_[0]->Ncolor(), V_[0]->Nspin(), Nvec, 0,  (char**)0);
     } else {
       errorQuda("No eigenspace file defined.");
     }
 
+    // compress the staged vectors into the deflation space
+    for (unsigned int i=0; i<io.size(); i++) {
+      *B[i] = *io[i];
+      delete io[i];
+    }
+
+    delete []V;
+
     printfQuda("Done loading vectors\n");
     profile.TPSTOP(QUDA_PROFILE_IO);
     profile.TPSTART(QUDA_PROFILE_INIT);
@@ -418,7 +533,7 @@ namespace quda {
   }
 
   void Deflation::saveVectors(ColorSpinorField *RV) {
-    if(RV->IsComposite()) errorQuda("\nNot a composite field.\n");
+    if(!RV->IsComposite()) errorQuda("\nNot a composite field.\n");
 
     profile.TPSTOP(QUDA_PROFILE_INIT);
     profile.TPSTART(QUDA_PROFILE_IO);
@@ -432,18 +547,23 @@ namespace quda {
       const int Nvec = B.size();
       printfQuda("Start saving %d vectors to %s\n", Nvec, vec_outfile.c_str());
 
+      std::vector<ColorSpinorField*> io = createIOFields(B);
+      for (unsigned int i=0; i<io.size(); i++) *io[i] = *B[i];
+      std::vector<ColorSpinorField*> &V_ = io.size() ? io : B;
+
       void **V = static_cast<void**>(safe_malloc(Nvec*sizeof(void*)));
       for (int i=0; i<Nvec; i++) {
-	V[i] = B[i]->V();
+	V[i] = V_[i]->V();
 	if (V[i] == NULL) {
 	  printfQuda("Could not allocate V[%d]\n", i);
 	}
       }
 
-      write_spinor_field(vec_outfile.c_str(), &V[0], B[0]->Precision(), B[0]->X(),
-			 B[0]->Ncolor(), B[0]->Nspin(), Nvec, 0,  (char**)0);
+      write_spinor_field(vec_outfile.c_str(), &V[0], V_[0]->Precision(), V_[0]->X(),
+			 V_[0]->Ncolor(), V_[0]->Nspin(), Nvec, 0,  (char**)0);
 
       host_free(V);
+      for (unsigned int i=0; i<io.size(); i++) delete io[i];
       printfQuda("Done saving vectors\n");
     }
 
@@ -12,27 +12,203 @@
 #include <lanczos_quda.h>
 
 #include <iostream>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include <Eigen/Dense>
 
 namespace quda {
 
+  static double epsilon(QudaPrecision precision)
+  {
+    switch (precision) {
+    case QUDA_DOUBLE_PRECISION: return std::numeric_limits<double>::epsilon();
+    case QUDA_SINGLE_PRECISION: return std::numeric_limits<float>::epsilon();
+    default: return pow(2.0, -15);
+    }
+  }
+
+  /**
+     Estimates of the orthogonality of the Lanczos vectors, using the
+     omega recurrence of Simon (Math. Comp. 42, 1984).  The residual
+     is only reorthogonalized against the basis when its estimated
+     overlap with any of the basis vectors exceeds sqrt(eps), and
+     then again on the following step, rather than on every step.
+
+     The basis may start with the kept Ritz vectors y_i, i < first,
+     of a thick restart, for which A y_i = theta_i y_i + s_i v_first.
+   */
+  class OrthoMonitor {
+
+    const double eps;
+    const double tol;
+    std::vector<double> prev; // estimates of (v_{j-1}, v_i)
+    std::vector<double> curr; // estimates of (v_j, v_i)
+    std::vector<double> next; // estimates of (v_{j+1}, v_i)
+    int pending; // number of steps that still require reorthogonalization
+
+  public:
+    OrthoMonitor(int m, double eps)
+      : eps(eps), tol(sqrt(eps)), prev(m+1, 0.0), curr(m+1, 0.0), next(m+1, 0.0), pending(0) { }
+
+    /**
+       Restart the estimates at v_j, which is assumed orthogonal to
+       working precision to all previous vectors.  If j > 0, the
+       first step is always reorthogonalized.
+    */
+    void reset(int j) {
+      std::fill(prev.begin(), prev.end(), eps);
+      std::fill(curr.begin(), curr.end(), eps);
+      curr[j] = 1.0;
+      pending = j > 0 ? 1 : 0;
+    }
+
+    /**
+       Compute the estimates for v_{j+1} from the coefficients of step j
+       @param alpha Diagonal of the projected matrix
+       @param beta Off-diagonal of the projected matrix, beta[j] being the current residual norm
+       @param s Coupling of the kept Ritz vectors to v_first
+       @param first Index of the first Lanczos vector following the kept Ritz vectors
+       @param j The current step
+       @return Whether the residual of step j must be reorthogonalized
+    */
+    bool update(const double *alpha, const double *beta, const double *s, int first, int j) {
+      double max = 0.0;
+      for (int i=0; i<j; i++) {
+	double w = (alpha[i] - alpha[j]) * curr[i];
+	if (i < first) {
+	  w += s[i] * curr[first];
+	} else {
+	  w += beta[i] * curr[i+1];
+	  if (i == first) for (int l=0; l<first; l++) w += s[l] * curr[l];
+	  else w += beta[i-1] * curr[i-1];
+	}
+	if (j > first) w -= beta[j-1] * prev[i];
+	w += copysign(eps * (beta[j] + (i < first ? fabs(s[i]) : beta[i])), w);
+	next[i] = w / beta[j];
+	max = std::max(max, fabs(next[i]));
+      }
+      next[j] = eps;
+
+      if (pending == 0 && max > tol) pending = 2;
+      bool reorth = pending > 0;
+      if (reorth) pending--;
+      return reorth;
+    }
+
+    /**
+       Advance to the next step
+       @param j The current step
+       @param reorth Whether the residual of step j was reorthogonalized
+    */
+    void advance(int j, bool reorth) {
+      if (reorth) std::fill(next.begin(), next.begin()+j+1, eps);
+      next[j+1] = 1.0;
+      prev.swap(curr);
+      curr.swap(next);
+    }
+  };
+
+  template <typename Float>
+  static void rotateBasisCPU(ColorSpinorField **v, int m, const double *Q, int k)
+  {
+    const size_t length = v[0]->Length();
+    std::vector<Float*> v_(m);
+    for (int i=0; i<m; i++) v_[i] = static_cast<Float*>(v[i]->V());
+
+    constexpr size_t block = 256;
+    const size_t nBlock = (length + block - 1) / block;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      std::vector<double> y(k*block);
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+      for (size_t b=0; b<nBlock; b++) {
+	const size_t begin = b * block;
+	const size_t n = std::min(block, length - begin);
+	std::fill(y.begin(), y.end(), 0.0);
+	for (int i=0; i<m; i++) {
+	  const Float *x = v_[i] + begin;
+	  for (int j=0; j<k; j++) {
+	    const double q = Q[j*m + i];
+	    for (size_t e=0; e<n; e++) y[j*block + e] += q * x[e];
+	  }
+	}
+	for (int j=0; j<k; j++) {
+	  Float *x = v_[j] + begin;
+	  for (size_t e=0; e<n; e++) x[e] = y[j*block + e];
+	}
+      }
+    }
+  }
+
+  /**
+     Rotate the basis in place, v[j] = sum_i v[i] Q(i,j) for j < k,
+     where Q is the real column-major m x k matrix of Ritz vectors of
+     the projected matrix.  Since Q is real, on the host the rotation
+     acts identically on every real degree of freedom of the fields,
+     so we thread over blocks of field elements.  On the device the
+     rotated vectors are accumulated in the work block, which is
+     grown to k fields on first use and reused on every subsequent
+     restart, and the caller is responsible for freeing it.
+  */
+  static void rotateBasis(ColorSpinorField **v, int m, const double *Q, int k, std::vector<ColorSpinorField*> &work)
+  {
+    if (v[0]->Location() == QUDA_CPU_FIELD_LOCATION) {
+      for (int i=1; i<m; i++) {
+	if (v[i]->Location() != QUDA_CPU_FIELD_LOCATION || v[i]->Precision() != v[0]->Precision() ||
+	    v[i]->Length() != v[0]->Length())
+	  errorQuda("Basis vectors do not match");
+      }
+
+      switch (v[0]->Precision()) {
+      case QUDA_DOUBLE_PRECISION: rotateBasisCPU<double>(v, m, Q, k); break;
+      case QUDA_SINGLE_PRECISION: rotateBasisCPU<float>(v, m, Q, k); break;
+      default: errorQuda("Unsupported precision %d", v[0]->Precision());
+      }
+    } else {
+      if (work.size() < static_cast<size_t>(k)) {
+	ColorSpinorParam param(*v[0]);
+	param.create = QUDA_NULL_FIELD_CREATE;
+	while (work.size() < static_cast<size_t>(k)) work.push_back(ColorSpinorField::Create(param));
+      }
+
+      std::vector<ColorSpinorField*> x(v, v+m);
+      std::vector<ColorSpinorField*> y(work.begin(), work.begin()+k);
+      for (int j=0; j<k; j++) blas::zero(*y[j]);
+
+      std::vector<Complex> a(m*k);
+      for (int i=0; i<m; i++)
+	for (int j=0; j<k; j++) a[i*k + j] = Q[j*m + i];
+      blas::caxpy(a.data(), x, y);
+
+      for (int j=0; j<k; j++) blas::copy(*v[j], *y[j]);
+    }
+  }
+
   Lanczos::Lanczos(RitzMat &ritz_mat, QudaEigParam &eigParam, TimeProfile &profile) :
     Eig_Solver(eigParam, profile), ritz_mat(ritz_mat)
   {
 
   }
 
-  Lanczos::~Lanczos() 
+  Lanczos::~Lanczos()
   {
 
   }
 
-  void Lanczos::operator()(double *alpha, double *beta, cudaColorSpinorField **Eig_Vec, cudaColorSpinorField &r, cudaColorSpinorField &Apsi, int k0, int m) 
+  void Lanczos::operator()(double *alpha, double *beta, ColorSpinorField **Eig_Vec, ColorSpinorField &r, ColorSpinorField &Apsi, int k0, int m)
   {
     using namespace blas;
 
     profile.TPSTART(QUDA_PROFILE_COMPUTE);
 
-    // Check to see that we'reV not trying to invert on a zero-field source    
+    // Check to see that we'reV not trying to invert on a zero-field source
     const double b2 = norm2(r);
     if(b2 == 0){
       profile.TPSTOP(QUDA_PROFILE_COMPUTE);
@@ -44,54 +220,42 @@ namespace quda {
     ff = sqrt(norm2(r));
     zero(*(Eig_Vec[k0]));
     axpy(1.0/ff, r, *(Eig_Vec[k0]));
-  
-    for (int k = k0; k < m; ++k)
-    {
-      if( k == 0 )
-      {
-        // r_k = A*v_k , r_k is used for temporary buffer.
-        ritz_mat(r, *(Eig_Vec[0]));
-        // alpha_k = ( v_k , r_k )
-        alpha[0] = reDotProduct(*(Eig_Vec[0]), r);
-        // r_k = (A - alpha_k)v_k - beta_{k-1}*v_{k-1} = r_k - alpha_k*v_k
-        // k = 1 case, beta_0 is defined to 0, so we don`t need beta related term.
-        axpy(-alpha[0],*(Eig_Vec[0]), r);
-        // beta_k = ||r_k||
-        beta[0] = sqrt(norm2(r));
 
+    // when continuing a previous run we have no estimates, so reorthogonalize on the first step
+    OrthoMonitor monitor(m, epsilon(r.Precision()));
+    monitor.reset(k0);
 
-        zero(*(Eig_Vec[1]));
-        axpy(1.0/beta[0], r, *(Eig_Vec[1]));
+    for (int k = k0; k < m; ++k)
+    {
+      // r_k = A*v_k , r_k is used for temporary buffer.
+      ritz_mat(r, *(Eig_Vec[k]));
+      // r_k = (A - alpha_k)v_k - beta_{k-1}*v_{k-1} = r_k - alpha_k*v_k
+      // 1st: r_k = r_k - beta_{k-1}*v_{k-1}, beta_{-1} is defined to 0
+      // 2nd: alpha = (v_k, A*v_k) = (v_k , r_k)
+      // 3rd: r_k = r_k - alpha_k*v_k
+      if (k > 0) axpy(-beta[k-1],*(Eig_Vec[k-1]), r);
+      alpha[k] = reDotProduct(*(Eig_Vec[k]), r);
+      axpy(-alpha[k],*(Eig_Vec[k]), r);
+      // beta_k = ||r_k||
+      beta[k] = sqrt(norm2(r));
 
-      }
-      else
-      {
-        // r_k = A*v_k , r_k is used for temporary buffer.
-        ritz_mat(r, *(Eig_Vec[k]));
-        // r_k = (A - alpha_k)v_k - beta_{k-1}*v_{k-1} = r_k - alpha_k*v_k
-        // 1st: r_k = r_k - beta_{k-1}*v_{k-1}
-        // 2nd: alpha = (v_k, A*v_k) = (v_k , r_k)
-        // 3rd: r_k = r_k - alpha_k*v_k
-        axpy(-beta[k-1],*(Eig_Vec[k-1]), r);
-        alpha[k] = reDotProduct(*(Eig_Vec[k]), r);
-        axpy(-alpha[k],*(Eig_Vec[k]), r);
-        // beta_k = ||r_k||
+      const bool reorth = monitor.update(alpha, beta, nullptr, 0, k);
+      if (reorth) {
+        GrandSchm_test(r, Eig_Vec, k+1, 0);
         beta[k] = sqrt(norm2(r));
+      }
+      monitor.advance(k, reorth);
 
-        GrandSchm_test(r, Eig_Vec, k+1, 0);
-      
-        if(k+1 < m)
-        {
-          zero(*(Eig_Vec[k+1]));
-          axpy(1.0/beta[k], r, *(Eig_Vec[k+1]));
-        }
+      if(k+1 < m)
+      {
+        zero(*(Eig_Vec[k+1]));
+        axpy(1.0/beta[k], r, *(Eig_Vec[k+1]));
       }
     }
     profile.TPSTOP(QUDA_PROFILE_COMPUTE);
     return;
   }
-  
-#if 0
+
   ImpRstLanczos::ImpRstLanczos(RitzMat &ritz_mat, QudaEigParam &eigParam, TimeProfile &profile) :
     Eig_Solver(eigParam, profile), ritz_mat(ritz_mat)
   { }
@@ -99,9 +263,125 @@ namespace quda {
   ImpRstLanczos::~ImpRstLanczos()
   { }
 
-  void ImpRstLanczos::operator()(double *alpha, double *beta, cudaColorSpinorField **Eig_Vec,
-				 cudaColorSpinorField &r, cudaColorSpinorField &Apsi, int k0, int m)
-  { }
-#endif
+  void ImpRstLanczos::operator()(double *alpha, double *beta, ColorSpinorField **Eig_Vec,
+				 ColorSpinorField &r, ColorSpinorField &Apsi, int k0, int m)
+  {
+    using namespace blas;
+
+    const int nk = eigParam.nk;
+    if (nk <= 0 || nk >= m) errorQuda("Invalid number of wanted eigenpairs nk=%d for basis size %d", nk, m);
+    if (k0 != 0) errorQuda("Thick-restart Lanczos must start from k0 = 0 (k0 = %d)", k0);
+    const int max_restart = eigParam.max_restarts;
+
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+
+    const double b2 = norm2(r);
+    if(b2 == 0){
+      profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+      printfQuda("Warning: initial residual is already zero\n");
+      return;
+    }
+
+    zero(*(Eig_Vec[0]));
+    axpy(1.0/sqrt(b2), r, *(Eig_Vec[0]));
+
+    std::vector<double> s(m, 0.0); // coupling of the kept Ritz vectors to v_k
+    int k = 0; // number of kept Ritz vectors
+
+    OrthoMonitor monitor(m, epsilon(r.Precision()));
+    monitor.reset(0);
+
+    std::vector<ColorSpinorField*> work; // rotation work block, device bases only
+
+    for (int restart = 0; ; restart++) {
+
+      for (int j = k; j < m; j++) {
+	ritz_mat(Apsi, *(Eig_Vec[j]));
+	if (j == k && k > 0) {
+	  for (int i=0; i<k; i++) axpy(-s[i], *(Eig_Vec[i]), Apsi);
+	} else if (j > 0) {
+	  axpy(-beta[j-1], *(Eig_Vec[j-1]), Apsi);
+	}
+	alpha[j] = reDotProduct(*(Eig_Vec[j]), Apsi);
+	axpy(-alpha[j], *(Eig_Vec[j]), Apsi);
+	beta[j] = sqrt(norm2(Apsi));
+
+	const bool reorth = monitor.update(alpha, beta, s.data(), k, j);
+	if (reorth) {
+	  GrandSchm_test(Apsi, Eig_Vec, j+1, 0);
+	  beta[j] = sqrt(norm2(Apsi));
+	}
+	monitor.advance(j, reorth);
+
+	if (j+1 < m) {
+	  zero(*(Eig_Vec[j+1]));
+	  axpy(1.0/beta[j], Apsi, *(Eig_Vec[j+1]));
+	}
+      }
+
+      // Rayleigh-Ritz on the projected matrix, which is arrowhead in
+      // the kept block and tridiagonal thereafter
+      Eigen::MatrixXd T = Eigen::MatrixXd::Zero(m, m);
+      for (int i=0; i<k; i++) {
+	T(i,i) = alpha[i];
+	T(i,k) = T(k,i) = s[i];
+      }
+      for (int i=k; i<m; i++) {
+	T(i,i) = alpha[i];
+	if (i+1 < m) T(i,i+1) = T(i+1,i) = beta[i];
+      }
+      Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> es(T);
+      const Eigen::VectorXd &theta = es.eigenvalues();    // ascending order
+      const Eigen::MatrixXd &Y = es.eigenvectors();
+
+      const double anorm = std::max(fabs(theta(0)), fabs(theta(m-1)));
+      int nconv = 0;
+      for (int l=0; l<m; l++) {
+	const double res = fabs(beta[m-1] * Y(m-1, m-1-l));
+	if (res >= eigParam.Stp_residual * anorm) break;
+	nconv++;
+      }
+
+      if (getVerbosity() >= QUDA_VERBOSE)
+	printfQuda("Thick-restart Lanczos: restart %d, %d of %d wanted Ritz pairs converged\n",
+		   restart, std::min(nconv, nk), nk);
+
+      const bool done = nconv >= nk || restart == max_restart;
+      if (done && nconv < nk) warningQuda("Thick-restart Lanczos did not converge after %d restarts", restart);
+
+      // keep the wanted Ritz vectors, plus some of any further converged ones
+      const int kept = done ? nk : nk + std::min(std::max(nconv - nk, 0), (m - nk) / 2);
+
+      // Ritz vectors in descending order of Ritz value
+      Eigen::MatrixXd Q(m, kept);
+      for (int l=0; l<kept; l++) Q.col(l) = Y.col(m-1-l);
+      rotateBasis(Eig_Vec, m, Q.data(), kept, work);
+
+      if (done) {
+	const double beta_m = beta[m-1];
+	for (int l=0; l<nk; l++) {
+	  alpha[l] = theta(m-1-l);
+	  beta[l] = fabs(beta_m * Y(m-1, m-1-l));
+	}
+	break;
+      }
+
+      for (int l=0; l<kept; l++) {
+	alpha[l] = theta(m-1-l);
+	s[l] = beta[m-1] * Y(m-1, m-1-l);
+      }
+      k = kept;
+
+      // continue the recurrence from the residual
+      zero(*(Eig_Vec[k]));
+      axpy(1.0/beta[m-1], Apsi, *(Eig_Vec[k]));
+      monitor.reset(k);
+    }
+
+    for (auto w : work) delete w;
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+    return;
+  }
 
 } // namespace quda
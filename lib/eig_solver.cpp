@@ -18,12 +18,10 @@ namespace quda {
       report("Lanczos solver");
       eig_solver = new Lanczos(ritz_mat, param, profile);
       break;
-#if 0
     case QUDA_IMP_RST_LANCZOS:
-      report("Implicitly restarted Lanczos");
+      report("Thick-restart Lanczos");
       eig_solver = new ImpRstLanczos(ritz_mat, param, profile);
       break;
-#endif
     default:
       errorQuda("Invalid eig solver type");
     }
@@ -44,7 +42,7 @@ namespace quda {
   void Eig_Solver::PrintSummary(const char *name, int k, const double &r2, const double &b2) {
   }
   
-  void Eig_Solver::GrandSchm_test(cudaColorSpinorField &psi, cudaColorSpinorField **Eig_Vec, int Nvec, double *delta) {
+  void Eig_Solver::GrandSchm_test(ColorSpinorField &psi, ColorSpinorField **Eig_Vec, int Nvec, double *delta) {
     Complex xp(0.0,0.0);
     for(int i = 0; i<Nvec; ++i)
     {
@@ -89,40 +89,41 @@ namespace quda {
   }
   
   /**
-     Generic CPU gauge ghost extraction and packing
+     Generic CPU gauge ghost extraction and packing.  The source and
+     destination indices are computed in closed form by the
+     extractor/injector, so the face slices (d, a) of both parities
+     and directions are processed in parallel, with each row of the
+     face visiting only the sites of the requested parity.
      NB This routines is specialized to four dimensions
   */
   template <typename Float, int length, int nDim, int dim, typename Order, bool extract>
   void extractGhostEx(ExtractGhostExArg<Order,nDim,dim> arg) {  
-    typedef typename mapper<Float>::type RegType;
+    const int dA = arg.A1[dim]-arg.A0[dim];
+    const int nSlice = arg.R[dim]*dA;
 
+    // dir = 0 backwards, dir = 1 forwards
+#ifdef _OPENMP
+#pragma omp parallel for collapse(3) schedule(static)
+#endif
     for (int parity=0; parity<2; parity++) {
-
-      // the following 4-way loop means this is specialized for 4 dimensions 
-      // dir = 0 backwards, dir = 1 forwards
-      for (int dir = 0; dir<2; dir++) {
-
-	int D0 = extract ? dir*arg.X[dim] + (1-dir)*arg.R[dim] : dir*(arg.X[dim] + arg.R[dim]); 
-	  
-	for (int d=D0; d<D0+arg.R[dim]; d++) {
-	  for (int a=arg.A0[dim]; a<arg.A1[dim]; a++) { // loop over the interior surface
-	    for (int b=arg.B0[dim]; b<arg.B1[dim]; b++) { // loop over the interior surface
-	      for (int c=arg.C0[dim]; c<arg.C1[dim]; c++) { // loop over the interior surface
-		for (int g=0; g<arg.order.geometry; g++) {
-
-		  // we only do the extraction for parity we are currently working on
-		  int oddness = (a+b+c+d) & 1;
-		  if (oddness == parity) {
-		    if (extract) extractor<Float,length,dim>(arg, dir, a, b, c, d, g, parity);
-		    else injector<Float,length,dim>(arg, dir, a, b, c, d, g, parity);
-		  } // oddness == parity
-		} // g
-	      } // c
-	    } // b
-	  } // a
-	} // d
+      for (int dir=0; dir<2; dir++) {
+	for (int slice=0; slice<nSlice; slice++) {
+	  int D0 = extract ? dir*arg.X[dim] + (1-dir)*arg.R[dim] : dir*(arg.X[dim] + arg.R[dim]);
+	  int d = D0 + slice / dA;
+	  int a = arg.A0[dim] + slice % dA;
+
+	  for (int b=arg.B0[dim]; b<arg.B1[dim]; b++) { // loop over the interior surface
+	    // we only do the extraction for parity we are currently working on
+	    int c0 = arg.C0[dim] + ((parity+a+b+d+arg.C0[dim]) & 1);
+	    for (int c=c0; c<arg.C1[dim]; c+=2) { // loop over the interior surface
+	      for (int g=0; g<arg.order.geometry; g++) {
+		if (extract) extractor<Float,length,dim>(arg, dir, a, b, c, d, g, parity);
+		else injector<Float,length,dim>(arg, dir, a, b, c, d, g, parity);
+	      } // g
+	    } // c
+	  } // b
+	} // slice
       } // dir
-      
     } // parity
 
   }
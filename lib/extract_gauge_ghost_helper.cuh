@@ -32,12 +32,45 @@ namespace quda {
   };
 
   /**
-     Generic CPU gauge ghost extraction and packing
-     NB This routines is specialized to four dimensions
+     Move a single link between the bulk and the ghost buffer
   */
   template <typename Float, int length, int nDim, typename Order, bool extract>
-  void extractGhost(ExtractGhostArg<Order,nDim> arg) {  
+  __device__ __host__ inline void moveGhost(ExtractGhostArg<Order,nDim> &arg, int dim, int parity, int indexCB, int indexGhost) {
     typedef typename mapper<Float>::type RegType;
+#ifdef FINE_GRAINED_ACCESS
+    for (int i=0; i<gauge::Ncolor(length); i++) {
+      for (int j=0; j<gauge::Ncolor(length); j++) {
+	if (extract) {
+	  arg.order.Ghost(dim, (parity+arg.localParity[dim])&1, indexGhost, i, j)
+	    = arg.order(dim+arg.offset, parity, indexCB, i, j);
+	} else { // injection
+	  arg.order(dim+arg.offset, parity, indexCB, i, j)
+	    = arg.order.Ghost(dim, (parity+arg.localParity[dim])&1, indexGhost, i, j);
+	}
+      }
+    }
+#else
+    if (extract) {
+      RegType u[length];
+      arg.order.load(u, indexCB, dim+arg.offset, parity); // load the ghost element from the bulk
+      arg.order.saveGhost(u, indexGhost, dim, (parity+arg.localParity[dim])&1);
+    } else { // injection
+      RegType u[length];
+      arg.order.loadGhost(u, indexGhost, dim, (parity+arg.localParity[dim])&1);
+      arg.order.save(u, indexCB, dim+arg.offset, parity); // save the ghost element to the bulk
+    }
+#endif
+  }
+
+  /**
+     Sequential CPU gauge ghost extraction and packing, where the
+     ghost index is a running counter.  This is only needed when the
+     innermost face dimension is odd, since then the number of sites
+     of a given parity differs between rows of the face.
+     NB This routines is specialized to four dimensions
+  */
+  template <typename Float, int length, int nDim, typename Order, bool extract>
+  void extractGhostSequential(ExtractGhostArg<Order,nDim> &arg) {
 
     for (int parity=0; parity<2; parity++) {
 
@@ -50,7 +83,6 @@ namespace quda {
 	int indexGhost = 0;
 	// the following 4-way loop means this is specialized for 4 dimensions 
 
-	// FIXME redefine a, b, c, d such that we always optimize for locality
 	for (int d=arg.X[dim]-arg.nFace; d<arg.X[dim]; d++) { // loop over last nFace faces in this dimension
 	  for (int a=0; a<arg.A[dim]; a++) { // loop over the surface elements of this face
 	    for (int b=0; b<arg.B[dim]; b++) { // loop over the surface elements of this face
@@ -60,29 +92,7 @@ namespace quda {
 		// we only do the extraction for parity we are currently working on
 		int oddness = (a+b+c+d) & 1;
 		if (oddness == parity) {
-#ifdef FINE_GRAINED_ACCESS
-		  for (int i=0; i<gauge::Ncolor(length); i++) {
-		    for (int j=0; j<gauge::Ncolor(length); j++) {
-		      if (extract) {
-			arg.order.Ghost(dim, (parity+arg.localParity[dim])&1, indexGhost, i, j)
-			  = arg.order(dim+arg.offset, parity, indexCB, i, j);
-		      } else { // injection
-			arg.order(dim+arg.offset, parity, indexCB, i, j)
-			  = arg.order.Ghost(dim, (parity+arg.localParity[dim])&1, indexGhost, i, j);
-		      }
-		    }
-		  }
-#else
-		  if (extract) {
-		    RegType u[length];
-		    arg.order.load(u, indexCB, dim+arg.offset, parity); // load the ghost element from the bulk
-		    arg.order.saveGhost(u, indexGhost, dim, (parity+arg.localParity[dim])&1);
-		  } else { // injection
-		    RegType u[length];
-		    arg.order.loadGhost(u, indexGhost, dim, (parity+arg.localParity[dim])&1);
-		    arg.order.save(u, indexCB, dim+arg.offset, parity); // save the ghost element to the bulk
-		  }
-#endif
+		  moveGhost<Float,length,nDim,Order,extract>(arg, dim, parity, indexCB, indexGhost);
 		  indexGhost++;
 		} // oddness == parity
 	      } // c
@@ -97,6 +107,65 @@ namespace quda {
 
   }
 
+  /**
+     Generic CPU gauge ghost extraction and packing.  With an even
+     innermost face dimension every row of the face holds C/2 sites of
+     each parity, so the ghost index has the closed form
+     (((d*A + a)*B + b)*C + c) >> 1, matching the GPU kernel.  This
+     lets the face slices (d, a) of every parity and dimension be
+     processed in parallel, with each row visiting only the sites of
+     the requested parity.
+     NB This routines is specialized to four dimensions
+  */
+  template <typename Float, int length, int nDim, typename Order, bool extract>
+  void extractGhost(ExtractGhostArg<Order,nDim> arg) {
+
+    for (int dim=0; dim<nDim; dim++) {
+      if ((arg.commDim[dim] || extract) && (arg.C[dim] & 1)) {
+	extractGhostSequential<Float,length,nDim,Order,extract>(arg);
+	return;
+      }
+    }
+
+    // flatten the (parity, dim) faces into a single slice index space
+    int nSegment = 0;
+    int segment[2*nDim][2];
+    int begin[2*nDim+1] = { };
+    for (int parity=0; parity<2; parity++) {
+      for (int dim=0; dim<nDim; dim++) {
+	// for now we never inject unless we have partitioned in that dimension
+	if (!arg.commDim[dim] && !extract) continue;
+	segment[nSegment][0] = parity;
+	segment[nSegment][1] = dim;
+	begin[nSegment+1] = begin[nSegment] + arg.nFace*arg.A[dim];
+	nSegment++;
+      }
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i=0; i<begin[nSegment]; i++) {
+      int k = 0;
+      while (i >= begin[k+1]) k++;
+      const int parity = segment[k][0];
+      const int dim = segment[k][1];
+      const int slice = i - begin[k]; // slice = (d - (X - nFace))*A + a
+      const int d = arg.X[dim] - arg.nFace + slice / arg.A[dim];
+      const int a = slice % arg.A[dim];
+
+      for (int b=0; b<arg.B[dim]; b++) {
+	const int row = slice*arg.B[dim] + b;
+	for (int c=(parity+a+b+d)&1; c<arg.C[dim]; c+=2) {
+	  int indexCB = (a*arg.f[dim][0] + b*arg.f[dim][1] + c*arg.f[dim][2] + d*arg.f[dim][3]) >> 1;
+	  int indexGhost = (row*arg.C[dim] + c) >> 1;
+	  moveGhost<Float,length,nDim,Order,extract>(arg, dim, parity, indexCB, indexGhost);
+	}
+      }
+    }
+
+  }
+
   /**
      Generic GPU gauge ghost extraction and packing
      NB This routines is specialized to four dimensions
@@ -33,6 +33,22 @@ namespace quda {
     DslashCD(out, in, QUDA_INVALID_PARITY, mu);
   }
 
+  void GaugeCovDev::MCD(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, const int mu) const
+  {
+    for (unsigned int i=0; i<in.size(); i++) {
+      checkFullSpinor(*out[i], *in[i]);
+      checkSpinorAlias(*in[i], *out[i]);
+    }
+
+    ApplyCovDev(out, in, *gauge, QUDA_INVALID_PARITY, mu);
+
+    // one link-vector product per spin per site
+    for (unsigned int i=0; i<in.size(); i++) {
+      const long long Nc = in[i]->Ncolor();
+      flops += (8*Nc*Nc - 2*Nc)*in[i]->Nspin()*in[i]->Volume();
+    }
+  }
+
   void GaugeCovDev::MdagMCD(ColorSpinorField &out, const ColorSpinorField &in, const int mu) const
   {
     bool reset = newTmp(&tmp1, in);
@@ -13,6 +13,7 @@
 
 #ifdef GPU_GAUGE_ALG
 #include <CUFFT_Plans.h>
+#include <host_fft.h>
 #endif
 
 namespace quda {
@@ -1187,12 +1188,271 @@ namespace quda {
     }
   }
 
+
+  /**
+   * @brief Measure the gauge fixing quality on the host and store
+   * Delta(x) for the next steepest descent step.  Delta(x) is written
+   * in lexicographic order with stride volume between the six
+   * independent components, as in computeFix_quality.  The partial
+   * sums of each time slice are combined in a fixed order so the
+   * result does not depend on the number of threads.
+   */
+  template<typename Float, typename Gauge, int gauge_dir>
+  void gaugeFixQualityCPU(Gauge &dataOr, const int X[4], complex<Float> *delta_out, double result[2]){
+    typedef complex<Float> Cmplx;
+    const int volume = X[0] * X[1] * X[2] * X[3];
+    std::vector<double> action(2 * X[3]), theta(2 * X[3]);
+
+#pragma omp parallel for collapse(2) schedule(static)
+    for ( int parity = 0; parity < 2; parity++ ) {
+      for ( int t = 0; t < X[3]; t++ ) {
+        double action_t = 0.0, theta_t = 0.0;
+        int x[4];
+        x[3] = t;
+        for ( x[2] = 0; x[2] < X[2]; x[2]++ ) {
+          for ( x[1] = 0; x[1] < X[1]; x[1]++ ) {
+            for ( x[0] = (parity + x[1] + x[2] + x[3]) & 1; x[0] < X[0]; x[0] += 2 ) {
+              const int idx = linkIndex(x, X);
+              Matrix<Cmplx,3> delta;
+              setZero(&delta);
+              for ( int mu = 0; mu < gauge_dir; mu++ ) {
+                Matrix<Cmplx,3> U;
+                dataOr.load((Float*)(U.data), idx, mu, parity);
+                delta -= U;
+              }
+              action_t += -delta(0,0).x - delta(1,1).x - delta(2,2).x;
+              for ( int mu = 0; mu < gauge_dir; mu++ ) {
+                Matrix<Cmplx,3> U;
+                dataOr.load((Float*)(U.data), linkIndexM1(x, X, mu), mu, 1 - parity);
+                delta += U;
+              }
+              delta -= conj(delta);
+              SubTraceUnit(delta);
+              const int id = ((x[3] * X[2] + x[2]) * X[1] + x[1]) * X[0] + x[0];
+              delta_out[id] = delta(0,0);
+              delta_out[id + 1 * volume] = delta(0,1);
+              delta_out[id + 2 * volume] = delta(0,2);
+              delta_out[id + 3 * volume] = delta(1,1);
+              delta_out[id + 4 * volume] = delta(1,2);
+              delta_out[id + 5 * volume] = delta(2,2);
+              theta_t += getRealTraceUVdagger(delta, delta);
+            }
+          }
+        }
+        action[parity * X[3] + t] = action_t;
+        theta[parity * X[3] + t] = theta_t;
+      }
+    }
+
+    result[0] = 0.0;
+    result[1] = 0.0;
+    for ( int i = 0; i < 2 * X[3]; i++ ) {
+      result[0] += action[i];
+      result[1] += theta[i];
+    }
+    result[0] /= (double)(3 * gauge_dir * volume);
+    result[1] /= (double)(3 * volume);
+  }
+
+
+  /**
+   * @brief Host gauge fixing with the Fourier accelerated steepest
+   * descent method.  Each component of Delta(x) is transformed with
+   * the host FFT, multiplied by the same p_max^2/p^2 factor as the
+   * device path, and transformed back.  g(x) is then computed once
+   * per site before the links are rotated.
+   */
+  template<typename Float, typename Gauge, int gauge_dir>
+  void gaugefixingFFTCPU( Gauge dataOr,  cpuGaugeField& data,
+                          const int Nsteps, const int verbose_interval,
+                          const Float alpha0, const int autotune, const double tolerance,
+                          const int stopWtheta) {
+    typedef complex<Float> Cmplx;
+
+    TimeProfile profileInternalGaugeFixFFT("InternalGaugeFixQudaFFT", false);
+
+    profileInternalGaugeFixFFT.TPSTART(QUDA_PROFILE_COMPUTE);
+
+    Float alpha = alpha0;
+    std::cout << "\tAlpha parameter of the Steepest Descent Method: " << alpha << std::endl;
+    if ( autotune ) std::cout << "\tAuto tune active: yes" << std::endl;
+    else std::cout << "\tAuto tune active: no" << std::endl;
+    std::cout << "\tStop criterium: " << tolerance << std::endl;
+    if ( stopWtheta ) std::cout << "\tStop criterium method: theta" << std::endl;
+    else std::cout << "\tStop criterium method: Delta" << std::endl;
+    std::cout << "\tMaximum number of iterations: " << Nsteps << std::endl;
+    std::cout << "\tPrint convergence results at every " << verbose_interval << " steps" << std::endl;
+
+    const int *X = data.X();
+    const int volume = X[0] * X[1] * X[2] * X[3];
+    std::vector<Cmplx> delta(6 * (size_t)volume);
+    std::vector<Float> invpsq(volume);
+    std::vector<Matrix<Cmplx,3> > gx(volume);
+    HostFFT4D<Float> fft(X);
+
+    //The FFT normalization is done here
+#pragma omp parallel for schedule(static)
+    for ( int id = 0; id < volume; id++ ) {
+      int x[4];
+      x[0] = id % X[0];
+      x[1] = (id / X[0]) % X[1];
+      x[2] = (id / (X[0] * X[1])) % X[2];
+      x[3] = id / (X[0] * X[1] * X[2]);
+      Float sinsq = 0.0;
+      for ( int dr = 0; dr < 4; dr++ ) {
+        Float s = sin( (Float)x[dr] * FL_UNITARIZE_PI / (Float)X[dr]);
+        sinsq += s * s;
+      }
+      invpsq[id] = sinsq > 0.00001 ? 4.0 / (sinsq * (Float)volume) : 0.0;
+    }
+
+    double result[2];
+    gaugeFixQualityCPU<Float, Gauge, gauge_dir>(dataOr, X, delta.data(), result);
+    double action0 = result[0];
+    printf("Step: %d\tAction: %.16e\ttheta: %.16e\n", 0, result[0], result[1]);
+
+    double diff = 0.0;
+    int iter = 0;
+    for ( iter = 0; iter < Nsteps; iter++ ) {
+      for ( int k = 0; k < 6; k++ ) {
+        Cmplx *_array = delta.data() + k * (size_t)volume;
+        fft(_array, HOST_FFT_FORWARD);
+#pragma omp parallel for schedule(static)
+        for ( int id = 0; id < volume; id++ ) _array[id] = _array[id] * invpsq[id];
+        fft(_array, HOST_FFT_INVERSE);
+      }
+      //------------------------------------------------------------------------
+      // Calculate g(x)
+      //------------------------------------------------------------------------
+      const Float half_alpha = alpha * 0.5;
+#pragma omp parallel for schedule(static)
+      for ( int id = 0; id < volume; id++ ) {
+        Matrix<Cmplx,3> de;
+        de(0,0) = delta[id];
+        de(0,1) = delta[id + 1 * volume];
+        de(0,2) = delta[id + 2 * volume];
+        de(1,1) = delta[id + 3 * volume];
+        de(1,2) = delta[id + 4 * volume];
+        de(2,2) = delta[id + 5 * volume];
+        de(1,0) = Cmplx(-de(0,1).x, de(0,1).y);
+        de(2,0) = Cmplx(-de(0,2).x, de(0,2).y);
+        de(2,1) = Cmplx(-de(1,2).x, de(1,2).y);
+        setIdentity(&gx[id]);
+        gx[id] += de * half_alpha;
+        reunit_link<Float>( gx[id] );
+      }
+      //------------------------------------------------------------------------
+      // Apply gauge fix to current gauge field, U_mu(x) = g(x) U_mu(x) g(x+mu)^dagger
+      //------------------------------------------------------------------------
+#pragma omp parallel for collapse(2) schedule(static)
+      for ( int parity = 0; parity < 2; parity++ ) {
+        for ( int id = 0; id < volume / 2; id++ ) {
+          int x[4];
+          getCoords(x, id, X, parity);
+          const int idx = getIndexFull(id, X, parity);
+          for ( int mu = 0; mu < 4; mu++ ) {
+            Matrix<Cmplx,3> U;
+            dataOr.load((Float*)(U.data), id, mu, parity);
+            U = gx[idx] * U * conj(gx[linkNormalIndexP1(x, X, mu)]);
+            dataOr.save((Float*)(U.data), id, mu, parity);
+          }
+        }
+      }
+      //------------------------------------------------------------------------
+      // Measure gauge quality and recalculate new Delta(x)
+      //------------------------------------------------------------------------
+      gaugeFixQualityCPU<Float, Gauge, gauge_dir>(dataOr, X, delta.data(), result);
+      double action = result[0];
+      diff = abs(action0 - action);
+      if ((iter % verbose_interval) == (verbose_interval - 1))
+        printf("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter + 1, result[0], result[1], diff);
+      if ( autotune && ((action - action0) < -1e-14) ) {
+        if ( alpha > 0.01 ) {
+          alpha = 0.95 * alpha;
+          printf(">>>>>>>>>>>>>> Warning: changing alpha down -> %.4e\n", alpha );
+        }
+      }
+      //------------------------------------------------------------------------
+      // Check gauge fix quality criterium
+      //------------------------------------------------------------------------
+      if ( stopWtheta ) {   if ( result[1] < tolerance ) break; }
+      else { if ( diff < tolerance ) break; }
+
+      action0 = action;
+    }
+    if ((iter % verbose_interval) != 0 )
+      printf("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter, result[0], result[1], diff);
+
+    // Reunitarize at end
+#pragma omp parallel for collapse(2) schedule(static)
+    for ( int parity = 0; parity < 2; parity++ ) {
+      for ( int id = 0; id < volume / 2; id++ ) {
+        for ( int mu = 0; mu < 4; mu++ ) {
+          Matrix<Cmplx,3> U;
+          dataOr.load((Float*)(U.data), id, mu, parity);
+          reunit_link<Float>( U );
+          dataOr.save((Float*)(U.data), id, mu, parity);
+        }
+      }
+    }
+
+    profileInternalGaugeFixFFT.TPSTOP(QUDA_PROFILE_COMPUTE);
+    if (getVerbosity() > QUDA_SUMMARIZE){
+      double secs = profileInternalGaugeFixFFT.Last(QUDA_PROFILE_COMPUTE);
+      printfQuda("Time: %6.6f s\n", secs);
+    }
+  }
+
+  template<typename Float, typename Gauge>
+  void gaugefixingFFTCPU( Gauge dataOr,  cpuGaugeField& data, const int gauge_dir, \
+                          const int Nsteps, const int verbose_interval, const Float alpha, const int autotune, \
+                          const double tolerance, const int stopWtheta) {
+    if ( gauge_dir != 3 ) {
+      printf("Starting Landau gauge fixing with FFTs...\n");
+      gaugefixingFFTCPU<Float, Gauge, 4>(dataOr, data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+    }
+    else {
+      printf("Starting Coulomb gauge fixing with FFTs...\n");
+      gaugefixingFFTCPU<Float, Gauge, 3>(dataOr, data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+    }
+  }
+
+  template<typename Float>
+  void gaugefixingFFT( cpuGaugeField& data, const int gauge_dir, \
+                       const int Nsteps, const int verbose_interval, const Float alpha, const int autotune, \
+                       const double tolerance, const int stopWtheta) {
+
+    if ( data.Reconstruct() != QUDA_RECONSTRUCT_NO )
+      errorQuda("Reconstruction type %d of host gauge field not supported", data.Reconstruct());
+    for ( int dir = 0; dir < 4; dir++ )
+      if ( data.R()[dir] != 0 ) errorQuda("Extended host gauge field not supported\n");
+
+    if ( data.Order() == QUDA_QDP_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,3>::type Gauge;
+      gaugefixingFFTCPU<Float>(Gauge(data), data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+    } else if ( data.Order() == QUDA_QDPJIT_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_QDPJIT_GAUGE_ORDER,3>::type Gauge;
+      gaugefixingFFTCPU<Float>(Gauge(data), data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+    } else if ( data.Order() == QUDA_MILC_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,3>::type Gauge;
+      gaugefixingFFTCPU<Float>(Gauge(data), data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+    } else if ( data.Order() == QUDA_BQCD_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_BQCD_GAUGE_ORDER,3>::type Gauge;
+      gaugefixingFFTCPU<Float>(Gauge(data), data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+    } else if ( data.Order() == QUDA_TIFR_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_TIFR_GAUGE_ORDER,3>::type Gauge;
+      gaugefixingFFTCPU<Float>(Gauge(data), data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+    } else {
+      errorQuda("Gauge order %d of host gauge field not supported", data.Order());
+    }
+  }
+
 #endif // GPU_GAUGE_ALG
 
 
   /**
    * @brief Gauge fixing with Steepest descent method with FFTs with support for single GPU only.
-   * @param[in,out] data, quda gauge field
+   * @param[in,out] data, quda gauge field, either on the device or on the host
    * @param[in] gauge_dir, 3 for Coulomb gauge fixing, other for Landau gauge fixing
    * @param[in] Nsteps, maximum number of steps to perform gauge fixing
    * @param[in] verbose_interval, print gauge fixing info when iteration count is a multiple of this
@@ -1201,7 +1461,7 @@ namespace quda {
    * @param[in] tolerance, torelance value to stop the method, if this value is zero then the method stops when iteration reachs the maximum number of steps defined by Nsteps
    * @param[in] stopWtheta, 0 for MILC criterium and 1 to use the theta value
    */
-  void gaugefixingFFT( cudaGaugeField& data, const int gauge_dir, \
+  void gaugefixingFFT( GaugeField& data, const int gauge_dir, \
                        const int Nsteps, const int verbose_interval, const double alpha, const int autotune, \
                        const double tolerance, const int stopWtheta) {
 
@@ -1213,10 +1473,22 @@ namespace quda {
     if ( data.Precision() == QUDA_HALF_PRECISION ) {
       errorQuda("Half precision not supported\n");
     }
+    if ( data.Location() == QUDA_CPU_FIELD_LOCATION ) {
+      cpuGaugeField &cpuData = static_cast<cpuGaugeField&>(data);
+      if ( data.Precision() == QUDA_SINGLE_PRECISION ) {
+        gaugefixingFFT<float> (cpuData, gauge_dir, Nsteps, verbose_interval, (float)alpha, autotune, tolerance, stopWtheta);
+      } else if ( data.Precision() == QUDA_DOUBLE_PRECISION ) {
+        gaugefixingFFT<double>(cpuData, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+      } else {
+        errorQuda("Precision %d not supported", data.Precision());
+      }
+      return;
+    }
+    cudaGaugeField &cudaData = static_cast<cudaGaugeField&>(data);
     if ( data.Precision() == QUDA_SINGLE_PRECISION ) {
-      gaugefixingFFT<float> (data, gauge_dir, Nsteps, verbose_interval, (float)alpha, autotune, tolerance, stopWtheta);
+      gaugefixingFFT<float> (cudaData, gauge_dir, Nsteps, verbose_interval, (float)alpha, autotune, tolerance, stopWtheta);
     } else if ( data.Precision() == QUDA_DOUBLE_PRECISION ) {
-      gaugefixingFFT<double>(data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+      gaugefixingFFT<double>(cudaData, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
     } else {
       errorQuda("Precision %d not supported", data.Precision());
     }
@@ -10,6 +10,7 @@
 #include <gauge_fix_ovr_hit_devf.cuh>
 #include <cub_helper.cuh>
 #include <index_helper.cuh>
+#include <vector>
 
 namespace quda {
 
@@ -1790,12 +1791,415 @@ namespace quda {
     }
   }
 
+
+  /**
+   * @brief container to pass parameters for the host gauge fixing
+   * routines.  X holds the local (non-extended) dimensions and E the
+   * dimensions of the field in memory, which differ by 2*border when
+   * the field is extended.
+   */
+  template <typename Gauge>
+  struct GaugeFixCPUArg {
+    int X[4]; // local lattice dimensions
+    int E[4]; // extended lattice dimensions
+    int border[4];
+    int volumeCB; // local checkerboard volume
+    Gauge dataOr;
+    GaugeFixCPUArg(const Gauge &dataOr, const cpuGaugeField &data)
+      : dataOr(dataOr) {
+      for ( int dir = 0; dir < 4; ++dir ) {
+        border[dir] = data.R()[dir];
+        E[dir] = data.X()[dir];
+        X[dir] = E[dir] - 2 * border[dir];
+      }
+      volumeCB = X[0] * X[1] * X[2] * X[3] / 2;
+    }
+  };
+
+
+  /**
+   * @brief Measure the gauge fixing quality on the host.  Each time
+   * slice of each parity is summed into its own partial result, and
+   * the partials are combined in a fixed order so the result does not
+   * depend on the number of threads.
+   */
+  template<typename Float, typename Gauge, int gauge_dir>
+  void gaugeFixQualityCPU(const GaugeFixCPUArg<Gauge> &arg, double result[2]){
+    typedef complex<Float> Cmplx;
+    std::vector<double> action(2 * arg.X[3]), theta(2 * arg.X[3]);
+
+#pragma omp parallel for collapse(2) schedule(static)
+    for ( int parity = 0; parity < 2; parity++ ) {
+      for ( int t = 0; t < arg.X[3]; t++ ) {
+        double action_t = 0.0, theta_t = 0.0;
+        int x[4];
+        x[3] = t + arg.border[3];
+        for ( int z = 0; z < arg.X[2]; z++ ) {
+          x[2] = z + arg.border[2];
+          for ( int y = 0; y < arg.X[1]; y++ ) {
+            x[1] = y + arg.border[1];
+            for ( int x0 = (parity + t + z + y) & 1; x0 < arg.X[0]; x0 += 2 ) {
+              x[0] = x0 + arg.border[0];
+              const int idx = linkIndex(x, arg.E);
+              Matrix<Cmplx,3> delta;
+              setZero(&delta);
+              for ( int mu = 0; mu < gauge_dir; mu++ ) {
+                Matrix<Cmplx,3> U;
+                arg.dataOr.load((Float*)(U.data), idx, mu, parity);
+                delta -= U;
+              }
+              action_t += -delta(0,0).x - delta(1,1).x - delta(2,2).x;
+              for ( int mu = 0; mu < gauge_dir; mu++ ) {
+                Matrix<Cmplx,3> U;
+                arg.dataOr.load((Float*)(U.data), linkIndexM1(x, arg.E, mu), mu, 1 - parity);
+                delta += U;
+              }
+              delta -= conj(delta);
+              SubTraceUnit(delta);
+              theta_t += getRealTraceUVdagger(delta, delta);
+            }
+          }
+        }
+        action[parity * arg.X[3] + t] = action_t;
+        theta[parity * arg.X[3] + t] = theta_t;
+      }
+    }
+
+    result[0] = 0.0;
+    result[1] = 0.0;
+    for ( int i = 0; i < 2 * arg.X[3]; i++ ) {
+      result[0] += action[i];
+      result[1] += theta[i];
+    }
+    if ( comm_size() != 1 ) comm_allreduce_array(result, 2);
+    result[0] /= (double)(3 * gauge_dir * 2 * arg.volumeCB * comm_size());
+    result[1] /= (double)(3 * 2 * arg.volumeCB * comm_size());
+  }
+
+
+  /**
+   * @brief Host version of the overrelaxation hit for a single site.
+   * For each SU(2) subgroup the four real parameters are accumulated
+   * from the gauge_dir upward (link) and downward (link1) links,
+   * overrelaxed, and the rotation is applied to all eight links
+   * attached to the site.  This is the serial equivalent of
+   * GaugeFixHit_AtomicAdd.
+   */
+  template<typename Float, int gauge_dir, int NCOLORS>
+  inline void GaugeFixHitCPU(Matrix<complex<Float>,NCOLORS> link[4], Matrix<complex<Float>,NCOLORS> link1[4],
+                             const Float relax_boost){
+    for ( int block = 0; block < (NCOLORS * (NCOLORS - 1) / 2); block++ ) {
+      int p, q;
+      IndexBlock<NCOLORS>(block, p, q);
+      Float a0 = 0.0, a1 = 0.0, a2 = 0.0, a3 = 0.0;
+      for ( int mu = 0; mu < gauge_dir; mu++ ) {
+        a0 += link[mu](p,p).x + link[mu](q,q).x + link1[mu](p,p).x + link1[mu](q,q).x;
+        a1 += (link1[mu](p,q).y + link1[mu](q,p).y) - (link[mu](p,q).y + link[mu](q,p).y);
+        a2 += (link1[mu](p,q).x - link1[mu](q,p).x) - (link[mu](p,q).x - link[mu](q,p).x);
+        a3 += (link1[mu](p,p).y - link1[mu](q,q).y) - (link[mu](p,p).y - link[mu](q,q).y);
+      }
+      //Over-relaxation boost
+      Float asq = a1 * a1 + a2 * a2 + a3 * a3;
+      Float a0sq = a0 * a0;
+      Float x = (relax_boost * a0sq + asq) / (a0sq + asq);
+      Float r = 1.0 / sqrt(a0sq + x * x * asq);
+      a0 *= r;
+      a1 *= x * r;
+      a2 *= x * r;
+      a3 *= x * r;
+
+      for ( int mu = 0; mu < 4; mu++ ) {
+        //link <- u * link
+        for ( int j = 0; j < NCOLORS; j++ ) {
+          complex<Float> m0 = link[mu](p,j);
+          link[mu](p,j) = complex<Float>( a0, a3 ) * m0 + complex<Float>( a2, a1 ) * link[mu](q,j);
+          link[mu](q,j) = complex<Float>(-a2, a1 ) * m0 + complex<Float>( a0,-a3 ) * link[mu](q,j);
+        }
+        //link1 <- link1 * u_adj
+        for ( int j = 0; j < NCOLORS; j++ ) {
+          complex<Float> m0 = link1[mu](j,p);
+          link1[mu](j,p) = complex<Float>( a0,-a3 ) * m0 + complex<Float>( a2,-a1 ) * link1[mu](j,q);
+          link1[mu](j,q) = complex<Float>(-a2,-a1 ) * m0 + complex<Float>( a0, a3 ) * link1[mu](j,q);
+        }
+      }
+    }
+  }
+
+
+  /**
+   * @brief Perform one overrelaxation sweep over the sites of the
+   * given parity on the host.  Sites of the same parity share no
+   * links, so the sweep is race free.  When a dimension is extended
+   * the first forward halo layer is also updated: those sites are
+   * owned by the neighbouring process, which performs the identical
+   * hit, but updating them here rotates the backward links of our
+   * boundary sites without having to send them back.
+   */
+  template<typename Float, typename Gauge, int gauge_dir>
+  void gaugeFixHitCPU(GaugeFixCPUArg<Gauge> &arg, const Float relax_boost, const int parity){
+    typedef complex<Float> Cmplx;
+    int Y[4];
+    for ( int dr = 0; dr < 4; ++dr ) Y[dr] = arg.X[dr] + (arg.border[dr] ? 1 : 0);
+
+#pragma omp parallel for collapse(3) schedule(static)
+    for ( int t = 0; t < Y[3]; t++ ) {
+      for ( int z = 0; z < Y[2]; z++ ) {
+        for ( int y = 0; y < Y[1]; y++ ) {
+          int x[4];
+          x[1] = y + arg.border[1];
+          x[2] = z + arg.border[2];
+          x[3] = t + arg.border[3];
+          for ( int x0 = (parity + y + z + t) & 1; x0 < Y[0]; x0 += 2 ) {
+            x[0] = x0 + arg.border[0];
+            const int idx = linkIndex(x, arg.E);
+            int idxm1[4];
+            Matrix<Cmplx,3> link[4], link1[4];
+            for ( int mu = 0; mu < 4; mu++ ) {
+              idxm1[mu] = linkIndexM1(x, arg.E, mu);
+              arg.dataOr.load((Float*)(link[mu].data), idx, mu, parity);
+              arg.dataOr.load((Float*)(link1[mu].data), idxm1[mu], mu, 1 - parity);
+            }
+            GaugeFixHitCPU<Float, gauge_dir, 3>(link, link1, relax_boost);
+            for ( int mu = 0; mu < 4; mu++ ) {
+              arg.dataOr.save((Float*)(link[mu].data), idx, mu, parity);
+              arg.dataOr.save((Float*)(link1[mu].data), idxm1[mu], mu, 1 - parity);
+            }
+          }
+        }
+      }
+    }
+  }
+
+
+  /**
+   * @brief Project a link back onto SU(3) by Gram-Schmidt
+   * orthonormalization of its first two rows, with the third row
+   * reconstructed from the cross product.
+   */
+  template<typename Float>
+  inline void reunitLinkCPU(Matrix<complex<Float>,3> &U){
+    typedef complex<Float> Cmplx;
+    Float rnorm = 0.0;
+    for ( int j = 0; j < 3; j++ ) rnorm += norm(U(0,j));
+    rnorm = 1.0 / sqrt(rnorm);
+    for ( int j = 0; j < 3; j++ ) U(0,j) *= rnorm;
+
+    Cmplx proj = Cmplx(0.0, 0.0);
+    for ( int j = 0; j < 3; j++ ) proj += conj(U(0,j)) * U(1,j);
+    for ( int j = 0; j < 3; j++ ) U(1,j) -= proj * U(0,j);
+    rnorm = 0.0;
+    for ( int j = 0; j < 3; j++ ) rnorm += norm(U(1,j));
+    rnorm = 1.0 / sqrt(rnorm);
+    for ( int j = 0; j < 3; j++ ) U(1,j) *= rnorm;
+
+    U(2,0) = conj(U(0,1) * U(1,2) - U(0,2) * U(1,1));
+    U(2,1) = conj(U(0,2) * U(1,0) - U(0,0) * U(1,2));
+    U(2,2) = conj(U(0,0) * U(1,1) - U(0,1) * U(1,0));
+  }
+
+
+  /**
+   * @brief Reunitarize every link of the host field, including the
+   * halo of an extended field.
+   */
+  template<typename Float, typename Gauge>
+  void reunitGaugeCPU(GaugeFixCPUArg<Gauge> &arg){
+    const int volumeCB = arg.E[0] * arg.E[1] * arg.E[2] * arg.E[3] / 2;
+#pragma omp parallel for collapse(2) schedule(static)
+    for ( int parity = 0; parity < 2; parity++ ) {
+      for ( int idx = 0; idx < volumeCB; idx++ ) {
+        for ( int mu = 0; mu < 4; mu++ ) {
+          Matrix<complex<Float>,3> U;
+          arg.dataOr.load((Float*)(U.data), idx, mu, parity);
+          reunitLinkCPU(U);
+          arg.dataOr.save((Float*)(U.data), idx, mu, parity);
+        }
+      }
+    }
+  }
+
+
+  template<typename Float, typename Gauge, int gauge_dir>
+  void gaugefixingOVRCPU( Gauge dataOr,  cpuGaugeField& data,
+                          const int Nsteps, const int verbose_interval,
+                          const Float relax_boost, const double tolerance,
+                          const int reunit_interval, const int stopWtheta) {
+
+    TimeProfile profileInternalGaugeFixOVR("InternalGaugeFixQudaOVR", false);
+
+    profileInternalGaugeFixOVR.TPSTART(QUDA_PROFILE_COMPUTE);
+
+    printfQuda("\tOverrelaxation boost parameter: %lf\n", (double)relax_boost);
+    printfQuda("\tStop criterium: %lf\n", tolerance);
+    if ( stopWtheta ) printfQuda("\tStop criterium method: theta\n");
+    else printfQuda("\tStop criterium method: Delta\n");
+    printfQuda("\tMaximum number of iterations: %d\n", Nsteps);
+    printfQuda("\tReunitarize at every %d steps\n", reunit_interval);
+    printfQuda("\tPrint convergence results at every %d steps\n", verbose_interval);
+
+    GaugeFixCPUArg<Gauge> arg(dataOr, data);
+
+    // the halo of an extended field is refreshed after each parity sweep
+    bool extended = false;
+    for ( int dir = 0; dir < 4; ++dir ) {
+      if ( commDimPartitioned(dir) && data.R()[dir] == 0 )
+        errorQuda("Partitioned dimension %d requires an extended gauge field\n", dir);
+      if ( data.R()[dir] != 0 ) extended = true;
+    }
+
+    double result[2];
+    gaugeFixQualityCPU<Float, Gauge, gauge_dir>(arg, result);
+    double action0 = result[0];
+    printfQuda("Step: %d\tAction: %.16e\ttheta: %.16e\n", 0, result[0], result[1]);
+
+    reunitGaugeCPU<Float>(arg);
+    if ( extended ) data.exchangeExtendedGhost(data.R(), true);
+
+    int iter = 0;
+    for ( iter = 0; iter < Nsteps; iter++ ) {
+      for ( int p = 0; p < 2; p++ ) {
+        gaugeFixHitCPU<Float, Gauge, gauge_dir>(arg, relax_boost, p);
+        if ( extended ) data.exchangeExtendedGhost(data.R(), true);
+      }
+      if ((iter % reunit_interval) == (reunit_interval - 1)) reunitGaugeCPU<Float>(arg);
+      gaugeFixQualityCPU<Float, Gauge, gauge_dir>(arg, result);
+      double action = result[0];
+      double diff = abs(action0 - action);
+      if ((iter % verbose_interval) == (verbose_interval - 1))
+        printfQuda("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter + 1, result[0], result[1], diff);
+      if ( stopWtheta ) {
+        if ( result[1] < tolerance ) break;
+      }
+      else{
+        if ( diff < tolerance ) break;
+      }
+      action0 = action;
+    }
+    if ((iter % reunit_interval) != 0 ) reunitGaugeCPU<Float>(arg);
+    if ((iter % verbose_interval) != 0 ) {
+      gaugeFixQualityCPU<Float, Gauge, gauge_dir>(arg, result);
+      double action = result[0];
+      double diff = abs(action0 - action);
+      printfQuda("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter + 1, result[0], result[1], diff);
+    }
+    profileInternalGaugeFixOVR.TPSTOP(QUDA_PROFILE_COMPUTE);
+    if (getVerbosity() > QUDA_SUMMARIZE){
+      double secs = profileInternalGaugeFixOVR.Last(QUDA_PROFILE_COMPUTE);
+      printfQuda("Time: %6.6f s\n", secs);
+    }
+  }
+
+  template<typename Float, typename Gauge>
+  void gaugefixingOVRCPU( Gauge dataOr,  cpuGaugeField& data, const int gauge_dir, const int Nsteps, const int verbose_interval,
+                          const Float relax_boost, const double tolerance, const int reunit_interval, const int stopWtheta) {
+    if ( gauge_dir != 3 ) {
+      printfQuda("Starting Landau gauge fixing...\n");
+      gaugefixingOVRCPU<Float, Gauge, 4>(dataOr, data, Nsteps, verbose_interval, relax_boost, tolerance, reunit_interval, stopWtheta);
+    }
+    else {
+      printfQuda("Starting Coulomb gauge fixing...\n");
+      gaugefixingOVRCPU<Float, Gauge, 3>(dataOr, data, Nsteps, verbose_interval, relax_boost, tolerance, reunit_interval, stopWtheta);
+    }
+  }
+
+  template<typename Float>
+  void gaugefixingOVR( cpuGaugeField& data, const int gauge_dir, const int Nsteps, const int verbose_interval,
+		       const Float relax_boost, const double tolerance, const int reunit_interval, const int stopWtheta) {
+
+    if ( data.Reconstruct() != QUDA_RECONSTRUCT_NO )
+      errorQuda("Reconstruction type %d of host gauge field not supported", data.Reconstruct());
+
+    if ( data.Order() == QUDA_QDP_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,3>::type Gauge;
+      gaugefixingOVRCPU<Float>(Gauge(data), data, gauge_dir, Nsteps, verbose_interval, relax_boost, tolerance, reunit_interval, stopWtheta);
+    } else if ( data.Order() == QUDA_QDPJIT_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_QDPJIT_GAUGE_ORDER,3>::type Gauge;
+      gaugefixingOVRCPU<Float>(Gauge(data), data, gauge_dir, Nsteps, verbose_interval, relax_boost, tolerance, reunit_interval, stopWtheta);
+    } else if ( data.Order() == QUDA_MILC_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,3>::type Gauge;
+      gaugefixingOVRCPU<Float>(Gauge(data), data, gauge_dir, Nsteps, verbose_interval, relax_boost, tolerance, reunit_interval, stopWtheta);
+    } else if ( data.Order() == QUDA_BQCD_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_BQCD_GAUGE_ORDER,3>::type Gauge;
+      gaugefixingOVRCPU<Float>(Gauge(data), data, gauge_dir, Nsteps, verbose_interval, relax_boost, tolerance, reunit_interval, stopWtheta);
+    } else if ( data.Order() == QUDA_TIFR_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_TIFR_GAUGE_ORDER,3>::type Gauge;
+      gaugefixingOVRCPU<Float>(Gauge(data), data, gauge_dir, Nsteps, verbose_interval, relax_boost, tolerance, reunit_interval, stopWtheta);
+    } else {
+      errorQuda("Gauge order %d of host gauge field not supported", data.Order());
+    }
+  }
+
+  template<typename Float, typename Gauge>
+  double2 gaugeFixQualityCPU(Gauge dataOr, const cpuGaugeField &data, const int gauge_dir) {
+    GaugeFixCPUArg<Gauge> arg(dataOr, data);
+    double result[2];
+    if ( gauge_dir != 3 ) gaugeFixQualityCPU<Float, Gauge, 4>(arg, result);
+    else gaugeFixQualityCPU<Float, Gauge, 3>(arg, result);
+    return make_double2(result[0], result[1]);
+  }
+
+  template<typename Float>
+  double2 gaugeFixQuality(const cpuGaugeField& data, const int gauge_dir) {
+
+    if ( data.Reconstruct() != QUDA_RECONSTRUCT_NO )
+      errorQuda("Reconstruction type %d of host gauge field not supported", data.Reconstruct());
+
+    if ( data.Order() == QUDA_QDP_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,3>::type Gauge;
+      return gaugeFixQualityCPU<Float>(Gauge(data), data, gauge_dir);
+    } else if ( data.Order() == QUDA_QDPJIT_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_QDPJIT_GAUGE_ORDER,3>::type Gauge;
+      return gaugeFixQualityCPU<Float>(Gauge(data), data, gauge_dir);
+    } else if ( data.Order() == QUDA_MILC_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,3>::type Gauge;
+      return gaugeFixQualityCPU<Float>(Gauge(data), data, gauge_dir);
+    } else if ( data.Order() == QUDA_BQCD_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_BQCD_GAUGE_ORDER,3>::type Gauge;
+      return gaugeFixQualityCPU<Float>(Gauge(data), data, gauge_dir);
+    } else if ( data.Order() == QUDA_TIFR_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_TIFR_GAUGE_ORDER,3>::type Gauge;
+      return gaugeFixQualityCPU<Float>(Gauge(data), data, gauge_dir);
+    } else {
+      errorQuda("Gauge order %d of host gauge field not supported", data.Order());
+    }
+    return make_double2(0.0, 0.0);
+  }
+
 #endif // GPU_GAUGE_ALG
 
 
+  double2 gaugeFixQuality(const GaugeField& data, const int gauge_dir) {
+#ifdef GPU_GAUGE_ALG
+    if ( data.Location() == QUDA_CUDA_FIELD_LOCATION ) {
+      // measure on a host copy, keeping any extended halo
+      GaugeFieldParam param(data);
+      param.order = QUDA_QDP_GAUGE_ORDER;
+      param.reconstruct = QUDA_RECONSTRUCT_NO;
+      param.create = QUDA_NULL_FIELD_CREATE;
+      param.pad = 0;
+      if ( data.Precision() == QUDA_HALF_PRECISION ) param.setPrecision(QUDA_SINGLE_PRECISION);
+      cpuGaugeField cpuData(param);
+      static_cast<const cudaGaugeField&>(data).saveCPUField(cpuData);
+      return gaugeFixQuality(cpuData, gauge_dir);
+    }
+    const cpuGaugeField &cpuData = static_cast<const cpuGaugeField&>(data);
+    if ( data.Precision() == QUDA_SINGLE_PRECISION ) {
+      return gaugeFixQuality<float>(cpuData, gauge_dir);
+    } else if ( data.Precision() == QUDA_DOUBLE_PRECISION ) {
+      return gaugeFixQuality<double>(cpuData, gauge_dir);
+    } else {
+      errorQuda("Precision %d not supported", data.Precision());
+    }
+#else
+    errorQuda("Gauge fixing has not been built");
+#endif // GPU_GAUGE_ALG
+    return make_double2(0.0, 0.0);
+  }
+
+
   /**
    * @brief Gauge fixing with overrelaxation with support for single and multi GPU.
-   * @param[in,out] data, quda gauge field
+   * @param[in,out] data, quda gauge field, either on the device or on the host
    * @param[in] gauge_dir, 3 for Coulomb gauge fixing, other for Landau gauge fixing
    * @param[in] Nsteps, maximum number of steps to perform gauge fixing
    * @param[in] verbose_interval, print gauge fixing info when iteration count is a multiple of this
@@ -1804,16 +2208,28 @@ namespace quda {
    * @param[in] reunit_interval, reunitarize gauge field when iteration count is a multiple of this
    * @param[in] stopWtheta, 0 for MILC criterium and 1 to use the theta value
    */
-  void gaugefixingOVR( cudaGaugeField& data, const int gauge_dir, const int Nsteps, const int verbose_interval, const double relax_boost,
+  void gaugefixingOVR( GaugeField& data, const int gauge_dir, const int Nsteps, const int verbose_interval, const double relax_boost,
                        const double tolerance, const int reunit_interval, const int stopWtheta) {
 #ifdef GPU_GAUGE_ALG
     if ( data.Precision() == QUDA_HALF_PRECISION ) {
       errorQuda("Half precision not supported\n");
     }
+    if ( data.Location() == QUDA_CPU_FIELD_LOCATION ) {
+      cpuGaugeField &cpuData = static_cast<cpuGaugeField&>(data);
+      if ( data.Precision() == QUDA_SINGLE_PRECISION ) {
+        gaugefixingOVR<float> (cpuData, gauge_dir, Nsteps, verbose_interval, (float)relax_boost, tolerance, reunit_interval, stopWtheta);
+      } else if ( data.Precision() == QUDA_DOUBLE_PRECISION ) {
+        gaugefixingOVR<double>(cpuData, gauge_dir, Nsteps, verbose_interval, relax_boost, tolerance, reunit_interval, stopWtheta);
+      } else {
+        errorQuda("Precision %d not supported", data.Precision());
+      }
+      return;
+    }
+    cudaGaugeField &cudaData = static_cast<cudaGaugeField&>(data);
     if ( data.Precision() == QUDA_SINGLE_PRECISION ) {
-      gaugefixingOVR<float> (data, gauge_dir, Nsteps, verbose_interval, (float)relax_boost, tolerance, reunit_interval, stopWtheta);
+      gaugefixingOVR<float> (cudaData, gauge_dir, Nsteps, verbose_interval, (float)relax_boost, tolerance, reunit_interval, stopWtheta);
     } else if ( data.Precision() == QUDA_DOUBLE_PRECISION ) {
-      gaugefixingOVR<double>(data, gauge_dir, Nsteps, verbose_interval, relax_boost, tolerance, reunit_interval, stopWtheta);
+      gaugefixingOVR<double>(cudaData, gauge_dir, Nsteps, verbose_interval, relax_boost, tolerance, reunit_interval, stopWtheta);
     } else {
       errorQuda("Precision %d not supported", data.Precision());
     }
@@ -2,6 +2,7 @@
 #include <quda_matrix.h>
 #include <index_helper.cuh>
 #include <generics/ldg.h>
+#include <vector>
 
 namespace quda {
 
@@ -138,29 +139,142 @@ namespace quda {
     return;
   }
 
+  /**
+     A node in the compiled path table.  Paths for a given direction
+     are merged into a prefix tree, so that every distinct path prefix
+     is only evaluated once per site, and paths that share leading
+     links (e.g., the plaquette and rectangle staples) reuse the
+     products computed for the shorter loop.  The nodes are stored in
+     depth-first order, so the parent of each node is always evaluated
+     before it and its product is still on the evaluation stack.
+  */
+  struct GaugeForcePathNode {
+    int depth;     // depth of this node in the tree (0 = first link)
+    int step;      // path step (0-3 forwards, 4-7 backwards)
+    int lnkdir;    // direction of the link loaded at this step
+    bool forwards; // whether the link is traversed forwards
+    int dx[4];     // displacement of the link's site relative to the site x
+    int oddbit;    // parity of the link site relative to the parity of x
+    double coeff;  // accumulated coefficient of all paths ending here
+    std::vector<int> child; // children (only used while compiling)
+  };
+
+  /**
+     Compile the input path table for each direction into a prefix
+     tree of path nodes.  This is done once per force evaluation on
+     the host, rather than re-walking the path list at every site.
+  */
+  struct GaugeForcePaths {
+    std::vector<GaugeForcePathNode> node[4];
+    int max_depth;
+
+    GaugeForcePaths(int ***input_path, const int *length, const double *path_coeff, int num_paths)
+      : max_depth(0) {
+      for (int dir=0; dir<4; dir++) {
+	std::vector<GaugeForcePathNode> tree;
+	std::vector<int> root;
+
+	for (int i=0; i<num_paths; i++) {
+	  if (path_coeff[i] == 0) continue;
+
+	  // start from end of link in direction dir
+	  int pos[4] = {0, 0, 0, 0};
+	  pos[dir]++;
+	  int parent = -1;
+
+	  for (int j=0; j<length[i]; j++) {
+	    int step = input_path[dir][i][j];
+	    bool forwards = isForwards(step);
+	    int lnkdir = forwards ? step : flipDir(step);
+
+	    std::vector<int> &siblings = parent < 0 ? root : tree[parent].child;
+	    int match = -1;
+	    for (unsigned int k=0; k<siblings.size(); k++) if (tree[siblings[k]].step == step) match = siblings[k];
+
+	    if (!forwards) pos[lnkdir]--; // if we are going backwards the link is on the adjacent site
+	    if (match < 0) {
+	      GaugeForcePathNode n;
+	      n.depth = j;
+	      n.step = step;
+	      n.lnkdir = lnkdir;
+	      n.forwards = forwards;
+	      n.oddbit = 0;
+	      for (int d=0; d<4; d++) { n.dx[d] = pos[d]; n.oddbit ^= (pos[d] & 1); }
+	      n.coeff = 0.0;
+	      match = tree.size();
+	      tree.push_back(n);
+	      // tree may have been reallocated, so look up the siblings again
+	      (parent < 0 ? root : tree[parent].child).push_back(match);
+	    }
+	    if (forwards) pos[lnkdir]++; // now have to update location
+
+	    parent = match;
+	  }
+	  if (parent >= 0) tree[parent].coeff += path_coeff[i];
+	}
+
+	// flatten into depth-first order
+	std::vector<int> stack(root.rbegin(), root.rend());
+	while (!stack.empty()) {
+	  int n = stack.back();
+	  stack.pop_back();
+	  node[dir].push_back(tree[n]);
+	  for (auto c = tree[n].child.rbegin(); c != tree[n].child.rend(); c++) stack.push_back(*c);
+	  if (tree[n].depth + 1 > max_depth) max_depth = tree[n].depth + 1;
+	}
+	for (auto &n : node[dir]) n.child.clear();
+      }
+    }
+  };
+
+  /**
+     Evaluate the compiled path table for a single site and direction
+  */
+  template<typename Float, typename Arg>
+  inline void GaugeForceCompiled(Arg &arg, const GaugeForcePaths &paths, int dir, int idx, int parity,
+				 Matrix<complex<Float>,3> *product)
+  {
+    typedef Matrix<complex<Float>,3> Link;
+
+    int x[4] = {0, 0, 0, 0};
+    getCoords(x, idx, arg.X, parity);
+    for (int dr=0; dr<4; ++dr) x[dr] += arg.border[dr]; // extended grid coordinates
+
+    Link staple;
+    const std::vector<GaugeForcePathNode> &node = paths.node[dir];
+    for (unsigned int i=0; i<node.size(); i++) {
+      const GaugeForcePathNode &n = node[i];
+      Link link = arg.u(n.lnkdir, linkIndexShift(x, n.dx, arg.E), parity^n.oddbit);
+      if (!n.forwards) link = conj(link);
+      product[n.depth] = n.depth == 0 ? link : product[n.depth-1] * link;
+      if (n.coeff != 0.0) staple = staple + static_cast<Float>(n.coeff) * product[n.depth];
+    }
+
+    // multiply by U(x)
+    Link linkA = arg.u(dir, linkIndex(x,arg.E), parity);
+    linkA = linkA * staple;
+
+    // update mom(x)
+    Link mom = arg.mom(dir, idx, parity);
+    mom = mom - arg.coeff * linkA;
+    makeAntiHerm(mom);
+    arg.mom(dir, idx, parity) = mom;
+  }
+
   template <typename Float, typename Arg>
-  void GaugeForceCPU(Arg &arg) {
-    for (int dir=0; dir<4; dir++) {
+  void GaugeForceCPU(Arg &arg, const GaugeForcePaths &paths) {
+#pragma omp parallel
+    {
+      // per-thread stack of partial path products
+      std::vector<Matrix<complex<Float>,3> > product(paths.max_depth);
+#pragma omp for collapse(2) schedule(static)
       for (int parity=0; parity<2; parity++) {
-        for (int idx=0; idx<arg.threads; idx++) {
-	  switch(dir) {
-	  case 0:
-	    GaugeForceKernel<Float,Arg,0>(arg, idx, parity);
-	    break;
-	  case 1:
-	    GaugeForceKernel<Float,Arg,1>(arg, idx, parity);
-	    break;
-	  case 2:
-	    GaugeForceKernel<Float,Arg,2>(arg, idx, parity);
-	    break;
-	  case 3:
-	    GaugeForceKernel<Float,Arg,3>(arg, idx, parity);
-	    break;
-	  }
-        }
+	for (int idx=0; idx<arg.threads; idx++) {
+	  // all four directions for a site are done together for locality
+	  for (int dir=0; dir<4; dir++) GaugeForceCompiled<Float>(arg, paths, dir, idx, parity, product.data());
+	}
       }
     }
-    return;
   }
 
   template <typename Float, typename Arg>
@@ -207,7 +321,7 @@ namespace quda {
 	TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
 	GaugeForceGPU<Float,Arg><<<tp.grid,tp.block,tp.shared_bytes>>>(arg);
       } else {
-	GaugeForceCPU<Float,Arg>(arg);
+	errorQuda("Host gauge force should use the compiled path table");
       }
     }
   
@@ -263,6 +377,19 @@ namespace quda {
     }
   };
   
+  template <typename Float, typename Mom, typename Gauge>
+  void gaugeForceHost(Mom mom, const Gauge &u, GaugeField& meta_mom, const GaugeField& meta_u, const double coeff,
+		      int ***input_path, const int* length_h, const double* path_coeff_h, const int num_paths, const int path_max_length)
+  {
+    GaugeForcePaths paths(input_path, length_h, path_coeff_h, num_paths);
+    int count = 0;
+    for (int i=0; i<num_paths; i++) count += length_h[i];
+    int *input_path_h[4] = { nullptr, nullptr, nullptr, nullptr };
+    GaugeForceArg<Mom,Gauge> arg(mom, u, num_paths, path_max_length, coeff, input_path_h,
+				 length_h, path_coeff_h, count, meta_mom, meta_u);
+    GaugeForceCPU<Float>(arg, paths);
+  }
+
   template <typename Float, typename Mom, typename Gauge>
   void gaugeForce(Mom mom, const Gauge &u, GaugeField& meta_mom, const GaugeField& meta_u, const double coeff,
 		  int ***input_path, const int* length_h, const double* path_coeff_h, const int num_paths, const int path_max_length)
@@ -310,14 +437,50 @@ namespace quda {
     cudaDeviceSynchronize();
   }
 
+  template <typename Float, typename M, typename G>
+  void gaugeForceHost(GaugeField& mom, const GaugeField& u, const double coeff, int ***input_path,
+		      const int* length, const double* path_coeff, const int num_paths, const int max_length)
+  {
+    // device-resident fields are staged through pinned host buffers
+    const bool stage = mom.Location() == QUDA_CUDA_FIELD_LOCATION;
+    Float *mom_h = nullptr, *u_h = nullptr;
+    if (stage) {
+      mom_h = static_cast<Float*>(pool_pinned_malloc(mom.Bytes()));
+      u_h = static_cast<Float*>(pool_pinned_malloc(u.Bytes()));
+      qudaMemcpy(mom_h, mom.Gauge_p(), mom.Bytes(), cudaMemcpyDeviceToHost);
+      qudaMemcpy(u_h, u.Gauge_p(), u.Bytes(), cudaMemcpyDeviceToHost);
+    }
+
+    gaugeForceHost<Float,M,G>(M(mom, mom_h, 0, stage), G(u, u_h, 0, stage), mom, u, coeff,
+			      input_path, length, path_coeff, num_paths, max_length);
+
+    if (stage) {
+      qudaMemcpy(mom.Gauge_p(), mom_h, mom.Bytes(), cudaMemcpyHostToDevice);
+      pool_pinned_free(u_h);
+      pool_pinned_free(mom_h);
+    }
+  }
+
   template <typename Float>
   void gaugeForce(GaugeField& mom, const GaugeField& u, const double coeff, int ***input_path,
-		  const int* length, const double* path_coeff, const int num_paths, const int max_length)
+		  const int* length, const double* path_coeff, const int num_paths, const int max_length,
+		  QudaFieldLocation location)
   {
     if (mom.Reconstruct() != QUDA_RECONSTRUCT_10)
       errorQuda("Reconstruction type %d not supported", mom.Reconstruct());
 
-    if (mom.Order() == QUDA_FLOAT2_GAUGE_ORDER) {
+    if (mom.Order() == QUDA_FLOAT2_GAUGE_ORDER && location == QUDA_CPU_FIELD_LOCATION) {
+      typedef typename gauge::FloatNOrder<Float,18,2,11> M;
+      if (u.Reconstruct() == QUDA_RECONSTRUCT_NO) {
+	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type G;
+	gaugeForceHost<Float,M,G>(mom, u, coeff, input_path, length, path_coeff, num_paths, max_length);
+      } else if (u.Reconstruct() == QUDA_RECONSTRUCT_12) {
+	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type G;
+	gaugeForceHost<Float,M,G>(mom, u, coeff, input_path, length, path_coeff, num_paths, max_length);
+      } else {
+	errorQuda("Reconstruction type %d not supported", u.Reconstruct());
+      }
+    } else if (mom.Order() == QUDA_FLOAT2_GAUGE_ORDER) {
       typedef typename gauge::FloatNOrder<Float,18,2,11> M;
       if (u.Reconstruct() == QUDA_RECONSTRUCT_NO) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type G;
@@ -337,7 +500,7 @@ namespace quda {
 
 
   void gaugeForce(GaugeField& mom, const GaugeField& u, double coeff, int ***input_path, 
-		  int *length, double *path_coeff, int num_paths, int max_length)
+		  int *length, double *path_coeff, int num_paths, int max_length, QudaFieldLocation location)
   {
 #ifdef GPU_GAUGE_FORCE
     if (mom.Precision() != u.Precision()) errorQuda("Mixed precision not supported");
@@ -345,10 +508,10 @@ namespace quda {
 
     switch(mom.Precision()) {
     case QUDA_DOUBLE_PRECISION:
-      gaugeForce<double>(mom, u, coeff, input_path, length, path_coeff, num_paths, max_length);
+      gaugeForce<double>(mom, u, coeff, input_path, length, path_coeff, num_paths, max_length, location);
       break;
     case QUDA_SINGLE_PRECISION:
-      gaugeForce<float>(mom, u, coeff, input_path, length, path_coeff, num_paths, max_length);
+      gaugeForce<float>(mom, u, coeff, input_path, length, path_coeff, num_paths, max_length, location);
       break;
     default:
       errorQuda("Unsupported precision %d", mom.Precision());
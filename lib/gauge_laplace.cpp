@@ -44,6 +44,22 @@ namespace quda {
     DslashXpay(out, in, QUDA_INVALID_PARITY, in, -kappa);
   }
 
+  void GaugeLaplace::M(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in) const
+  {
+    for (unsigned int i=0; i<in.size(); i++) {
+      checkFullSpinor(*out[i], *in[i]);
+      checkSpinorAlias(*in[i], *out[i]);
+    }
+
+    ApplyLaplace(out, in, *gauge, -kappa, &in, QUDA_INVALID_PARITY);
+
+    // eight link-vector products, their sum and the xpay per site
+    for (unsigned int i=0; i<in.size(); i++) {
+      const long long Nc = in[i]->Ncolor();
+      flops += (2*4*8*Nc*Nc - 2*Nc + 2*2*Nc)*in[i]->Volume();
+    }
+  }
+
   void GaugeLaplace::MdagM(ColorSpinorField &out, const ColorSpinorField &in) const
   {
     bool reset = newTmp(&tmp1, in);
@@ -8,6 +8,7 @@
 #include <cub_helper.cuh>
 #include <index_helper.cuh>
 #include <random_quda.h>
+#include <comm_quda.h>
 
 namespace quda {
 
@@ -37,8 +38,8 @@ namespace quda {
   };
 
 
-  template<typename Float>
-  __device__ __host__  Matrix<complex<Float>,3> genGaussSU3(cuRNGState &localState){
+  template<typename Float, typename RNGState>
+  __device__ __host__  Matrix<complex<Float>,3> genGaussSU3(RNGState &localState){
        Matrix<complex<Float>, 3> ret;
 	       //ret(i,j) = 0.0;
 	       //ret(i,j) = complex<Float>( (Float)(Random<Float>(localState) - 0.5), (Float)(Random<Float>(localState) - 0.5) );
@@ -102,18 +103,55 @@ namespace quda {
     }
   }
 
+  /**
+     Host version of computeGenGauss.  The random numbers of each link
+     are drawn from a counter-based generator keyed by (global site,
+     direction, stream), so the field does not depend on the number of
+     threads.
+  */
+  template<typename Float, typename Gauge>
+  void computeGenGaussCPU(GaugeGaussArg<Gauge> &arg, uint64_t seed, unsigned int stream){
+    typedef Matrix<complex<Float>,3> Link;
+
+    int G[4], offset[4];
+    for (int dr=0; dr<4; ++dr) {
+      G[dr] = comm_dim(dr) * arg.X[dr];
+      offset[dr] = comm_coord(dr) * arg.X[dr];
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2) schedule(static)
+#endif
+    for (int parity=0; parity<2; parity++) {
+      for (int idx=0; idx<arg.threads; idx++) {
+	int x[4];
+	getCoords(x, idx, arg.X, parity);
+	const uint64_t site = (((uint64_t)(x[3] + offset[3]) * G[2] + x[2] + offset[2]) * G[1]
+			       + x[1] + offset[1]) * G[0] + x[0] + offset[0];
+	for (int dr=0; dr<4; ++dr) x[dr] += arg.border[dr]; // extended grid coordinates
+
+	for(int mu = 0; mu < 4; mu++){
+	  hostRNGState localState(seed, site, mu, stream);
+	  Link U = genGaussSU3<Float>(localState);
+	  arg.dataDs.save((Float*)(U.data), linkIndex(x,arg.E), mu, parity);
+	}
+      }
+    }
+  }
+
   template<typename Float, typename Gauge>
     class GaugeGauss : TunableVectorY {
       GaugeGaussArg<Gauge> arg;
       GaugeField &gf;
+      RNG &rngstate;
 
       private:
       unsigned int minThreads() const { return arg.threads; }
       bool tuneGridDim() const { return false; } // Don't tune the grid dimensions.
 
       public:
-      GaugeGauss(GaugeGaussArg<Gauge> &arg, GaugeField &gf)
-        : TunableVectorY(2), arg(arg), gf(gf){}
+      GaugeGauss(GaugeGaussArg<Gauge> &arg, GaugeField &gf, RNG &rngstate)
+        : TunableVectorY(2), arg(arg), gf(gf), rngstate(rngstate){}
       ~GaugeGauss () { }
 
       void apply(const cudaStream_t &stream){
@@ -123,7 +161,7 @@ namespace quda {
           computeGenGauss<Float><<<tp.grid,tp.block,tp.shared_bytes>>>(arg);
 	  cudaDeviceSynchronize();
         } else {
-          errorQuda("Randomize GaugeFields on CPU not supported yet\n");
+          computeGenGaussCPU<Float>(arg, rngstate.Seed(), rngstate.HostStream());
         }
       }
 
@@ -152,7 +190,7 @@ namespace quda {
   template<typename Float, typename Gauge>
   void genGauss(const Gauge dataDs, GaugeField& data, RNG &rngstate) {
       GaugeGaussArg<Gauge> arg(dataDs, data, rngstate);
-      GaugeGauss<Float,Gauge> gaugeGauss(arg, data);
+      GaugeGauss<Float,Gauge> gaugeGauss(arg, data, rngstate);
       gaugeGauss.apply(0);
 
     }
@@ -162,6 +200,34 @@ namespace quda {
   template<typename Float>
   void gaugeGauss(GaugeField &dataDs, RNG &rngstate) {
 
+      if(dataDs.Location() == QUDA_CPU_FIELD_LOCATION) {
+	  if(dataDs.Reconstruct() != QUDA_RECONSTRUCT_NO)
+	      errorQuda("Reconstruction type %d of host gauge field not supported", dataDs.Reconstruct());
+
+	  if(dataDs.Order() == QUDA_QDP_GAUGE_ORDER) {
+	      typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,3>::type Gauge;
+	      genGauss<Float>(Gauge(dataDs), dataDs, rngstate);
+	  }else if(dataDs.Order() == QUDA_QDPJIT_GAUGE_ORDER) {
+	      typedef typename gauge_order_mapper<Float,QUDA_QDPJIT_GAUGE_ORDER,3>::type Gauge;
+	      genGauss<Float>(Gauge(dataDs), dataDs, rngstate);
+	  }else if(dataDs.Order() == QUDA_MILC_GAUGE_ORDER) {
+	      typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,3>::type Gauge;
+	      genGauss<Float>(Gauge(dataDs), dataDs, rngstate);
+	  }else if(dataDs.Order() == QUDA_BQCD_GAUGE_ORDER) {
+	      typedef typename gauge_order_mapper<Float,QUDA_BQCD_GAUGE_ORDER,3>::type Gauge;
+	      genGauss<Float>(Gauge(dataDs), dataDs, rngstate);
+	  }else if(dataDs.Order() == QUDA_TIFR_GAUGE_ORDER) {
+	      typedef typename gauge_order_mapper<Float,QUDA_TIFR_GAUGE_ORDER,3>::type Gauge;
+	      genGauss<Float>(Gauge(dataDs), dataDs, rngstate);
+	  }else{
+	      errorQuda("Gauge order %d of host gauge field not supported", dataDs.Order());
+	  }
+	  return;
+      }
+
+      if (!dataDs.isNative())
+	  errorQuda("Order %d with %d reconstruct not supported", dataDs.Order(), dataDs.Reconstruct());
+
       if(dataDs.Reconstruct() == QUDA_RECONSTRUCT_NO) {
 	  typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type Gauge;
 	  genGauss<Float>(Gauge(dataDs), dataDs, rngstate);
@@ -187,9 +253,6 @@ namespace quda {
 	  errorQuda("Half precision not supported\n");
       }
 
-      if (!dataDs.isNative())
-	  errorQuda("Order %d with %d reconstruct not supported", dataDs.Order(), dataDs.Reconstruct());
-
       if (dataDs.Precision() == QUDA_SINGLE_PRECISION){
 	  gaugeGauss<float>(dataDs, rngstate);
       } else if(dataDs.Precision() == QUDA_DOUBLE_PRECISION) {
@@ -0,0 +1,158 @@
+#ifndef HOST_FFT_H
+#define HOST_FFT_H
+
+#include <vector>
+#include <cmath>
+#include <quda_internal.h>
+#include <complex_quda.h>
+
+#define HOST_FFT_FORWARD -1
+#define HOST_FFT_INVERSE  1
+
+namespace quda {
+
+  /**
+   * @brief Mixed-radix complex-to-complex FFT of a single line of
+   * host data.  The length is factorized into radix 4, 2, 3, 5 and any
+   * remaining odd factors, and each stage is a decimation-in-time
+   * radix-p butterfly, so any lattice extent is supported.  As with
+   * CUFFT the transform is unnormalized in both directions.
+   */
+  template <typename Float>
+  class HostFFT1D {
+    typedef complex<Float> Cmplx;
+
+    int n;
+    int max_radix;
+    std::vector<int> radix;     // radix of each stage
+    std::vector<int> length;    // remaining length after each stage
+    std::vector<Cmplx> twiddle; // exp(-2 pi i k / n)
+
+    void work(Cmplx *out, const Cmplx *in, const int fstride, const int stage, const int direction,
+              Cmplx *scratch) const {
+      const int p = radix[stage];
+      const int m = length[stage];
+
+      if ( m == 1 ) {
+        for ( int k = 0; k < p; k++ ) out[k] = in[k * fstride];
+      } else {
+        for ( int k = 0; k < p; k++ ) work(out + k * m, in + k * fstride, fstride * p, stage + 1, direction, scratch);
+      }
+
+      // generic radix-p butterfly, fstride * p * m == n
+      for ( int u = 0; u < m; u++ ) {
+        for ( int q = 0; q < p; q++ ) scratch[q] = out[u + q * m];
+        for ( int q1 = 0; q1 < p; q1++ ) {
+          const int k = u + q1 * m;
+          Cmplx sum = scratch[0];
+          int tw = 0;
+          for ( int q = 1; q < p; q++ ) {
+            tw += fstride * k;
+            if ( tw >= n ) tw -= n;
+            const Cmplx w = direction == HOST_FFT_FORWARD ? twiddle[tw] : conj(twiddle[tw]);
+            sum += scratch[q] * w;
+          }
+          out[k] = sum;
+        }
+      }
+    }
+
+  public:
+    HostFFT1D(const int n) : n(n), max_radix(1), twiddle(n) {
+      if ( n < 1 ) errorQuda("Invalid FFT length %d", n);
+      for ( int k = 0; k < n; k++ ) {
+        const double phase = -2.0 * M_PI * k / n;
+        twiddle[k] = Cmplx(cos(phase), sin(phase));
+      }
+
+      int len = n, p = 4;
+      while ( len > 1 ) {
+        while ( len % p ) {
+          switch ( p ) {
+          case 4: p = 2; break;
+          case 2: p = 3; break;
+          default: p += 2; break;
+          }
+          if ( p * p > len ) p = len;
+        }
+        len /= p;
+        radix.push_back(p);
+        length.push_back(len);
+        if ( p > max_radix ) max_radix = p;
+      }
+    }
+
+    /**
+     * @brief Size of the scratch buffer required by operator()
+     */
+    int ScratchSize() const { return max_radix; }
+
+    /**
+     * @brief Transform a single line
+     * @param[out] out, the transformed line (must not alias in)
+     * @param[in] in, the input line
+     * @param[in] direction, HOST_FFT_FORWARD or HOST_FFT_INVERSE
+     * @param[in] scratch, workspace of ScratchSize() elements
+     */
+    void operator()(Cmplx *out, const Cmplx *in, const int direction, Cmplx *scratch) const {
+      if ( n == 1 ) { out[0] = in[0]; return; }
+      work(out, in, 1, 0, direction, scratch);
+    }
+  };
+
+
+  /**
+   * @brief Four dimensional complex-to-complex FFT of host data in
+   * lexicographic order, x[0] running fastest.  The transform is
+   * applied in place one dimension at a time, with the lines of each
+   * dimension distributed over threads.  This is the host counterpart
+   * of the CUFFT plans in CUFFT_Plans.h.
+   */
+  template <typename Float>
+  class HostFFT4D {
+    typedef complex<Float> Cmplx;
+
+    int X[4];
+    int volume;
+    std::vector<HostFFT1D<Float> > fft;
+
+  public:
+    HostFFT4D(const int *X_) : volume(1) {
+      for ( int d = 0; d < 4; d++ ) {
+        X[d] = X_[d];
+        volume *= X[d];
+        fft.push_back(HostFFT1D<Float>(X[d]));
+      }
+    }
+
+    /**
+     * @brief Transform the field in place
+     * @param[in,out] data, the field of volume X[0]*X[1]*X[2]*X[3]
+     * @param[in] direction, HOST_FFT_FORWARD or HOST_FFT_INVERSE
+     */
+    void operator()(Cmplx *data, const int direction) const {
+      int stride = 1;
+      for ( int d = 0; d < 4; d++ ) {
+        const int n = X[d];
+        const int lines = volume / n;
+        if ( n > 1 ) {
+#pragma omp parallel
+          {
+            std::vector<Cmplx> in(n), out(n), scratch(fft[d].ScratchSize());
+#pragma omp for schedule(static)
+            for ( int l = 0; l < lines; l++ ) {
+              Cmplx *line = data + (size_t)(l / stride) * stride * n + l % stride;
+              for ( int i = 0; i < n; i++ ) in[i] = line[i * stride];
+              fft[d](out.data(), in.data(), direction, scratch.data());
+              for ( int i = 0; i < n; i++ ) line[i * stride] = out[i];
+            }
+          }
+        }
+        stride *= n;
+      }
+    }
+  };
+
+} // namespace quda
+
+#endif // HOST_FFT_H
@@ -131,6 +131,9 @@ cudaGaugeField *gaugeLongPrecondition = NULL;
 
 cudaGaugeField *gaugeSmeared = NULL;
 
+// bumped whenever the resident precise (fat) or long links are replaced or freed
+static uint64_t resident_gauge_generation = 0;
+
 cudaCloverField *cloverPrecise = NULL;
 cudaCloverField *cloverSloppy = NULL;
 cudaCloverField *cloverPrecondition = NULL;
@@ -635,6 +638,7 @@ void loadGaugeQuda(void *h_gauge, QudaGaugeParam *param)
     default:
       errorQuda("Invalid gauge type %d", param->type);
   }
+  resident_gauge_generation++;
 
   // if not preserving then copy the gauge field passed in
   cudaGaugeField *precise = NULL;
@@ -940,8 +944,15 @@ void loadCloverQuda(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param)
       profileClover.TPSTART(QUDA_PROFILE_TOTAL);
     }
 
+    // the host path of createCloverQuda inverts the clover term in the same pass
+    bool host_calc = device_calc && inv_param->clover_compute_location == QUDA_CPU_FIELD_LOCATION && cloverPrecise->V(true);
+    if (host_calc && inv_param->compute_clover_trlog) {
+      inv_param->trlogA[0] = cloverPrecise->TrLog()[0];
+      inv_param->trlogA[1] = cloverPrecise->TrLog()[1];
+    }
+
     // inverted clover term is required when applying preconditioned operator
-    if ((!h_clovinv || inv_param->compute_clover_inverse) && pc_solve) {
+    if ((!h_clovinv || inv_param->compute_clover_inverse) && pc_solve && !host_calc) {
       profileClover.TPSTART(QUDA_PROFILE_COMPUTE);
       if (!dynamic_clover) {
 	cloverInvert(*cloverPrecise, inv_param->compute_clover_trlog, QUDA_CUDA_FIELD_LOCATION);
@@ -1093,6 +1104,8 @@ void freeGaugeQuda(void)
   gaugeFatPrecise = NULL;
   gaugeFatExtended = NULL;
 
+  resident_gauge_generation++;
+
   if (gaugeSmeared) delete gaugeSmeared;
 
   gaugeSmeared = NULL;
@@ -1278,7 +1291,7 @@ void endQuda(void)
   if(momResident) delete momResident;
 
   LatticeField::freeGhostBuffer();
-  cpuColorSpinorField::freeGhostBuffer();
+  freeGhostFaceTables();
 
   blas::end();
 
@@ -1970,8 +1983,12 @@ void MatDagMatQuda(void *h_out, void *h_in, QudaInvertParam *inv_param)
 
 namespace quda{
 bool canReuseResidentGauge(QudaInvertParam *param){
+  if (param->dslash_type == QUDA_ASQTAD_DSLASH &&
+      (gaugeLongPrecise == NULL || param->cuda_prec != gaugeLongPrecise->Precision())) return false;
   return (gaugePrecise != NULL) and param->cuda_prec == gaugePrecise->Precision();
 }
+
+uint64_t residentGaugeGeneration() { return resident_gauge_generation; }
 }
 
 void checkClover(QudaInvertParam *param) {
@@ -2169,53 +2186,64 @@ void lanczosQuda(int k0, int m, void *hp_Apsi, void *hp_r, void *hp_V,
                              static_cast<ColorSpinorField*>(new cudaColorSpinorField(cpuParam));
 
   //Make Eigen vector data set
-  cpuColorSpinorField **h_Eig_Vec;
-  h_Eig_Vec =(cpuColorSpinorField **)safe_malloc( m*sizeof(cpuColorSpinorField*));
+  ColorSpinorField **h_Eig_Vec;
+  h_Eig_Vec =(ColorSpinorField **)safe_malloc( m*sizeof(ColorSpinorField*));
   for( int k = 0 ; k < m ; k++)
   {
     cpuParam.v = ((double**)hp_V)[k];
     h_Eig_Vec[k] = new cpuColorSpinorField(cpuParam);
   }
 
-  // download source
-  ColorSpinorParam cudaParam(cpuParam, *param);
-  cudaParam.create = QUDA_COPY_FIELD_CREATE;
-  r = new cudaColorSpinorField(*h_r, cudaParam);
-  Apsi = new cudaColorSpinorField(*h_Apsi, cudaParam);
+  // the Lanczos basis is kept on the host if requested, with the
+  // Ritz operator staging each vector through the device
+  const bool host_basis = eig_param->location == QUDA_CPU_FIELD_LOCATION &&
+    param->input_location == QUDA_CPU_FIELD_LOCATION;
 
-  double cpu;
-  double gpu;
+  ColorSpinorField **Eig_Vec = h_Eig_Vec;
 
-  if (getVerbosity() >= QUDA_VERBOSE) {
-    cpu = blas::norm2(*h_r);
-    gpu = blas::norm2(*r);
-    printfQuda("r vector CPU %1.14e CUDA %1.14e\n", cpu, gpu);
-    cpu = blas::norm2(*h_Apsi);
-    gpu = blas::norm2(*Apsi);
-    printfQuda("Apsi vector CPU %1.14e CUDA %1.14e\n", cpu, gpu);
-  }
+  if (!host_basis) {
+    // download source
+    ColorSpinorParam cudaParam(cpuParam, *param);
+    cudaParam.create = QUDA_COPY_FIELD_CREATE;
+    r = new cudaColorSpinorField(*h_r, cudaParam);
+    Apsi = new cudaColorSpinorField(*h_Apsi, cudaParam);
 
-  // download Eigen vector set
-  cudaColorSpinorField **Eig_Vec;
-  Eig_Vec = (cudaColorSpinorField **)safe_malloc( m*sizeof(cudaColorSpinorField*));
+    double cpu;
+    double gpu;
 
-  for( int k = 0 ; k < m ; k++)
-  {
-    Eig_Vec[k] = new cudaColorSpinorField(*h_Eig_Vec[k], cudaParam);
     if (getVerbosity() >= QUDA_VERBOSE) {
-      cpu = blas::norm2(*h_Eig_Vec[k]);
-      gpu = blas::norm2(*Eig_Vec[k]);
-      printfQuda("Eig_Vec[%d] CPU %1.14e CUDA %1.14e\n", k, cpu, gpu);
+      cpu = blas::norm2(*h_r);
+      gpu = blas::norm2(*r);
+      printfQuda("r vector CPU %1.14e CUDA %1.14e\n", cpu, gpu);
+      cpu = blas::norm2(*h_Apsi);
+      gpu = blas::norm2(*Apsi);
+      printfQuda("Apsi vector CPU %1.14e CUDA %1.14e\n", cpu, gpu);
+    }
+
+    // download Eigen vector set
+    Eig_Vec = (ColorSpinorField **)safe_malloc( m*sizeof(ColorSpinorField*));
+
+    for( int k = 0 ; k < m ; k++)
+    {
+      Eig_Vec[k] = new cudaColorSpinorField(*h_Eig_Vec[k], cudaParam);
+      if (getVerbosity() >= QUDA_VERBOSE) {
+        cpu = blas::norm2(*h_Eig_Vec[k]);
+        gpu = blas::norm2(*Eig_Vec[k]);
+        printfQuda("Eig_Vec[%d] CPU %1.14e CUDA %1.14e\n", k, cpu, gpu);
+      }
     }
   }
   profileInvert.TPSTOP(QUDA_PROFILE_H2D);
 
+  ColorSpinorField &r_ = host_basis ? *h_r : *r;
+  ColorSpinorField &Apsi_ = host_basis ? *h_Apsi : *Apsi;
+
   if(eig_param->RitzMat_lanczos == QUDA_MATPC_DAG_SOLUTION)
   {
     DiracMdag mat(dirac);
     RitzMat ritz_mat(mat,*eig_param);
     Eig_Solver *eig_solve = Eig_Solver::create(*eig_param, ritz_mat, profileInvert);
-    (*eig_solve)((double*)hp_alpha, (double*)hp_beta, Eig_Vec, *r, *Apsi, k0, m);
+    (*eig_solve)((double*)hp_alpha, (double*)hp_beta, Eig_Vec, r_, Apsi_, k0, m);
     delete eig_solve;
   }
   else if(eig_param->RitzMat_lanczos == QUDA_MATPCDAG_MATPC_SOLUTION)
@@ -2223,7 +2251,7 @@ void lanczosQuda(int k0, int m, void *hp_Apsi, void *hp_r, void *hp_V,
     DiracMdagM mat(dirac);
     RitzMat ritz_mat(mat,*eig_param);
     Eig_Solver *eig_solve = Eig_Solver::create(*eig_param, ritz_mat, profileInvert);
-    (*eig_solve)((double*)hp_alpha, (double*)hp_beta, Eig_Vec, *r, *Apsi, k0, m);
+    (*eig_solve)((double*)hp_alpha, (double*)hp_beta, Eig_Vec, r_, Apsi_, k0, m);
     delete eig_solve;
   }
   else if(eig_param->RitzMat_lanczos == QUDA_MATPCDAG_MATPC_SHIFT_SOLUTION)
@@ -2231,7 +2259,7 @@ void lanczosQuda(int k0, int m, void *hp_Apsi, void *hp_r, void *hp_V,
     DiracMdagM mat(dirac);
     RitzMat ritz_mat(mat,*eig_param);
     Eig_Solver *eig_solve = Eig_Solver::create(*eig_param, ritz_mat, profileInvert);
-    (*eig_solve)((double*)hp_alpha, (double*)hp_beta, Eig_Vec, *r, *Apsi, k0, m);
+    (*eig_solve)((double*)hp_alpha, (double*)hp_beta, Eig_Vec, r_, Apsi_, k0, m);
     delete eig_solve;
   }
   else
@@ -2240,25 +2268,26 @@ void lanczosQuda(int k0, int m, void *hp_Apsi, void *hp_r, void *hp_V,
     exit(0);
   }
 
-  //Write back calculated eigen vector
-  profileInvert.TPSTART(QUDA_PROFILE_D2H);
-  for( int k = 0 ; k < m ; k++)
-  {
-    *h_Eig_Vec[k] = *Eig_Vec[k];
-  }
-  *h_r = *r;
-  *h_Apsi = *Apsi;
-  profileInvert.TPSTOP(QUDA_PROFILE_D2H);
+  if (!host_basis) {
+    //Write back calculated eigen vector
+    profileInvert.TPSTART(QUDA_PROFILE_D2H);
+    for( int k = 0 ; k < m ; k++)
+    {
+      *h_Eig_Vec[k] = *Eig_Vec[k];
+    }
+    *h_r = *r;
+    *h_Apsi = *Apsi;
+    profileInvert.TPSTOP(QUDA_PROFILE_D2H);
 
+    delete r;
+    delete Apsi;
+    for( int k = 0 ; k < m ; k++) delete Eig_Vec[k];
+    host_free(Eig_Vec);
+  }
 
   delete h_r;
   delete h_Apsi;
-  for( int k = 0 ; k < m ; k++)
-  {
-    delete Eig_Vec[k];
-    delete h_Eig_Vec[k];
-  }
-  host_free(Eig_Vec);
+  for( int k = 0 ; k < m ; k++) delete h_Eig_Vec[k];
   host_free(h_Eig_Vec);
 
   delete d;
@@ -2439,10 +2468,18 @@ deflated_solver::deflated_solver(QudaEigParam &eig_param, TimeProfile &profile)
   ritzParam.is_composite  = true;
   ritzParam.is_component  = false;
   ritzParam.composite_dim = param->nev*param->deflation_grid;
-  ritzParam.setPrecision(param->cuda_prec_ritz);
+
+  // the deflation space may be stored compressed at a lower precision than it is applied in
+  const QudaPrecision ritz_storage_prec = eig_param.cuda_prec_ritz_storage != QUDA_INVALID_PRECISION ?
+    eig_param.cuda_prec_ritz_storage : param->cuda_prec_ritz;
+  if (ritz_storage_prec > param->cuda_prec_ritz)
+    errorQuda("Ritz storage precision %d exceeds the Ritz precision %d", ritz_storage_prec, param->cuda_prec_ritz);
+  if (ritz_storage_prec == QUDA_HALF_PRECISION && ritzParam.location == QUDA_CPU_FIELD_LOCATION)
+    errorQuda("Half precision Ritz storage is not supported on the host");
+  ritzParam.setPrecision(ritz_storage_prec);
 
   if (ritzParam.location==QUDA_CUDA_FIELD_LOCATION) {
-    ritzParam.fieldOrder = (param->cuda_prec_ritz == QUDA_DOUBLE_PRECISION ) ?  QUDA_FLOAT2_FIELD_ORDER : QUDA_FLOAT4_FIELD_ORDER;
+    ritzParam.fieldOrder = (ritz_storage_prec == QUDA_DOUBLE_PRECISION ) ?  QUDA_FLOAT2_FIELD_ORDER : QUDA_FLOAT4_FIELD_ORDER;
     if(ritzParam.nSpin != 1) ritzParam.gammaBasis = QUDA_UKQCD_GAMMA_BASIS;
 
     //select memory location here, by default ritz vectors will be allocated on the device
@@ -3177,8 +3214,12 @@ for(int i=0; i < param->num_src; i++) {
  * At present, the solution_type must be MATDAG_MAT or MATPCDAG_MATPC,
  * and solve_type must be NORMOP or NORMOP_PC.  The solution and solve
  * preconditioning have to match.
+ *
+ * The solution for source s and shift i is _hp_x[s*num_offset + i].
+ * With more than one source, the pipelined multi-shift CG advances
+ * all sources in lockstep.
  */
-void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
+static void invertMultiShiftMultiSrc(void **_hp_x, void **_hp_b, int num_src, QudaInvertParam *param)
 {
 
   profileMulti.TPSTART(QUDA_PROFILE_TOTAL);
@@ -3247,11 +3288,11 @@ void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
   }
 
   // Host pointers for x, take a copy of the input host pointers
+  const int num_x = num_src * param->num_offset;
   void** hp_x;
-  hp_x = new void* [ param->num_offset ];
+  hp_x = new void* [ num_x ];
 
-  void* hp_b = _hp_b;
-  for(int i=0;i < param->num_offset;i++){
+  for(int i=0;i < num_x;i++){
     hp_x[i] = _hp_x[i];
   }
 
@@ -3276,9 +3317,9 @@ void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
   Dirac &dirac = *d;
   Dirac &diracSloppy = *dSloppy;
 
-  cudaColorSpinorField *b = NULL;   // Cuda RHS
-  std::vector<ColorSpinorField*> x;  // Cuda Solutions
-  x.resize(param->num_offset);
+  std::vector<ColorSpinorField*> b(num_src);   // Cuda RHS
+  std::vector<std::vector<ColorSpinorField*> > x(num_src);  // Cuda Solutions
+  for (int s=0; s<num_src; s++) x[s].resize(param->num_offset);
 
   // Grab the dimension array of the input gauge field.
   const int *X = ( param->dslash_type == QUDA_ASQTAD_DSLASH ) ?
@@ -3289,14 +3330,18 @@ void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
   // the solution is on a checkerboard instruction or not. These can
   // then be used as 'instructions' to create the actual
   // ColorSpinorField
-  ColorSpinorParam cpuParam(hp_b, *param, X, pc_solution, param->input_location);
-  ColorSpinorField *h_b = ColorSpinorField::Create(cpuParam);
+  ColorSpinorParam cpuParam(_hp_b[0], *param, X, pc_solution, param->input_location);
+  std::vector<ColorSpinorField*> h_b(num_src);
+  for (int s=0; s<num_src; s++) {
+    cpuParam.v = _hp_b[s];
+    h_b[s] = ColorSpinorField::Create(cpuParam);
+  }
 
   std::vector<ColorSpinorField*> h_x;
-  h_x.resize(param->num_offset);
+  h_x.resize(num_x);
 
   cpuParam.location = param->output_location;
-  for(int i=0; i < param->num_offset; i++) {
+  for(int i=0; i < num_x; i++) {
     cpuParam.v = hp_x[i];
     h_x[i] = ColorSpinorField::Create(cpuParam);
   }
@@ -3307,7 +3352,8 @@ void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
   ColorSpinorParam cudaParam(cpuParam, *param);
   // This setting will download a host vector
   cudaParam.create = QUDA_COPY_FIELD_CREATE;
-  b = new cudaColorSpinorField(*h_b, cudaParam); // Creates b and downloads h_b to it
+  for (int s=0; s<num_src; s++)
+    b[s] = new cudaColorSpinorField(*h_b[s], cudaParam); // Creates b and downloads h_b to it
   profileMulti.TPSTOP(QUDA_PROFILE_H2D);
 
   profileMulti.TPSTART(QUDA_PROFILE_INIT);
@@ -3325,10 +3371,11 @@ void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
   }
 
   // grow resident solutions to be big enough
-  for (int i=solutionResident.size(); i < param->num_offset; i++) {
+  for (int i=solutionResident.size(); i < num_x; i++) {
     solutionResident.push_back(new cudaColorSpinorField(cudaParam));
   }
-  for (int i=0; i < param->num_offset; i++) x[i] = solutionResident[i];
+  for (int s=0; s<num_src; s++)
+    for (int i=0; i < param->num_offset; i++) x[s][i] = solutionResident[s*param->num_offset + i];
 
   profileMulti.TPSTOP(QUDA_PROFILE_INIT);
 
@@ -3336,20 +3383,27 @@ void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
   profileMulti.TPSTART(QUDA_PROFILE_PREAMBLE);
 
   // Check source norms
-  double nb = blas::norm2(*b);
-  if (nb==0.0) errorQuda("Source has zero norm");
+  std::vector<double> nb(num_src);
+  double offset[QUDA_MAX_MULTI_SHIFT];
+  for (int i=0; i < param->num_offset; i++) offset[i] = param->offset[i];
+  for (int s=0; s<num_src; s++) {
+    nb[s] = blas::norm2(*b[s]);
+    if (nb[s]==0.0) errorQuda("Source %d has zero norm", s);
+
+    if(getVerbosity() >= QUDA_VERBOSE ) {
+      double nh_b = blas::norm2(*h_b[s]);
+      printfQuda("Source %d: CPU = %g, CUDA copy = %g\n", s, nh_b, nb[s]);
+    }
 
-  if(getVerbosity() >= QUDA_VERBOSE ) {
-    double nh_b = blas::norm2(*h_b);
-    printfQuda("Source: CPU = %g, CUDA copy = %g\n", nh_b, nb);
-  }
+    // rescale the source vector to help prevent the onset of underflow
+    if (param->solver_normalization == QUDA_SOURCE_NORMALIZATION) {
+      blas::ax(1.0/sqrt(nb[s]), *b[s]);
+    }
 
-  // rescale the source vector to help prevent the onset of underflow
-  if (param->solver_normalization == QUDA_SOURCE_NORMALIZATION) {
-    blas::ax(1.0/sqrt(nb), *b);
+    // massRescale also rescales the shifts, so restore them before rescaling further sources
+    if (s > 0) for (int i=0; i < param->num_offset; i++) param->offset[i] = offset[i];
+    massRescale(*static_cast<cudaColorSpinorField*>(b[s]), *param);
   }
-
-  massRescale(*b, *param);
   profileMulti.TPSTOP(QUDA_PROFILE_PREAMBLE);
 
   // use multi-shift CG
@@ -3357,7 +3411,8 @@ void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
     DiracMdagM m(dirac), mSloppy(diracSloppy);
     SolverParam solverParam(*param);
     MultiShiftCG cg_m(m, mSloppy, solverParam, profileMulti);
-    cg_m(x, *b);
+    if (num_src == 1) cg_m(x[0], *b[0]);
+    else cg_m(x, b);
     solverParam.updateInvertParam(*param);
   }
 
@@ -3365,7 +3420,7 @@ void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
     // check each shift has the desired tolerance and use sequential CG to refine
     profileMulti.TPSTART(QUDA_PROFILE_INIT);
     cudaParam.create = QUDA_ZERO_FIELD_CREATE;
-    cudaColorSpinorField r(*b, cudaParam);
+    cudaColorSpinorField r(*b[0], cudaParam);
     profileMulti.TPSTOP(QUDA_PROFILE_INIT);
 
 #define REFINE_INCREASING_MASS
@@ -3411,56 +3466,73 @@ void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
 	  mSloppy.shift = param->offset[i];
 	}
 
-	if (0) { // experimenting with Minimum residual extrapolation
-	  // only perform MRE using current and previously refined solutions
+	double true_res = 0.0, true_res_hq = 0.0, secs = 0.0, gflops = 0.0;
+	int iter = 0;
+	for (int s=0; s<num_src; s++) {
+	  if (0) { // experimenting with Minimum residual extrapolation
+	    // only perform MRE using current and previously refined solutions
 #ifdef REFINE_INCREASING_MASS
-	  const int nRefine = i+1;
+	    const int nRefine = i+1;
 #else
-	  const int nRefine = param->num_offset - i + 1;
+	    const int nRefine = param->num_offset - i + 1;
 #endif
 
-	  std::vector<ColorSpinorField*> q;
-	  q.resize(nRefine);
-	  std::vector<ColorSpinorField*> z;
-	  z.resize(nRefine);
-	  cudaParam.create = QUDA_NULL_FIELD_CREATE;
-	  cudaColorSpinorField tmp(cudaParam);
+	    std::vector<ColorSpinorField*> q;
+	    q.resize(nRefine);
+	    std::vector<ColorSpinorField*> z;
+	    z.resize(nRefine);
+	    cudaParam.create = QUDA_NULL_FIELD_CREATE;
+	    cudaColorSpinorField tmp(cudaParam);
 
-	  for(int j=0; j < nRefine; j++) {
-	    q[j] = new cudaColorSpinorField(cudaParam);
-	    z[j] = new cudaColorSpinorField(cudaParam);
-	  }
+	    for(int j=0; j < nRefine; j++) {
+	      q[j] = new cudaColorSpinorField(cudaParam);
+	      z[j] = new cudaColorSpinorField(cudaParam);
+	    }
 
-	  *z[0] = *x[0]; // zero solution already solved
+	    *z[0] = *x[s][0]; // zero solution already solved
 #ifdef REFINE_INCREASING_MASS
-	  for (int j=1; j<nRefine; j++) *z[j] = *x[j];
+	    for (int j=1; j<nRefine; j++) *z[j] = *x[s][j];
 #else
-	  for (int j=1; j<nRefine; j++) *z[j] = *x[param->num_offset-j];
+	    for (int j=1; j<nRefine; j++) *z[j] = *x[s][param->num_offset-j];
 #endif
 
-	  bool orthogonal = true;
-	  bool apply_mat = true;
-	  MinResExt mre(m, orthogonal, apply_mat, profileMulti);
-	  blas::copy(tmp, *b);
-	  mre(*x[i], tmp, z, q);
+	    bool orthogonal = true;
+	    bool apply_mat = true;
+	    MinResExt mre(m, orthogonal, apply_mat, profileMulti);
+	    blas::copy(tmp, *b[s]);
+	    mre(*x[s][i], tmp, z, q);
 
-	  for(int j=0; j < nRefine; j++) {
-	    delete q[j];
-	    delete z[j];
+	    for(int j=0; j < nRefine; j++) {
+	      delete q[j];
+	      delete z[j];
+	    }
 	  }
-	}
 
-	SolverParam solverParam(*param);
-	solverParam.iter = 0;
-	solverParam.use_init_guess = QUDA_USE_INIT_GUESS_YES;
-	solverParam.tol = (param->tol_offset[i] > 0.0 ?  param->tol_offset[i] : iter_tol); // set L2 tolerance
-	solverParam.tol_hq = param->tol_hq_offset[i]; // set heavy quark tolerance
+	  SolverParam solverParam(*param);
+	  solverParam.iter = 0;
+	  solverParam.use_init_guess = QUDA_USE_INIT_GUESS_YES;
+	  solverParam.tol = (param->tol_offset[i] > 0.0 ?  param->tol_offset[i] : iter_tol); // set L2 tolerance
+	  solverParam.tol_hq = param->tol_hq_offset[i]; // set heavy quark tolerance
+
+	  CG cg(m, mSloppy, solverParam, profileMulti);
+	  cg(*x[s][i], *b[s]);
 
-	CG cg(m, mSloppy, solverParam, profileMulti);
-	cg(*x[i], *b);
+	  true_res = std::max(true_res, solverParam.true_res);
+	  true_res_hq = std::max(true_res_hq, solverParam.true_res_hq);
+	  iter += solverParam.iter;
+	  secs += solverParam.secs;
+	  gflops += solverParam.gflops;
+	}
 
-	solverParam.true_res_offset[i] = solverParam.true_res;
-	solverParam.true_res_hq_offset[i] = solverParam.true_res_hq;
+	// report the worst residual over the sources
+	SolverParam solverParam(*param);
+	solverParam.iter = iter;
+	solverParam.secs = secs;
+	solverParam.gflops = gflops;
+	solverParam.true_res = true_res;
+	solverParam.true_res_hq = true_res_hq;
+	solverParam.true_res_offset[i] = true_res;
+	solverParam.true_res_hq_offset[i] = true_res_hq;
 	solverParam.updateInvertParam(*param,i);
 
 	if (param->dslash_type == QUDA_ASQTAD_DSLASH ||
@@ -3482,22 +3554,25 @@ void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
 
   if (param->compute_action) {
     Complex action(0);
-    for (int i=0; i<param->num_offset; i++) action += param->residue[i] * blas::cDotProduct(*b, *x[i]);
+    for (int s=0; s<num_src; s++)
+      for (int i=0; i<param->num_offset; i++) action += param->residue[i] * blas::cDotProduct(*b[s], *x[s][i]);
     param->action[0] = action.real();
     param->action[1] = action.imag();
   }
 
-  for(int i=0; i < param->num_offset; i++) {
-    if (param->solver_normalization == QUDA_SOURCE_NORMALIZATION) { // rescale the solution
-      blas::ax(sqrt(nb), *x[i]);
-    }
+  for (int s=0; s<num_src; s++) {
+    for(int i=0; i < param->num_offset; i++) {
+      if (param->solver_normalization == QUDA_SOURCE_NORMALIZATION) { // rescale the solution
+	blas::ax(sqrt(nb[s]), *x[s][i]);
+      }
 
-    if (getVerbosity() >= QUDA_VERBOSE){
-      double nx = blas::norm2(*x[i]);
-      printfQuda("Solution %d = %g\n", i, nx);
-    }
+      if (getVerbosity() >= QUDA_VERBOSE){
+	double nx = blas::norm2(*x[s][i]);
+	printfQuda("Solution %d = %g\n", s*param->num_offset + i, nx);
+      }
 
-    if (!param->make_resident_solution) *h_x[i] = *x[i];
+      if (!param->make_resident_solution) *h_x[s*param->num_offset + i] = *x[s][i];
+    }
   }
   profileMulti.TPSTOP(QUDA_PROFILE_D2H);
 
@@ -3511,13 +3586,15 @@ void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
   profileMulti.TPSTOP(QUDA_PROFILE_EPILOGUE);
 
   profileMulti.TPSTART(QUDA_PROFILE_FREE);
-  for(int i=0; i < param->num_offset; i++){
+  for(int i=0; i < num_x; i++){
     delete h_x[i];
     //if (!param->make_resident_solution) delete x[i];
   }
 
-  delete h_b;
-  delete b;
+  for (int s=0; s<num_src; s++) {
+    delete h_b[s];
+    delete b[s];
+  }
 
   delete [] hp_x;
 
@@ -3534,6 +3611,17 @@ void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
   profileMulti.TPSTOP(QUDA_PROFILE_TOTAL);
 }
 
+void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
+{
+  invertMultiShiftMultiSrc(_hp_x, &_hp_b, 1, param);
+}
+
+void invertMultiSrcMultiShiftQuda(void **_hp_x, void **_hp_b, QudaInvertParam *param)
+{
+  if (param->num_src < 1) errorQuda("Invalid number of sources %d", param->num_src);
+  invertMultiShiftMultiSrc(_hp_x, _hp_b, param->num_src, param);
+}
+
 void computeKSLinkQuda(void* fatlink, void* longlink, void* ulink, void* inlink, double *path_coeff, QudaGaugeParam *param) {
 
 #ifdef GPU_FATLINK
@@ -3708,7 +3796,8 @@ int computeGaugeForceQuda(void* mom, void* siteLink,  int*** input_path_buf, int
 
   // actually do the computation
   profileGaugeForce.TPSTART(QUDA_PROFILE_COMPUTE);
-  gaugeForce(*cudaMom, *cudaGauge, eb3, input_path_buf,  path_length, loop_coeff, num_paths, max_length);
+  gaugeForce(*cudaMom, *cudaGauge, eb3, input_path_buf,  path_length, loop_coeff, num_paths, max_length,
+	     qudaGaugeParam->force_compute_location);
   profileGaugeForce.TPSTOP(QUDA_PROFILE_COMPUTE);
 
   if (qudaGaugeParam->return_result_mom) {
@@ -3721,6 +3810,7 @@ int computeGaugeForceQuda(void* mom, void* siteLink,  int*** input_path_buf, int
   if (qudaGaugeParam->make_resident_gauge) {
     if (gaugePrecise && gaugePrecise != cudaSiteLink) delete gaugePrecise;
     gaugePrecise = cudaSiteLink;
+    resident_gauge_generation++;
   } else {
     delete cudaSiteLink;
   }
@@ -3774,7 +3864,15 @@ void createCloverQuda(QudaInvertParam* invertParam)
 
   profileClover.TPSTART(QUDA_PROFILE_COMPUTE);
   computeFmunu(Fmunu, *gauge, QUDA_CUDA_FIELD_LOCATION);
-  computeClover(*cloverPrecise, Fmunu, invertParam->clover_coeff, QUDA_CUDA_FIELD_LOCATION);
+  if (invertParam->clover_compute_location == QUDA_CPU_FIELD_LOCATION && cloverPrecise->V(true)) {
+    // construct and invert each chiral block in a single threaded pass on the host
+    computeCloverAndInvert(*cloverPrecise, Fmunu, invertParam->clover_coeff, invertParam->compute_clover_trlog,
+			   QUDA_CPU_FIELD_LOCATION);
+  } else {
+    if (invertParam->clover_compute_location == QUDA_CPU_FIELD_LOCATION)
+      warningQuda("Host clover computation requires an allocated inverse, computing on the device");
+    computeClover(*cloverPrecise, Fmunu, invertParam->clover_coeff, QUDA_CUDA_FIELD_LOCATION);
+  }
   profileClover.TPSTOP(QUDA_PROFILE_COMPUTE);
 
   profileClover.TPSTOP(QUDA_PROFILE_TOTAL);
@@ -4730,6 +4828,7 @@ void updateGaugeFieldQuda(void* gauge,
     if (!gaugePrecise) errorQuda("No resident gauge field allocated");
     cudaInGauge = gaugePrecise;
     gaugePrecise = NULL;
+    resident_gauge_generation++;
   }
 
   if (!param->use_resident_mom) {
@@ -4759,6 +4858,7 @@ void updateGaugeFieldQuda(void* gauge,
   if (param->make_resident_gauge) {
     if (gaugePrecise != NULL) delete gaugePrecise;
     gaugePrecise = cudaOutGauge;
+    resident_gauge_generation++;
   } else {
     delete cudaOutGauge;
   }
@@ -4828,6 +4928,7 @@ void updateGaugeFieldQuda(void* gauge,
    if (param->make_resident_gauge) {
      if (gaugePrecise != NULL && cudaGauge != gaugePrecise) delete gaugePrecise;
      gaugePrecise = cudaGauge;
+     resident_gauge_generation++;
    } else {
      delete cudaGauge;
    }
@@ -4882,6 +4983,7 @@ void updateGaugeFieldQuda(void* gauge,
    if (param->make_resident_gauge) {
      if (gaugePrecise != NULL && cudaGauge != gaugePrecise) delete gaugePrecise;
      gaugePrecise = cudaGauge;
+     resident_gauge_generation++;
    } else {
      delete cudaGauge;
    }
@@ -5333,6 +5435,98 @@ void performWuppertalnStep(void *h_out, void *h_in, QudaInvertParam *inv_param,
   profileWuppertal.TPSTOP(QUDA_PROFILE_TOTAL);
 }
 
+void performWuppertalnStepMulti(void **h_out, void **h_in, int nVec, QudaInvertParam *inv_param,
+                                unsigned int nSteps, double alpha)
+{
+  profileWuppertal.TPSTART(QUDA_PROFILE_TOTAL);
+
+  if (gaugePrecise == NULL) errorQuda("Gauge field must be loaded");
+
+  pushVerbosity(inv_param->verbosity);
+  if (getVerbosity() >= QUDA_DEBUG_VERBOSE) printQudaInvertParam(inv_param);
+
+  cudaGaugeField *precise = NULL;
+
+  if (gaugeSmeared != NULL) {
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("Wuppertal smearing done with gaugeSmeared\n");
+    GaugeFieldParam gParam(*gaugePrecise);
+    gParam.create = QUDA_NULL_FIELD_CREATE;
+    precise = new cudaGaugeField(gParam);
+    copyExtendedGauge(*precise, *gaugeSmeared, QUDA_CUDA_FIELD_LOCATION);
+  } else {
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("Wuppertal smearing done with gaugePrecise\n");
+    precise = gaugePrecise;
+  }
+
+  profileWuppertal.TPSTART(QUDA_PROFILE_H2D);
+
+  // the batched step runs on the host, so stage the links there with their backward ghost zone
+  GaugeFieldParam gParam(*precise);
+  gParam.create = QUDA_NULL_FIELD_CREATE;
+  gParam.order = QUDA_QDP_GAUGE_ORDER;
+  gParam.reconstruct = QUDA_RECONSTRUCT_NO;
+  gParam.pad = 0;
+  gParam.ghostExchange = QUDA_GHOST_EXCHANGE_PAD;
+  cpuGaugeField cpuGauge(gParam);
+  precise->saveCPUField(cpuGauge);
+  cpuGauge.exchangeGhost();
+
+  if (gaugeSmeared != NULL) delete precise;
+
+  ColorSpinorParam cpuParam(h_in[0], *inv_param, cpuGauge.X(), 0, inv_param->input_location);
+  ColorSpinorParam hostParam(cpuParam);
+  hostParam.location = QUDA_CPU_FIELD_LOCATION;
+  hostParam.create = QUDA_NULL_FIELD_CREATE;
+  hostParam.precision = cpuGauge.Precision();
+  hostParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  hostParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+
+  std::vector<ColorSpinorField*> in, out;
+  for (int i=0; i<nVec; i++) {
+    cpuParam.v = h_in[i];
+    ColorSpinorField *in_h = ColorSpinorField::Create(cpuParam);
+    in.push_back(new cpuColorSpinorField(hostParam));
+    out.push_back(new cpuColorSpinorField(hostParam));
+    *in[i] = *in_h;
+    delete in_h;
+  }
+
+  profileWuppertal.TPSTOP(QUDA_PROFILE_H2D);
+
+  profileWuppertal.TPSTART(QUDA_PROFILE_COMPUTE);
+  int parity = 0;
+
+  for (unsigned int i=0; i<nSteps; i++) {
+    if (i) std::swap(in, out);
+    wuppertalStep(out, in, parity, cpuGauge, alpha);
+    if (getVerbosity() >= QUDA_DEBUG_VERBOSE) {
+      for (int j=0; j<nVec; j++) printfQuda("Step %d, vector %d norm %e\n", i, j, blas::norm2(*out[j]));
+    }
+  }
+  profileWuppertal.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+  profileWuppertal.TPSTART(QUDA_PROFILE_D2H);
+  cpuParam.location = inv_param->output_location;
+  for (int i=0; i<nVec; i++) {
+    cpuParam.v = h_out[i];
+    ColorSpinorField *out_h = ColorSpinorField::Create(cpuParam);
+    *out_h = *out[i];
+    delete out_h;
+  }
+  profileWuppertal.TPSTOP(QUDA_PROFILE_D2H);
+
+  for (int i=0; i<nVec; i++) {
+    delete in[i];
+    delete out[i];
+  }
+
+  popVerbosity();
+
+  profileWuppertal.TPSTOP(QUDA_PROFILE_TOTAL);
+}
+
 void performAPEnStep(unsigned int nSteps, double alpha)
 {
   profileAPE.TPSTART(QUDA_PROFILE_TOTAL);
@@ -5507,6 +5701,7 @@ int computeGaugeFixingOVRQuda(void* gauge, const unsigned int gauge_dir,  const
   if (param->make_resident_gauge) {
     if (gaugePrecise != NULL) delete gaugePrecise;
     gaugePrecise = cudaInGauge;
+    resident_gauge_generation++;
   } else {
     delete cudaInGauge;
   }
@@ -5584,6 +5779,7 @@ int computeGaugeFixingFFTQuda(void* gauge, const unsigned int gauge_dir,  const
   if (param->make_resident_gauge) {
     if (gaugePrecise != NULL) delete gaugePrecise;
     gaugePrecise = cudaInGauge;
+    resident_gauge_generation++;
   } else {
     delete cudaInGauge;
   }
@@ -5632,6 +5828,26 @@ void contract(const cudaColorSpinorField x, const cudaColorSpinorField y, void *
   }
 }
 
+void contractMomentumQuda(void *h_result, void *h_x, void *h_y, const int *mom, int n_mom, QudaInvertParam *inv_param)
+{
+  if (gaugePrecise == NULL) errorQuda("Gauge field must be loaded");
+
+  pushVerbosity(inv_param->verbosity);
+  if (getVerbosity() >= QUDA_DEBUG_VERBOSE) printQudaInvertParam(inv_param);
+
+  ColorSpinorParam cpuParam(h_x, *inv_param, gaugePrecise->X(), false, QUDA_CPU_FIELD_LOCATION);
+  cpuColorSpinorField x(cpuParam);
+  cpuParam.v = h_y;
+  cpuColorSpinorField y(cpuParam);
+
+  std::vector<int> momenta(mom, mom + 3*n_mom);
+  std::vector<Complex> result;
+  contractMomentumProject(result, x, y, momenta, QUDA_INVALID_PARITY, profileContract);
+  memcpy(h_result, result.data(), result.size()*sizeof(Complex));
+
+  popVerbosity();
+}
+
 double qChargeCuda ()
 {
   profileQCharge.TPSTART(QUDA_PROFILE_TOTAL);
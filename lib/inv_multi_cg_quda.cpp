@@ -158,6 +158,13 @@ namespace quda {
     if (checkLocation(*(x[0]), b) != QUDA_CUDA_FIELD_LOCATION)
       errorQuda("Not supported");
 
+    if (param.multishift_pipeline) {
+      std::vector<std::vector<ColorSpinorField*> > x_(1, x);
+      std::vector<ColorSpinorField*> b_(1, &b);
+      pipelinedSolve(x_, b_);
+      return;
+    }
+
     profile.TPSTART(QUDA_PROFILE_INIT);
 
     int num_offset = param.num_offset;
@@ -552,4 +559,430 @@ namespace quda {
     return;
   }
 
+  /**
+     Apply the operator including the shift of the unshifted system,
+     which for staggered fermions is already folded into the mass
+   */
+  static void applyShifted(const DiracMatrix &mat, ColorSpinorField &out, ColorSpinorField &in,
+			   ColorSpinorField &tmp1, ColorSpinorField &tmp2, double shift)
+  {
+    mat(out, in, tmp1, tmp2);
+    if (in.Nspin()==4) blas::axpy(shift, in, out);
+  }
+
+  void MultiShiftCG::operator()(std::vector<std::vector<ColorSpinorField*> > x, std::vector<ColorSpinorField*> b)
+  {
+    if (x.size() != b.size()) errorQuda("Number of solution sets %lu does not match number of sources %lu", x.size(), b.size());
+    for (unsigned int s=0; s<b.size(); s++)
+      if (checkLocation(*(x[s][0]), *(b[s])) != QUDA_CUDA_FIELD_LOCATION)
+	errorQuda("Not supported");
+
+    pipelinedSolve(x, b);
+  }
+
+  void MultiShiftCG::pipelinedSolve(std::vector<std::vector<ColorSpinorField*> > &x, std::vector<ColorSpinorField*> &b)
+  {
+    profile.TPSTART(QUDA_PROFILE_INIT);
+
+    const int num_offset = param.num_offset;
+    const double *offset = param.offset;
+    const int n_src = b.size();
+
+    if (num_offset == 0) {
+      profile.TPSTOP(QUDA_PROFILE_INIT);
+      return;
+    }
+
+    // this is the limit of precision possible
+    const double prec_tol = pow(10.,(-2*(int)b[0]->Precision()+1));
+
+    // flag whether we will be using reliable updates or not
+    bool reliable = false;
+    for (int j=0; j<num_offset; j++)
+      if (param.tol_offset[j] < param.delta) reliable = true;
+
+    // scalars of each source, indexed by s*num_offset + j
+    std::vector<double> zeta(n_src*num_offset, 1.0);
+    std::vector<double> zeta_old(n_src*num_offset, 1.0);
+    std::vector<double> alpha(n_src*num_offset, 1.0);
+    std::vector<double> beta(n_src*num_offset, 0.0);
+    std::vector<double> r2(n_src*num_offset);
+    std::vector<double> stop(n_src*num_offset);
+    std::vector<int> iter(n_src*(num_offset+1), 0); // record how many iterations for each shift
+    std::vector<int> num_offset_now(n_src, num_offset);
+
+    std::vector<double> b2(n_src);
+    std::vector<double> r2_old(n_src);
+    std::vector<double> r0Norm(n_src), maxrx(n_src), maxrr(n_src);
+    std::vector<int> resIncrease(n_src, 0), resIncreaseTotal(n_src, 0);
+    std::vector<bool> active(n_src, true);
+
+    ColorSpinorParam csParam(*b[0]);
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+
+    std::vector<ColorSpinorField*> r(n_src);
+    std::vector<std::vector<ColorSpinorField*> > y(n_src);
+    for (int s=0; s<n_src; s++) {
+      r[s] = new cudaColorSpinorField(*b[s]);
+      if (reliable)
+	for (int j=0; j<num_offset; j++) y[s].push_back(new cudaColorSpinorField(*r[s], csParam));
+    }
+
+    // high-precision temporaries for the true residual
+    cudaColorSpinorField tmpH1(*r[0], csParam);
+    cudaColorSpinorField *tmpH2_p = !mat.isStaggered() ? new cudaColorSpinorField(*r[0], csParam) : &tmpH1;
+    cudaColorSpinorField &tmpH2 = *tmpH2_p;
+
+    csParam.setPrecision(param.precision_sloppy);
+
+    std::vector<ColorSpinorField*> r_sloppy(n_src);
+    std::vector<std::vector<ColorSpinorField*> > x_sloppy(n_src);
+    std::vector<std::vector<ColorSpinorField*> > p(n_src);
+    std::vector<ColorSpinorField*> Ar(n_src), AAr(n_src), Ap(n_src), AAp(n_src);
+
+    for (int s=0; s<n_src; s++) {
+      if (param.precision_sloppy == x[s][0]->Precision()) {
+	r_sloppy[s] = r[s];
+      } else {
+	csParam.create = QUDA_COPY_FIELD_CREATE;
+	r_sloppy[s] = new cudaColorSpinorField(*r[s], csParam);
+      }
+
+      x_sloppy[s].resize(num_offset);
+      if (param.precision_sloppy == x[s][0]->Precision() ||
+	  !param.use_sloppy_partial_accumulator) {
+	for (int j=0; j<num_offset; j++) {
+	  x_sloppy[s][j] = x[s][j];
+	  blas::zero(*x_sloppy[s][j]);
+	}
+      } else {
+	csParam.create = QUDA_ZERO_FIELD_CREATE;
+	for (int j=0; j<num_offset; j++)
+	  x_sloppy[s][j] = new cudaColorSpinorField(*x[s][j], csParam);
+      }
+
+      for (int j=0; j<num_offset; j++) p[s].push_back(new cudaColorSpinorField(*r_sloppy[s]));
+
+      csParam.create = QUDA_ZERO_FIELD_CREATE;
+      Ar[s] = new cudaColorSpinorField(*r_sloppy[s], csParam);
+      AAr[s] = new cudaColorSpinorField(*r_sloppy[s], csParam);
+      Ap[s] = new cudaColorSpinorField(*r_sloppy[s], csParam);
+      AAp[s] = new cudaColorSpinorField(*r_sloppy[s], csParam);
+    }
+
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+    cudaColorSpinorField tmp1(*Ar[0], csParam);
+
+    // tmp2 only needed for multi-gpu Wilson-like kernels
+    cudaColorSpinorField *tmp2_p = !mat.isStaggered() ?
+      new cudaColorSpinorField(*Ar[0], csParam) : &tmp1;
+    cudaColorSpinorField &tmp2 = *tmp2_p;
+
+    // the inner products of all sources are reduced in a single message
+    std::vector<double> reduce(2*n_src, 0.0);
+    ReduceHandle *rh = comm_declare_allreduce();
+
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+    profile.TPSTART(QUDA_PROFILE_PREAMBLE);
+
+    for (int s=0; s<n_src; s++) {
+      b2[s] = blas::norm2(*b[s]);
+      // Check to see that we're not trying to invert on a zero-field source
+      if (b2[s] == 0) {
+	printfQuda("Warning: inverting on zero-field source %d\n", s);
+	for (int j=0; j<num_offset; j++) blas::zero(*x_sloppy[s][j]);
+	active[s] = false;
+      }
+
+      for (int j=0; j<num_offset; j++) {
+	r2[s*num_offset+j] = b2[s];
+	stop[s*num_offset+j] = Solver::stopping(param.tol_offset[j], b2[s], param.residual_type);
+      }
+      // this initial condition ensures that the heaviest shift can be removed
+      iter[s*(num_offset+1)+num_offset] = 1;
+
+      r0Norm[s] = sqrt(b2[s]);
+      maxrx[s] = r0Norm[s];
+      maxrr[s] = r0Norm[s];
+
+      if (active[s]) applyShifted(matSloppy, *Ar[s], *r_sloppy[s], tmp1, tmp2, offset[0]);
+    }
+
+    const double delta = param.delta;
+
+    // this parameter determines how many consective reliable update
+    // reisudal increases we tolerate before terminating the solver,
+    // i.e., how long do we want to keep trying to converge
+    const int maxResIncrease =  param.max_res_increase; // check if we reached the limit of our tolerance
+    const int maxResIncreaseTotal = param.max_res_increase_total;
+
+    int k = 0;
+    int rUpdate = 0;
+    blas::flops = 0;
+
+    profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+
+    while (k < param.maxiter) {
+
+      // local inner products, whose global sum overlaps with the operator
+      commGlobalReductionSet(false);
+      for (int s=0; s<n_src; s++) {
+	if (!active[s]) continue;
+	double3 rAr = blas::cDotProductNormA(*r_sloppy[s], *Ar[s]);
+	reduce[2*s+0] = rAr.z;
+	reduce[2*s+1] = rAr.x;
+      }
+      commGlobalReductionSet(true);
+
+      comm_allreduce_append(rh, reduce.data(), 2*n_src);
+      comm_allreduce_start(rh);
+
+      for (int s=0; s<n_src; s++)
+	if (active[s]) applyShifted(matSloppy, *AAr[s], *Ar[s], tmp1, tmp2, offset[0]);
+
+      comm_allreduce_wait(rh);
+
+      for (int s=0; s<n_src; s++) {
+	if (!active[s]) continue;
+
+	double *zeta_s = &zeta[s*num_offset];
+	double *zeta_old_s = &zeta_old[s*num_offset];
+	double *alpha_s = &alpha[s*num_offset];
+	double *beta_s = &beta[s*num_offset];
+	double *r2_s = &r2[s*num_offset];
+	double *stop_s = &stop[s*num_offset];
+	int *iter_s = &iter[s*(num_offset+1)];
+	int &n_now = num_offset_now[s];
+
+	double gamma = reduce[2*s+0];
+	double rAr = reduce[2*s+1];
+
+	// complete the solution update of the previous iteration, and
+	// form the new gradient vectors, for all the shifts
+	if (k > 0) {
+	  beta_s[0] = gamma / r2_old[s];
+	  for (int j=1; j<n_now; j++)
+	    beta_s[j] = beta_s[0] * zeta_s[j] * alpha_s[j] / (zeta_old_s[j] * alpha_s[0]);
+
+	  blas::axpyZpbx(alpha_s[0], *p[s][0], *x_sloppy[s][0], *r_sloppy[s], beta_s[0]);
+	  if (n_now > 1) {
+	    std::vector<ColorSpinorField*> P(p[s].begin()+1, p[s].begin()+n_now);
+	    std::vector<ColorSpinorField*> X(x_sloppy[s].begin()+1, x_sloppy[s].begin()+n_now);
+	    blas::axpyBzpcx(&alpha_s[1], P, X, &zeta_s[1], *r_sloppy[s], &beta_s[1]);
+	  }
+	}
+
+	// now we can check if any of the shifts have converged and remove them
+	r2_s[0] = gamma;
+	int converged = 0;
+	for (int j=n_now-1; j>=1; j--) {
+	  if (zeta_s[j] == 0.0 && r2_s[j+1] < stop_s[j+1]) {
+	    converged++;
+	    if (getVerbosity() >= QUDA_VERBOSE)
+	      printfQuda("MultiShift CG: Source %d shift %d converged after %d iterations\n", s, j, k);
+	  } else {
+	    r2_s[j] = zeta_s[j] * zeta_s[j] * r2_s[0];
+	    // only remove if shift above has converged
+	    if ((r2_s[j] < stop_s[j] || sqrt(r2_s[j] / b2[s]) < prec_tol) && iter_s[j+1] ) {
+	      converged++;
+	      iter_s[j] = k;
+	      if (getVerbosity() >= QUDA_VERBOSE)
+		printfQuda("MultiShift CG: Source %d shift %d converged after %d iterations\n", s, j, k);
+	    }
+	  }
+	}
+	n_now -= converged;
+
+	if (convergence(r2_s, stop_s, n_now)) {
+	  for (int j=0; j<n_now; j++) iter_s[j] = k;
+	  active[s] = false;
+	  continue;
+	}
+
+	// reliable update conditions, triggered by the unshifted system only
+	const double rNorm = sqrt(gamma);
+	if (rNorm > maxrx[s]) maxrx[s] = rNorm;
+	if (rNorm > maxrr[s]) maxrr[s] = rNorm;
+	const bool updateX = (rNorm < delta*r0Norm[s] && r0Norm[s] <= maxrx[s]);
+	const bool updateR = (rNorm < delta*maxrr[s] && r0Norm[s] <= maxrr[s]) || updateX;
+
+	double pAp;
+	bool replaced = false;
+	if (reliable && updateR) {
+	  for (int j=0; j<n_now; j++) {
+	    blas::copy(*x[s][j], *x_sloppy[s][j]);
+	    blas::xpy(*x[s][j], *y[s][j]);
+	    blas::zero(*x_sloppy[s][j]);
+	  }
+
+	  applyShifted(mat, *r[s], *y[s][0], tmpH1, tmpH2, offset[0]);
+	  const double r2_true = blas::xmyNorm(*b[s], *r[s]);
+	  blas::copy(*r_sloppy[s], *r[s]);
+
+	  // break-out check if we have reached the limit of the precision
+	  if (sqrt(r2_true) > r0Norm[s]) { // reuse r0Norm for this
+	    resIncrease[s]++;
+	    resIncreaseTotal[s]++;
+	    warningQuda("MultiShiftCG: Source %d, updated residual %e is greater than previous residual %e (total #inc %i)",
+			s, sqrt(r2_true), r0Norm[s], resIncreaseTotal[s]);
+
+	    if (resIncrease[s] > maxResIncrease or resIncreaseTotal[s] > maxResIncreaseTotal) {
+	      warningQuda("MultiShiftCG: source %d exiting due to too many true residual norm increases", s);
+	      for (int j=0; j<n_now; j++) iter_s[j] = k;
+	      active[s] = false;
+	      continue;
+	    }
+	  } else {
+	    resIncrease[s] = 0;
+	  }
+
+	  // recompute the vectors of the pipelined recurrence from the new residual
+	  applyShifted(matSloppy, *Ar[s], *r_sloppy[s], tmp1, tmp2, offset[0]);
+	  applyShifted(matSloppy, *AAr[s], *Ar[s], tmp1, tmp2, offset[0]);
+	  applyShifted(matSloppy, *Ap[s], *p[s][0], tmp1, tmp2, offset[0]);
+	  applyShifted(matSloppy, *AAp[s], *Ap[s], tmp1, tmp2, offset[0]);
+
+	  gamma = blas::norm2(*r_sloppy[s]);
+	  pAp = blas::reDotProduct(*p[s][0], *Ap[s]);
+	  r2_s[0] = gamma;
+	  for (int j=1; j<n_now; j++) r2_s[j] = zeta_s[j] * zeta_s[j] * gamma;
+
+	  r0Norm[s] = sqrt(gamma);
+	  maxrr[s] = r0Norm[s];
+	  maxrx[s] = r0Norm[s];
+	  rUpdate++;
+	  replaced = true;
+	} else {
+	  // (p, Ap) from the recurrence of the unshifted system
+	  pAp = k > 0 ? rAr - beta_s[0] * gamma / alpha_s[0] : rAr;
+	}
+
+	r2_old[s] = gamma;
+
+	// compute zeta and alpha
+	updateAlphaZeta(alpha_s, zeta_s, zeta_old_s, r2_s, beta_s, pAp, offset, n_now, 0);
+
+	if (k == 0) {
+	  blas::copy(*Ap[s], *Ar[s]);
+	  blas::copy(*AAp[s], *AAr[s]);
+	} else if (!replaced) {
+	  blas::xpay(*Ar[s], beta_s[0], *Ap[s]);
+	  blas::xpay(*AAr[s], beta_s[0], *AAp[s]);
+	}
+	blas::axpy(-alpha_s[0], *Ap[s], *r_sloppy[s]);
+	blas::axpy(-alpha_s[0], *AAp[s], *Ar[s]);
+      }
+
+      bool done = true;
+      for (int s=0; s<n_src; s++) if (active[s]) done = false;
+      if (done) break;
+
+      k++;
+
+      if (getVerbosity() >= QUDA_VERBOSE)
+	for (int s=0; s<n_src; s++)
+	  if (active[s]) printfQuda("MultiShift CG: source %d, %d iterations, <r,r> = %e, |r|/|b| = %e\n",
+				    s, k, r2[s*num_offset], sqrt(r2[s*num_offset]/b2[s]));
+    }
+
+    for (int s=0; s<n_src; s++) {
+      int *iter_s = &iter[s*(num_offset+1)];
+      // any source still active has exceeded maxiter, so complete its pending solution update
+      if (active[s])
+	for (int j=0; j<num_offset_now[s]; j++) blas::axpy(alpha[s*num_offset+j], *p[s][j], *x_sloppy[s][j]);
+
+      for (int j=0; j<num_offset; j++) {
+	if (iter_s[j] == 0) iter_s[j] = k;
+	blas::copy(*x[s][j], *x_sloppy[s][j]);
+	if (reliable) blas::xpy(*y[s][j], *x[s][j]);
+      }
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+    profile.TPSTART(QUDA_PROFILE_EPILOGUE);
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("MultiShift CG: Reliable updates = %d\n", rUpdate);
+
+    if (k==param.maxiter) warningQuda("Exceeded maximum iterations %d\n", param.maxiter);
+
+    param.secs = profile.Last(QUDA_PROFILE_COMPUTE);
+    double gflops = (blas::flops + mat.flops() + matSloppy.flops())*1e-9;
+    param.gflops = gflops;
+    param.iter += k;
+
+    for (int j=0; j < num_offset; j++) {
+      param.iter_res_offset[j] = 0.0;
+      for (int s=0; s<n_src; s++) {
+	if (b2[s] == 0.0) continue;
+	param.iter_res_offset[j] = std::max(param.iter_res_offset[j], sqrt(r2[s*num_offset+j]/b2[s]));
+      }
+    }
+
+    if (param.compute_true_res) {
+      for (int j=0; j < num_offset; j++) {
+	param.true_res_offset[j] = 0.0;
+	param.true_res_hq_offset[j] = 0.0;
+      }
+
+      for (int s=0; s<n_src; s++) {
+	if (b2[s] == 0.0) continue;
+	for (int j=0; j < num_offset; j++) {
+	  mat(*r[s], *x[s][j], tmpH1, tmpH2);
+	  if (r[s]->Nspin()==4) {
+	    blas::axpy(offset[j], *x[s][j], *r[s]); // Offset it.
+	  } else if (j!=0) {
+	    blas::axpy(offset[j]-offset[0], *x[s][j], *r[s]); // Offset it.
+	  }
+	  double true_res = blas::xmyNorm(*b[s], *r[s]);
+	  param.true_res_offset[j] = std::max(param.true_res_offset[j], sqrt(true_res/b2[s]));
+	  param.true_res_hq_offset[j] = std::max(param.true_res_hq_offset[j],
+						 sqrt(blas::HeavyQuarkResidualNorm(*x[s][j], *r[s]).z));
+	}
+      }
+    }
+
+    if (getVerbosity() >= QUDA_SUMMARIZE){
+      printfQuda("MultiShift CG: Converged %d sources after %d iterations\n", n_src, k);
+      for (int s=0; s<n_src; s++) {
+	for (int j=0; j < num_offset; j++) {
+	  printfQuda(" source=%d, shift=%d, %d iterations, relative residual: iterated = %e\n",
+		     s, j, iter[s*(num_offset+1)+j], b2[s] > 0.0 ? sqrt(r2[s*num_offset+j]/b2[s]) : 0.0);
+	}
+      }
+    }
+
+    // reset the flops counters
+    blas::flops = 0;
+    mat.flops();
+    matSloppy.flops();
+
+    profile.TPSTOP(QUDA_PROFILE_EPILOGUE);
+    profile.TPSTART(QUDA_PROFILE_FREE);
+
+    comm_free_allreduce(rh);
+
+    if (&tmp2 != &tmp1) delete tmp2_p;
+    if (&tmpH2 != &tmpH1) delete tmpH2_p;
+
+    for (int s=0; s<n_src; s++) {
+      if (r_sloppy[s] != r[s]) delete r_sloppy[s];
+      for (int j=0; j<num_offset; j++)
+	if (x_sloppy[s][j] != x[s][j]) delete x_sloppy[s][j];
+      for (int j=0; j<num_offset; j++) delete p[s][j];
+      for (auto v : y[s]) delete v;
+
+      delete r[s];
+      delete Ar[s];
+      delete AAr[s];
+      delete Ap[s];
+      delete AAp[s];
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_FREE);
+
+    return;
+  }
+
 } // namespace quda
@@ -4,6 +4,8 @@
 #include <index_helper.cuh>
 #include <stencil.h>
 #include <color_spinor.h>
+#include <multi_stencil.cuh>
+#include <vector>
 
 /**
    This is a basic gauged Laplace operator
@@ -124,22 +126,6 @@ namespace quda {
     arg.out(x_cb, arg.nParity == 2 ? parity : 0) = out;
   }
 
-  // CPU kernel for applying the Laplace operator to a vector
-  template <typename Float, int nDim, int nColor, typename Arg>
-  void laplaceCPU(Arg arg)
-  {
-
-    for (int parity= 0; parity < arg.nParity; parity++) {
-      // for full fields then set parity from loop else use arg setting
-      parity = (arg.nParity == 2) ? parity : arg.parity;
-
-      for (int x_cb = 0; x_cb < arg.volumeCB; x_cb++) { // 4-d volume
-	laplace<Float,nDim,nColor>(arg, x_cb, parity);
-      } // 4-d volumeCB
-    } // parity
-
-  }
-
   // GPU Kernel for applying the Laplace operator to a vector
   template <typename Float, int nDim, int nColor, typename Arg>
   __global__ void laplaceGPU(Arg arg)
@@ -194,12 +180,8 @@ namespace quda {
     virtual ~Laplace() { }
 
     void apply(const cudaStream_t &stream) {
-      if (meta.Location() == QUDA_CPU_FIELD_LOCATION) {
-	laplaceCPU<Float,nDim,nColor>(arg);
-      } else {
-        TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
-	laplaceGPU<Float,nDim,nColor> <<<tp.grid,tp.block,tp.shared_bytes,stream>>>(arg);
-      }
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      laplaceGPU<Float,nDim,nColor> <<<tp.grid,tp.block,tp.shared_bytes,stream>>>(arg);
     }
 
     TuneKey tuneKey() const { return TuneKey(meta.VolString(), typeid(*this).name(), aux); }
@@ -262,6 +244,15 @@ namespace quda {
   void ApplyLaplace(ColorSpinorField &out, const ColorSpinorField &in, const GaugeField &U,
 		    double kappa, const ColorSpinorField *x, int parity)		    
   {
+    // host fields go through the batched kernel
+    if (U.Location() == QUDA_CPU_FIELD_LOCATION) {
+      std::vector<ColorSpinorField*> out_(1, &out);
+      std::vector<ColorSpinorField*> in_(1, const_cast<ColorSpinorField*>(&in));
+      std::vector<ColorSpinorField*> x_(1, const_cast<ColorSpinorField*>(x));
+      ApplyLaplace(out_, in_, U, kappa, x ? &x_ : nullptr, parity);
+      return;
+    }
+
     if (in.V() == out.V()) errorQuda("Aliasing pointers");
     if (in.FieldOrder() != out.FieldOrder())
       errorQuda("Field order mismatch in = %d, out = %d", in.FieldOrder(), out.FieldOrder());
@@ -287,4 +278,146 @@ namespace quda {
   }
 
 
+  template <typename Float, int nColor, typename F, typename G, bool xpay>
+  struct LaplaceMultiArg : public MultiStencilArg<Float,F,G> {
+    typedef ColorSpinor<Float,nColor,1> Vector;
+    std::vector<F> x;     // input vectors when doing xpay
+    const Float kappa;    // kappa parameter = 1/(8+m)
+
+    LaplaceMultiArg(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, const G &U,
+                    Float kappa, const std::vector<ColorSpinorField*> *x_, int parity)
+      : MultiStencilArg<Float,F,G>(out, in, U, parity), kappa(kappa)
+    {
+      if (xpay) for (int i=0; i<this->nVec; i++) x.push_back(F(*(*x_)[i]));
+    }
+
+    //out(x) = x(x) + kappa * computeMultiNeighborSum(out, x)
+    inline void store(Vector *out, int x_cb, int parity)
+    {
+      for (int v=0; v<this->nVec; v++) {
+        if (xpay) {
+          Vector x;
+          this->x[v].load((Float*)x.data, x_cb, parity);
+          out[v] = x + kappa * out[v];
+        }
+        this->out[v].save((Float*)out[v].data, x_cb, parity);
+      }
+    }
+  };
+
+  template <typename Float, int nColor, typename F, typename G>
+    void ApplyLaplace(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, const G &U,
+		      double kappa, const std::vector<ColorSpinorField*> *x, int parity)
+  {
+    constexpr int nDim = 4;
+    if (x) {
+      LaplaceMultiArg<Float,nColor,F,G,true> arg(out, in, U, kappa, x, parity);
+      multiStencilCPU<Float,1,nColor>(arg, 0, nDim, true, true);
+    } else {
+      LaplaceMultiArg<Float,nColor,F,G,false> arg(out, in, U, kappa, x, parity);
+      multiStencilCPU<Float,1,nColor>(arg, 0, nDim, true, true);
+    }
+  }
+
+  // template on the color-spinor field order
+  template <typename Float, int nColor, typename G>
+    void ApplyLaplace(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, const G &U,
+		      double kappa, const std::vector<ColorSpinorField*> *x, int parity)
+  {
+    if (in[0]->FieldOrder() == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) {
+      typedef typename colorspinor::SpaceSpinorColorOrder<Float,1,nColor> F;
+      ApplyLaplace<Float,nColor,F>(out, in, U, kappa, x, parity);
+    } else if (in[0]->FieldOrder() == QUDA_FLOAT2_FIELD_ORDER) {
+      typedef typename colorspinor_order_mapper<Float,QUDA_FLOAT2_FIELD_ORDER,1,nColor>::type F;
+      ApplyLaplace<Float,nColor,F>(out, in, U, kappa, x, parity);
+    } else {
+      errorQuda("Unsupported field order %d\n", in[0]->FieldOrder());
+    }
+  }
+
+  // template on the gauge field order
+  template <typename Float, int nColor>
+    void ApplyLaplace(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, const GaugeField &U,
+		      double kappa, const std::vector<ColorSpinorField*> *x, int parity)
+  {
+    if (U.isNative()) {
+      if (U.Reconstruct()== QUDA_RECONSTRUCT_NO) {
+	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type G;
+	ApplyLaplace<Float,nColor>(out, in, G(U), kappa, x, parity);
+      } else if (U.Reconstruct()== QUDA_RECONSTRUCT_12) {
+	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type G;
+	ApplyLaplace<Float,nColor>(out, in, G(U), kappa, x, parity);
+      } else if (U.Reconstruct()== QUDA_RECONSTRUCT_8) {
+	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type G;
+	ApplyLaplace<Float,nColor>(out, in, G(U), kappa, x, parity);
+      } else {
+	errorQuda("Unsupported reconstruct type %d\n", U.Reconstruct());
+      }
+    } else if (U.Order() == QUDA_QDP_GAUGE_ORDER) {
+      typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,nColor>::type G;
+      ApplyLaplace<Float,nColor>(out, in, G(U), kappa, x, parity);
+    } else if (U.Order() == QUDA_MILC_GAUGE_ORDER) {
+      typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,nColor>::type G;
+      ApplyLaplace<Float,nColor>(out, in, G(U), kappa, x, parity);
+    } else {
+      errorQuda("Unsupported gauge order %d\n", U.Order());
+    }
+  }
+
+  // template on the number of colors
+  template <typename Float>
+    void ApplyLaplace(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, const GaugeField &U,
+		      double kappa, const std::vector<ColorSpinorField*> *x, int parity)
+  {
+    if (in[0]->Ncolor() == 3) {
+      ApplyLaplace<Float,3>(out, in, U, kappa, x, parity);
+    } else {
+      errorQuda("Unsupported number of colors %d\n", U.Ncolor());
+    }
+  }
+
+  //Apply the Laplace operator to a set of vectors
+  //out(x) = M*in = - kappa*\sum_mu U_{-\mu}(x)in(x+mu) + U^\dagger_mu(x-mu)in(x-mu)
+  //Host fields are processed together, device fields one at a time
+  void ApplyLaplace(std::vector<ColorSpinorField*> &out, const std::vector<ColorSpinorField*> &in, const GaugeField &U,
+		    double kappa, const std::vector<ColorSpinorField*> *x, int parity)
+  {
+    if (out.size() != in.size() || (x && x->size() != in.size()))
+      errorQuda("Number of vectors mismatch in = %lu, out = %lu", in.size(), out.size());
+    if (in.size() == 0) return;
+
+    if (U.Location() == QUDA_CUDA_FIELD_LOCATION) {
+      for (unsigned int i=0; i<in.size(); i++) ApplyLaplace(*out[i], *in[i], U, kappa, x ? (*x)[i] : nullptr, parity);
+      return;
+    }
+
+    for (unsigned int i=0; i<in.size(); i++) {
+      if (in[i]->V() == out[i]->V()) errorQuda("Aliasing pointers");
+      if (in[i]->FieldOrder() != in[0]->FieldOrder() || out[i]->FieldOrder() != in[0]->FieldOrder() ||
+	  (x && (*x)[i]->FieldOrder() != in[0]->FieldOrder()))
+	errorQuda("Field order mismatch in = %d, out = %d", in[i]->FieldOrder(), out[i]->FieldOrder());
+      if (in[i]->VolumeCB() != in[0]->VolumeCB() || out[i]->VolumeCB() != in[0]->VolumeCB() ||
+	  in[i]->SiteSubset() != in[0]->SiteSubset() || out[i]->SiteSubset() != in[0]->SiteSubset())
+	errorQuda("Volume or site subset mismatch between vectors");
+
+      // check all precisions match
+      checkPrecision(*out[i], *in[i], U);
+
+      // check all locations match
+      checkLocation(*out[i], *in[i], U);
+    }
+
+    const int nFace = 1;
+    for (unsigned int i=0; i<in.size(); i++) in[i]->exchangeGhost((QudaParity)(1-parity), nFace, 0); // last parameter is dummy
+
+    if (U.Precision() == QUDA_DOUBLE_PRECISION) {
+      ApplyLaplace<double>(out, in, U, kappa, x, parity);
+    } else if (U.Precision() == QUDA_SINGLE_PRECISION) {
+      ApplyLaplace<float>(out, in, U, kappa, x, parity);
+    } else {
+      errorQuda("Unsupported precision %d\n", U.Precision());
+    }
+  }
+
+
 } // namespace quda
@@ -5,6 +5,7 @@
 #include <quda_milc_interface.h>
 #include <quda_internal.h>
 #include <color_spinor_field.h>
+#include <gauge_field.h>
 #include <string.h>
 #include <unitarization_links.h>
 #include <ks_improved_force.h>
@@ -46,8 +47,25 @@ static bool initialized = false;
 static int gridDim[4];
 static int localDim[4];
 
-static bool invalidate_quda_gauge = true;
-static bool create_quda_gauge = false;
+/**
+   Record of the host links that the resident device fat and long
+   links were loaded from.  Before each solve we checksum the incoming
+   host links and only reload them when their content (or the
+   requested device precisions) differ from the resident ones, or when
+   the resident links have since been replaced or freed by any other
+   interface function (tracked by residentGaugeGeneration).
+*/
+static struct {
+  bool valid;
+  uint64_t generation;
+  uint64_t fat_checksum;
+  uint64_t long_checksum;
+  QudaPrecision cpu_prec;
+  QudaPrecision cuda_prec;
+  QudaPrecision cuda_prec_sloppy;
+  QudaPrecision cuda_prec_precondition;
+  QudaReconstructType long_reconstruct;
+} resident_links = { false };
 
 static bool invalidate_quda_mom = true;
 
@@ -99,6 +117,7 @@ void qudaFinalize()
 {
   qudamilc_called<true>(__func__);
   endQuda();
+  resident_links.valid = false;
   qudamilc_called<false>(__func__);
 }
 #ifdef MULTI_GPU
@@ -219,7 +238,59 @@ static QudaGaugeParam newMILCGaugeParam(const int* dim, QudaPrecision prec, Quda
 
 static  void invalidateGaugeQuda() {
   freeGaugeQuda();
-  invalidate_quda_gauge = true;
+  resident_links.valid = false;
+}
+
+/**
+   Compute the position-dependent XOR checksum of MILC-ordered host links
+   @param[in] link The host links
+   @param[in] prec The host precision
+   @return The checksum over the global lattice
+*/
+static uint64_t milcLinkChecksum(const void *link, QudaPrecision prec)
+{
+  QudaGaugeParam param = newMILCGaugeParam(localDim, prec, QUDA_GENERAL_LINKS);
+  GaugeFieldParam gParam(const_cast<void*>(link), param);
+  cpuGaugeField cpuLink(gParam);
+  return cpuLink.checksum();
+}
+
+/**
+   Record of the last HISQ link construction, used to skip rebuilding
+   links from an unchanged thin link when the host output links still
+   hold the previous result.
+*/
+struct KSLinkRecord {
+  bool valid;
+  int prec;
+  double act_path_coeff[6];
+  uint64_t inlink_checksum;
+  uint64_t fatlink_checksum;
+  uint64_t outlink_checksum;
+};
+
+static bool ksLinkUnchanged(const KSLinkRecord &record, int prec, const double act_path_coeff[6],
+			    const void *inlink, const void *fatlink, const void *outlink)
+{
+  if (!record.valid || record.prec != prec) return false;
+  for (int i=0; i<6; i++) if (record.act_path_coeff[i] != act_path_coeff[i]) return false;
+
+  QudaPrecision host_prec = (prec==1) ? QUDA_SINGLE_PRECISION : QUDA_DOUBLE_PRECISION;
+  return milcLinkChecksum(inlink, host_prec) == record.inlink_checksum &&
+    milcLinkChecksum(fatlink, host_prec) == record.fatlink_checksum &&
+    milcLinkChecksum(outlink, host_prec) == record.outlink_checksum;
+}
+
+static void ksLinkRecord(KSLinkRecord &record, int prec, const double act_path_coeff[6],
+			 const void *inlink, const void *fatlink, const void *outlink)
+{
+  QudaPrecision host_prec = (prec==1) ? QUDA_SINGLE_PRECISION : QUDA_DOUBLE_PRECISION;
+  record.valid = true;
+  record.prec = prec;
+  for (int i=0; i<6; i++) record.act_path_coeff[i] = act_path_coeff[i];
+  record.inlink_checksum = milcLinkChecksum(inlink, host_prec);
+  record.fatlink_checksum = milcLinkChecksum(fatlink, host_prec);
+  record.outlink_checksum = milcLinkChecksum(outlink, host_prec);
 }
 
 void qudaLoadKSLink(int prec, QudaFatLinkArgs_t fatlink_args,
@@ -234,14 +305,20 @@ void qudaLoadKSLink(int prec, QudaFatLinkArgs_t fatlink_args,
   param.staggered_phase_applied = 1;
   param.staggered_phase_type = QUDA_STAGGERED_PHASE_MILC;
 
+  // nothing to do if the thin link is unchanged and the output links still hold the previous result
+  static KSLinkRecord record = { false };
+  if (ksLinkUnchanged(record, prec, act_path_coeff, inlink, fatlink, longlink)) {
+    if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Thin link unchanged - skipping HISQ link construction\n");
+    qudamilc_called<false>(__func__);
+    return;
+  }
+
   computeKSLinkQuda(fatlink, longlink, NULL, inlink, const_cast<double*>(act_path_coeff), &param);
-  qudamilc_called<false>(__func__);
+  ksLinkRecord(record, prec, act_path_coeff, inlink, fatlink, longlink);
 
   // requires loadGaugeQuda to be called in subequent solver
   invalidateGaugeQuda();
 
-  // this flags that we are using QUDA to create the HISQ links
-  create_quda_gauge = true;
   qudamilc_called<false>(__func__);
 }
 
@@ -256,14 +333,20 @@ void qudaLoadUnitarizedLink(int prec, QudaFatLinkArgs_t fatlink_args,
 					   (prec==1) ? QUDA_SINGLE_PRECISION : QUDA_DOUBLE_PRECISION,
 					   QUDA_GENERAL_LINKS);
 
+  // nothing to do if the thin link is unchanged and the output links still hold the previous result
+  static KSLinkRecord record = { false };
+  if (ksLinkUnchanged(record, prec, act_path_coeff, inlink, fatlink, ulink)) {
+    if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Thin link unchanged - skipping HISQ link construction\n");
+    qudamilc_called<false>(__func__);
+    return;
+  }
+
   computeKSLinkQuda(fatlink, NULL, ulink, inlink, const_cast<double*>(act_path_coeff), &param);
-  qudamilc_called<false>(__func__);
+  ksLinkRecord(record, prec, act_path_coeff, inlink, fatlink, ulink);
 
   // requires loadGaugeQuda to be called in subequent solver
   invalidateGaugeQuda();
 
-  // this flags that we are using QUDA to create the HISQ links
-  create_quda_gauge = true;
   qudamilc_called<false>(__func__);
 }
 
@@ -586,6 +669,62 @@ static int getFatLinkPadding(const int dim[4])
 }
 
 
+/**
+   Load the fat and long links onto the device, unless the resident
+   links were loaded from host links with identical content and with
+   the same device precisions, in which case the copy is skipped.
+   @param[in] fatlink Host fat links
+   @param[in] longlink Host long links
+   @param[in,out] gaugeParam Gauge parameters for the solve
+   @param[in] invertParam Invert parameters for the solve
+   @param[in] long_reconstruct Reconstruction type for the long links
+*/
+static void loadMILCLinks(const void *fatlink, const void *longlink, QudaGaugeParam &gaugeParam,
+			  QudaInvertParam &invertParam, QudaReconstructType long_reconstruct)
+{
+  const uint64_t fat_checksum = milcLinkChecksum(fatlink, gaugeParam.cpu_prec);
+  const uint64_t long_checksum = milcLinkChecksum(longlink, gaugeParam.cpu_prec);
+
+  if (resident_links.valid &&
+      resident_links.generation == residentGaugeGeneration() &&
+      canReuseResidentGauge(&invertParam) &&
+      resident_links.fat_checksum == fat_checksum &&
+      resident_links.long_checksum == long_checksum &&
+      resident_links.cpu_prec == gaugeParam.cpu_prec &&
+      resident_links.cuda_prec == gaugeParam.cuda_prec &&
+      resident_links.cuda_prec_sloppy == gaugeParam.cuda_prec_sloppy &&
+      resident_links.cuda_prec_precondition == gaugeParam.cuda_prec_precondition &&
+      resident_links.long_reconstruct == long_reconstruct) {
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("Fat and long links unchanged - using resident links %lu %lu\n", fat_checksum, long_checksum);
+    return;
+  }
+
+  const int fat_pad  = getFatLinkPadding(localDim);
+  const int long_pad = 3*fat_pad;
+
+  gaugeParam.type = QUDA_GENERAL_LINKS;
+  gaugeParam.ga_pad = fat_pad;
+  gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
+  loadGaugeQuda(const_cast<void*>(fatlink), &gaugeParam);
+
+  gaugeParam.type = QUDA_THREE_LINKS;
+  gaugeParam.ga_pad = long_pad;
+  gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = long_reconstruct;
+  loadGaugeQuda(const_cast<void*>(longlink), &gaugeParam);
+
+  resident_links.valid = true;
+  resident_links.generation = residentGaugeGeneration();
+  resident_links.fat_checksum = fat_checksum;
+  resident_links.long_checksum = long_checksum;
+  resident_links.cpu_prec = gaugeParam.cpu_prec;
+  resident_links.cuda_prec = gaugeParam.cuda_prec;
+  resident_links.cuda_prec_sloppy = gaugeParam.cuda_prec_sloppy;
+  resident_links.cuda_prec_precondition = gaugeParam.cuda_prec_precondition;
+  resident_links.long_reconstruct = long_reconstruct;
+}
+
+
 // set the params for the single mass solver
 static void setInvertParams(const int dim[4],
     QudaPrecision cpu_prec,
@@ -865,10 +1004,6 @@ void qudaMultishiftInvert(int external_precision,
   ColorSpinorParam csParam;
   setColorSpinorParams(localDim, host_precision, &csParam);
 
-  // dirty hack to invalidate the cached gauge field without breaking interface compatability
-  if (*num_iters == -1) {
-    invalidateGaugeQuda();
-  }
 
   // set the solver
   char *quda_reconstruct = getenv("QUDA_MILC_HISQ_RECONSTRUCT");
@@ -884,20 +1019,8 @@ void qudaMultishiftInvert(int external_precision,
   }
 
 
-  if(invalidate_quda_gauge || !create_quda_gauge ){
-    const int fat_pad  = getFatLinkPadding(localDim);
-    gaugeParam.type = QUDA_GENERAL_LINKS;
-    gaugeParam.ga_pad = fat_pad;  // don't know if this is correct
-    gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(fatlink), &gaugeParam);
-
-    const int long_pad = 3*fat_pad;
-    gaugeParam.type = QUDA_THREE_LINKS;
-    gaugeParam.ga_pad = long_pad;
-    gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = long_reconstruct;
-    loadGaugeQuda(const_cast<void*>(longlink), &gaugeParam);
-    invalidate_quda_gauge = false;
-  }
+  // the links are only reloaded if their content has changed
+  loadMILCLinks(fatlink, longlink, gaugeParam, invertParam, long_reconstruct);
 
   void** sln_pointer = (void**)malloc(num_offsets*sizeof(void*));
   int quark_offset = getColorVectorOffset(local_parity, false, gaugeParam.X)*host_precision;
@@ -915,8 +1038,6 @@ void qudaMultishiftInvert(int external_precision,
     final_fermilab_residual[i] = invertParam.true_res_hq_offset[i];
   } // end loop over number of offsets
 
-  if(!create_quda_gauge) invalidateGaugeQuda();
-
   qudamilc_called<false>(__func__, verbosity);
   return;
 } // qudaMultiShiftInvert
@@ -982,27 +1103,8 @@ void qudaInvert(int external_precision,
   ColorSpinorParam csParam;
   setColorSpinorParams(localDim, host_precision, &csParam);
 
-  const int fat_pad  = getFatLinkPadding(localDim);
-  const int long_pad = 3*fat_pad;
-
-  // dirty hack to invalidate the cached gauge field without breaking interface compatability
-  if (*num_iters == -1  || !canReuseResidentGauge(&invertParam) ) {
-    invalidateGaugeQuda();
-  }
-
-  if(invalidate_quda_gauge || !create_quda_gauge){
-    gaugeParam.type = QUDA_GENERAL_LINKS;
-    gaugeParam.ga_pad = fat_pad;
-    gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(fatlink), &gaugeParam);
-
-    gaugeParam.type = QUDA_THREE_LINKS;
-    gaugeParam.ga_pad = long_pad;
-    gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(longlink), &gaugeParam);
-
-    invalidate_quda_gauge = false;
-  }
+  // the links are only reloaded if their content has changed
+  loadMILCLinks(fatlink, longlink, gaugeParam, invertParam, QUDA_RECONSTRUCT_NO);
 
   int quark_offset = getColorVectorOffset(local_parity, false, gaugeParam.X)*host_precision;
 
@@ -1015,8 +1117,6 @@ void qudaInvert(int external_precision,
   *final_residual = invertParam.true_res;
   *final_fermilab_residual = invertParam.true_res_hq;
 
-  if(!create_quda_gauge) invalidateGaugeQuda();
-
   qudamilc_called<false>(__func__, verbosity);
   return;
 } // qudaInvert
@@ -1055,27 +1155,8 @@ void qudaDslash(int external_precision,
   ColorSpinorParam csParam;
   setColorSpinorParams(localDim, host_precision, &csParam);
 
-  const int fat_pad  = getFatLinkPadding(localDim);
-  const int long_pad = 3*fat_pad;
-
-  // dirty hack to invalidate the cached gauge field without breaking interface compatability
-  if (*num_iters == -1  || !canReuseResidentGauge(&invertParam) ) {
-    invalidateGaugeQuda();
-  }
-
-  if(invalidate_quda_gauge || !create_quda_gauge){
-    gaugeParam.type = QUDA_GENERAL_LINKS;
-    gaugeParam.ga_pad = fat_pad;
-    gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(fatlink), &gaugeParam);
-
-    gaugeParam.type = QUDA_THREE_LINKS;
-    gaugeParam.ga_pad = long_pad;
-    gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(longlink), &gaugeParam);
-
-    invalidate_quda_gauge = false;
-  }
+  // the links are only reloaded if their content has changed
+  loadMILCLinks(fatlink, longlink, gaugeParam, invertParam, QUDA_RECONSTRUCT_NO);
 
   int src_offset = getColorVectorOffset(other_parity, false, gaugeParam.X);
   int dst_offset = getColorVectorOffset(local_parity, false, gaugeParam.X);
@@ -1084,8 +1165,6 @@ void qudaDslash(int external_precision,
 	     static_cast<char*>(src) + src_offset*host_precision,
 	     &invertParam, local_parity);
 
-  if(!create_quda_gauge) invalidateGaugeQuda();
-
   qudamilc_called<false>(__func__, verbosity);
   return;
 } // qudaDslash
@@ -1154,27 +1233,8 @@ void qudaInvertMsrc(int external_precision,
   ColorSpinorParam csParam;
   setColorSpinorParams(localDim, host_precision, &csParam);
 
-  const int fat_pad  = getFatLinkPadding(localDim);
-  const int long_pad = 3*fat_pad;
-
-  // dirty hack to invalidate the cached gauge field without breaking interface compatability
-  if (*num_iters == -1  || !canReuseResidentGauge(&invertParam) ) {
-    invalidateGaugeQuda();
-  }
-
-  if(invalidate_quda_gauge || !create_quda_gauge){
-    gaugeParam.type = QUDA_GENERAL_LINKS;
-    gaugeParam.ga_pad = fat_pad;
-    gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(fatlink), &gaugeParam);
-
-    gaugeParam.type = QUDA_THREE_LINKS;
-    gaugeParam.ga_pad = long_pad;
-    gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(longlink), &gaugeParam);
-
-    invalidate_quda_gauge = false;
-  }
+  // the links are only reloaded if their content has changed
+  loadMILCLinks(fatlink, longlink, gaugeParam, invertParam, QUDA_RECONSTRUCT_NO);
 
   int quark_offset = getColorVectorOffset(local_parity, false, gaugeParam.X)*host_precision;
   void** sln_pointer = (void**)malloc(num_src*sizeof(void*));
@@ -1193,8 +1253,6 @@ void qudaInvertMsrc(int external_precision,
   *final_residual = invertParam.true_res;
   *final_fermilab_residual = invertParam.true_res_hq;
 
-  if(!create_quda_gauge) invalidateGaugeQuda();
-
   qudamilc_called<false>(__func__, verbosity);
   return;
 } // qudaInvert
@@ -1283,23 +1341,8 @@ void qudaEigCGInvert(int external_precision,
   ColorSpinorParam csParam;
   setColorSpinorParams(localDim, host_precision, &csParam);
 
-  if((invalidate_quda_gauge || !create_quda_gauge) && (rhs_idx == 0)){//do this for the first RHS
-
-    const int fat_pad  = getFatLinkPadding(localDim);
-    const int long_pad = 3*fat_pad;
-
-    printfQuda("Initialize gauge field.\n"); 
-    gaugeParam.type = QUDA_GENERAL_LINKS;
-    gaugeParam.ga_pad = fat_pad;
-    gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(fatlink), &gaugeParam);
-
-    gaugeParam.type = QUDA_THREE_LINKS;
-    gaugeParam.ga_pad = long_pad;
-    gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(longlink), &gaugeParam);
-
-    invalidate_quda_gauge = false;
+  if (rhs_idx == 0) { // do this for the first RHS, only reloading the links if their content has changed
+    loadMILCLinks(fatlink, longlink, gaugeParam, invertParam, QUDA_RECONSTRUCT_NO);
   }
 
   int quark_offset = getColorVectorOffset(local_parity, false, gaugeParam.X)*host_precision;
@@ -1319,8 +1362,6 @@ void qudaEigCGInvert(int external_precision,
   *final_residual = invertParam.true_res;
   *final_fermilab_residual = invertParam.true_res_hq;
 
-  if(!create_quda_gauge && last_rhs_flag) invalidateGaugeQuda();
-
   qudamilc_called<false>(__func__, verbosity);
 
   return;
@@ -1501,7 +1542,7 @@ void qudaLoadGaugeField(int external_precision,
 
 void qudaFreeGaugeField() {
     qudamilc_called<true>(__func__);
-  freeGaugeQuda();
+  invalidateGaugeQuda();
     qudamilc_called<false>(__func__);
 } // qudaFreeGaugeField
 
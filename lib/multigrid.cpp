@@ -668,6 +668,8 @@ namespace quda {
 #ifdef HAVE_QIO
       read_spinor_field(vec_infile.c_str(), &V[0], B[0]->Precision(), B[0]->X(),
 			B[0]->Ncolor(), B[0]->Nspin(), Nvec, 0,  (char**)0);
+      if (getVerbosity() >= QUDA_VERBOSE)
+	for (int i=0; i<Nvec; i++) printfQuda("Loaded vector %d checksum %016lx\n", i, B[i]->checksum());
 #else
       errorQuda("\nQIO library was not built.\n");      
 #endif
@@ -727,6 +729,8 @@ namespace quda {
 
       write_spinor_field(vec_outfile.c_str(), &V[0], B[0]->Precision(), B[0]->X(),
 			 B[0]->Ncolor(), B[0]->Nspin(), Nvec, 0,  (char**)0);
+      if (getVerbosity() >= QUDA_VERBOSE)
+	for (int i=0; i<Nvec; i++) printfQuda("Saved vector %d checksum %016lx\n", i, B[i]->checksum());
 
       host_free(V);
       printfQuda("Done saving vectors\n");
@@ -89,10 +89,10 @@ namespace quda {
     @brief Generate full SU(2) matrix (four real numbers instead of 2x2 complex matrix) and update link matrix.
     Get from MILC code.
     @param al weight
-    @param localstate CURAND rng state
+    @param localstate rng state, CURAND on the device or counter-based on the host
  */
-  template <class T>
-  __device__ static inline Matrix<T,2> generate_su2_matrix_milc(T al, cuRNGState& localState){
+  template <class T, class RNGState>
+  __host__ __device__ static inline Matrix<T,2> generate_su2_matrix_milc(T al, RNGState& localState){
     T xr1, xr2, xr3, xr4, d, r;
     int k;
     xr1 = Random<T>(localState);
@@ -300,11 +300,11 @@ namespace quda {
     @brief Link update by pseudo-heatbath
     @param U link to be updated
     @param F staple
-    @param localstate CURAND rng state
+    @param localstate rng state, CURAND on the device or counter-based on the host
  */
-  template <class Float, int NCOLORS>
-  __device__ inline void heatBathSUN( Matrix<complex<Float>,NCOLORS>& U, Matrix<complex<Float>,NCOLORS> F,
-                                      cuRNGState& localState, Float BetaOverNc ){
+  template <class Float, int NCOLORS, class RNGState>
+  __host__ __device__ inline void heatBathSUN( Matrix<complex<Float>,NCOLORS>& U, Matrix<complex<Float>,NCOLORS> F,
+                                               RNGState& localState, Float BetaOverNc ){
 
     if ( NCOLORS == 3 ) {
       //////////////////////////////////////////////////////////////////
@@ -436,7 +436,7 @@ namespace quda {
      @param F staple
    */
   template <class Float, int NCOLORS>
-  __device__ inline void overrelaxationSUN( Matrix<complex<Float>,NCOLORS>& U, Matrix<complex<Float>,NCOLORS> F ){
+  __host__ __device__ inline void overrelaxationSUN( Matrix<complex<Float>,NCOLORS>& U, Matrix<complex<Float>,NCOLORS> F ){
 
     if ( NCOLORS == 3 ) {
       //////////////////////////////////////////////////////////////////
@@ -844,22 +844,208 @@ namespace quda {
       errorQuda("Invalid Gauge Order\n");
     }
   }
+
+
+  /**
+   * @brief container to pass parameters for the host heatbath and
+   * overrelaxation sweeps.  X holds the local (non-extended)
+   * dimensions and E the dimensions of the field in memory, which
+   * differ by 2*border when the field is extended.  G and offset
+   * locate the local lattice in the global one, and are used to key
+   * the counter-based random number generator by global site.
+   */
+  template <typename Gauge, typename Float, int NCOLORS>
+  struct MonteCPUArg {
+    int X[4];      // local lattice dimensions
+    int E[4];      // extended lattice dimensions
+    int border[4];
+    int G[4];      // global lattice dimensions
+    int offset[4]; // global coordinates of the local origin
+    Gauge dataOr;
+    Float BetaOverNc;
+    uint64_t seed;
+    MonteCPUArg(const Gauge &dataOr, const cpuGaugeField &data, Float Beta, uint64_t seed)
+      : dataOr(dataOr), seed(seed) {
+      BetaOverNc = Beta / (Float)NCOLORS;
+      for ( int dir = 0; dir < 4; ++dir ) {
+        border[dir] = data.R()[dir];
+        E[dir] = data.X()[dir];
+        X[dir] = E[dir] - 2 * border[dir];
+        G[dir] = comm_dim(dir) * X[dir];
+        offset[dir] = comm_coord(dir) * X[dir];
+      }
+    }
+  };
+
+
+  /**
+   * @brief Heatbath or overrelaxation update of the links in
+   * direction mu on the sites of the given parity.  These links do
+   * not appear in each other's staples, so the sites are updated in
+   * parallel.  The random numbers of each site are drawn from a
+   * counter-based generator keyed by (global site, mu, stream), so
+   * the result does not depend on the number of threads.
+   */
+  template<typename Float, typename Gauge, int NCOLORS, bool HeatbathOrRelax>
+  void heatBathCPU(MonteCPUArg<Gauge, Float, NCOLORS> &arg, const int mu, const int parity, const unsigned int stream){
+    typedef Matrix<complex<Float>,NCOLORS> Link;
+
+#ifdef _OPENMP
+#pragma omp parallel for collapse(3) schedule(static)
+#endif
+    for ( int t = 0; t < arg.X[3]; t++ ) {
+      for ( int z = 0; z < arg.X[2]; z++ ) {
+        for ( int y = 0; y < arg.X[1]; y++ ) {
+          int x[4];
+          x[1] = y + arg.border[1];
+          x[2] = z + arg.border[2];
+          x[3] = t + arg.border[3];
+          for ( int x0 = (parity + y + z + t) & 1; x0 < arg.X[0]; x0 += 2 ) {
+            x[0] = x0 + arg.border[0];
+            const int idx = linkIndex(x, arg.E);
+
+            Link staple;
+            setZero(&staple);
+            Link U;
+            for ( int nu = 0; nu < 4; nu++ ) if ( mu != nu ) {
+                int dx[4] = { 0, 0, 0, 0 };
+                Link link;
+                arg.dataOr.load((Float*)(link.data), idx, nu, parity);
+                dx[nu]++;
+                arg.dataOr.load((Float*)(U.data), linkIndexShift(x,dx,arg.E), mu, 1 - parity);
+                link *= U;
+                dx[nu]--;
+                dx[mu]++;
+                arg.dataOr.load((Float*)(U.data), linkIndexShift(x,dx,arg.E), nu, 1 - parity);
+                link *= conj(U);
+                staple += link;
+                dx[mu]--;
+                dx[nu]--;
+                arg.dataOr.load((Float*)(link.data), linkIndexShift(x,dx,arg.E), nu, 1 - parity);
+                arg.dataOr.load((Float*)(U.data), linkIndexShift(x,dx,arg.E), mu, 1 - parity);
+                link = conj(link) * U;
+                dx[mu]++;
+                arg.dataOr.load((Float*)(U.data), linkIndexShift(x,dx,arg.E), nu, parity);
+                link *= U;
+                staple += link;
+              }
+            arg.dataOr.load((Float*)(U.data), idx, mu, parity);
+            if ( HeatbathOrRelax ) {
+              const uint64_t site = (((uint64_t)(t + arg.offset[3]) * arg.G[2] + z + arg.offset[2]) * arg.G[1]
+                                     + y + arg.offset[1]) * arg.G[0] + x0 + arg.offset[0];
+              hostRNGState localState(arg.seed, site, mu, stream);
+              heatBathSUN<Float, NCOLORS>( U, conj(staple), localState, arg.BetaOverNc );
+            }
+            else{
+              overrelaxationSUN<Float, NCOLORS>( U, conj(staple) );
+            }
+            arg.dataOr.save((Float*)(U.data), idx, mu, parity);
+          }
+        }
+      }
+    }
+  }
+
+
+  template<typename Float, int NCOLORS, typename Gauge>
+  void MonteCPU( Gauge dataOr,  cpuGaugeField& data, RNG &rngstate, Float Beta, int nhb, int nover) {
+
+    TimeProfile profileHBOVR("HeatBath_OR_Relax_CPU", false);
+    MonteCPUArg<Gauge, Float, NCOLORS> montearg(dataOr, data, Beta, rngstate.Seed());
+
+    // the halo of an extended field is refreshed after each update
+    bool extended = false;
+    for ( int dir = 0; dir < 4; ++dir ) {
+      if ( commDimPartitioned(dir) && data.R()[dir] == 0 )
+        errorQuda("Partitioned dimension %d requires an extended gauge field\n", dir);
+      if ( data.R()[dir] != 0 ) extended = true;
+    }
+
+    if ( getVerbosity() >= QUDA_SUMMARIZE ) profileHBOVR.TPSTART(QUDA_PROFILE_COMPUTE);
+    for ( int step = 0; step < nhb; ++step ) {
+      // each sweep draws from a fresh stream of the generator
+      const unsigned int stream = rngstate.HostStream();
+      for ( int parity = 0; parity < 2; ++parity ) {
+        for ( int mu = 0; mu < 4; ++mu ) {
+          heatBathCPU<Float, Gauge, NCOLORS, true>(montearg, mu, parity, stream);
+          if ( extended ) data.exchangeExtendedGhost(data.R(), true);
+        }
+      }
+    }
+    if ( getVerbosity() >= QUDA_SUMMARIZE ) {
+      profileHBOVR.TPSTOP(QUDA_PROFILE_COMPUTE);
+      printfQuda("HB: Time = %6.6f s\n", profileHBOVR.Last(QUDA_PROFILE_COMPUTE));
+    }
+
+    if ( getVerbosity() >= QUDA_SUMMARIZE ) profileHBOVR.TPSTART(QUDA_PROFILE_COMPUTE);
+    for ( int step = 0; step < nover; ++step ) {
+      for ( int parity = 0; parity < 2; ++parity ) {
+        for ( int mu = 0; mu < 4; ++mu ) {
+          heatBathCPU<Float, Gauge, NCOLORS, false>(montearg, mu, parity, 0);
+          if ( extended ) data.exchangeExtendedGhost(data.R(), true);
+        }
+      }
+    }
+    if ( getVerbosity() >= QUDA_SUMMARIZE ) {
+      profileHBOVR.TPSTOP(QUDA_PROFILE_COMPUTE);
+      printfQuda("OVR: Time = %6.6f s\n", profileHBOVR.Last(QUDA_PROFILE_COMPUTE));
+    }
+  }
+
+
+  template<typename Float>
+  void Monte( cpuGaugeField& data, RNG &rngstate, Float Beta, int nhb, int nover) {
+
+    if ( data.Reconstruct() != QUDA_RECONSTRUCT_NO )
+      errorQuda("Reconstruction type %d of host gauge field not supported", data.Reconstruct());
+
+    if ( data.Order() == QUDA_QDP_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,3>::type Gauge;
+      MonteCPU<Float, 3>(Gauge(data), data, rngstate, Beta, nhb, nover);
+    } else if ( data.Order() == QUDA_QDPJIT_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_QDPJIT_GAUGE_ORDER,3>::type Gauge;
+      MonteCPU<Float, 3>(Gauge(data), data, rngstate, Beta, nhb, nover);
+    } else if ( data.Order() == QUDA_MILC_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,3>::type Gauge;
+      MonteCPU<Float, 3>(Gauge(data), data, rngstate, Beta, nhb, nover);
+    } else if ( data.Order() == QUDA_BQCD_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_BQCD_GAUGE_ORDER,3>::type Gauge;
+      MonteCPU<Float, 3>(Gauge(data), data, rngstate, Beta, nhb, nover);
+    } else if ( data.Order() == QUDA_TIFR_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_TIFR_GAUGE_ORDER,3>::type Gauge;
+      MonteCPU<Float, 3>(Gauge(data), data, rngstate, Beta, nhb, nover);
+    } else {
+      errorQuda("Gauge order %d of host gauge field not supported", data.Order());
+    }
+  }
 #endif // GPU_GAUGE_ALG
 
 /** @brief Perform heatbath and overrelaxation. Performs nhb heatbath steps followed by nover overrelaxation steps.
  *
- * @param[in,out] data Gauge field
- * @param[in,out] rngstate state of the CURAND random number generator
+ * @param[in,out] data Gauge field, either on the device or on the host
+ * @param[in,out] rngstate state of the CURAND random number generator, on the host only its seed and stream counter are used
  * @param[in] Beta inverse of the gauge coupling, beta = 2 Nc / g_0^2
  * @param[in] nhb number of heatbath steps
  * @param[in] nover number of overrelaxation steps
  */
-  void Monte( cudaGaugeField& data, RNG &rngstate, double Beta, int nhb, int nover) {
+  void Monte( GaugeField& data, RNG &rngstate, double Beta, int nhb, int nover) {
 #ifdef GPU_GAUGE_ALG
+    if ( data.Location() == QUDA_CPU_FIELD_LOCATION ) {
+      cpuGaugeField &cpuData = static_cast<cpuGaugeField&>(data);
+      if ( data.Precision() == QUDA_SINGLE_PRECISION ) {
+        Monte<float> (cpuData, rngstate, (float)Beta, nhb, nover);
+      } else if ( data.Precision() == QUDA_DOUBLE_PRECISION ) {
+        Monte<double>(cpuData, rngstate, Beta, nhb, nover);
+      } else {
+        errorQuda("Precision %d not supported", data.Precision());
+      }
+      return;
+    }
+    cudaGaugeField &cudaData = static_cast<cudaGaugeField&>(data);
     if ( data.Precision() == QUDA_SINGLE_PRECISION ) {
-      Monte<float> (data, rngstate, (float)Beta, nhb, nover);
+      Monte<float> (cudaData, rngstate, (float)Beta, nhb, nover);
     } else if ( data.Precision() == QUDA_DOUBLE_PRECISION ) {
-      Monte<double>(data, rngstate, Beta, nhb, nover);
+      Monte<double>(cudaData, rngstate, Beta, nhb, nover);
     } else {
       errorQuda("Precision %d not supported", data.Precision());
     }
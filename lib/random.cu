@@ -105,6 +105,7 @@ RNG::RNG(int rng_sizes, int seedin){
     seed = seedin;
     state = NULL;
     node_offset = 0;
+    host_stream = 0;
     #ifdef MULTI_GPU
     for(int i=0; i<4;i++) X[i]=0;
     node_offset = comm_rank() * rng_sizes;
@@ -124,6 +125,7 @@ RNG::RNG(int rng_sizes, int seedin, const int XX[4]){
     seed = seedin;
     state = NULL;
     node_offset = 0;
+    host_stream = 0;
     #ifdef MULTI_GPU
     for(int i=0; i<4;i++) X[i]=XX[i];
     node_offset = comm_rank() * rng_sizes;
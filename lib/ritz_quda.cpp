@@ -14,7 +14,33 @@
 
 namespace quda {
 
-  void RitzMat::operator()(cudaColorSpinorField &out, const cudaColorSpinorField &in) const
+  void RitzMat::operator()(ColorSpinorField &out, const ColorSpinorField &in) const
+  {
+    if (in.Location() == QUDA_CUDA_FIELD_LOCATION && out.Location() == QUDA_CUDA_FIELD_LOCATION) {
+      apply(static_cast<cudaColorSpinorField&>(out), static_cast<const cudaColorSpinorField&>(in));
+      return;
+    }
+
+    if (!d_in) {
+      ColorSpinorParam param(in);
+      // to force setting the field to be native first set to double-precision native order
+      // then use the setPrecision method to set to native order
+      param.fieldOrder = QUDA_FLOAT2_FIELD_ORDER;
+      param.precision = QUDA_DOUBLE_PRECISION;
+      param.setPrecision(precision);
+      param.location = QUDA_CUDA_FIELD_LOCATION;
+      param.gammaBasis = in.Nspin() == 4 ? QUDA_UKQCD_GAMMA_BASIS : QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+      param.create = QUDA_NULL_FIELD_CREATE;
+      d_in = new cudaColorSpinorField(param);
+      d_out = new cudaColorSpinorField(param);
+    }
+
+    *d_in = in;
+    apply(*d_out, *d_in);
+    out = *d_out;
+  }
+
+  void RitzMat::apply(cudaColorSpinorField &out, const cudaColorSpinorField &in) const
   {
     using namespace blas;
     
@@ -52,7 +78,12 @@ namespace quda {
     deleteTmp(&(tmp2), reset2);
 
   }
-  RitzMat::~RitzMat() {;}
+  RitzMat::~RitzMat()
+  {
+    if (d_in) delete d_in;
+    if (d_out) delete d_out;
+  }
+
   bool RitzMat::newTmp(cudaColorSpinorField **tmp, const cudaColorSpinorField &a) const{
     if (*tmp) return false;
     ColorSpinorParam param(a);
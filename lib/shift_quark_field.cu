@@ -1,297 +1,240 @@
-#include <cstdio>
-#include <cstdlib>
-#include <cuda.h>
-#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <color_spinor_field_order.h>
+#include <index_helper.cuh>
+#include <color_spinor.h>
+#include <tune_quda.h>
 
-namespace quda {
+/**
+   Shift a color-spinor field by a fixed number of sites along a
+   given dimension: out(x) = in(x + shift * mu_hat)
+*/
 
-  template<typename Output, typename Input>
-    struct ShiftColorSpinorFieldArg {
-      const unsigned int length;
-      unsigned int X[4];
-#ifdef MULTI_GPU
-      const usigned int ghostOffset; // depends on the direction
-#endif
-      const unsigned int parity;
-      const unsigned int dir;
-      bool partitioned[4];
-      const int shift;
-      Input in;
-      Output out;
-      ShiftColorSpinorFieldArg(const unsigned int length, 
-          const unsigned int X[4],
-          const unsigned int ghostOffset,
-          const unsigned int parity,
-          const unsigned int dir,
-          const int shift,   
-          const Input& in,
-          const Output& out) : length(length),
-#ifdef MULTI_GPU
-      ghostOffset(ghostOffset),
-#endif
-      parity(parity), dir(dir), shift(shift),  in(in), out(out) 
-      {
-        for(int i=0; i<4; ++i) this->X[i] = X[i];
-        for(int i=0; i<4; ++i) partitioned[i] = commDimPartitioned(i) ? true : false;
-      }
-    };
+namespace quda {
 
-  template<IndexType idxType, typename Int>
-    __device__ __forceinline__
-    int neighborIndex(const unsigned int& cb_idx, const int (&shift)[4], const bool (&partitioned)[4], const unsigned int& parity){
+  /**
+     @brief Parameter structure for driving the color-spinor shift
+   */
+  template <typename Float, int nSpin, int nColor, typename F>
+  struct ShiftColorSpinorFieldArg {
+    F out;                // output vector field
+    const F in;           // input vector field
+    const int parity;     // destination parity, only use this for single parity fields
+    const int nParity;    // number of parities we're working on
+    const int dir;        // dimension along which we shift
+    const int shift;      // number of sites we shift by
+    const int nFace;      // depth of the ghost zone we read from
+    const int dim[5];     // full lattice dimensions
+    const int commDim[4]; // whether a given dimension is partitioned or not
+    const int volumeCB;   // checkerboarded volume
+
+    ShiftColorSpinorFieldArg(ColorSpinorField &out, const ColorSpinorField &in, int parity, int dir, int shift)
+      : out(out), in(in, std::abs(shift), 0, 0, reinterpret_cast<Float**>(const_cast<void**>(in.Ghost()))),
+	parity(parity), nParity(in.SiteSubset()), dir(dir), shift(shift), nFace(std::abs(shift)),
+	dim{ (3-nParity) * in.X(0), in.X(1), in.X(2), in.X(3), 1 },
+      commDim{comm_dim_partitioned(0), comm_dim_partitioned(1), comm_dim_partitioned(2), comm_dim_partitioned(3)},
+      volumeCB(in.VolumeCB())
+    { }
+  };
+
+  /**
+     Shift the color spinor at a single site
+
+     @param[in,out] arg Parameter struct
+     @param[in] x_cb The checkerboarded site index
+     @param[in] parity The destination site parity
+   */
+  template <typename Float, int nSpin, int nColor, typename Arg>
+  __device__ __host__ inline void shiftColorSpinor(Arg &arg, int x_cb, int parity)
+  {
+    typedef ColorSpinor<Float,nColor,nSpin> Vector;
+    const int their_spinor_parity = (arg.nParity == 2) ? (parity + arg.shift) & 1 : 0;
+    const int my_spinor_parity = (arg.nParity == 2) ? parity : 0;
+    const int d = arg.dir;
+
+    int coord[5];
+    getCoords(coord, x_cb, arg.dim, parity);
+    coord[4] = 0;
+
+    Vector out;
+    const int y = coord[d] + arg.shift;
+
+    if ( arg.commDim[d] && (y < 0 || y >= arg.dim[d]) ) {
+      // the source site lives on the neighboring node
+      const int ghost_idx = (arg.shift > 0) ? ghostFaceIndex<1>(coord, arg.dim, d, arg.nFace) :
+	ghostFaceIndex<0>(coord, arg.dim, d, arg.nFace);
+      arg.in.loadGhost((Float*)out.data, ghost_idx, d, arg.shift > 0 ? 1 : 0, their_spinor_parity);
+    } else {
+      int src[4] = { coord[0], coord[1], coord[2], coord[3] };
+      src[d] = ((y % arg.dim[d]) + arg.dim[d]) % arg.dim[d];
+      arg.in.load((Float*)out.data, linkIndex(src, arg.dim), their_spinor_parity);
+    }
 
-      int idx;
-      Int x, y, z, t;
+    arg.out.save((Float*)out.data, x_cb, my_spinor_parity);
+  }
 
-      coordsFromIndex(full_idx, x, y, z, t, cb_idx, parity);
+  // CPU kernel for shifting a color-spinor field
+  template <typename Float, int nSpin, int nColor, typename Arg>
+  void shiftColorSpinorFieldCPU(Arg arg)
+  {
 
-#ifdef MULTI_GPU
-      if(partitioned[0])
-        if( (x+shift[0])<0 || (x+shift[0])>=X1) return -1;
-      if(partitioned[1])
-        if( (y+shift[1])<0 || (y+shift[1])>=X2) return -1;
-      if(partitioned[2])
-        if( (z+shift[2])<0 || (z+shift[2])>=X3) return -1;
-      if(partitioned[3])
-        if( (z+shift[3])<0 || (z+shift[3])>=X4) return -1;
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2) schedule(static)
 #endif
+    for (int p = 0; p < arg.nParity; p++) {
+      for (int x_cb = 0; x_cb < arg.volumeCB; x_cb++) { // 4-d volume
+	// for full fields then set parity from loop else use arg setting
+	const int parity = (arg.nParity == 2) ? p : arg.parity;
+	shiftColorSpinor<Float,nSpin,nColor>(arg, x_cb, parity);
+      } // 4-d volumeCB
+    } // parity
 
-      x = shift[0] ? (x + shift[0] + X1) % X1 : x;
-      y = shift[1] ? (y + shift[1] + X2) % X2 : y;
-      z = shift[2] ? (z + shift[2] + X3) % X3 : z;
-      t = shift[3] ? (t + shift[3] + X4) % X4 : t;
-      return  (((t*X3 + z)*X2 + y)*X1 + x) >> 1;
-    }
+  }
 
+  // GPU kernel for shifting a color-spinor field
+  template <typename Float, int nSpin, int nColor, typename Arg>
+  __global__ void shiftColorSpinorFieldGPU(Arg arg)
+  {
+    int x_cb = blockIdx.x*blockDim.x + threadIdx.x;
 
-  template <typename FloatN, int N, typename Output, typename Input>
-    __global__ void shiftColorSpinorFieldKernel(ShiftQuarkArg<Output,Input> arg){
+    // for full fields set parity from y thread index else use arg setting
+    int parity = blockDim.y*blockIdx.y + threadIdx.y;
 
-      int shift[4] = {0,0,0,0};
-      shift[arg.dir] = arg.shift;
+    if (x_cb >= arg.volumeCB) return;
+    if (parity >= arg.nParity) return;
+    parity = (arg.nParity == 2) ? parity : arg.parity;
 
-      unsigned int idx = blockIdx.x*(blockDim.x) + threadIdx.x;
-      unsigned int gridSize = gridDim.x*blockDim.x;
+    shiftColorSpinor<Float,nSpin,nColor>(arg, x_cb, parity);
+  }
 
-      FloatN x[N];
-      while(idx<arg.length){
-        const int new_idx = neighborIndex(idx, shift, arg.partitioned, arg.parity);
+  template <typename Float, int nSpin, int nColor, typename Arg>
+  class ShiftColorSpinorField : public TunableVectorY {
+
+  protected:
+    Arg &arg;
+    const ColorSpinorField &meta;
+
+    long long flops() const { return 0; }
+    long long bytes() const { return arg.out.Bytes() + arg.in.Bytes(); }
+    bool tuneGridDim() const { return false; }
+    unsigned int minThreads() const { return arg.volumeCB; }
+
+  public:
+    ShiftColorSpinorField(Arg &arg, const ColorSpinorField &meta) : TunableVectorY(arg.nParity), arg(arg), meta(meta)
+    {
+      strcpy(aux, meta.AuxString());
+      char shift[32];
+      sprintf(shift, ",dir=%d,shift=%d", arg.dir, arg.shift);
+      strcat(aux, shift);
 #ifdef MULTI_GPU
-        if(new_idx > 0){
+      char comm[5];
+      comm[0] = (arg.commDim[0] ? '1' : '0');
+      comm[1] = (arg.commDim[1] ? '1' : '0');
+      comm[2] = (arg.commDim[2] ? '1' : '0');
+      comm[3] = (arg.commDim[3] ? '1' : '0');
+      comm[4] = '\0';
+      strcat(aux,",comm=");
+      strcat(aux,comm);
 #endif
-          arg.in.load(x, new_idx);
-          arg.out.save(x, idx);
-#ifdef MULTI_GPU
-        }
-#endif       
-        idx += gridSize;
-      }  
-      return;
     }
-
-  template<typename FloatN, int N, typename Output, typename Input>
-    __global__ void shiftColorSpinorFieldExternalKernel(ShiftQuarkArg<Output,Input> arg){
-
-      unsigned int idx = blockIdx.x*(blockDim.x) + threadIdx.x;
-      unsigned int gridSize = gridDim.x*blockDim.x;
-
-      Float x[N];
-      unsigned int coord[4];
-      while(idx<arg.length){
-
-        // compute the coordinates in the ghost zone 
-        coordsFromIndex<1>(coord, idx, arg.X, arg.dir, arg.parity);
-
-        unsigned int ghost_idx = arg.ghostOffset + ghostIndexFromCoords<3,3>(arg.X, coord, arg.dir, arg.shift);
-
-        arg.in.load(x, ghost_idx);
-        arg.out.save(x, idx);
-
-        idx += gridSize;
+    virtual ~ShiftColorSpinorField() { }
+
+    void apply(const cudaStream_t &stream) {
+      if (meta.Location() == QUDA_CPU_FIELD_LOCATION) {
+	shiftColorSpinorFieldCPU<Float,nSpin,nColor>(arg);
+      } else {
+        TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+	shiftColorSpinorFieldGPU<Float,nSpin,nColor> <<<tp.grid,tp.block,tp.shared_bytes,stream>>>(arg);
       }
+    }
 
+    TuneKey tuneKey() const { return TuneKey(meta.VolString(), typeid(*this).name(), aux); }
+  };
 
-      return;
-    }
+  template <typename Float, int nSpin, int nColor, typename F>
+    void shiftColorSpinorField(ColorSpinorField &dst, const ColorSpinorField &src, int parity, int dim, int shift)
+  {
+    typedef ShiftColorSpinorFieldArg<Float,nSpin,nColor,F> Arg;
+    Arg arg(dst, src, parity, dim, shift);
+    ShiftColorSpinorField<Float,nSpin,nColor,Arg> shifter(arg, src);
+    shifter.apply(0);
+  }
 
-  template<typename Output, typename Input> 
-    class ShiftColorSpinorField : public Tunable {
-
-      private:
-        ShiftColorSpinorFieldArg<Output,Input> arg;
-        const int *X; // pointer to lattice dimensions
-
-        int sharedBytesPerThread() const { return 0; }
-        int sharedBytesPerBlock(const TuneParam &) cont { return 0; }
-
-        // don't tune the grid dimension
-        bool advanceGridDim(TuneParam & param) const { return false; }
-
-        bool advanceBlockDim(TuneParam &param) const 
-        {
-          const unsigned int max_threads = deviceProp.maxThreadsDim[0];
-          const unsigned int max_blocks = deviceProp.maxGridSize[0];
-          const unsigned int max_shared = 16384;
-          const int step = deviceProp.warpSize;
-          const int threads = arg.length;
-          bool ret;
-
-          param.block.x += step;
-          if(param.block.x > max_threads || sharedBytesPerThread()*param.block.x > max_shared){
-            param.block = dim3((threads+max_blocks-1)/max_blocks, 1, 1); // ensure the blockDim is large enough given the limit on gridDim
-            param.block.x = ((param.block.x+step-1)/step)*step;
-            if(param.block.x > max_threads) errorQuda("Local lattice volume is too large for device");
-            ret = false;
-          }else{
-            ret = true;
-          }
-          param.grid = dim3((threads+param.block.x-1)/param.block.x,1,1);
-          return ret;
-        }
-
-
-      public:
-        ShiftColorSpinorField(const ShiftColorSpinorField<Output,Input> &arg, 
-            QudaFieldLocation location)
-          : arg(arg), location(location)  {}
-        virtual ~ShiftColorSpinorField() {}
-
-        void apply(const cudaStream_t &stream){
-          if(location == QUDA_CUDA_FIELD_LOCATION){
-            TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
-            shiftColorSpinorFieldKernel<Output,Input><<<tp.grid,tp.block,tp.shared_bytes>>>(arg);
-#ifdef MULTI_GPU
-            // Need to perform some communication and call exterior kernel, I guess
-#endif
-          }else{ // run the CPU code
-            errorQuda("ShiftColorSpinorField is not yet implemented on the CPU\n");
-          }
-        } // apply
-
-        virtual void initTuneParam(TuneParam &param) const
-        {
-          const unsigned int max_threads = deviceProp.maxThreadsDim[0];
-          const unsigned int max_blocks = deviceProp.maxGridSize[0];
-          const int threads = arg.length;
-          const int step = deviceProp.warpSize;
-          param.block = dim3((threads+max_blocks-1)/max_blocks, 1, 1); // ensure the blockDim is large enough, given the limit on gridDim
-          param.block.x = ((param.block.x+step-1) / step) * step; // round up to the nearest "step"
-          if (param.block.x > max_threads) errorQuda("Local lattice volume is too large for device");
-          param.grid = dim3((threads+param.block.x-1)/param.block.x, 1, 1);
-          param.shared_bytes = sharedBytesPerThread()*param.block.x > sharedBytesPerBlock(param) ?
-            sharedBytesPerThread()*param.block.x : sharedBytesPerBlock(param);
-        }
-
-        /** sets default values for when tuning is disabled */
-        void defaultTuneParam(TuneParam &param) const {
-          initTuneParam(param);
-        }
-
-        long long flops() const { return 0; } // fixme
-        long long bytes() const { return 0; } // fixme
-
-        TuneKey tuneKey() const {
-          std::stringstream vol, aux;
-          vol << X[0] << "x";
-          vol << X[1] << "x";
-          vol << X[2] << "x";
-          vol << X[3] << "x";
-          aux << "threads=" << 2*arg.in.volumeCB << ",prec=" << sizeof(Complex)/2;
-          aux << "stride=" << arg.in.stride;
-          return TuneKey(vol.str(), typeid(*this).name(), aux.str());
-        }
-    };
-
-
-  // Should really have a parity
-  void shiftColorSpinorField(cudaColorSpinorField &dst, const cudaColorSpinorField &src, const unsigned int parity, const unsigned int dim, const int shift) {
-
-    if(&src == &dst){
-      errorQuda("destination field is the same as source field\n");
-      return;
+  // template on the color-spinor field order
+  template <typename Float, int nSpin, int nColor>
+    void shiftColorSpinorField(ColorSpinorField &dst, const ColorSpinorField &src, int parity, int dim, int shift)
+  {
+    if (src.isNative()) {
+      typedef typename colorspinor_mapper<Float,nSpin,nColor>::type F;
+      shiftColorSpinorField<Float,nSpin,nColor,F>(dst, src, parity, dim, shift);
+    } else if (src.FieldOrder() == QUDA_FLOAT2_FIELD_ORDER) {
+      typedef typename colorspinor_order_mapper<Float,QUDA_FLOAT2_FIELD_ORDER,nSpin,nColor>::type F;
+      shiftColorSpinorField<Float,nSpin,nColor,F>(dst, src, parity, dim, shift);
+    } else if (src.FieldOrder() == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) {
+      if (src.Location() != QUDA_CPU_FIELD_LOCATION) errorQuda("Unsupported field order %d on the device", src.FieldOrder());
+      typedef typename colorspinor::SpaceSpinorColorOrder<Float,nSpin,nColor> F;
+      shiftColorSpinorField<Float,nSpin,nColor,F>(dst, src, parity, dim, shift);
+    } else {
+      errorQuda("Unsupported field order %d\n", src.FieldOrder());
     }
+  }
 
-    if(src.Nspin() != 1 && src.Nspin() !=4) errorQuda("nSpin(%d) not supported\n", src.Nspin());
+  // template on the number of spins
+  template <typename Float, int nColor>
+    void shiftColorSpinorField(ColorSpinorField &dst, const ColorSpinorField &src, int parity, int dim, int shift)
+  {
+    if (src.Nspin() == 1) {
+      shiftColorSpinorField<Float,1,nColor>(dst, src, parity, dim, shift);
+    } else if (src.Nspin() == 4) {
+      shiftColorSpinorField<Float,4,nColor>(dst, src, parity, dim, shift);
+    } else {
+      errorQuda("nSpin(%d) not supported\n", src.Nspin());
+    }
+  }
 
-    if(src.SiteSubset() != dst.SiteSubset())
-      errorQuda("Spinor fields do not have matching subsets\n");
+  // template on the number of colors
+  template <typename Float>
+    void shiftColorSpinorField(ColorSpinorField &dst, const ColorSpinorField &src, int parity, int dim, int shift)
+  {
+    if (src.Ncolor() == 3) {
+      shiftColorSpinorField<Float,3>(dst, src, parity, dim, shift);
+    } else {
+      errorQuda("Unsupported number of colors %d\n", src.Ncolor());
+    }
+  }
 
-    if(src.SiteSubset() == QUDA_FULL_SITE_SUBSET){
-      if(shift&1){
-        shiftColorSpinorField(dst.Even(), src.Odd(), 0, dim, shift);
-        shiftColorSpinorField(dst.Odd(), src.Even(), 1, dim, shift);
-      }else{
-        shiftColorSpinorField(dst.Even(), src.Even(), 0, dim, shift);
-        shiftColorSpinorField(dst.Odd(), src.Odd(), 1, dim, shift);
+  void shiftColorSpinorField(ColorSpinorField &dst, const ColorSpinorField &src, int parity, int dim, int shift)
+  {
+    if (&src == &dst || src.V() == dst.V()) errorQuda("destination field is the same as source field\n");
+    if (dim < 0 || dim > 3) errorQuda("Invalid shift dimension %d", dim);
+    if (src.SiteSubset() != dst.SiteSubset()) errorQuda("Spinor fields do not have matching subsets\n");
+    if (src.FieldOrder() != dst.FieldOrder())
+      errorQuda("Field order mismatch src = %d, dst = %d", src.FieldOrder(), dst.FieldOrder());
+    if (src.Nspin() != dst.Nspin()) errorQuda("nSpin mismatch src = %d, dst = %d", src.Nspin(), dst.Nspin());
+    checkPrecision(dst, src);
+    checkLocation(dst, src);
+
+    const int X = (dim == 0) ? (3-src.SiteSubset()) * src.X(0) : src.X(dim);
+    if (comm_dim_partitioned(dim) && std::abs(shift) > X)
+      errorQuda("Shift %d exceeds the local lattice extent %d in partitioned dimension %d", shift, X, dim);
+
+    if (shift != 0 && comm_dim_partitioned(dim)) {
+      // the source parity of a single-parity field is flipped by odd shifts
+      const int src_parity = (src.SiteSubset() == QUDA_FULL_SITE_SUBSET) ? QUDA_INVALID_PARITY : (parity + shift) & 1;
+      if (src.Location() == QUDA_CPU_FIELD_LOCATION) {
+        // only the halo along the shift dimension is read
+        static_cast<const cpuColorSpinorField&>(src).exchangeGhostDim((QudaParity)src_parity, std::abs(shift), 0, dim);
+      } else {
+        src.exchangeGhost((QudaParity)src_parity, std::abs(shift), 0); // last parameter is dummy
       }
-      return;
     }
 
-#ifdef MULTI_GPU
-    const int dir = (shift>0) ? QUDA_BACKWARDS : QUDA_FORWARDS; // pack the start of the field if shift is positive
-    const int offset = (shift>0) ? 0 : 1;
-#endif
-
-
-    if(dst.Precision() == QUDA_DOUBLE_PRECISION && src.Precision() == QUDA_DOUBLE_PRECISION){
-      if(src.Nspin() == 1){
-        Spinor<double2, double2, double2, 3, 0, 0> src_tex(src);
-        Spinor<double2, double2, double2, 3, 1> dst_spinor(dst);
-        ShiftColorSpinorFieldArg arg(src.Volume(), parity, dim, shift, dst_spinor, src_tex);
-        ShiftColorSpinorField shiftColorSpinor(arg, QUDA_CPU_FIELD_LOCATION);
-
-#ifdef MULTI_GPU
-        if(commDimPartitioned(dim) && dim!=3){
-          face->pack(src, 1-parity, dagger, dim, dir, streams); // pack in stream[1]
-          cudaEventRecord(packEnd, streams[1]);
-          cudaStreamWaitEvent(streams[1], packEnd, 0); // wait for pack to end in stream[1]
-          face->gather(src, dagger, 2*dim+offset, 1); // copy packed data from device buffer to host and do this in stream[1] 
-          cudaEventRecord(gatherEnd, streams[1]); // record the completion of face->gather
-        }
-#endif
-
-        shiftColorSpinor.apply(0); // shift the field in the interior region
-
-#ifdef MULTI_GPU
-        if(commDimPartitioned(dim) && dim!=3){
-          while(1){
-            cudaError_t eventQuery = cudaEventQuery(gatherEnd);
-            if(eventQuery == cudaSuccess){
-              face->commsStart(2*dim + offset); // if argument is even, send backwards, else send forwards
-              break;
-            }
-          }
-
-          // after communication, load data back on to device
-          // do this in stream[1]
-          while(1){
-            if(face->commsQuery(2*dim + offset)){
-              face->scatter(src, dagger, 2*dim+offset, 1);
-              break;
-            }
-          } // while(1) 
-          cudaEventRecord(scatterEnd, streams[1]);
-          cudaStreamWaitEvent(streams[1], scatterEnd, 0);
-          shiftColorSpinor.apply(1);
-        }
-#endif
-
-      }else{
-        errorQuda("Only staggered fermions are currently supported\n");
-      }
-    }else if(dst.Precision() == QUDA_SINGLE_PRECISION && src.Precision() == QUDA_SINGLE_PRECISION){
-      if(src.Nspin() == 1 ){
-        Spinor<float2, float2, float2, 3, 0, 0> src_tex(src);
-        Spinor<float2, float2, float2, 3, 1> dst_spinor(dst);
-        ShiftColorSpinorFieldArg arg(src.Volume(), parity, dim, shift, dst_spinor, src_tex);
-        ShiftColorSpinorField shiftColorSpinor(arg, QUDA_CPU_FIELD_LOCATION);
-      }else{
-        errorQuda("Only staggered fermions are currently supported\n");
-      }
+    if (src.Precision() == QUDA_DOUBLE_PRECISION) {
+      shiftColorSpinorField<double>(dst, src, parity, dim, shift);
+    } else if (src.Precision() == QUDA_SINGLE_PRECISION) {
+      shiftColorSpinorField<float>(dst, src, parity, dim, shift);
+    } else {
+      errorQuda("Unsupported precision %d\n", src.Precision());
     }
-    return;
   }
 
-
 } // namespace quda
-
@@ -6,6 +6,9 @@
 #include <quda_internal.h>
 #include <gauge_field_order.h>
 #include <quda_matrix.h>
+#include <color_spinor.h>
+#include <color_spinor_field_order.h>
+#include <index_helper.cuh>
 
 namespace quda {
 
@@ -66,7 +69,7 @@ namespace quda {
   };
 
   template <IndexType idxType>
-    static __device__ __forceinline__ void coordsFromIndex(int& idx, int c[4],  
+    static __device__ __host__ __forceinline__ void coordsFromIndex(int& idx, int c[4],  
         const unsigned int cb_idx, const unsigned int parity, const int X[4])
   {
       const int &LX = X[0];
@@ -123,7 +126,7 @@ namespace quda {
   
 
   // Get the  coordinates for the exterior kernels
-  __device__ static void coordsFromIndex(int x[4], const unsigned int cb_idx, const int X[4], const unsigned int dir, const int displacement, const unsigned int parity)
+  __device__ __host__ static void coordsFromIndex(int x[4], const unsigned int cb_idx, const int X[4], const unsigned int dir, const int displacement, const unsigned int parity)
   {
     int Xh[2] = {X[0]/2, X[1]/2};
     switch(dir){
@@ -163,7 +166,7 @@ namespace quda {
   }
 
 
-  __device__ __forceinline__
+  __device__ __host__ __forceinline__
   int neighborIndex(const unsigned int cb_idx, const int shift[4],  const bool partitioned[4], const unsigned int parity, const int X[4]){
     int full_idx;
     int x[4]; 
@@ -269,6 +272,98 @@ namespace quda {
     }
 
 
+  /**
+     Host interior kernel: accumulates the one and three hop outer
+     products for every site whose neighbors are on this node.
+  */
+  template<typename real, typename Output, typename InputA, typename InputB>
+  void interiorOprodCPU(StaggeredOprodArg<real, Output, InputA, InputB> &arg)
+  {
+    typedef complex<real> Complex;
+    typedef ColorSpinor<real,3,1> Vector;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int idx=0; idx<(int)arg.length; idx++) {
+      Vector x, y, z;
+      Matrix<Complex,3> result, temp;
+
+      arg.inA.load(reinterpret_cast<real*>(x.data), idx, 0);
+
+      for(int dim=0; dim<4; ++dim){
+	int shift[4] = {0,0,0,0};
+	shift[dim] = 1;
+	const int first_nbr_idx = neighborIndex(idx, shift, arg.partitioned, arg.parity, arg.X);
+	if(first_nbr_idx >= 0){
+	  arg.inB.load(reinterpret_cast<real*>(y.data), first_nbr_idx, 0);
+	  result = outerProdSpinTrace(y, x);
+	  arg.outA.load(reinterpret_cast<real*>(temp.data), idx, dim, arg.parity);
+	  result = temp + result*arg.coeff[0];
+	  arg.outA.save(reinterpret_cast<real*>(result.data), idx, dim, arg.parity);
+
+	  if (arg.nFace == 3) {
+	    shift[dim] = 3;
+	    const int third_nbr_idx = neighborIndex(idx, shift, arg.partitioned, arg.parity, arg.X);
+	    if(third_nbr_idx >= 0){
+	      arg.inB.load(reinterpret_cast<real*>(z.data), third_nbr_idx, 0);
+	      result = outerProdSpinTrace(z, x);
+	      arg.outB.load(reinterpret_cast<real*>(temp.data), idx, dim, arg.parity);
+	      result = temp + result*arg.coeff[1];
+	      arg.outB.save(reinterpret_cast<real*>(result.data), idx, dim, arg.parity);
+	    }
+	  }
+	}
+      } // dim
+    } // idx
+  } // interiorOprodCPU
+
+  /**
+     Host exterior kernel: accumulates the outer products for the
+     sites in the last arg.displacement slices of dimension arg.dir,
+     reading the neighbors from the forwards ghost zone of depth
+     arg.nFace.
+  */
+  template<typename real, typename Output, typename InputA, typename InputB>
+  void exteriorOprodCPU(StaggeredOprodArg<real, Output, InputA, InputB> &arg)
+  {
+    typedef complex<real> Complex;
+    typedef ColorSpinor<real,3,1> Vector;
+
+    Output& out = (arg.displacement == 1) ? arg.outA : arg.outB;
+    const real coeff = (arg.displacement == 1) ? arg.coeff[0] : arg.coeff[1];
+    const int dim = arg.dir;
+    const int X[5] = { arg.X[0], arg.X[1], arg.X[2], arg.X[3], 1 };
+    const int length = arg.displacement * (X[0]*X[1]*X[2]*X[3] / (2*X[dim]));
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int cb_idx=0; cb_idx<length; cb_idx++) {
+      Vector a, b;
+      Matrix<Complex,3> result, inmatrix;
+
+      int x[5];
+      coordsFromIndex(x, cb_idx, arg.X, arg.dir, arg.displacement, arg.parity);
+      x[4] = 0;
+      const int bulk_cb_idx = ((((x[3]*X[2] + x[2])*X[1] + x[1])*X[0] + x[0]) >> 1);
+
+      out.load(reinterpret_cast<real*>(inmatrix.data), bulk_cb_idx, dim, arg.parity);
+      arg.inA.load(reinterpret_cast<real*>(a.data), bulk_cb_idx, 0);
+
+      // the neighbor x+displacement sits in row x+displacement-X of the ghost zone
+      int y[5] = { x[0], x[1], x[2], x[3], x[4] };
+      y[dim] += arg.displacement - arg.nFace;
+      const int ghost_idx = ghostFaceIndex<1>(y, X, dim, arg.nFace);
+      arg.inB.loadGhost(reinterpret_cast<real*>(b.data), ghost_idx, dim, 1, 0);
+
+      result = outerProdSpinTrace(b, a);
+      result = inmatrix + result*coeff;
+      out.save(reinterpret_cast<real*>(result.data), bulk_cb_idx, dim, arg.parity);
+    }
+  } // exteriorOprodCPU
+
+
   template<typename Float, typename Output, typename InputA, typename InputB>
   class StaggeredOprodField : public Tunable {
 
@@ -403,12 +498,85 @@ namespace quda {
       checkCudaError();
     } // computeStaggeredOprodCuda
 
+  template<typename Float, typename Output>
+    void computeStaggeredOprodCPU(Output outA, Output outB, GaugeField& outFieldA, ColorSpinorField& inA, ColorSpinorField& inB,
+				  const unsigned int parity, const double coeff[2], int nFace)
+    {
+      typedef typename colorspinor::SpaceSpinorColorOrder<Float,1,3> Input;
+
+      inB.exchangeGhost((QudaParity)(1-parity), nFace, 0); // last parameter is dummy
+
+      Input spinorA(inA);
+      Input spinorB(inB, nFace, 0, 0, reinterpret_cast<Float**>(const_cast<void**>(inB.Ghost())));
+
+      // host ghost zones are indexed from the site coordinates
+      unsigned int ghostOffset[4] = {0,0,0,0};
+
+      StaggeredOprodArg<Float,Output,Input,Input> arg(parity, 0, ghostOffset, 1, OPROD_INTERIOR_KERNEL, nFace, coeff, spinorA, spinorB, outA, outB, outFieldA);
+      interiorOprodCPU(arg);
+
+      for(int i=3; i>=0; i--){
+	if (commDimPartitioned(i)) {
+	  arg.kernelType = OPROD_EXTERIOR_KERNEL;
+	  arg.dir = i;
+
+	  // First, do the one hop term
+	  arg.displacement = 1;
+	  exteriorOprodCPU(arg);
+
+	  // Now do the 3 hop term
+	  if (nFace == 3) {
+	    arg.displacement = 3;
+	    exteriorOprodCPU(arg);
+	  }
+	}
+      } // i=3,..,0
+    } // computeStaggeredOprodCPU
+
+  // template on the output gauge field order
+  template<typename Float>
+    void computeStaggeredOprodCPU(GaugeField& outA, GaugeField& outB, ColorSpinorField& inA, ColorSpinorField& inB,
+				  const unsigned int parity, const double coeff[2], int nFace)
+    {
+      if (outA.Order() == QUDA_QDP_GAUGE_ORDER) {
+	typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,3>::type Output;
+	computeStaggeredOprodCPU<Float>(Output(outA), Output(outB), outA, inA, inB, parity, coeff, nFace);
+      } else if (outA.Order() == QUDA_MILC_GAUGE_ORDER) {
+	typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,3>::type Output;
+	computeStaggeredOprodCPU<Float>(Output(outA), Output(outB), outA, inA, inB, parity, coeff, nFace);
+      } else {
+	errorQuda("Unsupported output ordering: %d\n", outA.Order());
+      }
+    }
+
 #endif // GPU_STAGGERED_DIRAC
 
   void computeStaggeredOprod(GaugeField& outA, GaugeField& outB, ColorSpinorField& inEven, ColorSpinorField& inOdd,
 			     const unsigned int parity, const double coeff[2], int nFace)
   {
 #ifdef GPU_STAGGERED_DIRAC
+    if (outA.Location() == QUDA_CPU_FIELD_LOCATION) {
+      if (outA.Order() != outB.Order())
+	errorQuda("Mismatched output ordering: %d %d\n", outA.Order(), outB.Order());
+
+      if (inEven.FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER)
+	errorQuda("Unsupported input ordering: %d\n", inEven.FieldOrder());
+
+      if (inEven.Precision() != outA.Precision()) errorQuda("Mixed precision not supported: %d %d\n", inEven.Precision(), outA.Precision());
+
+      ColorSpinorField &inA = (parity&1) ? inOdd : inEven;
+      ColorSpinorField &inB = (parity&1) ? inEven : inOdd;
+
+      if (inEven.Precision() == QUDA_DOUBLE_PRECISION) {
+	computeStaggeredOprodCPU<double>(outA, outB, inA, inB, parity, coeff, nFace);
+      } else if (inEven.Precision() == QUDA_SINGLE_PRECISION) {
+	computeStaggeredOprodCPU<float>(outA, outB, inA, inB, parity, coeff, nFace);
+      } else {
+	errorQuda("Unsupported precision: %d\n", inEven.Precision());
+      }
+      return;
+    }
+
     if(outA.Order() != QUDA_FLOAT2_GAUGE_ORDER)
       errorQuda("Unsupported output ordering: %d\n", outA.Order());    
 
@@ -198,30 +198,21 @@ namespace quda {
     FillV(V, B, Nvec);  //printfQuda("V fill check %e\n", norm2(*V));
   }
 
-  struct Int2 {
-    int x, y;
-    Int2() : x(0), y(0) { } 
-    Int2(int x, int y) : x(x), y(y) { } 
-    
-    bool operator<(const Int2 &a) const {
-      return (x < a.x) ? true : (x==a.x && y<a.y) ? true : false;
-    }
-  };
-
   // compute the fine-to-coarse site map
   void Transfer::createGeoMap(int *geo_bs) {
 
-    int x[QUDA_MAX_DIM];
-
     ColorSpinorField &fine(*fine_tmp_h);
     ColorSpinorField &coarse(*coarse_tmp_h);
 
     // compute the coarse grid point for every site (assuming parity ordering currently)
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (int i=0; i<fine.Volume(); i++) {
+      int x[QUDA_MAX_DIM];
+
       // compute the lattice-site index for this offset index
       fine.LatticeIndex(x, i);
-      
-      //printfQuda("fine idx %d = fine (%d,%d,%d,%d), ", i, x[0], x[1], x[2], x[3]);
 
       // compute the corresponding coarse-grid index given the block size
       for (int d=0; d<fine.Ndim(); d++) x[d] /= geo_bs[d];
@@ -230,16 +221,15 @@ namespace quda {
       int k;
       coarse.OffsetIndex(k, x); // this index is parity ordered
       fine_to_coarse_h[i] = k;
-
-      //printfQuda("coarse after (%d,%d,%d,%d), coarse idx %d\n", x[0], x[1], x[2], x[3], k);
     }
 
-    // now create an inverse-like variant of this
-
-    std::vector<Int2> geo_sort(B[0]->Volume());
-    for (unsigned int i=0; i<geo_sort.size(); i++) geo_sort[i] = Int2(fine_to_coarse_h[i], i);
-    std::sort(geo_sort.begin(), geo_sort.end());
-    for (unsigned int i=0; i<geo_sort.size(); i++) coarse_to_fine_h[i] = geo_sort[i].y;
+    // now create an inverse-like variant of this: a counting sort
+    // on the coarse index, which keeps the fine sites of each
+    // aggregate in ascending order
+    std::vector<int> offset(coarse.Volume()+1, 0);
+    for (int i=0; i<fine.Volume(); i++) offset[fine_to_coarse_h[i]+1]++;
+    for (int k=0; k<coarse.Volume(); k++) offset[k+1] += offset[k];
+    for (int i=0; i<fine.Volume(); i++) coarse_to_fine_h[offset[fine_to_coarse_h[i]]++] = i;
 
     if (enable_gpu) {
       qudaMemcpy(fine_to_coarse_d, fine_to_coarse_h, B[0]->Volume()*sizeof(int), cudaMemcpyHostToDevice);
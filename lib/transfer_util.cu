@@ -4,6 +4,7 @@
 #include <typeinfo>
 #include <vector>
 #include <assert.h>
+#include <limits>
 
 namespace quda {
 
@@ -193,17 +194,20 @@ namespace quda {
     for (int d=0; d<in.Ndim(); d++) geoBlockSize *= geo_bs[d];
     int blockSize = geoBlockSize * in.Ncolor() * spin_bs; // blockSize includes internal dof
 
-    int x[QUDA_MAX_DIM]; // global coordinates
-    int y[QUDA_MAX_DIM]; // local coordinates within a block (full site ordering)
-
     int checkLength = in.Nparity() * in.VolumeCB() * in.Ncolor() * in.Nspin() * in.Nvec();
     int *check = new int[checkLength];
     int count = 0;
 
     // Run through the fine grid and do the block ordering
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2) reduction(+:count)
+#endif
     for (int parity = 0; parity<in.Nparity(); parity++) {
       for (int x_cb=0; x_cb<in.VolumeCB(); x_cb++) {
+	int x[QUDA_MAX_DIM]; // global coordinates
+	int y[QUDA_MAX_DIM]; // local coordinates within a block (full site ordering)
 	int i = parity*in.VolumeCB() + x_cb;
+	int site_count = i * in.Nvec() * in.Nspin() * in.Ncolor();
 
 	// Get fine grid coordinates
 	V.LatticeIndex(x, i);
@@ -237,7 +241,8 @@ namespace quda {
 	      if (toBlock) out[index] = in(parity, x_cb, s, c, v); // going to block order
 	      else in(parity, x_cb, s, c, v) = out[index]; // coming from block order
 	    
-	      check[count++] = index;
+	      check[site_count++] = index;
+	      count++;
 	    }
 	  }
 	}
@@ -274,17 +279,20 @@ namespace quda {
     for (int d=0; d<in.Ndim(); d++) geoBlockSize *= geo_bs[d];
     int blockSize = geoBlockSize * in.Ncolor(); // blockSize includes internal dof
 
-    int x[QUDA_MAX_DIM]; // global coordinates
-    int y[QUDA_MAX_DIM]; // local coordinates within a block (full site ordering)
-
     int checkLength = in.Nparity() * in.VolumeCB() * in.Ncolor() * in.Nvec();
     int *check = new int[checkLength];
     int count = 0;
 
     // Run through the fine grid and do the block ordering
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2) reduction(+:count)
+#endif
     for (int parity = 0; parity<in.Nparity(); parity++) {
       for (int x_cb=0; x_cb<in.VolumeCB(); x_cb++) {
+	int x[QUDA_MAX_DIM]; // global coordinates
+	int y[QUDA_MAX_DIM]; // local coordinates within a block (full site ordering)
 	int i = parity*in.VolumeCB() + x_cb;
+	int site_count = i * in.Nvec() * in.Ncolor();
 
 	// Get fine grid coordinates
 	V.LatticeIndex(x, i);
@@ -318,7 +326,8 @@ namespace quda {
 	    if (toBlock) out[index] = in(parity, x_cb, s, c, v); // going to block order
 	    else in(parity, x_cb, s, c, v) = out[index]; // coming from block order
 
-	    check[count++] = index;
+	    check[site_count++] = index;
+	    count++;
 	  }
 	}
 
@@ -337,45 +346,134 @@ namespace quda {
 
 
 
-  // Orthogonalise the nc vectors v[] of length n
+  // Orthogonalise the nc vectors v[] of length n using modified Gram-Schmidt
   // this assumes the ordering v[(b * Nvec + v) * blocksize + i]
+  template <typename sumFloat, typename Float, int N>
+  void blockModifiedGramSchmidt(complex<Float> *v, int b, int blockSize) {
+    for (int jc=0; jc<N; jc++) {
+
+      for (int ic=0; ic<jc; ic++) {
+	// Calculate dot product.
+	complex<sumFloat> dot = 0.0;
+	for (int i=0; i<blockSize; i++) {
+	  complex<Float> z = conj(v[(b*N+ic)*blockSize+i]) * v[(b*N+jc)*blockSize+i];
+	  dot += complex<sumFloat>(z.real(), z.imag());
+	}
+
+	// Subtract the blocks to orthogonalise
+	const complex<Float> d(dot.real(), dot.imag());
+	for (int i=0; i<blockSize; i++)
+	  v[(b*N+jc)*blockSize+i] -= d * v[(b*N+ic)*blockSize+i];
+      }
 
+      // Normalize the block
+      sumFloat nrm2 = 0.0;
+      for (int i=0; i<blockSize; i++) nrm2 += norm(v[(b*N+jc)*blockSize+i]);
+      sumFloat scale = nrm2 > 0.0 ? 1.0/sqrt(nrm2) : 0.0;
+      for (int i=0; i<blockSize; i++) v[(b*N+jc)*blockSize+i] *= scale;
+    }
+  }
+
+  /**
+     Orthonormalize all N vectors of block b at once using a Cholesky
+     QR step: form the Gram matrix G = V^dag V, factor G = R^dag R and
+     replace V with V R^{-1}.  This gives the same basis as
+     Gram-Schmidt, but with a single pass over the block for the Gram
+     matrix and a single triangular update.  Returns false if the
+     factorization is not numerically trustworthy (non-positive pivot,
+     or the pivots indicate a condition number of G that is too large
+     for the working precision), in which case the block is left
+     untouched.
+     @param v Block-ordered vectors
+     @param b The block we are orthonormalizing
+     @param blockSize Length of each vector in the block
+     @param G Workspace for the N x N Gram matrix
+  */
   template <typename sumFloat, typename Float, int N>
-  void blockGramSchmidt(complex<Float> *v, int nBlocks, int blockSize) {
-    
-    for (int b=0; b<nBlocks; b++) {
-      for (int jc=0; jc<N; jc++) {
-      
-	for (int ic=0; ic<jc; ic++) {
-	  // Calculate dot product.
-	  complex<Float> dot = 0.0;
-	  for (int i=0; i<blockSize; i++) 
-	    dot += conj(v[(b*N+ic)*blockSize+i]) * v[(b*N+jc)*blockSize+i];
-	  
-	  // Subtract the blocks to orthogonalise
-	  for (int i=0; i<blockSize; i++) 
-	    v[(b*N+jc)*blockSize+i] -= dot * v[(b*N+ic)*blockSize+i];
+  bool blockCholeskyQR(complex<Float> *v, int b, int blockSize, complex<sumFloat> *G) {
+    // Gram matrix (lower triangle)
+    for (int j=0; j<N; j++) {
+      for (int k=0; k<=j; k++) {
+	complex<sumFloat> dot = 0.0;
+	for (int i=0; i<blockSize; i++) {
+	  complex<Float> z = conj(v[(b*N+j)*blockSize+i]) * v[(b*N+k)*blockSize+i];
+	  dot += complex<sumFloat>(z.real(), z.imag());
+	}
+	G[j*N+k] = dot; // G(j,k) = <v_j, v_k> = conj(G(k,j))
+      }
+    }
+
+    // in-place Cholesky G = L L^dag, with L lower triangular (L = R^dag)
+    sumFloat max_diag = 0.0, min_diag = 0.0;
+    for (int j=0; j<N; j++) {
+      for (int k=0; k<=j; k++) {
+	complex<sumFloat> sum = G[j*N+k];
+	for (int l=0; l<k; l++) sum -= G[j*N+l] * conj(G[k*N+l]);
+	if (j == k) {
+	  if (!(sum.real() > 0.0)) return false;
+	  sumFloat d = sqrt(sum.real());
+	  G[j*N+j] = d;
+	  if (j == 0 || d > max_diag) max_diag = d;
+	  if (j == 0 || d < min_diag) min_diag = d;
+	} else {
+	  G[j*N+k] = sum / G[k*N+k].real();
 	}
-	
-	// Normalize the block
-	// nrm2 is pure real, but need to use Complex because of template.
-        sumFloat nrm2 = 0.0;
-	for (int i=0; i<blockSize; i++) nrm2 += norm(v[(b*N+jc)*blockSize+i]);
-	sumFloat scale = nrm2 > 0.0 ? 1.0/sqrt(nrm2) : 0.0;
-	for (int i=0; i<blockSize; i++) v[(b*N+jc)*blockSize+i] *= scale;
       }
+    }
 
-      /*      
-      for (int jc=0; jc<N; jc++) {
-        complex<sumFloat> nrm2 = 0.0;
-        for(int i=0; i<blockSize; i++) nrm2 += norm(v[(b*N+jc)*blockSize+i]);
-	//printfQuda("block = %d jc = %d nrm2 = %f\n", b, jc, nrm2.real());
+    // the ratio of the pivots bounds the conditioning of the block
+    // from below: if it is too close to the working precision we
+    // would lose orthogonality, so let the caller fall back
+    const sumFloat eps = std::numeric_limits<Float>::epsilon();
+    if (min_diag < sqrt(eps) * max_diag) return false;
+
+    // V <- V L^{-dag}: q_j = (v_j - sum_{k<j} conj(L(j,k)) q_k) / L(j,j)
+    for (int j=0; j<N; j++) {
+      for (int k=0; k<j; k++) {
+	complex<Float> r = complex<Float>(G[j*N+k].real(), -G[j*N+k].imag());
+	for (int i=0; i<blockSize; i++) v[(b*N+j)*blockSize+i] -= r * v[(b*N+k)*blockSize+i];
       }
-      */
+      Float scale = 1.0 / G[j*N+j].real();
+      for (int i=0; i<blockSize; i++) v[(b*N+j)*blockSize+i] *= scale;
+    }
+
+    return true;
+  }
+
+  // Orthogonalise the nc vectors v[] of length n
+  // this assumes the ordering v[(b * Nvec + v) * blocksize + i]
+  // Each block is independent, so the blocks are distributed over
+  // threads.  Each block uses two passes of Cholesky QR (CholQR2),
+  // where the second pass restores orthogonality lost to rounding in
+  // the first; blocks that fail the stability check fall back to two
+  // passes of modified Gram-Schmidt.  Returns the number of blocks
+  // that needed the fallback.
+  template <typename sumFloat, typename Float, int N>
+  int blockGramSchmidt(complex<Float> *v, int nBlocks, int blockSize) {
+    int fallback = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:fallback)
+#endif
+    {
+      std::vector<complex<sumFloat> > G(N*N);
 
-      //printf("blockGramSchmidt done %d / %d\n", b, nBlocks);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+      for (int b=0; b<nBlocks; b++) {
+	if (!blockCholeskyQR<sumFloat,Float,N>(v, b, blockSize, G.data()) ||
+	    !blockCholeskyQR<sumFloat,Float,N>(v, b, blockSize, G.data())) {
+	  blockModifiedGramSchmidt<sumFloat,Float,N>(v, b, blockSize);
+	  blockModifiedGramSchmidt<sumFloat,Float,N>(v, b, blockSize);
+	  fallback++;
+	}
+      }
     }
 
+    if (fallback > 0 && getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("Block orthogonalization used Gram-Schmidt fallback for %d / %d blocks\n", fallback, nBlocks);
+    return fallback;
   }
 
   template <typename sumType, typename real, int N>
@@ -385,13 +483,14 @@ namespace quda {
     int nBlock;
     int blockSize;
     const ColorSpinorField &meta;
+    int fallback;
 
     unsigned int sharedBytesPerThread() const { return 0; }
     unsigned int sharedBytesPerBlock(const TuneParam &param) const { return 0; }
 
   public:
     BlockGramSchmidt(complex<real> *v, int nBlock, int blockSize, const ColorSpinorField &meta)
-      : v(v), nBlock(nBlock), blockSize(blockSize), meta(meta) {
+      : v(v), nBlock(nBlock), blockSize(blockSize), meta(meta), fallback(0) {
       if (meta.Location() == QUDA_CPU_FIELD_LOCATION) sprintf(aux, "nBlock=%d,blockSize=%d,CPU", nBlock, blockSize);
       else sprintf(aux, "nBlock=%d,blockSize=%d,GPU", nBlock, blockSize);
     }
@@ -401,7 +500,7 @@ namespace quda {
     void apply(const cudaStream_t &stream) {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       if (meta.Location() == QUDA_CPU_FIELD_LOCATION) {
-	blockGramSchmidt<sumType, real, N>(v, nBlock, blockSize);
+	fallback = blockGramSchmidt<sumType, real, N>(v, nBlock, blockSize);
       } else {
 	errorQuda("Not implemented for GPU");
       }
@@ -409,6 +508,9 @@ namespace quda {
 
     bool advanceTuneParam(TuneParam &param) const { return false; }
 
+    /** Number of blocks that fell back to Gram-Schmidt in the last apply */
+    int Fallback() const { return fallback; }
+
     TuneKey tuneKey() const { return TuneKey(meta.VolString(), typeid(*this).name(), aux); }
 
     long long flops() const { return nBlock * N * ((N-1) * (8l + 8l) + 2l) * blockSize; }
@@ -543,7 +645,7 @@ namespace quda {
 #endif
 
     template<typename Float, int nSpin, int nColor, int nVec>
-  void BlockOrthogonalize(ColorSpinorField &V, const int *geo_bs, const int *geo_map, int spin_bs) {
+  int BlockOrthogonalize(ColorSpinorField &V, const int *geo_bs, const int *geo_map, int spin_bs) {
     complex<Float> *Vblock = new complex<Float>[V.Volume()*V.Nspin()*V.Ncolor()];
 
     if (V.FieldOrder() == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) {
@@ -579,88 +681,94 @@ namespace quda {
 
       delete []Vblock;
 
+      return ortho.Fallback();
     } else {
       errorQuda("Unsupported field order %d\n", V.FieldOrder());
     }
 
+    return 0;
   }
 
   template<typename Float, int nSpin, int nColor>
-  void BlockOrthogonalize(ColorSpinorField &V, int Nvec, const int *geo_bs, const int *geo_map, int spin_bs) {
+  int BlockOrthogonalize(ColorSpinorField &V, int Nvec, const int *geo_bs, const int *geo_map, int spin_bs) {
     if (Nvec == 2) {
-      BlockOrthogonalize<Float,nSpin,nColor,2>(V, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<Float,nSpin,nColor,2>(V, geo_bs, geo_map, spin_bs);
     } else if (Nvec == 4) {
-      BlockOrthogonalize<Float,nSpin,nColor,4>(V, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<Float,nSpin,nColor,4>(V, geo_bs, geo_map, spin_bs);
     } else if (Nvec == 8) {
-      BlockOrthogonalize<Float,nSpin,nColor,8>(V, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<Float,nSpin,nColor,8>(V, geo_bs, geo_map, spin_bs);
     } else if (Nvec == 12) {
-      BlockOrthogonalize<Float,nSpin,nColor,12>(V, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<Float,nSpin,nColor,12>(V, geo_bs, geo_map, spin_bs);
     } else if (Nvec == 16) {
-      BlockOrthogonalize<Float,nSpin,nColor,16>(V, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<Float,nSpin,nColor,16>(V, geo_bs, geo_map, spin_bs);
     } else if (Nvec == 20) {
-      BlockOrthogonalize<Float,nSpin,nColor,20>(V, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<Float,nSpin,nColor,20>(V, geo_bs, geo_map, spin_bs);
     } else if (Nvec == 24) {
-      BlockOrthogonalize<Float,nSpin,nColor,24>(V, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<Float,nSpin,nColor,24>(V, geo_bs, geo_map, spin_bs);
     } else if (Nvec == 32) {
-      BlockOrthogonalize<Float,nSpin,nColor,32>(V, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<Float,nSpin,nColor,32>(V, geo_bs, geo_map, spin_bs);
     } else if (Nvec == 48) {
-      BlockOrthogonalize<Float,nSpin,nColor,48>(V, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<Float,nSpin,nColor,48>(V, geo_bs, geo_map, spin_bs);
     } else {
       errorQuda("Unsupported nVec %d\n", Nvec);
     }
+    return 0;
   }
 
   template<typename Float, int nSpin>
-  void BlockOrthogonalize(ColorSpinorField &V, int Nvec, 
+  int BlockOrthogonalize(ColorSpinorField &V, int Nvec, 
 			  const int *geo_bs, const int *geo_map, int spin_bs) {
     if (V.Ncolor()/Nvec == 3) {
-      BlockOrthogonalize<Float,nSpin,3>(V, Nvec, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<Float,nSpin,3>(V, Nvec, geo_bs, geo_map, spin_bs);
     } else if (V.Ncolor()/Nvec == 2) {
-      BlockOrthogonalize<Float,nSpin,2>(V, Nvec, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<Float,nSpin,2>(V, Nvec, geo_bs, geo_map, spin_bs);
     } else if (V.Ncolor()/Nvec == 8) {
-      BlockOrthogonalize<Float,nSpin,8>(V, Nvec, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<Float,nSpin,8>(V, Nvec, geo_bs, geo_map, spin_bs);
     } else if (V.Ncolor()/Nvec == 16) {
-      BlockOrthogonalize<Float,nSpin,16>(V, Nvec, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<Float,nSpin,16>(V, Nvec, geo_bs, geo_map, spin_bs);
     } else if (V.Ncolor()/Nvec == 24) {
-      BlockOrthogonalize<Float,nSpin,24>(V, Nvec, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<Float,nSpin,24>(V, Nvec, geo_bs, geo_map, spin_bs);
     } else if (V.Ncolor()/Nvec == 32) {
-      BlockOrthogonalize<Float,nSpin,32>(V, Nvec, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<Float,nSpin,32>(V, Nvec, geo_bs, geo_map, spin_bs);
     } else if (V.Ncolor()/Nvec == 48) {
-      BlockOrthogonalize<Float,nSpin,48>(V, Nvec, geo_bs, geo_map, spin_bs); //for staggered, even-odd blocking presumed
+      return BlockOrthogonalize<Float,nSpin,48>(V, Nvec, geo_bs, geo_map, spin_bs); //for staggered, even-odd blocking presumed
     }  
     else {
       errorQuda("Unsupported nColor %d\n", V.Ncolor()/Nvec);
     }
+    return 0;
   }
 
   template<typename Float>
-  void BlockOrthogonalize(ColorSpinorField &V, int Nvec, 
+  int BlockOrthogonalize(ColorSpinorField &V, int Nvec, 
 			  const int *geo_bs, const int *geo_map, int spin_bs) {
     if (V.Nspin() == 4) {
-      BlockOrthogonalize<Float,4>(V, Nvec, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<Float,4>(V, Nvec, geo_bs, geo_map, spin_bs);
     } else if(V.Nspin() ==2) {
-      BlockOrthogonalize<Float,2>(V, Nvec, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<Float,2>(V, Nvec, geo_bs, geo_map, spin_bs);
     } else if (V.Nspin() == 1) {
-      BlockOrthogonalize<Float,1>(V, Nvec, geo_bs, geo_map, 1);
+      return BlockOrthogonalize<Float,1>(V, Nvec, geo_bs, geo_map, 1);
     }
     else {
       errorQuda("Unsupported nSpin %d\n", V.Nspin());
     }
+    return 0;
   }
 
-  void BlockOrthogonalize(ColorSpinorField &V, int Nvec, 
+  int BlockOrthogonalize(ColorSpinorField &V, int Nvec, 
 			  const int *geo_bs, const int *geo_map, int spin_bs) {
     if (V.Precision() == QUDA_DOUBLE_PRECISION) {
 #ifdef GPU_MULTIGRID_DOUBLE
-      BlockOrthogonalize<double>(V, Nvec, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<double>(V, Nvec, geo_bs, geo_map, spin_bs);
 #else
       errorQuda("Double precision multigrid has not been enabled");
 #endif
     } else if (V.Precision() == QUDA_SINGLE_PRECISION) {
-      BlockOrthogonalize<float>(V, Nvec, geo_bs, geo_map, spin_bs);
+      return BlockOrthogonalize<float>(V, Nvec, geo_bs, geo_map, spin_bs);
     } else {
       errorQuda("Unsupported precision %d\n", V.Precision());
     }
+    return 0;
   }
 
 } // namespace quda
@@ -0,0 +1,181 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <transfer.h>
+#include <util_quda.h>
+#include <comm_quda.h>
+
+#include <test_util.h>
+#include "misc.h"
+
+// Tests the host block orthogonalization used to build the multigrid
+// prolongator.  A random set of null-space vectors is orthonormalized
+// with Cholesky QR, and a set where two vectors are nearly parallel
+// is used to force the Gram-Schmidt fallback.  In both cases the Gram
+// matrix of every block is compared with the identity.
+
+using namespace quda;
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+
+extern void usage(char** );
+
+static const int Nvec = 2;     // number of null-space vectors
+static const int spin_bs = 2;  // spin block size (chirality)
+static const int geo_bs[] = { 2, 2, 2, 2 };
+
+void display_test_info()
+{
+  printfQuda("running the following test:\n");
+
+  printfQuda("prec    S_dimension T_dimension Nvec\n");
+  printfQuda("%s   %d/%d/%d          %d         %d\n", get_prec_str(QUDA_SINGLE_PRECISION), xdim, ydim, zdim, tdim, Nvec);
+
+  printfQuda("Grid partition info:     X  Y  Z  T\n");
+  printfQuda("                         %d  %d  %d  %d\n",
+	     dimPartitioned(0),
+	     dimPartitioned(1),
+	     dimPartitioned(2),
+	     dimPartitioned(3));
+}
+
+// maximum deviation of the Gram matrix of each block from the identity
+static double orthonormalityDeviation(const ColorSpinorField &V, const int *fine_to_coarse, int nCoarse)
+{
+  const int nSpin = V.Nspin();
+  const int nColor = V.Ncolor() / Nvec;
+  const int nChiral = nSpin / spin_bs;
+  const float *v = static_cast<const float*>(V.V());
+
+  // the raw complex index of (site, s, c, vec) in space-spin-color order is ((site*nSpin+s)*nColor+c)*Nvec+vec
+  std::vector<Complex> G((size_t)nCoarse*nChiral*Nvec*Nvec, Complex(0.0,0.0));
+  for (int i = 0; i < V.Volume(); i++) {
+    for (int s = 0; s < nSpin; s++) {
+      Complex *g = &G[((size_t)fine_to_coarse[i]*nChiral + s/spin_bs)*Nvec*Nvec];
+      for (int c = 0; c < nColor; c++) {
+	const float *z = v + (((size_t)i*nSpin + s)*nColor + c)*Nvec*2;
+	for (int j = 0; j < Nvec; j++)
+	  for (int k = 0; k < Nvec; k++)
+	    g[j*Nvec+k] += Complex(z[2*j], -z[2*j+1]) * Complex(z[2*k], z[2*k+1]);
+      }
+    }
+  }
+
+  double dev = 0.0;
+  for (size_t b = 0; b < G.size() / (Nvec*Nvec); b++)
+    for (int j = 0; j < Nvec; j++)
+      for (int k = 0; k < Nvec; k++)
+	dev = std::max(dev, std::abs(G[b*Nvec*Nvec + j*Nvec+k] - Complex(j == k ? 1.0 : 0.0, 0.0)));
+
+  comm_allreduce_max(&dev);
+  return dev;
+}
+
+// fill V with random vectors; if ill_conditioned is set the second
+// vector only differs from the first by a small random perturbation
+static void fillV(ColorSpinorField &V, bool ill_conditioned)
+{
+  float *v = static_cast<float*>(V.V());
+  const size_t n = (size_t)V.Volume() * V.Nspin() * V.Ncolor() / Nvec;
+  for (size_t i = 0; i < n; i++) {
+    for (int j = 0; j < Nvec; j++) {
+      v[(i*Nvec + j)*2 + 0] = rand() / (float)RAND_MAX - 0.5f;
+      v[(i*Nvec + j)*2 + 1] = rand() / (float)RAND_MAX - 0.5f;
+    }
+    if (ill_conditioned) {
+      v[(i*Nvec + 1)*2 + 0] = v[(i*Nvec + 0)*2 + 0] + 1e-5f * v[(i*Nvec + 1)*2 + 0];
+      v[(i*Nvec + 1)*2 + 1] = v[(i*Nvec + 0)*2 + 1] + 1e-5f * v[(i*Nvec + 1)*2 + 1];
+    }
+  }
+}
+
+static int blockOrthoTest()
+{
+  ColorSpinorParam param;
+  param.nColor = 3;
+  param.nSpin = 4;
+  param.nDim = 4;
+  param.x[0] = xdim;
+  param.x[1] = ydim;
+  param.x[2] = zdim;
+  param.x[3] = tdim;
+  param.precision = QUDA_SINGLE_PRECISION;
+  param.pad = 0;
+  param.siteSubset = QUDA_FULL_SITE_SUBSET;
+  param.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  param.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  param.gammaBasis = QUDA_UKQCD_GAMMA_BASIS;
+  param.create = QUDA_ZERO_FIELD_CREATE;
+
+  cpuColorSpinorField fine(param);
+  ColorSpinorField *coarse = fine.CreateCoarse(geo_bs, spin_bs, Nvec);
+
+  param.nColor = 3 * Nvec;
+  cpuColorSpinorField V(param);
+
+  // fine-to-coarse map, computed as in Transfer::createGeoMap
+  std::vector<int> fine_to_coarse(fine.Volume());
+  for (int i = 0; i < fine.Volume(); i++) {
+    int x[QUDA_MAX_DIM];
+    fine.LatticeIndex(x, i);
+    for (int d = 0; d < fine.Ndim(); d++) x[d] /= geo_bs[d];
+    coarse->OffsetIndex(fine_to_coarse[i], x);
+  }
+
+  const int nBlocks = coarse->Volume() * (V.Nspin() / spin_bs);
+  const double tol = 1e-5;
+  int fails = 0;
+
+  for (int ill = 0; ill < 2; ill++) {
+    fillV(V, ill);
+    int fallback = BlockOrthogonalize(V, Nvec, geo_bs, fine_to_coarse.data(), spin_bs);
+    double dev = orthonormalityDeviation(V, fine_to_coarse.data(), coarse->Volume());
+
+    // well-conditioned blocks must all take the Cholesky QR path and ill-conditioned ones the fallback
+    const int expected = ill ? nBlocks : 0;
+    printfQuda("%s blocks: %d / %d Gram-Schmidt fallbacks (expected %d), max deviation from orthonormality %e\n",
+	       ill ? "Ill-conditioned" : "Random", fallback, nBlocks, expected, dev);
+    if (fallback != expected || dev > tol) fails++;
+  }
+
+  delete coarse;
+  return fails;
+}
+
+int main(int argc, char **argv)
+{
+  for (int i = 1; i < argc; i++){
+    if(process_command_line_option(argc, argv, &i) == 0){
+      continue;
+    }
+    printf("ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  // initialize QMP/MPI, QUDA comms grid and RNG (test_util.cpp)
+  initComms(argc, argv, gridsize_from_cmdline);
+
+  display_test_info();
+
+  initQuda(device);
+  setVerbosity(QUDA_VERBOSE);
+
+  int fails = blockOrthoTest();
+  printfQuda("%s: %d failures\n", fails ? "FAILED" : "PASSED", fails);
+
+  endQuda();
+  finalizeComms();
+
+  return fails;
+}
@@ -0,0 +1,219 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <checksum.h>
+#include <util_quda.h>
+#include <comm_quda.h>
+
+#include <test_util.h>
+#include "misc.h"
+
+// Tests the position-dependent checksum of host color-spinor fields.
+// The checksum of a random field is compared with a reference computed
+// here from the global site coordinates, using a copy of the mixing
+// function that is first checked against the published splitmix64
+// output.  The same field in space-color-spin order must give the same
+// checksum, exchanging two components of a site or two sites must
+// change it, and the incremental checksum must follow the full one
+// as sites are modified and touched.
+
+using namespace quda;
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaPrecision prec;
+
+extern void usage(char** );
+
+void display_test_info()
+{
+  printfQuda("running the following test:\n");
+
+  printfQuda("prec    S_dimension T_dimension\n");
+  printfQuda("%s   %d/%d/%d          %d\n", get_prec_str(prec), xdim, ydim, zdim, tdim);
+
+  printfQuda("Grid partition info:     X  Y  Z  T\n");
+  printfQuda("                         %d  %d  %d  %d\n",
+	     dimPartitioned(0),
+	     dimPartitioned(1),
+	     dimPartitioned(2),
+	     dimPartitioned(3));
+}
+
+static uint64_t mix(uint64_t x)
+{
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+static uint64_t mix(uint64_t word, uint64_t position) { return mix(word ^ mix(position + 0x9e3779b97f4a7c15ull)); }
+
+// the first outputs of splitmix64 seeded with 1234567
+static int knownAnswerTest()
+{
+  const uint64_t expected[] = { 6457827717110365317ull, 3203168211198807973ull, 9817491932198370423ull,
+				4593380528125082431ull, 16408922859458223821ull };
+  uint64_t state = 1234567;
+  int fails = 0;
+  for (unsigned int i = 0; i < sizeof(expected)/sizeof(expected[0]); i++) {
+    state += 0x9e3779b97f4a7c15ull;
+    if (mix(state) != expected[i]) fails++;
+  }
+  printfQuda("splitmix64 known-answer test: %s\n", fails ? "FAILED" : "PASSED");
+  return fails ? 1 : 0;
+}
+
+// reference checksum of a space-spin-color field: every 64-bit word is
+// mixed with ((global site index)*nSpin*nColor + s*nColor + c)*words + w
+static uint64_t referenceChecksum(const cpuColorSpinorField &field)
+{
+  const int X[4] = { xdim, ydim, zdim, tdim };
+  const int nComplex = field.Nspin() * field.Ncolor();
+  const int words = 2 * field.Precision() / sizeof(uint64_t); // 64-bit words per complex number
+  const uint64_t *v = static_cast<const uint64_t*>(field.V());
+
+  uint64_t checksum = 0;
+  for (int parity = 0; parity < 2; parity++) {
+    for (int x_cb = 0; x_cb < Vh; x_cb++) {
+      int idx = fullLatticeIndex(x_cb, parity);
+      uint64_t index = 0, stride = 1;
+      for (int d = 0; d < 4; d++) {
+	index += (uint64_t)(idx % X[d] + comm_coord(d) * X[d]) * stride;
+	stride *= (uint64_t)X[d] * comm_dim(d);
+	idx /= X[d];
+      }
+
+      const uint64_t *site = v + (size_t)(parity*Vh + x_cb) * nComplex * words;
+      for (int k = 0; k < nComplex * words; k++) checksum ^= mix(site[k], index * nComplex * words + k);
+    }
+  }
+
+  comm_allreduce_xor(&checksum);
+  return checksum;
+}
+
+template <typename Float>
+static void swapComplex(cpuColorSpinorField &field, size_t i, size_t j)
+{
+  Float *v = static_cast<Float*>(field.V());
+  for (int r = 0; r < 2; r++) std::swap(v[2*i+r], v[2*j+r]);
+}
+
+template <typename Float>
+static int checksumTest(ColorSpinorParam &csParam)
+{
+  int fails = 0;
+  const int nComplex = csParam.nSpin * csParam.nColor;
+
+  cpuColorSpinorField field(csParam);
+  field.Source(QUDA_RANDOM_SOURCE);
+
+  const uint64_t checksum = field.checksum();
+  const uint64_t reference = referenceChecksum(field);
+  printfQuda("Checksum %016lx, reference %016lx\n", checksum, reference);
+  if (checksum != reference) fails++;
+
+  {
+    ColorSpinorParam scsParam(csParam);
+    scsParam.fieldOrder = QUDA_SPACE_COLOR_SPIN_FIELD_ORDER;
+    cpuColorSpinorField scs(scsParam);
+    scs = field;
+    const uint64_t checksum_scs = scs.checksum();
+    printfQuda("Space-color-spin checksum %016lx\n", checksum_scs);
+    if (checksum_scs != checksum) fails++;
+  }
+
+  IncrementalChecksum incremental(field);
+  if (incremental.checksum() != checksum) {
+    printfQuda("Initial incremental checksum does not agree\n");
+    fails++;
+  }
+
+  // exchange two components of a site on the first rank only, so the
+  // global checksum must change
+  if (comm_rank() == 0) swapComplex<Float>(field, 0, 1);
+  const uint64_t checksum_component = field.checksum();
+  printfQuda("Checksum after exchanging two components %016lx\n", checksum_component);
+  if (checksum_component == checksum) fails++;
+
+  if (comm_rank() == 0) {
+    swapComplex<Float>(field, 0, 1);
+    for (int k = 0; k < nComplex; k++) swapComplex<Float>(field, k, (size_t)(Vh + 1)*nComplex + k);
+  }
+  const uint64_t checksum_site = field.checksum();
+  printfQuda("Checksum after exchanging two sites %016lx\n", checksum_site);
+  if (checksum_site == checksum) fails++;
+
+  // only the two exchanged sites need to be rehashed
+  if (comm_rank() == 0) {
+    incremental.touch(0, 0, 1);
+    incremental.touch(1, 1, 2);
+  }
+  const uint64_t checksum_incremental = incremental.checksum();
+  printfQuda("Incremental checksum after exchanging two sites %016lx\n", checksum_incremental);
+  if (checksum_incremental != checksum_site) fails++;
+
+  return fails;
+}
+
+int main(int argc, char **argv)
+{
+  for (int i = 1; i < argc; i++){
+    if(process_command_line_option(argc, argv, &i) == 0){
+      continue;
+    }
+    printf("ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  // initialize QMP/MPI, QUDA comms grid and RNG (test_util.cpp)
+  initComms(argc, argv, gridsize_from_cmdline);
+
+  display_test_info();
+
+  if (prec != QUDA_DOUBLE_PRECISION && prec != QUDA_SINGLE_PRECISION) {
+    printfQuda("Precision %d not supported\n", prec);
+    finalizeComms();
+    return 0;
+  }
+
+  initQuda(device);
+
+  int X[4] = { xdim, ydim, zdim, tdim };
+  setDims(X);
+
+  int fails = knownAnswerTest();
+
+  ColorSpinorParam csParam;
+  csParam.nColor = 3;
+  csParam.nSpin = 4;
+  csParam.nDim = 4;
+  for (int d = 0; d < 4; d++) csParam.x[d] = X[d];
+  csParam.precision = prec;
+  csParam.pad = 0;
+  csParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+  csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  csParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  csParam.create = QUDA_ZERO_FIELD_CREATE;
+
+  fails += (prec == QUDA_DOUBLE_PRECISION) ? checksumTest<double>(csParam) : checksumTest<float>(csParam);
+
+  printfQuda("%s: %d failures\n", fails ? "FAILED" : "PASSED", fails);
+
+  endQuda();
+  finalizeComms();
+
+  return fails;
+}
@@ -0,0 +1,252 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <clover_field.h>
+#include <color_spinor_field.h>
+#include <util_quda.h>
+#include <comm_quda.h>
+
+#include <test_util.h>
+#include "misc.h"
+
+// Tests the host clover force kernel.  computeCloverForce is applied
+// to host fields and to device copies of the same gauge field and
+// solution vectors, and the resulting force fields are compared.  The
+// device kernel is only instantiated in double precision, so the
+// host single-precision kernel is instead compared with the host
+// double-precision force.  In multi-GPU builds every dimension is
+// marked as partitioned, so the exterior kernels are always exercised.
+
+using namespace quda;
+
+#define MAX(a,b) ((a)>(b)?(a):(b))
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaReconstructType link_recon;
+
+extern void usage(char** );
+
+static const int nvec = 2; // number of solution vectors contributing to the force
+static const double coeffs[nvec] = { 0.7, -0.3 };
+
+void display_test_info()
+{
+  printfQuda("running the following test:\n");
+
+  printfQuda("prec    link_recon  S_dimension T_dimension\n");
+  printfQuda("%s   %s            %d/%d/%d          %d\n",
+	     get_prec_str(QUDA_DOUBLE_PRECISION), get_recon_str(link_recon), xdim, ydim, zdim, tdim);
+
+  printfQuda("Grid partition info:     X  Y  Z  T\n");
+  printfQuda("                         %d  %d  %d  %d\n",
+	     dimPartitioned(0),
+	     dimPartitioned(1),
+	     dimPartitioned(2),
+	     dimPartitioned(3));
+}
+
+// relative deviation |a-b|/|b| of two host QDP-ordered force fields, summed over all ranks
+template <typename Float>
+static double relativeDeviation(const cpuGaugeField &a, const cpuGaugeField &b)
+{
+  double diff = 0.0, norm = 0.0;
+  for (int dir = 0; dir < 4; dir++) {
+    const Float *a_ = static_cast<const Float*>(((void* const*)a.Gauge_p())[dir]);
+    const double *b_ = static_cast<const double*>(((void* const*)b.Gauge_p())[dir]);
+    for (int i = 0; i < a.Volume()*gaugeSiteSize; i++) {
+      diff += (a_[i] - b_[i]) * (a_[i] - b_[i]);
+      norm += b_[i] * b_[i];
+    }
+  }
+  comm_allreduce(&diff);
+  comm_allreduce(&norm);
+  return norm > 0.0 ? sqrt(diff / norm) : sqrt(diff);
+}
+
+static int cloverForceTest()
+{
+  const QudaPrecision prec = QUDA_DOUBLE_PRECISION;
+
+  QudaGaugeParam gauge_param = newQudaGaugeParam();
+  gauge_param.X[0] = xdim;
+  gauge_param.X[1] = ydim;
+  gauge_param.X[2] = zdim;
+  gauge_param.X[3] = tdim;
+  gauge_param.cpu_prec = prec;
+  gauge_param.cuda_prec = prec;
+  gauge_param.reconstruct = QUDA_RECONSTRUCT_NO;
+  gauge_param.type = QUDA_SU3_LINKS;
+  gauge_param.gauge_order = QUDA_QDP_GAUGE_ORDER;
+  gauge_param.t_boundary = QUDA_PERIODIC_T;
+  gauge_param.gauge_fix = QUDA_GAUGE_FIXED_NO;
+  gauge_param.anisotropy = 1.0;
+  gauge_param.tadpole_coeff = 1.0;
+  gauge_param.scale = 1.0;
+
+  setDims(gauge_param.X);
+
+  void *links[4];
+  for (int dir = 0; dir < 4; dir++) links[dir] = malloc(V*gaugeSiteSize*sizeof(double));
+  construct_gauge_field(links, 1, prec, &gauge_param);
+
+  GaugeFieldParam gParam(links, gauge_param);
+  gParam.ghostExchange = QUDA_GHOST_EXCHANGE_PAD;
+  cpuGaugeField cpuGauge(gParam);
+
+  // the device kernel supports no and 12 reconstruct
+  int pad = MAX(xdim*ydim*zdim/2, xdim*ydim*tdim/2);
+  pad = MAX(pad, xdim*zdim*tdim/2);
+  pad = MAX(pad, ydim*zdim*tdim/2);
+  gParam.create = QUDA_NULL_FIELD_CREATE;
+  gParam.reconstruct = (link_recon == QUDA_RECONSTRUCT_12) ? QUDA_RECONSTRUCT_12 : QUDA_RECONSTRUCT_NO;
+  gParam.pad = pad;
+  gParam.order = QUDA_FLOAT2_GAUGE_ORDER;
+  cudaGaugeField cudaGauge(gParam);
+  cudaGauge.copy(cpuGauge);
+  cudaGauge.exchangeGhost();
+
+  // force fields
+  GaugeFieldParam fParam(0, gauge_param, QUDA_GENERAL_LINKS);
+  fParam.create = QUDA_ZERO_FIELD_CREATE;
+  fParam.reconstruct = QUDA_RECONSTRUCT_NO;
+  fParam.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+  cpuGaugeField cpuForce(fParam);
+  cpuGaugeField refForce(fParam);
+
+  fParam.order = QUDA_FLOAT2_GAUGE_ORDER;
+  cudaGaugeField cudaForce(fParam);
+
+  // solution and intermediate vectors, both parities
+  ColorSpinorParam csParam;
+  csParam.nColor = 3;
+  csParam.nSpin = 4;
+  csParam.nDim = 4;
+  for (int d = 0; d < 4; d++) csParam.x[d] = gauge_param.X[d];
+  csParam.precision = prec;
+  csParam.pad = 0;
+  csParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+  csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  csParam.gammaBasis = QUDA_UKQCD_GAMMA_BASIS;
+  csParam.create = QUDA_ZERO_FIELD_CREATE;
+
+  ColorSpinorParam cudaParam(csParam);
+  cudaParam.create = QUDA_NULL_FIELD_CREATE;
+  cudaParam.fieldOrder = QUDA_FLOAT2_FIELD_ORDER;
+
+  std::vector<ColorSpinorField*> x, p, x_d, p_d;
+  std::vector<double> coeff;
+  for (int i = 0; i < nvec; i++) {
+    x.push_back(new cpuColorSpinorField(csParam));
+    p.push_back(new cpuColorSpinorField(csParam));
+    x[i]->Source(QUDA_RANDOM_SOURCE);
+    p[i]->Source(QUDA_RANDOM_SOURCE);
+
+    cudaColorSpinorField *xd = new cudaColorSpinorField(cudaParam);
+    cudaColorSpinorField *pd = new cudaColorSpinorField(cudaParam);
+    *xd = *x[i];
+    *pd = *p[i];
+    x_d.push_back(xd);
+    p_d.push_back(pd);
+    coeff.push_back(coeffs[i]);
+  }
+
+  computeCloverForce(cpuForce, cpuGauge, x, p, coeff);
+  computeCloverForce(cudaForce, cudaGauge, x_d, p_d, coeff);
+  cudaForce.saveCPUField(refForce);
+
+  const double tol = 1e-10;
+  double dev = relativeDeviation<double>(cpuForce, refForce);
+  int fails = dev > tol ? 1 : 0;
+
+  printfQuda("Host vs device clover force deviation %e\n", dev);
+
+  // single-precision host force from single-precision copies of the same inputs
+  gParam = GaugeFieldParam(links, gauge_param);
+  gParam.create = QUDA_NULL_FIELD_CREATE;
+  gParam.precision = QUDA_SINGLE_PRECISION;
+  gParam.ghostExchange = QUDA_GHOST_EXCHANGE_PAD;
+  cpuGaugeField cpuGaugeSingle(gParam);
+  cpuGaugeSingle.copy(cpuGauge);
+  cpuGaugeSingle.exchangeGhost();
+
+  fParam = GaugeFieldParam(0, gauge_param, QUDA_GENERAL_LINKS);
+  fParam.create = QUDA_ZERO_FIELD_CREATE;
+  fParam.reconstruct = QUDA_RECONSTRUCT_NO;
+  fParam.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+  fParam.precision = QUDA_SINGLE_PRECISION;
+  cpuGaugeField cpuForceSingle(fParam);
+
+  ColorSpinorParam singleParam(csParam);
+  singleParam.precision = QUDA_SINGLE_PRECISION;
+  singleParam.create = QUDA_NULL_FIELD_CREATE;
+  std::vector<ColorSpinorField*> x_s, p_s;
+  for (int i = 0; i < nvec; i++) {
+    x_s.push_back(new cpuColorSpinorField(singleParam));
+    p_s.push_back(new cpuColorSpinorField(singleParam));
+    *x_s[i] = *x[i];
+    *p_s[i] = *p[i];
+  }
+
+  computeCloverForce(cpuForceSingle, cpuGaugeSingle, x_s, p_s, coeff);
+
+  const double tol_single = 1e-5;
+  double dev_single = relativeDeviation<float>(cpuForceSingle, cpuForce);
+  if (dev_single > tol_single) fails++;
+
+  printfQuda("Host single vs double precision clover force deviation %e\n", dev_single);
+
+  for (int i = 0; i < nvec; i++) {
+    delete x[i];
+    delete p[i];
+    delete x_d[i];
+    delete p_d[i];
+    delete x_s[i];
+    delete p_s[i];
+  }
+  for (int dir = 0; dir < 4; dir++) free(links[dir]);
+
+  return fails;
+}
+
+int main(int argc, char **argv)
+{
+  for (int i = 1; i < argc; i++){
+    if(process_command_line_option(argc, argv, &i) == 0){
+      continue;
+    }
+    printf("ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  // initialize QMP/MPI, QUDA comms grid and RNG (test_util.cpp)
+  initComms(argc, argv, gridsize_from_cmdline);
+
+  display_test_info();
+
+  initQuda(device);
+  setVerbosity(QUDA_VERBOSE);
+
+#ifdef MULTI_GPU
+  for (int d = 0; d < 4; d++) comm_dim_partitioned_set(d);
+#endif
+
+  int fails = cloverForceTest();
+  printfQuda("%s: %d failures\n", fails ? "FAILED" : "PASSED", fails);
+
+  endQuda();
+  finalizeComms();
+
+  return fails;
+}
@@ -0,0 +1,183 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <util_quda.h>
+#include <comm_quda.h>
+
+#include <test_util.h>
+#include "misc.h"
+
+// Tests the nearest-neighbor message transport.  Every rank sends a
+// contiguous and a strided message in each direction of each
+// dimension, and checks the received data against the pattern of the
+// sending neighbor.  The messages are completed either by polling
+// comm_query, checking the data before comm_wait is called, or by
+// comm_wait alone.  The intranode shared-memory transport is enabled
+// by default, so on a single node all messages go through it; set
+// QUDA_ENABLE_SHM_COMMS=0 to test MPI point-to-point instead.
+
+using namespace quda;
+
+extern int gridsize_from_cmdline[];
+
+extern void usage(char** );
+
+static const int niter = 8;     // repeated exchanges, to reuse the mailboxes
+static const int n = 1024;      // contiguous message length (ints)
+static const int nblocks = 16;  // strided message blocks
+static const int blk = 32;      // strided block length (ints)
+static const int stride = 48;   // strided block stride (ints)
+
+void display_test_info()
+{
+  printfQuda("running the following test:\n");
+
+  printfQuda("Grid partition info:     X  Y  Z  T\n");
+  printfQuda("                         %d  %d  %d  %d\n",
+	     dimPartitioned(0),
+	     dimPartitioned(1),
+	     dimPartitioned(2),
+	     dimPartitioned(3));
+}
+
+#ifdef MULTI_GPU
+// value of element i of the message sent by rank in direction (dim, dir) at iteration iter
+static inline int pattern(int rank, int dim, int dir, int iter, int i)
+{ return ((rank*8 + 2*dim + dir)*niter + iter)*n + i; }
+
+static int transportTest(bool query)
+{
+  const int ndim = 4;
+  std::vector<int> send(2*ndim*n), recv(2*ndim*n);
+  std::vector<int> send_s(2*ndim*nblocks*stride), recv_s(2*ndim*nblocks*stride);
+  MsgHandle *mh_send[2*ndim], *mh_recv[2*ndim], *mh_send_s[2*ndim], *mh_recv_s[2*ndim];
+  int neighbor[2*ndim];
+
+  for (int d=0; d<ndim; d++) {
+    for (int dir=0; dir<2; dir++) {
+      const int k = 2*d + dir;
+      mh_send[k] = comm_declare_send_relative(&send[k*n], d, dir == 0 ? -1 : 1, n*sizeof(int));
+      mh_recv[k] = comm_declare_receive_relative(&recv[k*n], d, dir == 0 ? -1 : 1, n*sizeof(int));
+      mh_send_s[k] = comm_declare_strided_send_relative(&send_s[k*nblocks*stride], d, dir == 0 ? -1 : 1,
+							 blk*sizeof(int), nblocks, stride*sizeof(int));
+      mh_recv_s[k] = comm_declare_strided_receive_relative(&recv_s[k*nblocks*stride], d, dir == 0 ? -1 : 1,
+							    blk*sizeof(int), nblocks, stride*sizeof(int));
+
+      int displacement[QUDA_MAX_DIM] = { };
+      displacement[d] = dir == 0 ? -1 : 1;
+      neighbor[k] = comm_rank_displaced(comm_default_topology(), displacement);
+    }
+  }
+
+  int mismatch = 0;
+  for (int iter=0; iter<niter; iter++) {
+    for (int k=0; k<2*ndim; k++) {
+      for (int i=0; i<n; i++) {
+	send[k*n + i] = pattern(comm_rank(), k/2, k%2, iter, i);
+	recv[k*n + i] = -1;
+      }
+      for (int i=0; i<nblocks*stride; i++) {
+	send_s[k*nblocks*stride + i] = pattern(comm_rank(), k/2, k%2, iter, i);
+	recv_s[k*nblocks*stride + i] = -1;
+      }
+    }
+
+    for (int k=0; k<2*ndim; k++) {
+      comm_start(mh_recv[k]);
+      comm_start(mh_recv_s[k]);
+    }
+    for (int k=0; k<2*ndim; k++) {
+      comm_start(mh_send[k]);
+      comm_start(mh_send_s[k]);
+    }
+
+    if (query) {
+      // poll until every message has completed and check the data before any comm_wait
+      std::vector<bool> done(4*ndim, false);
+      int remaining = 4*ndim;
+      while (remaining > 0) {
+	for (int k=0; k<2*ndim; k++) {
+	  if (!done[2*k+0] && comm_query(mh_recv[k])) { done[2*k+0] = true; remaining--; }
+	  if (!done[2*k+1] && comm_query(mh_recv_s[k])) { done[2*k+1] = true; remaining--; }
+	  comm_query(mh_send[k]);
+	  comm_query(mh_send_s[k]);
+	}
+      }
+    } else {
+      for (int k=0; k<2*ndim; k++) {
+	comm_wait(mh_recv[k]);
+	comm_wait(mh_recv_s[k]);
+      }
+    }
+
+    // the receive from direction dir carries the neighbor's send in the opposite direction
+    for (int k=0; k<2*ndim; k++) {
+      const int sender = neighbor[k], d = k/2, dir = 1 - k%2;
+      for (int i=0; i<n; i++)
+	if (recv[k*n + i] != pattern(sender, d, dir, iter, i)) mismatch++;
+      for (int b=0; b<nblocks; b++) {
+	for (int i=0; i<stride; i++) {
+	  const int expected = i < blk ? pattern(sender, d, dir, iter, b*stride + i) : -1;
+	  if (recv_s[k*nblocks*stride + b*stride + i] != expected) mismatch++;
+	}
+      }
+    }
+
+    // completing a receive that has already completed in a query must not block
+    for (int k=0; k<2*ndim; k++) {
+      comm_wait(mh_recv[k]);
+      comm_wait(mh_recv_s[k]);
+      comm_wait(mh_send[k]);
+      comm_wait(mh_send_s[k]);
+    }
+  }
+
+  for (int k=0; k<2*ndim; k++) {
+    comm_free(mh_send[k]);
+    comm_free(mh_recv[k]);
+    comm_free(mh_send_s[k]);
+    comm_free(mh_recv_s[k]);
+  }
+
+  comm_allreduce_int(&mismatch);
+  printfQuda("%s completion: %d mismatched elements\n", query ? "comm_query" : "comm_wait", mismatch);
+  return mismatch ? 1 : 0;
+}
+#endif
+
+int main(int argc, char **argv)
+{
+  for (int i = 1; i < argc; i++){
+    if(process_command_line_option(argc, argv, &i) == 0){
+      continue;
+    }
+    printf("ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  // exercise the shared-memory transport unless the user chose otherwise
+  setenv("QUDA_ENABLE_SHM_COMMS", "1", 0);
+
+  // initialize QMP/MPI, QUDA comms grid and RNG (test_util.cpp)
+  initComms(argc, argv, gridsize_from_cmdline);
+
+  display_test_info();
+
+  int fails = 0;
+#ifdef MULTI_GPU
+  fails += transportTest(true);
+  fails += transportTest(false);
+#else
+  printfQuda("Message transport requires a multi-GPU build, skipping\n");
+#endif
+
+  printfQuda("%s: %d failures\n", fails ? "FAILED" : "PASSED", fails);
+
+  finalizeComms();
+
+  return fails;
+}
@@ -0,0 +1,214 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <util_quda.h>
+#include <comm_quda.h>
+
+#include <test_util.h>
+#include "misc.h"
+
+// Tests contractMomentumQuda.  The fused host contraction and momentum
+// projection is compared with an unfused reference that first stores
+// the spin matrix of every site and then Fourier sums it per
+// timeslice, for zero, positive and negative momenta.
+
+using namespace quda;
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaReconstructType link_recon;
+extern QudaPrecision prec;
+
+extern void usage(char** );
+
+// (p_x, p_y, p_z) in units of 2 pi / L
+static const int nMom = 4;
+static const int momenta[3*nMom] = { 0, 0, 0,
+				     1, 0, 0,
+				     0,-1, 0,
+				     1,-2, 1 };
+
+void display_test_info()
+{
+  printfQuda("running the following test:\n");
+
+  printfQuda("prec    S_dimension T_dimension\n");
+  printfQuda("%s   %d/%d/%d          %d\n", get_prec_str(prec), xdim, ydim, zdim, tdim);
+
+  printfQuda("Grid partition info:     X  Y  Z  T\n");
+  printfQuda("                         %d  %d  %d  %d\n",
+	     dimPartitioned(0),
+	     dimPartitioned(1),
+	     dimPartitioned(2),
+	     dimPartitioned(3));
+}
+
+// Unfused reference: the spin matrix sum_c x^*_{mu c} y_{nu c} is
+// stored for every local site and then projected onto each momentum.
+template <typename Float>
+static void contractReference(std::vector<Complex> &result, const Float *x, const Float *y)
+{
+  const int X[4] = { xdim, ydim, zdim, tdim };
+  const int T = tdim * comm_dim(3);
+
+  std::vector<Complex> site((size_t)V*16);
+  for (int i = 0; i < V; i++) {
+    for (int mu = 0; mu < 4; mu++) {
+      for (int nu = 0; nu < 4; nu++) {
+	Complex s = 0.0;
+	for (int c = 0; c < 3; c++) {
+	  const Float *a = x + (i*12 + mu*3 + c)*2;
+	  const Float *b = y + (i*12 + nu*3 + c)*2;
+	  s += Complex(a[0], -a[1]) * Complex(b[0], b[1]);
+	}
+	site[i*16 + mu*4 + nu] = s;
+      }
+    }
+  }
+
+  result.assign((size_t)nMom*T*16, Complex(0.0,0.0));
+  for (int parity = 0; parity < 2; parity++) {
+    for (int x_cb = 0; x_cb < Vh; x_cb++) {
+      int idx = fullLatticeIndex(x_cb, parity);
+      int coord[4];
+      for (int d = 0; d < 4; d++) {
+	coord[d] = idx % X[d] + comm_coord(d) * X[d]; // global coordinate
+	idx /= X[d];
+      }
+
+      for (int m = 0; m < nMom; m++) {
+	double theta = 0.0;
+	for (int d = 0; d < 3; d++) theta -= 2.0 * M_PI * momenta[3*m+d] * coord[d] / (X[d] * comm_dim(d));
+	const Complex phase(cos(theta), sin(theta));
+	for (int g = 0; g < 16; g++)
+	  result[((size_t)m*T + coord[3])*16 + g] += phase * site[(parity*Vh + x_cb)*16 + g];
+      }
+    }
+  }
+
+  comm_allreduce_array(reinterpret_cast<double*>(result.data()), 2*result.size());
+}
+
+int main(int argc, char **argv)
+{
+  for (int i = 1; i < argc; i++){
+    if(process_command_line_option(argc, argv, &i) == 0){
+      continue;
+    }
+    printf("ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  // initialize QMP/MPI, QUDA comms grid and RNG (test_util.cpp)
+  initComms(argc, argv, gridsize_from_cmdline);
+
+  display_test_info();
+
+  if (prec != QUDA_DOUBLE_PRECISION && prec != QUDA_SINGLE_PRECISION) {
+    printfQuda("Precision %d not supported\n", prec);
+    finalizeComms();
+    return 0;
+  }
+
+  initQuda(device);
+  setVerbosity(QUDA_VERBOSE);
+
+  // the lattice dimensions are taken from the resident gauge field
+  QudaGaugeParam gauge_param = newQudaGaugeParam();
+  gauge_param.X[0] = xdim;
+  gauge_param.X[1] = ydim;
+  gauge_param.X[2] = zdim;
+  gauge_param.X[3] = tdim;
+  gauge_param.anisotropy = 1.0;
+  gauge_param.type = QUDA_WILSON_LINKS;
+  gauge_param.gauge_order = QUDA_QDP_GAUGE_ORDER;
+  gauge_param.t_boundary = QUDA_PERIODIC_T;
+  gauge_param.cpu_prec = prec;
+  gauge_param.cuda_prec = prec;
+  gauge_param.reconstruct = link_recon;
+  gauge_param.cuda_prec_sloppy = prec;
+  gauge_param.reconstruct_sloppy = link_recon;
+  gauge_param.gauge_fix = QUDA_GAUGE_FIXED_NO;
+  gauge_param.ga_pad = 0;
+
+  setDims(gauge_param.X);
+
+  size_t gSize = (prec == QUDA_DOUBLE_PRECISION) ? sizeof(double) : sizeof(float);
+  void *links[4];
+  for (int dir = 0; dir < 4; dir++) links[dir] = malloc(V*gaugeSiteSize*gSize);
+  construct_gauge_field(links, 0, prec, &gauge_param);
+  loadGaugeQuda(links, &gauge_param);
+
+  QudaInvertParam inv_param = newQudaInvertParam();
+  inv_param.dslash_type = QUDA_WILSON_DSLASH;
+  inv_param.cpu_prec = prec;
+  inv_param.cuda_prec = prec;
+  inv_param.dirac_order = QUDA_DIRAC_ORDER;
+  inv_param.gamma_basis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  inv_param.verbosity = QUDA_VERBOSE;
+
+  ColorSpinorParam csParam;
+  csParam.nColor = 3;
+  csParam.nSpin = 4;
+  csParam.nDim = 4;
+  for (int d = 0; d < 4; d++) csParam.x[d] = gauge_param.X[d];
+  csParam.precision = prec;
+  csParam.pad = 0;
+  csParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+  csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  csParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  csParam.create = QUDA_ZERO_FIELD_CREATE;
+
+  int fails = 0;
+  {
+    cpuColorSpinorField x(csParam), y(csParam);
+    x.Source(QUDA_RANDOM_SOURCE);
+    y.Source(QUDA_RANDOM_SOURCE);
+
+    const int T = tdim * comm_dim(3);
+    std::vector<Complex> result((size_t)nMom*T*16), ref;
+    contractMomentumQuda(result.data(), x.V(), y.V(), momenta, nMom, &inv_param);
+
+    if (prec == QUDA_DOUBLE_PRECISION) contractReference(ref, (const double*)x.V(), (const double*)y.V());
+    else contractReference(ref, (const float*)x.V(), (const float*)y.V());
+
+    const double tol = (prec == QUDA_DOUBLE_PRECISION) ? 1e-10 : 1e-5;
+    for (int m = 0; m < nMom; m++) {
+      double diff = 0.0, ref_norm = 0.0;
+      for (int i = m*T*16; i < (m+1)*T*16; i++) {
+	diff += std::norm(result[i] - ref[i]);
+	ref_norm += std::norm(ref[i]);
+      }
+      const double dev = ref_norm > 0.0 ? sqrt(diff / ref_norm) : sqrt(diff);
+
+      printfQuda("p = (%d, %d, %d): deviation from the unfused contraction %e\n",
+		 momenta[3*m+0], momenta[3*m+1], momenta[3*m+2], dev);
+      if (dev > tol) {
+	warningQuda("Momentum projected contraction for p = (%d, %d, %d) does not agree",
+		    momenta[3*m+0], momenta[3*m+1], momenta[3*m+2]);
+	fails++;
+      }
+    }
+  }
+
+  printfQuda("%s: %d failures\n", fails ? "FAILED" : "PASSED", fails);
+
+  freeGaugeQuda();
+  for (int dir = 0; dir < 4; dir++) free(links[dir]);
+
+  endQuda();
+  finalizeComms();
+
+  return fails;
+}
@@ -16,6 +16,10 @@
 #include <dslash_util.h>
 #include <covdev_reference.h>
 #include <gauge_field.h>
+#include <covDev.h>
+#include <stencil.h>
+
+#include <vector>
 
 #include <assert.h>
 #include <gtest.h>
@@ -184,12 +188,14 @@ void init()
 
   construct_gauge_field(links, 1, gaugeParam.cpu_prec, &gaugeParam);
 
-#ifdef MULTI_GPU
+  // host gauge field with ghost links, used by the batched host operators
   gaugeParam.type = QUDA_SU3_LINKS;
   gaugeParam.reconstruct = QUDA_RECONSTRUCT_NO;
   GaugeFieldParam cpuParam(links, gaugeParam);
   cpuParam.ghostExchange = QUDA_GHOST_EXCHANGE_PAD;
   cpuLink   = new cpuGaugeField(cpuParam);
+
+#ifdef MULTI_GPU
   ghostLink = cpuLink->Ghost();
 
   int x_face_size = X[1]*X[2]*X[3]/2;
@@ -333,6 +339,102 @@ TEST(dslash, verify) {
   ASSERT_LE(deviation, tol) << "CPU and CUDA implementations do not agree";
 }
 
+// relative deviation |a-b|/|b| of two host fields, summed over all ranks
+static double relativeDeviation(const ColorSpinorField &a, const ColorSpinorField &b)
+{
+  const double *a_ = static_cast<const double*>(a.V());
+  const double *b_ = static_cast<const double*>(b.V());
+  double diff = 0.0, norm = 0.0;
+  for (size_t i=0; i<a.Length(); i++) {
+    diff += (a_[i] - b_[i]) * (a_[i] - b_[i]);
+    norm += b_[i] * b_[i];
+  }
+  comm_allreduce(&diff);
+  comm_allreduce(&norm);
+  return norm > 0.0 ? sqrt(diff / norm) : sqrt(diff);
+}
+
+// Applies the batched covariant derivative (spin 1 and 4, all eight
+// directions) and the batched Laplace operator to a set of host
+// vectors and to the same vectors on the device, and compares each
+// with the single-vector operator applied on the device.
+static int batchedTest()
+{
+  const int nvec = 4;
+  const double tol = (inv_param.cuda_prec == QUDA_DOUBLE_PRECISION) ? 1e-12 : 1e-5;
+  int fails = 0;
+
+  DiracParam diracParam;
+  setDiracParam(diracParam, &inv_param, false);
+  diracParam.kappa = 0.1;
+  GaugeLaplace laplace(diracParam);
+
+  for (int s = 0; s < 2; s++) {
+    const int nSpin = (s == 0) ? 1 : 4;
+
+    ColorSpinorParam csParam(*spinor);
+    csParam.nSpin = nSpin;
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+
+    ColorSpinorParam cudaParam(csParam);
+    cudaParam.create = QUDA_NULL_FIELD_CREATE;
+    cudaParam.precision = inv_param.cuda_prec;
+    cudaParam.pad = inv_param.sp_pad;
+    cudaParam.fieldOrder = (inv_param.cuda_prec == QUDA_DOUBLE_PRECISION || nSpin == 1) ?
+      QUDA_FLOAT2_FIELD_ORDER : QUDA_FLOAT4_FIELD_ORDER;
+
+    std::vector<ColorSpinorField*> in, out, in_d, out_d;
+    for (int i = 0; i < nvec; i++) {
+      in.push_back(new cpuColorSpinorField(csParam));
+      out.push_back(new cpuColorSpinorField(csParam));
+      in_d.push_back(new cudaColorSpinorField(cudaParam));
+      out_d.push_back(new cudaColorSpinorField(cudaParam));
+      in[i]->Source(QUDA_RANDOM_SOURCE);
+      *in_d[i] = *in[i];
+    }
+    cpuColorSpinorField ref(csParam), batched_d(csParam);
+    cudaColorSpinorField single_d(cudaParam);
+
+    for (int op = 0; op < (nSpin == 1 ? 9 : 8); op++) {
+      // op < 8 is the covariant derivative in direction mu = op, op == 8 the Laplace operator
+      if (op < 8) {
+	ApplyCovDev(out, in, *cpuLink, QUDA_INVALID_PARITY, op);
+	dirac->MCD(out_d, in_d, op);
+      } else {
+	ApplyLaplace(out, in, *cpuLink, -laplace.Kappa(), &in, QUDA_INVALID_PARITY);
+	laplace.M(out_d, in_d);
+      }
+
+      for (int i = 0; i < nvec; i++) {
+	if (op < 8) dirac->MCD(single_d, *in_d[i], op);
+	else laplace.M(single_d, *in_d[i]);
+	ref = single_d;
+	batched_d = *out_d[i];
+
+	double dev_host = relativeDeviation(*out[i], ref);
+	double dev_device = relativeDeviation(batched_d, ref);
+	if (op < 8) printfQuda("CovDev nSpin = %d mu = %d vector %d: ", nSpin, op, i);
+	else printfQuda("Laplace vector %d: ", i);
+	printfQuda("host batched deviation %e, device batched deviation %e\n", dev_host, dev_device);
+
+	if (dev_host > tol || dev_device > tol) {
+	  warningQuda("Batched and per-vector results do not agree");
+	  fails++;
+	}
+      }
+    }
+
+    for (int i = 0; i < nvec; i++) {
+      delete in[i];
+      delete out[i];
+      delete in_d[i];
+      delete out_d[i];
+    }
+  }
+
+  return fails;
+}
+
 static int dslashTest()
 {
   // return code for google test
@@ -382,6 +484,12 @@ static int dslashTest()
     }  // Directions
   }
 
+  if (verify_results) {
+    int fails = batchedTest();
+    printfQuda("Batched operators: %d failures\n", fails);
+    if (fails) test_rc = 1;
+  }
+
   end();
 
   return test_rc;
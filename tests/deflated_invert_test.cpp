@@ -39,6 +39,7 @@ extern QudaPrecision  prec;
 extern QudaPrecision  prec_sloppy;
 extern QudaPrecision  prec_precondition;
 extern QudaPrecision  prec_ritz;
+extern QudaPrecision  prec_ritz_storage;
 extern QudaReconstructType link_recon_sloppy;
 extern QudaReconstructType link_recon_precondition;
 extern double mass;
@@ -275,13 +276,14 @@ void setInvertParam(QudaInvertParam &inv_param) {
 void setDeflationParam(QudaEigParam &df_param) {
 
   df_param.import_vectors = QUDA_BOOLEAN_NO;
-  df_param.run_verify     = QUDA_BOOLEAN_NO;
+  df_param.run_verify     = QUDA_BOOLEAN_YES; // check each expansion of the space
 
   df_param.nk             = df_param.invert_param->nev;
   df_param.np             = df_param.invert_param->nev*df_param.invert_param->deflation_grid;
   df_param.extlib_type    = deflation_ext_lib;
 
   df_param.cuda_prec_ritz = prec_ritz;
+  df_param.cuda_prec_ritz_storage = prec_ritz_storage;
   df_param.location       = location_ritz;
   df_param.mem_type_ritz  = mem_type_ritz;
 
@@ -291,6 +293,42 @@ void setDeflationParam(QudaEigParam &df_param) {
 }
   
 
+// Solves Nsrc random right-hand sides with a newly created deflation
+// space and returns the total number of iterations.  The random number
+// generator is reseeded first, so runs with different deflation
+// parameters see the same sources.
+static int deflatedSolves(QudaEigParam &df_param, QudaInvertParam &inv_param, void *spinorOut, void *spinorIn, size_t sSize)
+{
+  initRand();
+
+  void *df_preconditioner  = newDeflationQuda(&df_param);
+  inv_param.deflation_op   = df_preconditioner;
+  inv_param.rhs_idx        = 0;
+
+  int total_iter = 0;
+  for (int i=0; i<Nsrc; i++) {
+    // create a point source at 0 (in each subvolume...  FIXME)
+    memset(spinorIn, 0, inv_param.Ls*V*spinorSiteSize*sSize);
+    memset(spinorOut, 0, inv_param.Ls*V*spinorSiteSize*sSize);
+
+    if (inv_param.cpu_prec == QUDA_SINGLE_PRECISION) {
+      //((float*)spinorIn)[i] = 1.0;
+      for (int i=0; i<inv_param.Ls*V*spinorSiteSize; i++) ((float*)spinorIn)[i] = rand() / (float)RAND_MAX;
+    } else {
+      //((double*)spinorIn)[i] = 1.0;
+      for (int i=0; i<inv_param.Ls*V*spinorSiteSize; i++) ((double*)spinorIn)[i] = rand() / (double)RAND_MAX;
+    }
+
+    invertQuda(spinorOut, spinorIn, &inv_param);
+    total_iter += inv_param.iter;
+    printfQuda("\nDone for %d rhs.\n", inv_param.rhs_idx);
+  }
+
+  destroyDeflationQuda(df_preconditioner);
+
+  return total_iter;
+}
+
 int main(int argc, char **argv)
 {
 
@@ -396,28 +434,8 @@ int main(int argc, char **argv)
   // this line ensure that if we need to construct the clover inverse (in either the smoother or the solver) we do so
   if (dslash_type == QUDA_CLOVER_WILSON_DSLASH || dslash_type == QUDA_TWISTED_CLOVER_DSLASH) loadCloverQuda(clover, clover_inv, &inv_param);
 
-  void *df_preconditioner  = newDeflationQuda(&df_param);
-  inv_param.deflation_op   = df_preconditioner;
-
-  for (int i=0; i<Nsrc; i++) {
-    // create a point source at 0 (in each subvolume...  FIXME)
-    memset(spinorIn, 0, inv_param.Ls*V*spinorSiteSize*sSize);
-    memset(spinorCheck, 0, inv_param.Ls*V*spinorSiteSize*sSize);
-    memset(spinorOut, 0, inv_param.Ls*V*spinorSiteSize*sSize);
-
-    if (inv_param.cpu_prec == QUDA_SINGLE_PRECISION) {
-      //((float*)spinorIn)[i] = 1.0;
-      for (int i=0; i<inv_param.Ls*V*spinorSiteSize; i++) ((float*)spinorIn)[i] = rand() / (float)RAND_MAX;
-    } else {
-      //((double*)spinorIn)[i] = 1.0;
-      for (int i=0; i<inv_param.Ls*V*spinorSiteSize; i++) ((double*)spinorIn)[i] = rand() / (double)RAND_MAX;
-    }
-
-    invertQuda(spinorOut, spinorIn, &inv_param);
-    printfQuda("\nDone for %d rhs.\n", inv_param.rhs_idx);
-  }
-
-  destroyDeflationQuda(df_preconditioner);    
+  int total_iter = deflatedSolves(df_param, inv_param, spinorOut, spinorIn, sSize);
+  memset(spinorCheck, 0, inv_param.Ls*V*spinorSiteSize*sSize);
 
   // stop the timer
   time0 += clock();
@@ -481,6 +499,35 @@ int main(int argc, char **argv)
   printfQuda("Residuals: (L2 relative) tol %g, QUDA = %g, host = %g; (heavy-quark) tol %g, QUDA = %g\n",
 	     inv_param.tol, inv_param.true_res, l2r, inv_param.tol_hq, inv_param.true_res_hq);
 
+  // A deflation space stored below the Ritz precision is compared with
+  // the same solves using an uncompressed space.  The last solutions
+  // must agree to the solver tolerance up to the conditioning of the
+  // operator.
+  int fails = 0;
+  if (prec_ritz_storage != QUDA_INVALID_PRECISION && prec_ritz_storage < df_param.cuda_prec_ritz) {
+    void *spinorRef = malloc(V*spinorSiteSize*sSize*inv_param.Ls);
+
+    QudaEigParam ref_param = df_param;
+    ref_param.cuda_prec_ritz_storage = df_param.cuda_prec_ritz;
+    strcpy(ref_param.vec_outfile, ""); // only the compressed run saves its vectors
+    int ref_iter = deflatedSolves(ref_param, inv_param, spinorRef, spinorIn, sSize);
+
+    mxpy(spinorOut, spinorRef, vol*spinorSiteSize*inv_param.Ls, inv_param.cpu_prec);
+    double dev = sqrt(norm_2(spinorRef, vol*spinorSiteSize*inv_param.Ls, inv_param.cpu_prec) /
+		      norm_2(spinorOut, vol*spinorSiteSize*inv_param.Ls, inv_param.cpu_prec));
+
+    printfQuda("Compressed deflation space (%s storage): %d iterations, uncompressed (%s storage): %d iterations\n",
+	       get_prec_str(prec_ritz_storage), total_iter, get_prec_str(df_param.cuda_prec_ritz), ref_iter);
+    printfQuda("Relative deviation of the last solution from the uncompressed run %e\n", dev);
+    if (dev > 1e2*inv_param.tol) {
+      warningQuda("Compressed deflation solution deviates by %e from the uncompressed solution", dev);
+      fails++;
+    }
+    printfQuda("%s: %d failures\n", fails ? "FAILED" : "PASSED", fails);
+
+    free(spinorRef);
+  }
+
 
   freeGaugeQuda();
   if (dslash_type == QUDA_CLOVER_WILSON_DSLASH || dslash_type == QUDA_TWISTED_CLOVER_DSLASH) freeCloverQuda();
@@ -498,5 +545,5 @@ int main(int argc, char **argv)
 
   for (int dir = 0; dir<4; dir++) free(gauge[dir]);
 
-  return 0;
+  return fails;
 }
@@ -285,17 +285,20 @@ void dslashReference_4d_sgpu(sFloat *res, gFloat **gaugeFull, sFloat *spinorFiel
     // are 4-dim'l.
     gaugeOdd[dir]  = gaugeFull[dir]+Vh*gaugeSiteSize;
   }
-  int sp_idx,gaugeOddBit;
+  // each site only writes its own output, so threading over sites is deterministic
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2)
+#endif
   for (int xs=0;xs<Ls;xs++) {
     for (int gge_idx = 0; gge_idx < Vh; gge_idx++) {
       for (int dir = 0; dir < 8; dir++) {
-        sp_idx=gge_idx+Vh*xs;
+        int sp_idx=gge_idx+Vh*xs;
         // Here is a function call to study.  It is defined near
         // Line 90 of this file.
         // Here we have to switch oddBit depending on the value of xs.  E.g., suppose
         // xs=1.  Then the odd spinor site x1=x2=x3=x4=0 wants the even gauge array
         // element 0, so that we get U_\mu(0).
-	gaugeOddBit = (xs%2 == 0 || type == QUDA_4D_PC) ? oddBit : (oddBit+1) % 2;
+	int gaugeOddBit = (xs%2 == 0 || type == QUDA_4D_PC) ? oddBit : (oddBit+1) % 2;
         gFloat *gauge = gaugeLink_sgpu(gge_idx, dir, gaugeOddBit, gaugeEven, gaugeOdd);
         
         // Even though we're doing the 4d part of the dslash, we need
@@ -343,12 +346,14 @@ void dslashReference_4d_mgpu(sFloat *res, gFloat **gaugeFull, gFloat **ghostGaug
     ghostGaugeEven[dir] = ghostGauge[dir];
     ghostGaugeOdd[dir] = ghostGauge[dir] + (faceVolume[dir]/2)*gaugeSiteSize;
   }
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2)
+#endif
   for (int xs=0;xs<Ls;xs++) 
   {  
-    int sp_idx;
     for (int i = 0; i < Vh; i++) 
     {
-      sp_idx = i + Vh*xs;
+      int sp_idx = i + Vh*xs;
       for (int dir = 0; dir < 8; dir++) 
       {
 	int gaugeOddBit = (xs%2 == 0 || type == QUDA_4D_PC) ? oddBit : (oddBit + 1) % 2;
@@ -376,6 +381,9 @@ void dslashReference_4d_mgpu(sFloat *res, gFloat **gaugeFull, gFloat **ghostGaug
 template <QudaDWFPCType type, bool zero_initialize=false, typename sFloat>
 void dslashReference_5th(sFloat *res, sFloat *spinorField, 
                 int oddBit, int daggerBit, sFloat mferm) {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int i = 0; i < V5h; i++) {
     if (zero_initialize) for(int one_site = 0 ; one_site < 24 ; one_site++)
       res[i*(4*3*2)+one_site] = 0.0;
@@ -403,12 +411,17 @@ void dslashReference_5th(sFloat *res, sFloat *spinorField,
 template <typename sFloat>
 void dslashReference_5th_inv(sFloat *res, sFloat *spinorField, 
                 int oddBit, int daggerBit, sFloat mferm, double *kappa) {
+  // The recurrence in the fifth dimension is sequential, but within each
+  // step every 4-d site is independent, so we thread over those.
   double *inv_Ftr = (double*)malloc(Ls*sizeof(sFloat));
   double *Ftr = (double*)malloc(Ls*sizeof(sFloat));
   for(int xs = 0 ; xs < Ls ; xs++)
   {
     inv_Ftr[xs] = 1.0/(1.0+pow(2.0*kappa[xs], Ls)*mferm);
     Ftr[xs] = -2.0*kappa[xs]*mferm*inv_Ftr[xs]; 
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (int i = 0; i < Vh; i++) {
       memcpy(&res[24*(i+Vh*xs)], &spinorField[24*(i+Vh*xs)], 24*sizeof(sFloat));
     }
@@ -416,6 +429,9 @@ void dslashReference_5th_inv(sFloat *res, sFloat *spinorField,
   if(daggerBit == 0)
   {
     // s = 0
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (int i = 0; i < Vh; i++) {
       ax(&res[12+24*(i+Vh*(Ls-1))],(sFloat)(inv_Ftr[0]), &spinorField[12+24*(i+Vh*(Ls-1))], 12);
     }
@@ -423,6 +439,9 @@ void dslashReference_5th_inv(sFloat *res, sFloat *spinorField,
     // s = 1 ... ls-2
     for(int xs = 0 ; xs <= Ls-2 ; ++xs)
     {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
       for (int i = 0; i < Vh; i++) {
         axpy((sFloat)(2.0*kappa[xs]), &res[24*(i+Vh*xs)], &res[24*(i+Vh*(xs+1))], 12);
         axpy((sFloat)Ftr[xs], &res[12+24*(i+Vh*xs)], &res[12+24*(i+Vh*(Ls-1))], 12);
@@ -437,6 +456,9 @@ void dslashReference_5th_inv(sFloat *res, sFloat *spinorField,
     // s = ls-2 ... 0
     for(int xs = Ls-2 ; xs >=0 ; --xs)
     {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
       for (int i = 0; i < Vh; i++) {
         axpy((sFloat)Ftr[xs], &res[24*(i+Vh*(Ls-1))], &res[24*(i+Vh*xs)], 12);
         axpy((sFloat)(2.0*kappa[xs]), &res[12+24*(i+Vh*(xs+1))], &res[12+24*(i+Vh*xs)], 12);
@@ -445,6 +467,9 @@ void dslashReference_5th_inv(sFloat *res, sFloat *spinorField,
         Ftr[tmp_s] /= 2.0*kappa[tmp_s];
     }
     // s = ls -1
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (int i = 0; i < Vh; i++) {
       ax(&res[24*(i+Vh*(Ls-1))], (sFloat)(inv_Ftr[Ls-1]), &res[24*(i+Vh*(Ls-1))], 12);
     }
@@ -452,6 +477,9 @@ void dslashReference_5th_inv(sFloat *res, sFloat *spinorField,
   else
   {
     // s = 0
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (int i = 0; i < Vh; i++) {
       ax(&res[24*(i+Vh*(Ls-1))],(sFloat)(inv_Ftr[0]), &spinorField[24*(i+Vh*(Ls-1))], 12);
     }
@@ -459,6 +487,9 @@ void dslashReference_5th_inv(sFloat *res, sFloat *spinorField,
     // s = 1 ... ls-2
     for(int xs = 0 ; xs <= Ls-2 ; ++xs)
     {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
       for (int i = 0; i < Vh; i++) {
         axpy((sFloat)Ftr[xs], &res[24*(i+Vh*xs)], &res[24*(i+Vh*(Ls-1))], 12);
         axpy((sFloat)(2.0*kappa[xs]), &res[12+24*(i+Vh*xs)], &res[12+24*(i+Vh*(xs+1))], 12);
@@ -473,6 +504,9 @@ void dslashReference_5th_inv(sFloat *res, sFloat *spinorField,
     // s = ls-2 ... 0
     for(int xs = Ls-2 ; xs >=0 ; --xs)
     {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
       for (int i = 0; i < Vh; i++) {
         axpy((sFloat)(2.0*kappa[xs]), &res[24*(i+Vh*(xs+1))], &res[24*(i+Vh*xs)], 12);
         axpy((sFloat)Ftr[xs], &res[12+24*(i+Vh*(Ls-1))], &res[12+24*(i+Vh*xs)], 12);
@@ -481,6 +515,9 @@ void dslashReference_5th_inv(sFloat *res, sFloat *spinorField,
         Ftr[tmp_s] /= 2.0*kappa[tmp_s];
     }
     // s = ls -1
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (int i = 0; i < Vh; i++) {
       ax(&res[12+24*(i+Vh*(Ls-1))], (sFloat)(inv_Ftr[Ls-1]), &res[12+24*(i+Vh*(Ls-1))], 12);
     }
@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
 
 #include <quda.h>
 #include <quda_internal.h>
@@ -48,6 +49,9 @@ DiracDomainWall4DPC *dirac_4dpc = NULL; // create the 4d preconditioned DWF Dira
 // What test are we doing (0 = dslash, 1 = MatPC, 2 = Mat, 3 = MatPCDagMatPC, 4 = MatDagMat)
 extern int test_type;
 
+// deviation of the host computed clover field from the device one (negative if not checked)
+double host_clover_deviation = -1.0;
+
 // Dirac operator type
 extern QudaDslashType dslash_type;
 
@@ -81,6 +85,77 @@ extern double mu;
 
 QudaVerbosity verbosity = QUDA_VERBOSE;
 
+template <typename Float>
+static double maxDeviation(const Float *a, const Float *b, size_t n)
+{
+  double deviation = 0.0;
+  for (size_t i=0; i<n; i++) deviation = std::max(deviation, (double)fabs(a[i] - b[i]));
+  return deviation;
+}
+
+static double maxDeviation(const void *a, const void *b, size_t n, QudaPrecision precision)
+{
+  return precision == QUDA_DOUBLE_PRECISION ?
+    maxDeviation(static_cast<const double*>(a), static_cast<const double*>(b), n) :
+    maxDeviation(static_cast<const float*>(a), static_cast<const float*>(b), n);
+}
+
+// compute the clover term and its inverse on the device and with the
+// fused host engine and compare the two; this is independent of
+// whether the clover field used by the test is computed or loaded, so
+// the resident clover field is restored from the test's host copy
+// afterwards
+static void verifyHostClover()
+{
+  const size_t n = (size_t)V*cloverSiteSize;
+  void *ref = malloc(n*inv_param.clover_cpu_prec);
+  void *ref_inv = malloc(n*inv_param.clover_cpu_prec);
+  void *clover = malloc(n*inv_param.clover_cpu_prec);
+  void *clover_inv = malloc(n*inv_param.clover_cpu_prec);
+
+  QudaInvertParam param = inv_param;
+  param.compute_clover = 1;
+  param.return_clover = 1;
+  param.compute_clover_inverse = 1;
+  param.return_clover_inverse = 1;
+  param.compute_clover_trlog = 1;
+
+  printfQuda("Computing clover field on the device\n");
+  freeCloverQuda();
+  param.clover_compute_location = QUDA_CUDA_FIELD_LOCATION;
+  loadCloverQuda(ref, ref_inv, &param);
+  const double trlog[2] = { param.trlogA[0], param.trlogA[1] };
+
+  printfQuda("Computing clover field on the host\n");
+  freeCloverQuda();
+  param.clover_compute_location = QUDA_CPU_FIELD_LOCATION;
+  loadCloverQuda(clover, clover_inv, &param);
+
+  host_clover_deviation = maxDeviation(ref, clover, n, inv_param.clover_cpu_prec);
+
+  // the device only inverts the clover term for preconditioned operators
+  if (inv_param.solve_type == QUDA_DIRECT_PC_SOLVE) {
+    host_clover_deviation = std::max(host_clover_deviation, maxDeviation(ref_inv, clover_inv, n, inv_param.clover_cpu_prec));
+    for (int i=0; i<2; i++)
+      host_clover_deviation = std::max(host_clover_deviation, fabs(trlog[i] - param.trlogA[i]) / std::max(1.0, fabs(trlog[i])));
+  }
+  printfQuda("Host vs device clover deviation = %e\n", host_clover_deviation);
+
+  // restore the clover field used by the test
+  freeCloverQuda();
+  inv_param.compute_clover = 0;
+  inv_param.compute_clover_inverse = 0;
+  inv_param.compute_clover_trlog = 0;
+  inv_param.return_clover = 0;
+  inv_param.return_clover_inverse = 0;
+  loadCloverQuda(hostClover, hostCloverInv, &inv_param);
+
+  free(clover_inv);
+  free(clover);
+  free(ref_inv);
+  free(ref);
+}
+
 void init(int argc, char **argv) {
 
   cuda_prec = prec;
@@ -339,10 +414,13 @@ void init(int argc, char **argv) {
     inv_param.return_clover = compute_clover;
     inv_param.compute_clover_inverse = compute_clover;
     inv_param.return_clover_inverse = compute_clover;
+    inv_param.compute_clover_trlog = compute_clover;
 
     if (dslash_type == QUDA_TWISTED_CLOVER_DSLASH) inv_param.return_clover_inverse = true;
 
     loadCloverQuda(hostClover, hostCloverInv, &inv_param);
+
+    verifyHostClover();
   }
 
   if (!transfer) {
@@ -964,6 +1042,16 @@ void display_test_info()
 
 extern void usage(char**);
 
+TEST(dslash, host_clover) {
+  if (dslash_type != QUDA_CLOVER_WILSON_DSLASH && dslash_type != QUDA_TWISTED_CLOVER_DSLASH) {
+    printfQuda("Skipping host clover check: %s dslash has no clover term\n", get_dslash_str(dslash_type));
+    return;
+  }
+  ASSERT_GE(host_clover_deviation, 0.0) << "Host clover computation was not checked";
+  double tol = (inv_param.clover_cuda_prec == QUDA_DOUBLE_PRECISION ? 1e-10 : 1e-4);
+  ASSERT_LE(host_clover_deviation, tol) << "Host and device clover computations do not agree";
+}
+
 TEST(dslash, verify) {
   double deviation = pow(10, -(double)(cpuColorSpinorField::Compare(*spinorRef, *spinorOut)));
   double tol = (inv_param.cuda_prec == QUDA_DOUBLE_PRECISION ? 1e-12 :
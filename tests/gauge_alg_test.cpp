@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+#include <vector>
 
 #include <quda.h>
 #include <quda_internal.h>
@@ -17,6 +19,10 @@
 
 #include <gtest.h>
 
+#ifdef QUDA_OPENMP
+#include <omp.h>
+#endif
+
 using   namespace quda;
 
 extern int device;
@@ -35,6 +41,10 @@ int *num_failures_dev;
 #define MAX(a,b) ((a)>(b)?(a):(b))
 #define DABS(a) ((a)<(0.)?(-(a)):(a))
 
+// theta tolerance requested from the host gauge fixing, and the step limit to reach it
+const double gf_tolerance = 1e-6;
+const int gf_maxiter = 2000;
+
 
 
 
@@ -54,6 +64,18 @@ class GaugeAlgTest : public ::testing::Test {
 
   }
 
+  // copy the device gauge field to a host field, keeping any extended halo
+  cpuGaugeField *copyToHost(){
+    GaugeFieldParam gParam(*cudaInGauge);
+    gParam.order = QUDA_QDP_GAUGE_ORDER;
+    gParam.reconstruct = QUDA_RECONSTRUCT_NO;
+    gParam.create = QUDA_NULL_FIELD_CREATE;
+    gParam.pad = 0;
+    cpuGaugeField *cpuGauge = new cpuGaugeField(gParam);
+    cudaInGauge->saveCPUField(*cpuGauge);
+    return cpuGauge;
+  }
+
   bool checkDimsPartitioned(){
     if(comm_dim_partitioned(0) || comm_dim_partitioned(1) || comm_dim_partitioned(2) || comm_dim_partitioned(3)) return true;
     return false;
@@ -233,6 +255,90 @@ TEST_F(GaugeAlgTest,Generation){
   }
 }
 
+// mean and sample standard deviation of a series of measurements
+static void meanAndSpread(const std::vector<double> &x, double &mean, double &sigma){
+  mean = 0.0;
+  for(size_t i=0; i<x.size(); i++) mean += x[i];
+  mean /= x.size();
+  sigma = 0.0;
+  for(size_t i=0; i<x.size(); i++) sigma += (x[i] - mean) * (x[i] - mean);
+  sigma = sqrt(sigma / (x.size() - 1));
+}
+
+TEST_F(GaugeAlgTest,Generation_Host){
+  // Starting from the configuration thermalized in SetUp, the chain is
+  // continued at the same beta both on the host and on the device.  The
+  // error of a mean plaquette is bounded by the spread of the individual
+  // measurements however correlated they are, so the two means must
+  // agree within five times the combined spread.
+  printfQuda("Heatbath and overrelaxation on the host and on the device\n");
+  cpuGaugeField *cpuGauge = copyToHost();
+  GaugeFieldParam gParam(*cudaInGauge);
+  gParam.create = QUDA_NULL_FIELD_CREATE;
+  cudaGaugeField *hostChain = new cudaGaugeField(gParam);
+  RNG hostrng(0, 1234);
+
+  std::vector<double> plaq_host(nsteps), plaq_dev(nsteps);
+  for(int step=0; step<nsteps; ++step){
+    Monte( *cpuGauge, hostrng, beta_value, nhbsteps, novrsteps);
+    hostChain->loadCPUField(*cpuGauge);
+    CallUnitarizeLinks(hostChain);
+    plaq_host[step] = plaquette( *hostChain, QUDA_CUDA_FIELD_LOCATION).x;
+
+    Monte( *cudaInGauge, *randstates, beta_value, nhbsteps, novrsteps);
+    CallUnitarizeLinks(cudaInGauge);
+    plaq_dev[step] = plaquette( *cudaInGauge, QUDA_CUDA_FIELD_LOCATION).x;
+    printfQuda("Step %d plaquette: host %.16e, device %.16e\n", step+1, plaq_host[step], plaq_dev[step]);
+  }
+  detu = getLinkDeterminant(*hostChain);
+  delete hostChain;
+  delete cpuGauge;
+
+  double mean_host, sigma_host, mean_dev, sigma_dev;
+  meanAndSpread(plaq_host, mean_host, sigma_host);
+  meanAndSpread(plaq_dev, mean_dev, sigma_dev);
+  const double tol = 5.0 * sqrt(sigma_host*sigma_host + sigma_dev*sigma_dev);
+  printfQuda("Mean plaquette: host %.16e +/- %.2e, device %.16e +/- %.2e, tolerance %.2e\n",
+             mean_host, sigma_host, mean_dev, sigma_dev, tol);
+  ASSERT_LT(fabs(mean_host - mean_dev), tol);
+  ASSERT_TRUE(CheckDeterminant(detu));
+}
+
+TEST_F(GaugeAlgTest,Generation_Host_Reproducible){
+  // the host generator is keyed by site and stream, so two chains with
+  // the same seed must be bitwise identical, here on one and on all
+  // threads when OpenMP is enabled
+#ifdef QUDA_OPENMP
+  const int nthreads = omp_get_max_threads();
+  printfQuda("Heatbath and overrelaxation on the host with 1 and %d threads\n", nthreads);
+#else
+  printfQuda("Heatbath and overrelaxation on the host, repeated with the same seed\n");
+#endif
+  cpuGaugeField *cpuGauge[2] = { copyToHost(), copyToHost() };
+  for(int i=0; i<2; i++){
+#ifdef QUDA_OPENMP
+    omp_set_num_threads(i == 0 ? 1 : nthreads);
+#endif
+    RNG hostrng(0, 1234);
+    for(int step=1; step<=nsteps; ++step) Monte( *cpuGauge[i], hostrng, beta_value, nhbsteps, novrsteps);
+  }
+#ifdef QUDA_OPENMP
+  omp_set_num_threads(nthreads);
+#endif
+
+  const size_t bytes = cpuGauge[0]->Volume() * cpuGauge[0]->Reconstruct() * cpuGauge[0]->Precision();
+  int differ = 0;
+  for(int dir=0; dir<4; dir++){
+    const void *a = ((void**)cpuGauge[0]->Gauge_p())[dir];
+    const void *b = ((void**)cpuGauge[1]->Gauge_p())[dir];
+    if(memcmp(a, b, bytes) != 0) differ++;
+  }
+  comm_allreduce_int(&differ);
+  delete cpuGauge[0];
+  delete cpuGauge[1];
+  ASSERT_EQ(differ, 0);
+}
+
 TEST_F(GaugeAlgTest,Landau_Overrelaxation){
   const int reunit_interval = 10;
   printfQuda("Landau gauge fixing with overrelaxation\n");
@@ -263,6 +369,56 @@ TEST_F(GaugeAlgTest,Coulomb_FFT){
   }
 }
 
+TEST_F(GaugeAlgTest,Landau_Overrelaxation_Host){
+  const int reunit_interval = 10;
+  printfQuda("Landau gauge fixing with overrelaxation on the host\n");
+  cpuGaugeField *cpuGauge = copyToHost();
+  gaugefixingOVR(*cpuGauge, 4, gf_maxiter, 10, 1.5, gf_tolerance, reunit_interval, 1);
+  double2 quality = gaugeFixQuality(*cpuGauge, 4);
+  cudaInGauge->loadCPUField(*cpuGauge);
+  delete cpuGauge;
+  ASSERT_TRUE(comparePlaquette(plaq, plaquette( *cudaInGauge, QUDA_CUDA_FIELD_LOCATION)));
+  ASSERT_LT(quality.y, gf_tolerance);
+}
+
+TEST_F(GaugeAlgTest,Coulomb_Overrelaxation_Host){
+  const int reunit_interval = 10;
+  printfQuda("Coulomb gauge fixing with overrelaxation on the host\n");
+  cpuGaugeField *cpuGauge = copyToHost();
+  gaugefixingOVR(*cpuGauge, 3, gf_maxiter, 10, 1.5, gf_tolerance, reunit_interval, 1);
+  double2 quality = gaugeFixQuality(*cpuGauge, 3);
+  cudaInGauge->loadCPUField(*cpuGauge);
+  delete cpuGauge;
+  ASSERT_TRUE(comparePlaquette(plaq, plaquette( *cudaInGauge, QUDA_CUDA_FIELD_LOCATION)));
+  ASSERT_LT(quality.y, gf_tolerance);
+}
+
+TEST_F(GaugeAlgTest,Landau_FFT_Host){
+  if(!checkDimsPartitioned()){
+    printfQuda("Landau gauge fixing with steepest descent method with FFTs on the host\n");
+    cpuGaugeField *cpuGauge = copyToHost();
+    gaugefixingFFT(*cpuGauge, 4, gf_maxiter, 10, 0.08, 0, gf_tolerance, 1);
+    double2 quality = gaugeFixQuality(*cpuGauge, 4);
+    cudaInGauge->loadCPUField(*cpuGauge);
+    delete cpuGauge;
+    ASSERT_TRUE(comparePlaquette(plaq, plaquette( *cudaInGauge, QUDA_CUDA_FIELD_LOCATION)));
+    ASSERT_LT(quality.y, gf_tolerance);
+  }
+}
+
+TEST_F(GaugeAlgTest,Coulomb_FFT_Host){
+  if(!checkDimsPartitioned()){
+    printfQuda("Coulomb gauge fixing with steepest descent method with FFTs on the host\n");
+    cpuGaugeField *cpuGauge = copyToHost();
+    gaugefixingFFT(*cpuGauge, 3, gf_maxiter, 10, 0.08, 0, gf_tolerance, 1);
+    double2 quality = gaugeFixQuality(*cpuGauge, 3);
+    cudaInGauge->loadCPUField(*cpuGauge);
+    delete cpuGauge;
+    ASSERT_TRUE(comparePlaquette(plaq, plaquette( *cudaInGauge, QUDA_CUDA_FIELD_LOCATION)));
+    ASSERT_LT(quality.y, gf_tolerance);
+  }
+}
+
 
 
 
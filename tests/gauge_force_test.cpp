@@ -501,9 +501,9 @@ gauge_force_test(void)
     }
   }
 
+  memcpy(refmom, mom, 4*V*momSiteSize*gSize);
   if (getTuning() == QUDA_TUNE_YES) {
     printfQuda("Tuning...\n");
-    memcpy(refmom, mom, 4*V*momSiteSize*gSize);
     computeGaugeForceQuda(mom, sitelink,  input_path_buf, length,
 			  loop_coeff_d, num_paths, max_length, eb3,
 			  &qudaGaugeParam);
@@ -527,6 +527,15 @@ gauge_force_test(void)
   int flops=153004;
     
   if (verify_results){	
+    // repeat the force on the host path from the same initial momentum
+    void* hostmom = safe_malloc(4*V*momSiteSize*gSize);
+    memcpy(hostmom, refmom, 4*V*momSiteSize*gSize);
+    qudaGaugeParam.force_compute_location = QUDA_CPU_FIELD_LOCATION;
+    computeGaugeForceQuda(hostmom, sitelink,  input_path_buf, length,
+			  loop_coeff_d, num_paths, max_length, eb3,
+			  &qudaGaugeParam);
+    qudaGaugeParam.force_compute_location = QUDA_CUDA_FIELD_LOCATION;
+
 #ifdef MULTI_GPU
     //last arg=0 means no optimization for communication, i.e. exchange data in all directions
     //even they are not partitioned
@@ -546,6 +555,11 @@ gauge_force_test(void)
     strong_check_mom(mom, refmom, 4*V, qudaGaugeParam.cpu_prec);
     
     printfQuda("Test %s\n",(1 == res) ? "PASSED" : "FAILED");
+
+    int host_res = compare_floats(hostmom, refmom, 4*V*momSiteSize, 1e-3, qudaGaugeParam.cpu_prec);
+    strong_check_mom(hostmom, refmom, 4*V, qudaGaugeParam.cpu_prec);
+    printfQuda("Host path test %s\n",(1 == host_res) ? "PASSED" : "FAILED");
+    host_free(hostmom);
   }  
 
   double perf = 1.0*niter*flops*V/(total_time*1e+9);
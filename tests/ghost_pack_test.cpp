@@ -0,0 +1,280 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <gauge_field.h>
+#include <util_quda.h>
+#include <comm_quda.h>
+
+#include <test_util.h>
+#include "misc.h"
+
+// Tests host ghost packing.  The color-spinor ghost zones packed from
+// the cached face-to-bulk tables are compared with the sequential walk
+// over the volume they replaced, for full and single-parity fields.
+// Every dimension is marked as partitioned so that all faces are
+// packed, which requires a multi-GPU build.  The gauge ghost zones
+// extracted with the closed-form face index are likewise compared with
+// the sequential running counter, for one- and three-deep faces, and
+// repeated with an odd Y extent, where the extraction falls back to
+// the sequential loop.
+
+using namespace quda;
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaPrecision prec;
+
+extern void usage(char** );
+
+void display_test_info()
+{
+  printfQuda("running the following test:\n");
+
+  printfQuda("prec    S_dimension T_dimension\n");
+  printfQuda("%s   %d/%d/%d          %d\n", get_prec_str(prec), xdim, ydim, zdim, tdim);
+
+  printfQuda("Grid partition info:     X  Y  Z  T\n");
+  printfQuda("                         %d  %d  %d  %d\n",
+	     dimPartitioned(0),
+	     dimPartitioned(1),
+	     dimPartitioned(2),
+	     dimPartitioned(3));
+}
+
+// full-lattice coordinates of checkerboard site x_cb of a given parity
+static void getCoords(int x[4], int x_cb, const int X[4], int parity)
+{
+  const int za = x_cb / (X[0] / 2);
+  const int zb = za / X[1];
+  x[1] = za - zb * X[1];
+  x[3] = zb / X[2];
+  x[2] = zb - x[3] * X[2];
+  x[0] = 2 * x_cb + ((x[1] + x[2] + x[3] + parity) & 1) - za * X[0];
+}
+
+// checkerboard index of a site within the face (dim, dir): the face
+// coordinate varies slowest and the remaining coordinates are ordered
+// with x[0] fastest
+static int ghostFaceIndex(const int x[4], const int X[4], int dim, int dir, int nFace)
+{
+  int index = dir == 0 ? x[dim] : x[dim] - X[dim] + nFace;
+  for (int d = 3; d >= 0; d--) if (d != dim) index = index * X[d] + x[d];
+  return index >> 1;
+}
+
+template <typename Float>
+static int spinorPackTest(QudaSiteSubset subset, QudaParity parity)
+{
+  const int nSpin = 4, nColor = 3, nFace = 1;
+  const int X[4] = { xdim, ydim, zdim, tdim };
+  const int nParity = subset == QUDA_FULL_SITE_SUBSET ? 2 : 1;
+
+  ColorSpinorParam csParam;
+  csParam.nColor = nColor;
+  csParam.nSpin = nSpin;
+  csParam.nDim = 4;
+  for (int d = 0; d < 4; d++) csParam.x[d] = X[d];
+  if (subset == QUDA_PARITY_SITE_SUBSET) csParam.x[0] /= 2;
+  csParam.precision = sizeof(Float) == sizeof(double) ? QUDA_DOUBLE_PRECISION : QUDA_SINGLE_PRECISION;
+  csParam.pad = 0;
+  csParam.siteSubset = subset;
+  csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  csParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  csParam.create = QUDA_ZERO_FIELD_CREATE;
+  cpuColorSpinorField field(csParam);
+
+  // every real number of the field is distinct
+  const int siteLength = 2 * nSpin * nColor;
+  const int volumeCB = field.VolumeCB();
+  Float *v = static_cast<Float*>(field.V());
+  for (int i = 0; i < nParity * volumeCB * siteLength; i++) v[i] = static_cast<Float>(i);
+
+  std::vector<Float> ghost[8], ref[8];
+  void *ghost_[8];
+  for (int dim = 0; dim < 4; dim++) {
+    for (int dir = 0; dir < 2; dir++) {
+      ghost[2*dim+dir].assign((size_t)nParity * nFace * field.SurfaceCB(dim) * siteLength, -1);
+      ref[2*dim+dir].assign((size_t)nParity * nFace * field.SurfaceCB(dim) * siteLength, -1);
+      ghost_[2*dim+dir] = ghost[2*dim+dir].data();
+    }
+  }
+
+  genericPackGhost(ghost_, field, parity, nFace, 0);
+
+  // sequential walk over the volume, testing every site against every face
+  for (int p = 0; p < nParity; p++) {
+    const int site_parity = nParity == 2 ? p : parity;
+    for (int x_cb = 0; x_cb < volumeCB; x_cb++) {
+      int x[4];
+      getCoords(x, x_cb, X, site_parity);
+      for (int dim = 0; dim < 4; dim++) {
+	const int faceVolumeCB = nFace * field.SurfaceCB(dim);
+	for (int dir = 0; dir < 2; dir++) {
+	  if (dir == 0 ? x[dim] >= nFace : x[dim] < X[dim] - nFace) continue;
+	  const int ghost_idx = ghostFaceIndex(x, X, dim, dir, nFace);
+	  memcpy(&ref[2*dim+dir][((size_t)p * faceVolumeCB + ghost_idx) * siteLength],
+		 &v[((size_t)p * volumeCB + x_cb) * siteLength], siteLength * sizeof(Float));
+	}
+      }
+    }
+  }
+
+  int mismatch = 0;
+  for (int i = 0; i < 8; i++)
+    for (size_t j = 0; j < ref[i].size(); j++) if (ghost[i][j] != ref[i][j]) mismatch++;
+
+  comm_allreduce_int(&mismatch);
+  printfQuda("%s color-spinor ghost packing: %d mismatched elements\n",
+	     subset == QUDA_FULL_SITE_SUBSET ? "Full-field" : parity == QUDA_EVEN_PARITY ? "Even-parity" : "Odd-parity",
+	     mismatch);
+  return mismatch ? 1 : 0;
+}
+
+template <typename Float>
+static int spinorPackTest()
+{
+  int fails = 0;
+#ifdef MULTI_GPU
+  for (int d = 0; d < 4; d++) comm_dim_partitioned_set(d);
+  fails += spinorPackTest<Float>(QUDA_FULL_SITE_SUBSET, QUDA_EVEN_PARITY);
+  fails += spinorPackTest<Float>(QUDA_PARITY_SITE_SUBSET, QUDA_EVEN_PARITY);
+  fails += spinorPackTest<Float>(QUDA_PARITY_SITE_SUBSET, QUDA_ODD_PARITY);
+#else
+  printfQuda("Color-spinor ghost packing requires a multi-GPU build, skipping\n");
+#endif
+  return fails;
+}
+
+// sequential gauge ghost extraction: the ghost index is a running
+// counter over the face sites of the given parity
+template <typename Float>
+static void referenceGaugeGhost(Float **ghost, Float *const *gauge, const int X[4], int nFace)
+{
+  const int A[4] = { X[3], X[3], X[3], X[2] };
+  const int B[4] = { X[2], X[2], X[1], X[1] };
+  const int C[4] = { X[1], X[0], X[0], X[0] };
+  const int f[4][4] = {
+    { X[0]*X[1]*X[2], X[0]*X[1], X[0],           1 },
+    { X[0]*X[1]*X[2], X[0]*X[1],    1,        X[0] },
+    { X[0]*X[1]*X[2],      X[0],    1,   X[0]*X[1] },
+    {      X[0]*X[1],      X[0],    1, X[0]*X[1]*X[2] }
+  };
+  const int volumeCB = X[0]*X[1]*X[2]*X[3] / 2;
+
+  for (int parity = 0; parity < 2; parity++) {
+    for (int dim = 0; dim < 4; dim++) {
+      const int faceVolumeCB = nFace * A[dim] * B[dim] * C[dim] / 2;
+      const int localParity = (X[dim] % 2 == 1 && comm_dim(dim) > 1) ? 1 : 0;
+      int indexGhost = 0;
+      for (int d = X[dim] - nFace; d < X[dim]; d++) {
+	for (int a = 0; a < A[dim]; a++) {
+	  for (int b = 0; b < B[dim]; b++) {
+	    for (int c = 0; c < C[dim]; c++) {
+	      if (((a + b + c + d) & 1) != parity) continue;
+	      const int indexCB = (a*f[dim][0] + b*f[dim][1] + c*f[dim][2] + d*f[dim][3]) >> 1;
+	      memcpy(&ghost[dim][((size_t)((parity + localParity) & 1) * faceVolumeCB + indexGhost) * 18],
+		     &gauge[dim][((size_t)parity * volumeCB + indexCB) * 18], 18 * sizeof(Float));
+	      indexGhost++;
+	    }
+	  }
+	}
+      }
+    }
+  }
+}
+
+template <typename Float>
+static int gaugeExtractTest(const int X[4], QudaLinkType link_type)
+{
+  GaugeFieldParam gParam(X, sizeof(Float) == sizeof(double) ? QUDA_DOUBLE_PRECISION : QUDA_SINGLE_PRECISION,
+			 QUDA_RECONSTRUCT_NO, 0, QUDA_VECTOR_GEOMETRY, QUDA_GHOST_EXCHANGE_NO);
+  gParam.order = QUDA_QDP_GAUGE_ORDER;
+  gParam.link_type = link_type;
+  gParam.nFace = link_type == QUDA_THREE_LINKS ? 3 : 1;
+  gParam.create = QUDA_ZERO_FIELD_CREATE;
+  cpuGaugeField u(gParam);
+
+  // every real number of a given link direction is distinct
+  Float **gauge = static_cast<Float**>(u.Gauge_p());
+  for (int dim = 0; dim < 4; dim++)
+    for (int i = 0; i < u.Volume() * 18; i++) gauge[dim][i] = static_cast<Float>(i);
+
+  std::vector<Float> ghost[4], ref[4];
+  Float *ghost_[4], *ref_[4];
+  for (int dim = 0; dim < 4; dim++) {
+    ghost[dim].assign((size_t)2 * u.SurfaceCB(dim) * u.Nface() * 18, -1);
+    ref[dim].assign((size_t)2 * u.SurfaceCB(dim) * u.Nface() * 18, -1);
+    ghost_[dim] = ghost[dim].data();
+    ref_[dim] = ref[dim].data();
+  }
+
+  extractGaugeGhost(u, reinterpret_cast<void**>(ghost_));
+  referenceGaugeGhost<Float>(ref_, gauge, X, u.Nface());
+
+  int mismatch = 0;
+  for (int dim = 0; dim < 4; dim++)
+    for (size_t j = 0; j < ref[dim].size(); j++) if (ghost[dim][j] != ref[dim][j]) mismatch++;
+
+  comm_allreduce_int(&mismatch);
+  printfQuda("Gauge ghost extraction, nFace = %d, X = %d %d %d %d, %s: %d mismatched elements\n",
+	     u.Nface(), X[0], X[1], X[2], X[3], X[1] % 2 ? "sequential fallback" : "closed form", mismatch);
+  return mismatch ? 1 : 0;
+}
+
+template <typename Float>
+static int gaugeExtractTest()
+{
+  int fails = 0;
+  const int X[4] = { xdim, ydim, zdim, tdim };
+  const int X_odd[4] = { xdim, ydim | 1, zdim, tdim }; // odd innermost face extent C = X[1] of the X face
+  for (int i = 0; i < 2; i++) {
+    fails += gaugeExtractTest<Float>(i ? X_odd : X, QUDA_GENERAL_LINKS);
+    fails += gaugeExtractTest<Float>(i ? X_odd : X, QUDA_THREE_LINKS);
+  }
+  return fails;
+}
+
+int main(int argc, char **argv)
+{
+  for (int i = 1; i < argc; i++){
+    if(process_command_line_option(argc, argv, &i) == 0){
+      continue;
+    }
+    printf("ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  // initialize QMP/MPI, QUDA comms grid and RNG (test_util.cpp)
+  initComms(argc, argv, gridsize_from_cmdline);
+
+  display_test_info();
+
+  if (prec != QUDA_DOUBLE_PRECISION && prec != QUDA_SINGLE_PRECISION) {
+    printfQuda("Precision %d not supported\n", prec);
+    finalizeComms();
+    return 0;
+  }
+
+  initQuda(device);
+
+  int fails = (prec == QUDA_DOUBLE_PRECISION) ? spinorPackTest<double>() : spinorPackTest<float>();
+  fails += (prec == QUDA_DOUBLE_PRECISION) ? gaugeExtractTest<double>() : gaugeExtractTest<float>();
+
+  printfQuda("%s: %d failures\n", fails ? "FAILED" : "PASSED", fails);
+
+  endQuda();
+  finalizeComms();
+
+  return fails;
+}
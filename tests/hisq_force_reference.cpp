@@ -330,6 +330,9 @@ update_mom(anti_hermitmat* momentum, int dir, su3_matrix* sitelink,
 	   su3_matrix* staple, Float eb3)
 {
     int i;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for(i=0;i <V; i++){
 	su3_matrix tmat1;
 	su3_matrix tmat2;
@@ -361,6 +364,9 @@ u_shift_hw(half_wilson_vector *src, half_wilson_vector *dest, int dir, su3_matri
     
     if(GOES_FORWARDS(dir)){	
 	dx[dir]=1;	
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
 	for(i=0;i < V; i++){
 	    int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
 	    half_wilson_vector* hw = src + nbr_idx;
@@ -370,6 +376,9 @@ u_shift_hw(half_wilson_vector *src, half_wilson_vector *dest, int dir, su3_matri
 	}	
     }else{
 	dx[OPP_DIR(dir)]=-1;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
 	for(i=0;i < V; i++){
 	    int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
 	    half_wilson_vector* hw = src + nbr_idx;
@@ -396,6 +405,9 @@ shifted_outer_prod(half_wilson_vector *src, su3_matrix* dest, int dir)
 	dx[dir]=1;	
     }else{ dx[OPP_DIR(dir)]=-1; }
 
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for(i=0;i < V; i++){
       int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
       half_wilson_vector* hw = src + nbr_idx;
@@ -418,6 +430,9 @@ forward_shifted_outer_prod(half_wilson_vector *src, su3_matrix* dest, int dir)
     dx[dir]=1;	
   }else{ dx[OPP_DIR(dir)]=-1; }
 
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for(i=0;i < V; i++){
     int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
     half_wilson_vector* hw = src + nbr_idx;
@@ -436,8 +451,11 @@ template <typename half_wilson_vector, typename su3_matrix>
 static void
 computeLinkOrderedOuterProduct(half_wilson_vector *src, su3_matrix* dest, int gauge_order)
 {
-  int dx[4];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for(int i=0; i<V; ++i){
+    int dx[4];
     for(int dir=0; dir<4; ++dir){
       dx[3]=dx[2]=dx[1]=dx[0]=0;
       dx[dir] = 1;
@@ -455,8 +473,11 @@ template <typename half_wilson_vector, typename su3_matrix>
 static void
 computeLinkOrderedOuterProduct(half_wilson_vector *src, su3_matrix* dest, size_t nhops, int gauge_order)
 {
-  int dx[4];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for(int i=0; i<V; ++i){
+    int dx[4];
     for(int dir=0; dir<4; ++dir){
       dx[3]=dx[2]=dx[1]=dx[0]=0;
       dx[dir] = nhops;
@@ -532,6 +553,9 @@ u_shift_mat(su3_matrix *src, su3_matrix *dest, int dir, su3_matrix* sitelink)
 
   if(GOES_FORWARDS(dir)){
     dx[dir]=1;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for(i=0; i<V; i++){
       int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
       su3_matrix* mat = src+nbr_idx; // No need for a factor of 4 here, the colour matrices do not have a Lorentz index
@@ -540,6 +564,9 @@ u_shift_mat(su3_matrix *src, su3_matrix *dest, int dir, su3_matrix* sitelink)
     }	
   }else{
     dx[OPP_DIR(dir)]=-1;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for(i=0; i<V; i++){
       int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
       su3_matrix* mat = src+nbr_idx; // No need for a factor of 4 here, the colour matrices do not have a Lorentz index
@@ -563,7 +590,6 @@ add_3f_force_to_mom(half_wilson_vector *back, half_wilson_vector *forw,
 		    int dir, Real coeff[2], anti_hermitmat* momentum) 
 {
     Real my_coeff[2] ;
-    Real tmp_coeff[2] ;
     int mydir;
     int i;
     
@@ -577,7 +603,11 @@ add_3f_force_to_mom(half_wilson_vector *back, half_wilson_vector *forw,
 	my_coeff[1] = coeff[1]; 
     }
     
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for(i=0;i < V;i++){
+	Real tmp_coeff[2] ;
 	if (i < Vh){
 	    tmp_coeff[0] = my_coeff[0];
 	    tmp_coeff[1] = my_coeff[1];
@@ -640,7 +670,6 @@ add_force_to_momentum(su3_matrix *back, su3_matrix *forw,
     int dir, Real coeff, anti_hermitmat* momentum)
 {
   Real my_coeff;
-  Real tmp_coeff;
   int mydir;
   int i;
 
@@ -653,7 +682,11 @@ add_force_to_momentum(su3_matrix *back, su3_matrix *forw,
   }
 
 
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for(i=0; i<V; i++){
+    Real tmp_coeff;
     if(i<Vh){ tmp_coeff = my_coeff; }
     else{ tmp_coeff = -my_coeff; }
 
@@ -740,6 +773,9 @@ static void set_identity_matrix(su3_matrix* mat)
 
 template<typename su3_matrix> 
 static void set_identity(su3_matrix* matrices, int num_dirs){
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for(int i=0; i<V*num_dirs; i++){
     set_identity_matrix(&matrices[i]);	
   }
@@ -882,6 +918,9 @@ void do_color_matrix_hisq_force_reference(Real eps, Real weight,
              u_shift_mat(P7, P7rho, rho, sitelink);
              side_link_force(rho, sig, SevenSt, Qnumu, P7, Qrhonumu, P7rho, mom);		    
              if(FiveSt != 0)coeff = SevenSt/FiveSt ; else coeff = 0;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
              for(i=0; i<V; i++){
              scalar_mult_add_su3_matrix(&P5[i], &P7rho[i], coeff, &P5[i]);
              } // end loop over volume
@@ -893,6 +932,9 @@ void do_color_matrix_hisq_force_reference(Real eps, Real weight,
         // check this!
         if(ThreeSt != 0)coeff	= FiveSt/ThreeSt; else coeff = 0;
 
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for(i=0; i<V; i++){
         scalar_mult_add_su3_matrix(&P3[i], &P5nu[i], coeff, &P3[i]);
         } // end loop over volume
@@ -913,6 +955,9 @@ void do_color_matrix_hisq_force_reference(Real eps, Real weight,
 
       if(ThreeSt != 0)coeff = Lepage/ThreeSt; else coeff = 0;
 
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
       for(i=0; i<V; i++){
       scalar_mult_add_su3_matrix(&P3[i], &P5nu[i], coeff, &P3[i]);
       }
@@ -1061,6 +1106,9 @@ void do_halfwilson_hisq_force_reference(Real eps, Real weight,
 	  u_shift_mat(P7, P7rho, rho, sitelink);
 	  side_link_force(rho, sig, SevenSt, Qnumu, P7, Qrhonumu, P7rho, mom);		    
 	  if(FiveSt != 0)coeff = SevenSt/FiveSt ; else coeff = 0;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
 	  for(i=0; i<V; i++){
 	    scalar_mult_add_su3_matrix(&P5[i], &P7rho[i], coeff, &P5[i]);
 	  } // end loop over volume
@@ -1072,6 +1120,9 @@ void do_halfwilson_hisq_force_reference(Real eps, Real weight,
 							       // check this!
 	if(ThreeSt != 0)coeff	= FiveSt/ThreeSt; else coeff = 0;
 	
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for(i=0; i<V; i++){
 	  scalar_mult_add_su3_matrix(&P3[i], &P5nu[i], coeff, &P3[i]);
 	} // end loop over volume
@@ -1092,6 +1143,9 @@ void do_halfwilson_hisq_force_reference(Real eps, Real weight,
 
       if(ThreeSt != 0)coeff = Lepage/ThreeSt; else coeff = 0;
 
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
       for(i=0; i<V; i++){
 	scalar_mult_add_su3_matrix(&P3[i], &P5nu[i], coeff, &P3[i]);
       }
@@ -10,6 +10,9 @@
 #include "ks_improved_force.h"
 #include "hw_quda.h"
 #include <dslash_quda.h> 
+#include <color_spinor_field.h>
+#include <staggered_oprod.h>
+#include <comm_quda.h>
 #include <sys/time.h>
 
 #define TDIFF(a,b) (b.tv_sec - a.tv_sec + 0.000001*(b.tv_usec - a.tv_usec))
@@ -521,6 +524,58 @@ hisq_force_end()
   return;
 }
 
+// Compute the one and three hop outer products on the host with
+// computeStaggeredOprod and compare against the reference outer
+// products used to seed the force test.  The reference treats the
+// local volume as periodic, so this is only checked when no dimension
+// is partitioned.
+  static int
+host_oprod_test(void)
+{
+  ColorSpinorParam csParam;
+  csParam.nColor = 3;
+  csParam.nSpin = 1;
+  csParam.nDim = 4;
+  for (int d=0; d<4; d++) csParam.x[d] = qudaGaugeParam.X[d];
+  csParam.precision = hw_prec;
+  csParam.pad = 0;
+  csParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+  csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  csParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS; // meaningless for staggered
+  csParam.create = QUDA_ZERO_FIELD_CREATE;
+  cpuColorSpinorField in(csParam);
+
+  // the reference outer product uses the first color vector of each half-wilson vector
+  for (int i=0; i<V; i++) {
+    memcpy((char*)in.V() + i*3*2*hw_prec, (char*)hw + i*hwSiteSize*hw_prec, 3*2*hw_prec);
+  }
+
+  GaugeFieldParam param(*cpuOprod);
+  param.create = QUDA_ZERO_FIELD_CREATE;
+  cpuGaugeField oprod(param);
+  cpuGaugeField longLinkOprod(param);
+
+  GaugeField *out[2] = {&oprod, &longLinkOprod};
+  double coeff[2] = {1.0, 1.0};
+  computeStaggeredOprod(out, in, coeff, 3);
+
+  const double tol = (hw_prec == QUDA_DOUBLE_PRECISION) ? 1e-10 : 1e-5;
+  int res = 1;
+  if (gauge_order == QUDA_QDP_GAUGE_ORDER) {
+    for (int dir=0; dir<4; dir++) {
+      res &= compare_floats(((void**)oprod.Gauge_p())[dir], ((void**)cpuOprod->Gauge_p())[dir], V*gaugeSiteSize, tol, hw_prec);
+      res &= compare_floats(((void**)longLinkOprod.Gauge_p())[dir], ((void**)cpuLongLinkOprod->Gauge_p())[dir], V*gaugeSiteSize, tol, hw_prec);
+    }
+  } else {
+    res &= compare_floats(oprod.Gauge_p(), cpuOprod->Gauge_p(), 4*V*gaugeSiteSize, tol, hw_prec);
+    res &= compare_floats(longLinkOprod.Gauge_p(), cpuLongLinkOprod->Gauge_p(), 4*V*gaugeSiteSize, tol, hw_prec);
+  }
+
+  printfQuda("Host outer product test %s\n", (1 == res) ? "PASSED" : "FAILED");
+  return res;
+}
+
   static int 
 hisq_force_test(void)
 {
@@ -528,6 +583,9 @@ hisq_force_test(void)
 
   hisq_force_init();
 
+  int host_oprod_res = 1;
+  if (verify_results && !comm_partitioned()) host_oprod_res = host_oprod_test();
+
   //float weight = 1.0;
   float act_path_coeff[6];
 
@@ -670,6 +728,8 @@ hisq_force_test(void)
 
   hisq_force_end();
 
+  if (!host_oprod_res) accuracy_level = 0;
+
   return accuracy_level;
 }
 
@@ -0,0 +1,352 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <gauge_field.h>
+#include <blas_quda.h>
+#include <multigrid.h>
+#include <tune_quda.h>
+#include <comm_quda.h>
+
+#include <test_util.h>
+#include <misc.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Micro-benchmarks for the host-side (CPU field) hot paths.  Each
+// benchmark is run for a number of warm-up calls, followed by niter
+// individually timed calls, and we report statistics of the per-call
+// latency together with the effective bandwidth and flop rate based
+// on the median.  Results can be written as JSON for tracking
+// performance regressions across builds.
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern int niter;
+extern QudaPrecision prec;
+
+extern void usage(char** );
+
+using namespace quda;
+
+static int warmup = 5;
+static char json_file[256] = "";
+static char bench_filter[256] = "all";
+
+struct Benchmark {
+  std::string name;
+  double bytes; // bytes moved per call
+  double flops; // flops per call
+  std::function<void()> run;
+  Benchmark(const std::string &name, double bytes, double flops, std::function<void()> run)
+    : name(name), bytes(bytes), flops(flops), run(run) { }
+};
+
+struct BenchmarkResult {
+  std::string name;
+  int calls;
+  double min, max, mean, median, stddev; // per-call latency in seconds
+  double bytes, flops;
+};
+
+static double wallTime() {
+  // monotonic clock, so the timings are immune to system clock adjustments
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// rate per second, guarding against calls too fast for the clock to resolve
+static double rate(double amount, double time) { return time > 0.0 ? amount / time : 0.0; }
+
+static BenchmarkResult runBenchmark(Benchmark &bench)
+{
+  for (int i=0; i<warmup; i++) bench.run();
+
+  std::vector<double> time(niter);
+  for (int i=0; i<niter; i++) {
+    comm_barrier();
+    double start = wallTime();
+    bench.run();
+    time[i] = wallTime() - start;
+  }
+
+  BenchmarkResult result;
+  result.name = bench.name;
+  result.calls = niter;
+  result.bytes = bench.bytes;
+  result.flops = bench.flops;
+
+  std::sort(time.begin(), time.end());
+  result.min = time[0];
+  result.max = time[niter-1];
+  result.median = (niter % 2) ? time[niter/2] : 0.5*(time[niter/2-1] + time[niter/2]);
+
+  double sum = 0.0, sum2 = 0.0;
+  for (int i=0; i<niter; i++) { sum += time[i]; sum2 += time[i]*time[i]; }
+  result.mean = sum / niter;
+  result.stddev = niter > 1 ? sqrt(std::max(0.0, (sum2 - niter*result.mean*result.mean) / (niter-1))) : 0.0;
+
+  // report the slowest rank, since that is what limits the application
+  comm_allreduce_max(&result.min);
+  comm_allreduce_max(&result.max);
+  comm_allreduce_max(&result.mean);
+  comm_allreduce_max(&result.median);
+  comm_allreduce_max(&result.stddev);
+
+  // bytes and flops are per rank: report aggregate rates
+  result.bytes *= comm_size();
+  result.flops *= comm_size();
+
+  return result;
+}
+
+static void writeJSON(const std::vector<BenchmarkResult> &results, QudaPrecision host_prec)
+{
+  if (comm_rank() != 0 || strlen(json_file) == 0) return;
+
+  FILE *fp = fopen(json_file, "w");
+  if (!fp) errorQuda("Unable to open %s for writing", json_file);
+
+#ifdef _OPENMP
+  int threads = omp_get_max_threads();
+#else
+  int threads = 1;
+#endif
+
+  fprintf(fp, "{\n");
+  fprintf(fp, "  \"suite\": \"host_benchmark_test\",\n");
+  fprintf(fp, "  \"version\": \"%d.%d.%d\",\n", QUDA_VERSION_MAJOR, QUDA_VERSION_MINOR, QUDA_VERSION_SUBMINOR);
+  fprintf(fp, "  \"lattice\": [%d, %d, %d, %d],\n", xdim, ydim, zdim, tdim);
+  fprintf(fp, "  \"grid\": [%d, %d, %d, %d],\n", gridsize_from_cmdline[0], gridsize_from_cmdline[1],
+	  gridsize_from_cmdline[2], gridsize_from_cmdline[3]);
+  fprintf(fp, "  \"ranks\": %d,\n", comm_size());
+  fprintf(fp, "  \"threads\": %d,\n", threads);
+  fprintf(fp, "  \"precision\": \"%s\",\n", get_prec_str(host_prec));
+  fprintf(fp, "  \"warmup\": %d,\n", warmup);
+  fprintf(fp, "  \"results\": [\n");
+  for (unsigned int i=0; i<results.size(); i++) {
+    const BenchmarkResult &r = results[i];
+    fprintf(fp, "    {\"name\": \"%s\", \"calls\": %d, \"min_us\": %.3f, \"max_us\": %.3f, "
+	    "\"mean_us\": %.3f, \"median_us\": %.3f, \"stddev_us\": %.3f, \"bytes\": %.0f, \"flops\": %.0f, "
+	    "\"GBps\": %.3f, \"GFLOPs\": %.3f}%s\n",
+	    r.name.c_str(), r.calls, 1e6*r.min, 1e6*r.max, 1e6*r.mean, 1e6*r.median, 1e6*r.stddev,
+	    r.bytes, r.flops, 1e-9*rate(r.bytes, r.median), 1e-9*rate(r.flops, r.median),
+	    i+1 < results.size() ? "," : "");
+  }
+  fprintf(fp, "  ]\n");
+  fprintf(fp, "}\n");
+  fclose(fp);
+
+  printfQuda("Wrote benchmark results to %s\n", json_file);
+}
+
+void display_test_info(QudaPrecision host_prec)
+{
+  printfQuda("running the following test:\n");
+  printfQuda("S_dimension T_dimension Host precision Warm-up Iterations\n");
+  printfQuda("%3d /%3d / %3d   %3d      %s     %d     %d\n", xdim, ydim, zdim, tdim,
+	     get_prec_str(host_prec), warmup, niter);
+  printfQuda("Grid partition info:     X  Y  Z  T\n");
+  printfQuda("                         %d  %d  %d  %d\n",
+	     dimPartitioned(0),
+	     dimPartitioned(1),
+	     dimPartitioned(2),
+	     dimPartitioned(3));
+  return;
+}
+
+void usage_extra(char** argv )
+{
+  printfQuda("Extra options:\n");
+  printfQuda("    --warmup <n>                              # Number of untimed warm-up calls per benchmark (default 5)\n");
+  printfQuda("    --json <file>                             # Write results as JSON to this file\n");
+  printfQuda("    --bench <name>                            # Only run benchmarks whose name contains this string (default all)\n");
+  return;
+}
+
+int main(int argc, char** argv)
+{
+  for (int i = 1; i < argc; i++){
+    if(process_command_line_option(argc, argv, &i) == 0){
+      continue;
+    }
+
+    if( strcmp(argv[i], "--warmup") == 0){
+      if (i+1 >= argc) usage(argv);
+      warmup = atoi(argv[i+1]);
+      if (warmup < 0) {
+	printf("ERROR: invalid number of warm-up iterations (%d)\n", warmup);
+	usage(argv);
+      }
+      i++;
+      continue;
+    }
+
+    if( strcmp(argv[i], "--json") == 0){
+      if (i+1 >= argc) usage(argv);
+      strncpy(json_file, argv[i+1], 255);
+      i++;
+      continue;
+    }
+
+    if( strcmp(argv[i], "--bench") == 0){
+      if (i+1 >= argc) usage(argv);
+      strncpy(bench_filter, argv[i+1], 255);
+      i++;
+      continue;
+    }
+
+    printfQuda("ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  // host fields do not support half precision
+  QudaPrecision host_prec = (prec == QUDA_HALF_PRECISION) ? QUDA_SINGLE_PRECISION : prec;
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  display_test_info(host_prec);
+  initQuda(device);
+
+  setVerbosity(QUDA_SUMMARIZE);
+
+  int X[4] = {xdim, ydim, zdim, tdim};
+
+  // the fields are scoped so they are destroyed before QUDA and the comms are torn down
+  {
+    // fine-grid Wilson-like spinors
+    ColorSpinorParam param;
+    param.nColor = 3;
+    param.nSpin = 4;
+    param.nDim = 4;
+    for (int d=0; d<4; d++) param.x[d] = X[d];
+    param.pad = 0; // padding must be zero for cpu fields
+    param.siteSubset = QUDA_FULL_SITE_SUBSET;
+    param.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+    param.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+    param.setPrecision(host_prec);
+    param.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+    param.create = QUDA_NULL_FIELD_CREATE;
+
+    cpuColorSpinorField xH(param);
+    cpuColorSpinorField yH(param);
+    xH.Source(QUDA_RANDOM_SOURCE);
+    yH.Source(QUDA_RANDOM_SOURCE);
+
+    param.fieldOrder = QUDA_SPACE_COLOR_SPIN_FIELD_ORDER;
+    cpuColorSpinorField zH(param);
+
+    // single-parity spinor for the halo exchange
+    param.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+    param.siteSubset = QUDA_PARITY_SITE_SUBSET;
+    param.x[0] = X[0]/2;
+    cpuColorSpinorField ghostH(param);
+    ghostH.Source(QUDA_RANDOM_SOURCE);
+
+    // gauge fields in two host orders
+    GaugeFieldParam gParam(X, host_prec, QUDA_RECONSTRUCT_NO, 0, QUDA_VECTOR_GEOMETRY);
+    gParam.link_type = QUDA_WILSON_LINKS;
+    gParam.t_boundary = QUDA_PERIODIC_T;
+    gParam.create = QUDA_ZERO_FIELD_CREATE;
+    gParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+    gParam.order = QUDA_QDP_GAUGE_ORDER;
+    cpuGaugeField qdpGauge(gParam);
+    gParam.order = QUDA_MILC_GAUGE_ORDER;
+    cpuGaugeField milcGauge(gParam);
+
+    std::vector<Benchmark> benchmarks;
+
+    benchmarks.push_back(Benchmark("copyGenericColorSpinor", xH.Bytes() + zH.Bytes(), 0.0,
+	  			 [&]() { copyGenericColorSpinor(zH, xH, QUDA_CPU_FIELD_LOCATION); }));
+
+    benchmarks.push_back(Benchmark("copyGenericGauge", qdpGauge.Bytes() + milcGauge.Bytes(), 0.0,
+	  			 [&]() { copyGenericGauge(milcGauge, qdpGauge, QUDA_CPU_FIELD_LOCATION); }));
+
+    benchmarks.push_back(Benchmark("norm2", xH.Bytes(), 2.0*xH.Length(),
+	  			 [&]() { blas::norm2(xH); }));
+
+    benchmarks.push_back(Benchmark("cDotProduct", xH.Bytes() + yH.Bytes(), 4.0*xH.Length(),
+	  			 [&]() { blas::cDotProduct(xH, yH); }));
+
+    double ghost_bytes = 0.0;
+    for (int d=0; d<4; d++) {
+      if (!commDimPartitioned(d)) continue;
+      // pack into the send buffer and receive into the ghost buffer in both directions
+      ghost_bytes += 2 * 2 * ghostH.SurfaceCB(d) * 2 * ghostH.Nspin() * ghostH.Ncolor() * ghostH.Precision();
+    }
+    benchmarks.push_back(Benchmark("exchangeGhost", ghost_bytes, 0.0,
+	  			 [&]() { ghostH.exchangeGhost(QUDA_EVEN_PARITY, 1, 0); }));
+
+#ifdef GPU_MULTIGRID
+    // coarse-grid operator with a typical multigrid coarse-level size
+    const int coarseSpin = 2;
+    const int coarseColor = 24;
+    ColorSpinorParam cParam(param);
+    cParam.nSpin = coarseSpin;
+    cParam.nColor = coarseColor;
+    cParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+    cParam.x[0] = X[0];
+    cParam.create = QUDA_ZERO_FIELD_CREATE;
+    cpuColorSpinorField coarseIn(cParam);
+    cpuColorSpinorField coarseOut(cParam);
+
+    GaugeFieldParam yParam(X, host_prec, QUDA_RECONSTRUCT_NO, 0, QUDA_COARSE_GEOMETRY);
+    yParam.nColor = coarseSpin*coarseColor;
+    yParam.link_type = QUDA_COARSE_LINKS;
+    yParam.t_boundary = QUDA_PERIODIC_T;
+    yParam.create = QUDA_ZERO_FIELD_CREATE;
+    yParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+    yParam.order = QUDA_QDP_GAUGE_ORDER;
+    yParam.ghostExchange = QUDA_GHOST_EXCHANGE_PAD;
+    yParam.nFace = 1;
+    cpuGaugeField Y(yParam);
+    yParam.geometry = QUDA_SCALAR_GEOMETRY;
+    yParam.nFace = 0;
+    cpuGaugeField Xc(yParam);
+
+    const double volume = (double)xdim*ydim*zdim*tdim;
+    const double N = coarseSpin*coarseColor;
+    // 8 hopping terms plus the clover term, each a complex N x N matrix-vector product
+    benchmarks.push_back(Benchmark("ApplyCoarse", Y.Bytes() + Xc.Bytes() + coarseIn.Bytes() + coarseOut.Bytes(),
+	  			 9 * 8 * N * N * volume,
+	  			 [&]() { ApplyCoarse(coarseOut, coarseIn, coarseIn, Y, Xc, 1.0); }));
+#endif
+
+    // without a resource path loadTuneCache only warns and returns
+    if (getTuning() == QUDA_TUNE_YES && getenv("QUDA_RESOURCE_PATH")) {
+      benchmarks.push_back(Benchmark("loadTuneCache", 0.0, 0.0, []() { loadTuneCache(); }));
+    } else {
+      printfQuda("Skipping loadTuneCache: tuning disabled or QUDA_RESOURCE_PATH not set\n");
+    }
+
+    std::vector<BenchmarkResult> results;
+    printfQuda("\n%-24s %10s %10s %10s %10s %10s %10s\n", "benchmark", "median(us)", "mean(us)",
+	       "min(us)", "stddev(us)", "GB/s", "GFLOP/s");
+    for (unsigned int i=0; i<benchmarks.size(); i++) {
+      if (strcmp(bench_filter, "all") != 0 && benchmarks[i].name.find(bench_filter) == std::string::npos) continue;
+      BenchmarkResult r = runBenchmark(benchmarks[i]);
+      printfQuda("%-24s %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", r.name.c_str(), 1e6*r.median, 1e6*r.mean,
+	         1e6*r.min, 1e6*r.stddev, 1e-9*rate(r.bytes, r.median), 1e-9*rate(r.flops, r.median));
+      results.push_back(r);
+    }
+
+    writeJSON(results, host_prec);
+  }
+
+  endQuda();
+
+  finalizeComms();
+}
@@ -3,6 +3,9 @@
 #include <time.h>
 #include <math.h>
 #include <string.h>
+#include <float.h>
+#include <vector>
+#include <algorithm>
 
 #include <util_quda.h>
 #include <test_util.h>
@@ -93,6 +96,65 @@ display_test_info()
   
 }
 
+/**
+   Host residual |(MdagM + offset) x - b| / |b| of a multi-shift
+   solution, using tmp and check as scratch
+ */
+static double multishiftResidual(void *x, void *b, double offset, void *tmp, void *check,
+				 void **gauge, void *clover, void *clover_inv,
+				 QudaGaugeParam &gauge_param, QudaInvertParam &inv_param)
+{
+  ax(0, check, V*spinorSiteSize, inv_param.cpu_prec);
+
+  if (dslash_type == QUDA_TWISTED_MASS_DSLASH) {
+    if (inv_param.twist_flavor != QUDA_TWIST_SINGLET) {
+      int tm_offset = Vh*spinorSiteSize;
+      void *out0 = check;
+      void *out1 = (char*)out0 + tm_offset*inv_param.cpu_prec;
+
+      void *tmp0 = tmp;
+      void *tmp1 = (char*)tmp0 + tm_offset*inv_param.cpu_prec;
+
+      void *in0  = x;
+      void *in1  = (char*)in0 + tm_offset*inv_param.cpu_prec;
+
+      tm_ndeg_matpc(tmp0, tmp1, gauge, in0, in1, inv_param.kappa, inv_param.mu, inv_param.epsilon, inv_param.matpc_type, 0, inv_param.cpu_prec, gauge_param);
+      tm_ndeg_matpc(out0, out1, gauge, tmp0, tmp1, inv_param.kappa, inv_param.mu, inv_param.epsilon, inv_param.matpc_type, 1, inv_param.cpu_prec, gauge_param);
+    } else {
+      tm_matpc(tmp, gauge, x, inv_param.kappa, inv_param.mu, inv_param.twist_flavor,
+	       inv_param.matpc_type, 0, inv_param.cpu_prec, gauge_param);
+      tm_matpc(check, gauge, tmp, inv_param.kappa, inv_param.mu, inv_param.twist_flavor,
+	       inv_param.matpc_type, 1, inv_param.cpu_prec, gauge_param);
+    }
+  } else if (dslash_type == QUDA_TWISTED_CLOVER_DSLASH) {
+    if (inv_param.twist_flavor != QUDA_TWIST_SINGLET)
+      errorQuda("Twisted mass solution type not supported");
+    tmc_matpc(tmp, gauge, x, clover, clover_inv, inv_param.kappa, inv_param.mu,
+	      inv_param.twist_flavor, inv_param.matpc_type, 0, inv_param.cpu_prec, gauge_param);
+    tmc_matpc(check, gauge, tmp, clover, clover_inv, inv_param.kappa, inv_param.mu,
+	      inv_param.twist_flavor, inv_param.matpc_type, 1, inv_param.cpu_prec, gauge_param);
+  } else if (dslash_type == QUDA_WILSON_DSLASH) {
+    wil_matpc(tmp, gauge, x, inv_param.kappa, inv_param.matpc_type, 0,
+	      inv_param.cpu_prec, gauge_param);
+    wil_matpc(check, gauge, tmp, inv_param.kappa, inv_param.matpc_type, 1,
+	      inv_param.cpu_prec, gauge_param);
+  } else if (dslash_type == QUDA_CLOVER_WILSON_DSLASH) {
+    clover_matpc(tmp, gauge, clover, clover_inv, x, inv_param.kappa, inv_param.matpc_type, 0,
+		 inv_param.cpu_prec, gauge_param);
+    clover_matpc(check, gauge, clover, clover_inv, tmp, inv_param.kappa, inv_param.matpc_type, 1,
+		 inv_param.cpu_prec, gauge_param);
+  } else {
+    printfQuda("Domain wall not supported for multi-shift\n");
+    exit(-1);
+  }
+
+  axpy(offset, x, check, Vh*spinorSiteSize, inv_param.cpu_prec);
+  mxpy(b, check, Vh*spinorSiteSize, inv_param.cpu_prec);
+  double nrm2 = norm_2(check, Vh*spinorSiteSize, inv_param.cpu_prec);
+  double src2 = norm_2(b, Vh*spinorSiteSize, inv_param.cpu_prec);
+  return sqrt(nrm2 / src2);
+}
+
 int main(int argc, char **argv)
 {
 
@@ -404,6 +466,8 @@ int main(int argc, char **argv)
   printfQuda("\nDone: %i iter / %g secs = %g Gflops, total time = %g secs\n", 
 	 inv_param.iter, inv_param.secs, inv_param.gflops/inv_param.secs, time0);
 
+  int fail = 0;
+
   if (multishift) {
     if (inv_param.mass_normalization == QUDA_MASS_NORMALIZATION) {
       errorQuda("Mass normalization not supported for multi-shift solver in invert_test");
@@ -412,61 +476,104 @@ int main(int argc, char **argv)
     void *spinorTmp = malloc(V*spinorSiteSize*sSize*inv_param.Ls);
 
     printfQuda("Host residuum checks: \n");
+    std::vector<double> l2r_ref(inv_param.num_offset);
     for(int i=0; i < inv_param.num_offset; i++) {
-      ax(0, spinorCheck, V*spinorSiteSize, inv_param.cpu_prec);
-      
-      if (dslash_type == QUDA_TWISTED_MASS_DSLASH) {
-	if (inv_param.twist_flavor != QUDA_TWIST_SINGLET) {
-          int tm_offset = Vh*spinorSiteSize;
-	  void *out0 = spinorCheck;
-	  void *out1 = (char*)out0 + tm_offset*cpu_prec;
+      double l2r = multishiftResidual(spinorOutMulti[i], spinorIn, inv_param.offset[i], spinorTmp, spinorCheck,
+				      gauge, clover, clover_inv, gauge_param, inv_param);
+      l2r_ref[i] = l2r;
 
-	  void *tmp0 = spinorTmp;
-	  void *tmp1 = (char*)tmp0 + tm_offset*cpu_prec;
+      printfQuda("Shift %d residuals: (L2 relative) tol %g, QUDA = %g, host = %g; (heavy-quark) tol %g, QUDA = %g\n",
+		 i, inv_param.tol_offset[i], inv_param.true_res_offset[i], l2r, 
+		 inv_param.tol_hq_offset[i], inv_param.true_res_hq_offset[i]);
+    }
 
-	  void *in0  = spinorOutMulti[i];
-	  void *in1  = (char*)in0 + tm_offset*cpu_prec;
+    // Compare the pipelined and the multi-source multi-shift CG with
+    // the standard one.  Refinement is switched off, so that the
+    // multi-shift solutions themselves are compared, and each
+    // solution must reach the residual of the unrefined standard
+    // solver.  The second source of the multi-source solve is
+    // independent of the first.
+    {
+      const int num_offset = inv_param.num_offset;
+      const int compute_true_res = inv_param.compute_true_res;
+      inv_param.compute_true_res = 0;
+
+      void *spinorIn2 = malloc(V*spinorSiteSize*sSize*inv_param.Ls);
+      for (int i=0; i<inv_param.Ls*V*spinorSiteSize; i++) {
+	if (inv_param.cpu_prec == QUDA_SINGLE_PRECISION) ((float*)spinorIn2)[i] = rand() / (float)RAND_MAX;
+	else ((double*)spinorIn2)[i] = rand() / (double)RAND_MAX;
+      }
+      void *sources[2] = { spinorIn, spinorIn2 };
 
-	  tm_ndeg_matpc(tmp0, tmp1, gauge, in0, in1, inv_param.kappa, inv_param.mu, inv_param.epsilon, inv_param.matpc_type, 0, inv_param.cpu_prec, gauge_param);
-	  tm_ndeg_matpc(out0, out1, gauge, tmp0, tmp1, inv_param.kappa, inv_param.mu, inv_param.epsilon, inv_param.matpc_type, 1, inv_param.cpu_prec, gauge_param);
+      std::vector<void*> x_std(num_offset), x_alt(2*num_offset);
+      for (int i=0; i<num_offset; i++) x_std[i] = malloc(V*spinorSiteSize*sSize*inv_param.Ls);
+      for (int i=0; i<2*num_offset; i++) x_alt[i] = malloc(V*spinorSiteSize*sSize*inv_param.Ls);
+
+      inv_param.multishift_pipeline = 0;
+      invertMultiShiftQuda(x_std.data(), spinorIn, &inv_param);
+      const int iter_std = inv_param.iter;
+
+      std::vector<double> l2r_std(num_offset);
+      for (int i=0; i<num_offset; i++)
+	l2r_std[i] = multishiftResidual(x_std[i], spinorIn, inv_param.offset[i], spinorTmp, spinorCheck,
+					gauge, clover, clover_inv, gauge_param, inv_param);
+
+      // rounding in the sloppy precision limits how closely the solutions can agree
+      const double eps = inv_param.cuda_prec_sloppy == QUDA_DOUBLE_PRECISION ? DBL_EPSILON :
+	inv_param.cuda_prec_sloppy == QUDA_SINGLE_PRECISION ? FLT_EPSILON : pow(2.0, -15);
+
+      for (int test=0; test<2; test++) {
+	const int num_src = test == 0 ? 1 : 2;
+	for (int i=0; i<num_src*num_offset; i++) memset(x_alt[i], 0, inv_param.Ls*V*spinorSiteSize*sSize);
+
+	if (test == 0) {
+	  inv_param.multishift_pipeline = 1;
+	  invertMultiShiftQuda(x_alt.data(), spinorIn, &inv_param);
+	  inv_param.multishift_pipeline = 0;
 	} else {
-	  tm_matpc(spinorTmp, gauge, spinorOutMulti[i], inv_param.kappa, inv_param.mu, inv_param.twist_flavor,
-		   inv_param.matpc_type, 0, inv_param.cpu_prec, gauge_param);
-	  tm_matpc(spinorCheck, gauge, spinorTmp, inv_param.kappa, inv_param.mu, inv_param.twist_flavor,
-		   inv_param.matpc_type, 1, inv_param.cpu_prec, gauge_param);
+	  inv_param.num_src = num_src;
+	  invertMultiSrcMultiShiftQuda(x_alt.data(), sources, &inv_param);
+	  inv_param.num_src = 1;
 	}
-      } else if (dslash_type == QUDA_TWISTED_CLOVER_DSLASH) {
-	if (inv_param.twist_flavor != QUDA_TWIST_SINGLET)
-	  errorQuda("Twisted mass solution type not supported");
-	tmc_matpc(spinorTmp, gauge, spinorOutMulti[i], clover, clover_inv, inv_param.kappa, inv_param.mu,
-		  inv_param.twist_flavor, inv_param.matpc_type, 0, inv_param.cpu_prec, gauge_param);
-        tmc_matpc(spinorCheck, gauge, spinorTmp, clover, clover_inv, inv_param.kappa, inv_param.mu,
-		  inv_param.twist_flavor, inv_param.matpc_type, 1, inv_param.cpu_prec, gauge_param);
-      } else if (dslash_type == QUDA_WILSON_DSLASH) {
-        wil_matpc(spinorTmp, gauge, spinorOutMulti[i], inv_param.kappa, inv_param.matpc_type, 0,
-                  inv_param.cpu_prec, gauge_param);
-        wil_matpc(spinorCheck, gauge, spinorTmp, inv_param.kappa, inv_param.matpc_type, 1,
-                  inv_param.cpu_prec, gauge_param);
-      } else if (dslash_type == QUDA_CLOVER_WILSON_DSLASH) {
-        clover_matpc(spinorTmp, gauge, clover, clover_inv, spinorOutMulti[i], inv_param.kappa, inv_param.matpc_type, 0,
-		     inv_param.cpu_prec, gauge_param);
-        clover_matpc(spinorCheck, gauge, clover, clover_inv, spinorTmp, inv_param.kappa, inv_param.matpc_type, 1,
-		     inv_param.cpu_prec, gauge_param);
-      } else {
-        printfQuda("Domain wall not supported for multi-shift\n");
-        exit(-1);
-      }
 
-      axpy(inv_param.offset[i], spinorOutMulti[i], spinorCheck, Vh*spinorSiteSize, inv_param.cpu_prec);
-      mxpy(spinorIn, spinorCheck, Vh*spinorSiteSize, inv_param.cpu_prec);
-      double nrm2 = norm_2(spinorCheck, Vh*spinorSiteSize, inv_param.cpu_prec);
-      double src2 = norm_2(spinorIn, Vh*spinorSiteSize, inv_param.cpu_prec);
-      double l2r = sqrt(nrm2 / src2);
+	const char *name = test == 0 ? "Pipelined" : "Multi-source";
+	printfQuda("%s multi-shift CG: %d iterations (standard %d)\n", name, inv_param.iter, iter_std);
+
+	for (int src=0; src<num_src; src++) {
+	  for (int i=0; i<num_offset; i++) {
+	    void *x = x_alt[src*num_offset + i];
+	    double l2r = multishiftResidual(x, sources[src], inv_param.offset[i], spinorTmp, spinorCheck,
+					    gauge, clover, clover_inv, gauge_param, inv_param);
+
+	    // relative deviation from the standard solution for the common
+	    // source, which is bounded by the condition number of the
+	    // shifted operator times the residuals: we allow for a
+	    // condition number of up to 1e3, or for rounding at the sloppy
+	    // precision if that is larger
+	    double dev = 0.0;
+	    const double dev_tol = std::max(1e3 * std::max(l2r_std[i], inv_param.tol_offset[i]), 100.0 * sqrt(eps));
+	    if (src == 0) {
+	      memcpy(spinorCheck, x, Vh*spinorSiteSize*sSize);
+	      mxpy(x_std[i], spinorCheck, Vh*spinorSiteSize, inv_param.cpu_prec);
+	      dev = sqrt(norm_2(spinorCheck, Vh*spinorSiteSize, inv_param.cpu_prec) /
+			 norm_2(x_std[i], Vh*spinorSiteSize, inv_param.cpu_prec));
+	    }
+
+	    const bool pass = l2r <= 10.0 * std::max(l2r_std[i], inv_param.tol_offset[i]) && dev <= dev_tol;
+	    if (!pass) fail++;
+	    printfQuda("%s source %d shift %d: host residual %e (standard %e), deviation from standard %e (tolerance %e) %s\n",
+		       name, src, i, l2r, l2r_std[i], dev, dev_tol, pass ? "" : "FAILED");
+	  }
+	}
+      }
+      printfQuda("Pipelined and multi-source multi-shift CG test %s\n", fail ? "FAILED" : "PASSED");
 
-      printfQuda("Shift %d residuals: (L2 relative) tol %g, QUDA = %g, host = %g; (heavy-quark) tol %g, QUDA = %g\n",
-		 i, inv_param.tol_offset[i], inv_param.true_res_offset[i], l2r, 
-		 inv_param.tol_hq_offset[i], inv_param.true_res_hq_offset[i]);
+      for (int i=0; i<2*num_offset; i++) free(x_alt[i]);
+      for (int i=0; i<num_offset; i++) free(x_std[i]);
+      free(spinorIn2);
+      inv_param.compute_true_res = compute_true_res;
     }
+
     free(spinorTmp);
 
   } else {
@@ -682,5 +789,5 @@ int main(int argc, char **argv)
 
   for (int dir = 0; dir<4; dir++) free(gauge[dir]);
 
-  return 0;
+  return fail;
 }
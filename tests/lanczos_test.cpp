@@ -0,0 +1,474 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <float.h>
+#include <algorithm>
+#include <vector>
+
+#include <util_quda.h>
+#include <test_util.h>
+#include <dslash_util.h>
+#include <comm_quda.h>
+#include "misc.h"
+
+#include <qio_field.h>
+
+// In a typical application, quda.h is the only QUDA header required.
+#include <quda.h>
+
+// Tests the Lanczos eigensolvers through lanczosQuda.  The plain
+// Lanczos recurrence is checked on a host-resident basis, and the
+// Ritz pairs of the thick-restart Lanczos are checked against the
+// Chebyshev-accelerated operator applied independently on the host,
+// for a host and a device basis, and for a host basis with the device
+// operator in a different precision from the host vectors.
+
+extern QudaDslashType dslash_type;
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaReconstructType link_recon;
+extern QudaPrecision prec;
+extern QudaMatPCType matpc_type;
+extern double mass;
+extern double anisotropy;
+extern double tol;
+extern char latfile[];
+
+extern int nev;
+extern int max_search_dim;
+extern int eig_max_restarts;
+
+extern void usage(char** );
+
+// Chebyshev acceleration of the normal operator: modes of MdagM
+// below cheby_param[0]^2 are amplified, those up to cheby_param[1]^2
+// are damped
+static const int n_poly = 4;
+static double cheby_param[2] = { 0.5, 2.5 };
+
+void display_test_info()
+{
+  printfQuda("running the following test:\n");
+
+  printfQuda("prec    link_recon  S_dimension T_dimension\n");
+  printfQuda("%s   %s            %d/%d/%d          %d\n",
+	     get_prec_str(prec), get_recon_str(link_recon), xdim, ydim, zdim, tdim);
+
+  printfQuda("Lanczos parameters\n");
+  printfQuda(" - number of wanted eigenpairs %d\n", nev);
+  printfQuda(" - basis size %d\n", max_search_dim);
+  printfQuda(" - maximum number of restarts %d\n", eig_max_restarts);
+
+  printfQuda("Grid partition info:     X  Y  Z  T\n");
+  printfQuda("                         %d  %d  %d  %d\n",
+	     dimPartitioned(0),
+	     dimPartitioned(1),
+	     dimPartitioned(2),
+	     dimPartitioned(3));
+}
+
+void setGaugeParam(QudaGaugeParam &gauge_param) {
+  gauge_param.X[0] = xdim;
+  gauge_param.X[1] = ydim;
+  gauge_param.X[2] = zdim;
+  gauge_param.X[3] = tdim;
+
+  gauge_param.anisotropy = anisotropy;
+  gauge_param.type = QUDA_WILSON_LINKS;
+  gauge_param.gauge_order = QUDA_QDP_GAUGE_ORDER;
+  gauge_param.t_boundary = QUDA_PERIODIC_T;
+
+  gauge_param.cpu_prec = prec;
+  gauge_param.cuda_prec = prec;
+  gauge_param.reconstruct = link_recon;
+  gauge_param.cuda_prec_sloppy = prec;
+  gauge_param.reconstruct_sloppy = link_recon;
+  gauge_param.cuda_prec_precondition = prec;
+  gauge_param.reconstruct_precondition = link_recon;
+
+  gauge_param.gauge_fix = QUDA_GAUGE_FIXED_NO;
+
+  gauge_param.ga_pad = 0;
+  // For multi-GPU, ga_pad must be large enough to store a time-slice
+#ifdef MULTI_GPU
+  int x_face_size = gauge_param.X[1]*gauge_param.X[2]*gauge_param.X[3]/2;
+  int y_face_size = gauge_param.X[0]*gauge_param.X[2]*gauge_param.X[3]/2;
+  int z_face_size = gauge_param.X[0]*gauge_param.X[1]*gauge_param.X[3]/2;
+  int t_face_size = gauge_param.X[0]*gauge_param.X[1]*gauge_param.X[2]/2;
+  int pad_size =std::max(x_face_size, y_face_size);
+  pad_size = std::max(pad_size, z_face_size);
+  pad_size = std::max(pad_size, t_face_size);
+  gauge_param.ga_pad = pad_size;
+#endif
+}
+
+void setInvertParam(QudaInvertParam &inv_param) {
+  inv_param.dslash_type = dslash_type;
+  inv_param.inv_type = QUDA_CG_INVERTER;
+  inv_param.Ls = 1;
+
+  inv_param.mass = mass;
+  inv_param.kappa = 1.0 / (2.0 * (1 + 3/anisotropy + mass));
+
+  inv_param.sp_pad = 0;
+  inv_param.cl_pad = 0;
+
+  inv_param.cpu_prec = prec;
+  inv_param.cuda_prec = prec;
+  inv_param.cuda_prec_sloppy = prec;
+  inv_param.cuda_prec_precondition = prec;
+  inv_param.preserve_source = QUDA_PRESERVE_SOURCE_NO;
+  inv_param.gamma_basis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  inv_param.dirac_order = QUDA_DIRAC_ORDER;
+
+  inv_param.input_location = QUDA_CPU_FIELD_LOCATION;
+  inv_param.output_location = QUDA_CPU_FIELD_LOCATION;
+
+  inv_param.dagger = QUDA_DAG_NO;
+  inv_param.mass_normalization = QUDA_KAPPA_NORMALIZATION;
+
+  // lanczosQuda works on single-parity fields for this solution type
+  inv_param.solution_type = QUDA_MATPC_DAG_SOLUTION;
+  inv_param.solve_type = QUDA_NORMOP_PC_SOLVE;
+  inv_param.matpc_type = matpc_type;
+
+  inv_param.tol = tol;
+  inv_param.tol_hq = 0.0;
+  inv_param.maxiter = 1000;
+  inv_param.reliable_delta = 1e-1;
+  inv_param.residual_type = QUDA_L2_RELATIVE_RESIDUAL;
+
+  inv_param.verbosity = QUDA_SUMMARIZE;
+}
+
+void setEigParam(QudaEigParam &eig_param, double stop) {
+  eig_param.RitzMat_lanczos = QUDA_MATPCDAG_MATPC_SOLUTION;
+  eig_param.RitzMat_Convcheck = QUDA_MATPCDAG_MATPC_SOLUTION;
+
+  eig_param.NPoly = n_poly;
+  eig_param.MatPoly_param = cheby_param;
+  eig_param.eigen_shift = 0.0;
+  eig_param.Stp_residual = stop;
+
+  eig_param.nk = nev;
+  eig_param.np = max_search_dim - nev;
+  eig_param.f_size = max_search_dim;
+  eig_param.max_restarts = eig_max_restarts;
+}
+
+static QudaInvertParam *mat_param = NULL;
+static int length = 0; // real degrees of freedom of a single-parity spinor
+
+template <typename Float>
+static double dot(const Float *x, const Float *y)
+{
+  double sum = 0.0;
+  for (int i=0; i<length; i++) sum += (double)x[i] * (double)y[i];
+  comm_allreduce(&sum);
+  return sum;
+}
+
+static double dot(const void *x, const void *y)
+{
+  return prec == QUDA_DOUBLE_PRECISION ? dot((const double*)x, (const double*)y) :
+    dot((const float*)x, (const float*)y);
+}
+
+template <typename Float>
+static void axpby(double a, const Float *x, double b, Float *y)
+{
+  for (int i=0; i<length; i++) y[i] = a*x[i] + b*y[i];
+}
+
+// y = a*x + b*y
+static void axpby(double a, const void *x, double b, void *y)
+{
+  if (prec == QUDA_DOUBLE_PRECISION) axpby(a, (const double*)x, b, (double*)y);
+  else axpby(a, (const float*)x, b, (float*)y);
+}
+
+/**
+   Apply the Chebyshev-accelerated operator of RitzMat, built here
+   from MatDagMatQuda
+ */
+static void ritzOp(void *out, const void *in, void *tmp1, void *tmp2)
+{
+  const size_t bytes = length * (prec == QUDA_DOUBLE_PRECISION ? sizeof(double) : sizeof(float));
+  const double alpha = pow(cheby_param[0], 2);
+  const double beta = pow(cheby_param[1], 2);
+  const double c1 = 2.0*(alpha+beta)/(alpha-beta);
+  const double c0 = 2.0/(alpha+beta);
+
+  // tmp2 = T_0(A) in, tmp1 = T_1(A) in
+  memcpy(tmp2, in, bytes);
+  MatDagMatQuda(tmp1, const_cast<void*>(in), mat_param);
+  axpby(-0.5*c1, in, 0.5*c0*c1, tmp1);
+
+  for (int i=2; i<=n_poly; i++) {
+    MatDagMatQuda(out, tmp1, mat_param);
+    axpby(-c1, tmp1, c0*c1, out);
+    axpby(-1.0, tmp2, 1.0, out);
+    std::swap(tmp1, tmp2);
+    memcpy(tmp1, out, bytes);
+  }
+}
+
+/**
+   Largest eigenvalue of the symmetric tridiagonal matrix by Sturm
+   bisection
+ */
+static double maxEigenvalue(const double *alpha, const double *beta, int m)
+{
+  double lo = alpha[0], hi = alpha[0];
+  for (int i=0; i<m; i++) {
+    const double r = (i > 0 ? fabs(beta[i-1]) : 0.0) + (i < m-1 ? fabs(beta[i]) : 0.0);
+    lo = std::min(lo, alpha[i] - r);
+    hi = std::max(hi, alpha[i] + r);
+  }
+
+  for (int iter=0; iter<200; iter++) {
+    const double x = 0.5*(lo + hi);
+    // count the eigenvalues below x
+    int count = 0;
+    double d = 1.0;
+    for (int i=0; i<m; i++) {
+      d = alpha[i] - x - (i > 0 ? beta[i-1]*beta[i-1] / d : 0.0);
+      if (d == 0.0) d = DBL_MIN;
+      if (d < 0.0) count++;
+    }
+    if (count == m) hi = x; // no eigenvalue exceeds x
+    else lo = x;
+  }
+  return 0.5*(lo + hi);
+}
+
+static void randomSpinor(void *v)
+{
+  for (int i=0; i<length; i++) {
+    if (prec == QUDA_DOUBLE_PRECISION) ((double*)v)[i] = rand() / (double)RAND_MAX - 0.5;
+    else ((float*)v)[i] = rand() / (float)RAND_MAX - 0.5f;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  for (int i = 1; i < argc; i++){
+    if(process_command_line_option(argc, argv, &i) == 0){
+      continue;
+    }
+    printf("ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  // initialize QMP/MPI, QUDA comms grid and RNG (test_util.cpp)
+  initComms(argc, argv, gridsize_from_cmdline);
+
+  // call srand() with a rank-dependent seed
+  initRand();
+
+  display_test_info();
+
+  if (dslash_type != QUDA_WILSON_DSLASH) {
+    printfQuda("dslash_type %d not supported\n", dslash_type);
+    exit(0);
+  }
+
+  if (prec != QUDA_DOUBLE_PRECISION && prec != QUDA_SINGLE_PRECISION) {
+    printfQuda("Precision %d not supported\n", prec);
+    exit(0);
+  }
+
+  if (nev <= 0 || nev >= max_search_dim) {
+    printfQuda("Invalid number of eigenpairs %d for basis size %d\n", nev, max_search_dim);
+    exit(0);
+  }
+
+  QudaGaugeParam gauge_param = newQudaGaugeParam();
+  setGaugeParam(gauge_param);
+
+  QudaInvertParam inv_param = newQudaInvertParam();
+  setInvertParam(inv_param);
+
+  // MatDagMatQuda applies the even-odd preconditioned operator for this solution type
+  QudaInvertParam op_param = inv_param;
+  op_param.solution_type = QUDA_MATPC_SOLUTION;
+  mat_param = &op_param;
+
+  const double eps = prec == QUDA_DOUBLE_PRECISION ? DBL_EPSILON : FLT_EPSILON;
+  const double stop = std::max(tol, 1e3*eps);
+
+  QudaEigParam eig_param = newQudaEigParam();
+  eig_param.invert_param = &inv_param;
+  setEigParam(eig_param, stop);
+
+  setDims(gauge_param.X);
+  setSpinorSiteSize(24);
+  length = Vh*spinorSiteSize;
+
+  size_t gSize = (gauge_param.cpu_prec == QUDA_DOUBLE_PRECISION) ? sizeof(double) : sizeof(float);
+  size_t sSize = (inv_param.cpu_prec == QUDA_DOUBLE_PRECISION) ? sizeof(double) : sizeof(float);
+
+  void *gauge[4];
+  for (int dir = 0; dir < 4; dir++) gauge[dir] = malloc(V*gaugeSiteSize*gSize);
+
+  if (strcmp(latfile,"")) {  // load in the command line supplied gauge field
+    read_gauge_field(latfile, gauge, gauge_param.cpu_prec, gauge_param.X, argc, argv);
+    construct_gauge_field(gauge, 2, gauge_param.cpu_prec, &gauge_param);
+  } else { // else generate a random SU(3) field
+    construct_gauge_field(gauge, 1, gauge_param.cpu_prec, &gauge_param);
+  }
+
+  const int m = max_search_dim;
+  const size_t bytes = length*sSize;
+
+  void *source = malloc(bytes);
+  void *r = malloc(bytes);
+  void *Apsi = malloc(bytes);
+  void *tmp1 = malloc(bytes);
+  void *tmp2 = malloc(bytes);
+  std::vector<void*> basis(m);
+  for (int k=0; k<m; k++) basis[k] = malloc(bytes);
+
+  std::vector<double> alpha(m), beta(m);
+  std::vector<double> alpha_host(m), beta_host(m);
+
+  randomSpinor(source);
+
+  initQuda(device);
+
+  loadGaugeQuda((void*)gauge, &gauge_param);
+
+  int fail = 0;
+
+  // plain Lanczos with the basis on the host: check the recurrence
+  // and the semi-orthogonality kept by the selective reorthogonalization
+  {
+    eig_param.eig_type = QUDA_LANCZOS;
+    eig_param.location = QUDA_CPU_FIELD_LOCATION;
+    memcpy(r, source, bytes);
+    lanczosQuda(0, m, Apsi, r, basis.data(), alpha.data(), beta.data(), &eig_param);
+
+    double anorm = 0.0;
+    for (int j=0; j<m; j++) anorm = std::max(anorm, fabs(alpha[j]) + beta[j] + (j > 0 ? beta[j-1] : 0.0));
+
+    double ortho = 0.0;
+    for (int i=0; i<m; i++)
+      for (int j=0; j<=i; j++) ortho = std::max(ortho, fabs(dot(basis[i], basis[j]) - (i == j ? 1.0 : 0.0)));
+
+    double relation = 0.0;
+    for (int j=0; j<m-1; j++) {
+      ritzOp(Apsi, basis[j], tmp1, tmp2);
+      if (j > 0) axpby(-beta[j-1], basis[j-1], 1.0, Apsi);
+      axpby(-alpha[j], basis[j], 1.0, Apsi);
+      axpby(-beta[j], basis[j+1], 1.0, Apsi);
+      relation = std::max(relation, sqrt(dot(Apsi, Apsi)) / anorm);
+    }
+
+    const double tol_ortho = 10.0*sqrt(eps);
+    printfQuda("Lanczos (host basis): orthogonality %e, recurrence %e (tolerance %e)\n", ortho, relation, tol_ortho);
+    if (ortho > tol_ortho || relation > tol_ortho) fail++;
+  }
+
+  // the largest Ritz value of the Lanczos matrix is a lower bound for the largest eigenvalue
+  const double theta_max = maxEigenvalue(alpha.data(), beta.data(), m);
+
+  // thick-restart Lanczos, with the basis on the host and then on the
+  // device, and finally with the basis on the host and the device
+  // operator in the other precision, so the host vectors are staged
+  // through device fields of a different precision
+  for (int test = 0; test < 3; test++) {
+    double eps_ = eps, stop_ = stop;
+    if (test == 2) {
+      const QudaPrecision cuda_prec = prec == QUDA_DOUBLE_PRECISION ? QUDA_SINGLE_PRECISION : QUDA_DOUBLE_PRECISION;
+      freeGaugeQuda();
+      gauge_param.cuda_prec = cuda_prec;
+      gauge_param.cuda_prec_sloppy = cuda_prec;
+      gauge_param.cuda_prec_precondition = cuda_prec;
+      loadGaugeQuda((void*)gauge, &gauge_param);
+
+      inv_param.cuda_prec = cuda_prec;
+      inv_param.cuda_prec_sloppy = cuda_prec;
+      inv_param.cuda_prec_precondition = cuda_prec;
+      op_param.cuda_prec = cuda_prec;
+      op_param.cuda_prec_sloppy = cuda_prec;
+      op_param.cuda_prec_precondition = cuda_prec;
+
+      // one of the two precisions is single
+      eps_ = FLT_EPSILON;
+      stop_ = std::max(tol, 1e3*eps_);
+      eig_param.Stp_residual = stop_;
+    }
+
+    eig_param.eig_type = QUDA_IMP_RST_LANCZOS;
+    eig_param.location = test == 1 ? QUDA_CUDA_FIELD_LOCATION : QUDA_CPU_FIELD_LOCATION;
+    const char *name = test == 0 ? "host" : test == 1 ? "device" : "host, mixed precision";
+    memcpy(r, source, bytes);
+    lanczosQuda(0, m, Apsi, r, basis.data(), alpha.data(), beta.data(), &eig_param);
+
+    const double anorm = fabs(alpha[0]);
+    const double tol_res = 10.0*stop_*anorm + 100.0*eps_*anorm;
+    int fail_loc = 0;
+
+    for (int l=0; l<nev; l++) {
+      ritzOp(Apsi, basis[l], tmp1, tmp2);
+      const double norm = sqrt(dot(basis[l], basis[l]));
+      const double rayleigh = dot(basis[l], Apsi) / (norm*norm);
+      axpby(-alpha[l], basis[l], 1.0, Apsi);
+      const double res = sqrt(dot(Apsi, Apsi)) / norm;
+
+      printfQuda("Thick-restart Lanczos (%s basis): eigenvalue %d = %.12e, Rayleigh quotient %.12e, "
+		 "residual %e (estimate %e)\n", name, l, alpha[l], rayleigh, res, beta[l]);
+
+      if (fabs(norm - 1.0) > 10.0*sqrt(eps_)) fail_loc++;
+      if (fabs(rayleigh - alpha[l]) > tol_res) fail_loc++;
+      if (res > tol_res) fail_loc++;
+      if (l > 0 && alpha[l] > alpha[l-1]) fail_loc++;
+      for (int i=0; i<l; i++) if (fabs(dot(basis[i], basis[l])) > 10.0*sqrt(eps_)) fail_loc++;
+    }
+
+    if (alpha[0] < theta_max - tol_res) {
+      printfQuda("Largest eigenvalue %e below the largest Lanczos Ritz value %e\n", alpha[0], theta_max);
+      fail_loc++;
+    }
+
+    if (test == 0) {
+      std::copy(alpha.begin(), alpha.end(), alpha_host.begin());
+      std::copy(beta.begin(), beta.end(), beta_host.begin());
+    } else {
+      // the converged eigenvalues must not depend on where the basis is kept or the device precision
+      for (int l=0; l<nev; l++)
+	if (fabs(alpha[l] - alpha_host[l]) > 2.0*(beta[l] + beta_host[l]) + 100.0*eps_*anorm) {
+	  printfQuda("Eigenvalue %d differs between host (%e) and %s (%e) bases\n", l, alpha_host[l], name, alpha[l]);
+	  fail_loc++;
+	}
+    }
+
+    printfQuda("Thick-restart Lanczos (%s basis) test %s\n", name, fail_loc ? "FAILED" : "PASSED");
+    fail += fail_loc;
+  }
+
+  freeGaugeQuda();
+
+  // finalize the QUDA library
+  endQuda();
+
+  // finalize the communications layer
+  finalizeComms();
+
+  printf("%s\n", fail ? "FAILED" : "PASSED");
+
+  for (int k=0; k<m; k++) free(basis[k]);
+  free(tmp2);
+  free(tmp1);
+  free(Apsi);
+  free(r);
+  free(source);
+  for (int dir = 0; dir<4; dir++) free(gauge[dir]);
+
+  return fail;
+}
@@ -117,10 +117,6 @@ llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu,
     su3_matrix* mulink, su3_matrix** sitelink, void** fatlink, Real coef,
     int use_staple) 
 {
-  su3_matrix tmat1,tmat2;
-  int i ;
-  su3_matrix *fat1;
-
   /* Upper staple */
   /* Computes the staple :
    *                mu (B)
@@ -132,15 +128,20 @@ llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu,
    * Where the mu link can be any su3_matrix. The result is saved in staple.
    * if staple==NULL then the result is not saved.
    * It also adds the computed staple to the fatlink[mu] with weight coef.
+   * Each site only updates its own staple and fatlink, so the site
+   * loops are threaded without changing the result.
    */
 
-  int dx[4];
-
   /* upper staple */
 
-  for(i=0;i < V;i++){	    
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for(int i=0;i < V;i++){
+    su3_matrix tmat1, tmat2;
+    int dx[4];
 
-    fat1 = ((su3_matrix*)fatlink[mu]) + i;
+    su3_matrix *fat1 = ((su3_matrix*)fatlink[mu]) + i;
     su3_matrix* A = sitelink[nu] + i;
 
     memset(dx, 0, sizeof(dx));
@@ -177,9 +178,14 @@ llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu,
    *
    *********************************************/
 
-  for(i=0;i < V;i++){	    
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for(int i=0;i < V;i++){
+    su3_matrix tmat1, tmat2;
+    int dx[4];
 
-    fat1 = ((su3_matrix*)fatlink[mu]) + i;
+    su3_matrix *fat1 = ((su3_matrix*)fatlink[mu]) + i;
     memset(dx, 0, sizeof(dx));
     dx[nu] = -1;
     int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);	
@@ -250,6 +256,9 @@ void llfat_cpu(void** fatlink, su3_matrix** sitelink, Float* act_path_coeff)
   for (int dir=XUP; dir<=TUP; dir++){
 
     /* Intialize fat links with c_1*U_\mu(x) */
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for(int i=0;i < V;i ++){
       su3_matrix* fat1 = ((su3_matrix*)fatlink[dir]) +  i;
       llfat_scalar_mult_su3_matrix(sitelink[dir] + i, one_link, fat1 );
@@ -300,10 +309,13 @@ void computeLongLinkCPU(void** longlink, su3_matrix** sitelink,
     Float* act_path_coeff)
 {
 
-  su3_matrix temp;
   for(int dir=XUP; dir<=TUP; ++dir){
-    int dx[4] = {0,0,0,0}; 
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for(int i=0; i<V; ++i){
+      su3_matrix temp;
+      int dx[4] = {0,0,0,0};
       // Initialize the longlinks
       su3_matrix* llink = ((su3_matrix*)longlink[dir]) + i;
       llfat_scalar_mult_su3_matrix(sitelink[dir]+i, act_path_coeff[1], llink);
@@ -327,7 +339,9 @@ void computeLongLinkCPU(void** longlink, su3_matrix** sitelinkEx, Float* act_pat
 
  const int extended_volume = E[3]*E[2]*E[1]*E[0];
 
-  su3_matrix temp;
+#ifdef _OPENMP
+#pragma omp parallel for collapse(4)
+#endif
   for(int t=0; t<Z[3]; ++t){
     for(int z=0; z<Z[2]; ++z){
       for(int y=0; y<Z[1]; ++y){
@@ -338,6 +352,7 @@ void computeLongLinkCPU(void** longlink, su3_matrix** sitelinkEx, Float* act_pat
         
       
           for(int dir=XUP; dir<=TUP; ++dir){
+            su3_matrix temp;
             int dx[4] = {0,0,0,0};
             su3_matrix* llink = ((su3_matrix*)longlink[dir]) + little_index;
             llfat_scalar_mult_su3_matrix(sitelinkEx[dir]+large_index, act_path_coeff[1], llink);
@@ -422,9 +437,6 @@ llfat_compute_gen_staple_field_mg(su3_matrix *staple, int mu, int nu,
     void** fatlink, Real coef,
     int use_staple) 
 {
-  su3_matrix tmat1,tmat2;
-  int i ;
-  su3_matrix *fat1;
 
 
   int X1 = Z[0];  
@@ -448,13 +460,18 @@ llfat_compute_gen_staple_field_mg(su3_matrix *staple, int mu, int nu,
    * Where the mu link can be any su3_matrix. The result is saved in staple.
    * if staple==NULL then the result is not saved.
    * It also adds the computed staple to the fatlink[mu] with weight coef.
+   * Each site only updates its own staple and fatlink, so the site
+   * loops are threaded without changing the result.
    */
 
-  int dx[4];
-
   /* upper staple */
 
-  for(i=0;i < V;i++){	    
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for(int i=0;i < V;i++){
+    su3_matrix tmat1, tmat2;
+    int dx[4];
 
     int half_index = i;
     int oddBit =0;
@@ -483,7 +500,7 @@ llfat_compute_gen_staple_field_mg(su3_matrix *staple, int mu, int nu,
       (x3*X2X1+x2*X1+x1)/2
     };
 
-    fat1 = ((su3_matrix*)fatlink[mu]) + i;
+    su3_matrix *fat1 = ((su3_matrix*)fatlink[mu]) + i;
     su3_matrix* A = sitelink[nu] + i;
 
     memset(dx, 0, sizeof(dx));
@@ -538,7 +555,12 @@ llfat_compute_gen_staple_field_mg(su3_matrix *staple, int mu, int nu,
    *
    *********************************************/
 
-  for(i=0;i < V;i++){
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for(int i=0;i < V;i++){
+    su3_matrix tmat1, tmat2;
+    int dx[4];
 
     int half_index = i;
     int oddBit =0;
@@ -566,7 +588,7 @@ llfat_compute_gen_staple_field_mg(su3_matrix *staple, int mu, int nu,
 
     //int x4 = x4_from_full_index(i);
 
-    fat1 = ((su3_matrix*)fatlink[mu]) + i;
+    su3_matrix *fat1 = ((su3_matrix*)fatlink[mu]) + i;
 
     //we could be in the ghost link area if nu is T and we are at low T boundary    
     su3_matrix* A;
@@ -703,6 +725,9 @@ void llfat_cpu_mg(void** fatlink, su3_matrix** sitelink, su3_matrix** ghost_site
   for (int dir=XUP; dir<=TUP; dir++){
 
     /* Intialize fat links with c_1*U_\mu(x) */
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for(int i=0;i < V;i ++){
       su3_matrix* fat1 = ((su3_matrix*)fatlink[dir]) +  i;
       llfat_scalar_mult_su3_matrix(sitelink[dir] + i, one_link, fat1 );
@@ -0,0 +1,167 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <philox.h>
+#include <util_quda.h>
+#include <comm_quda.h>
+
+#include <test_util.h>
+#include "misc.h"
+
+// Tests the counter-based Philox4x32-10 generator used for random
+// host fields.  The generator is checked against the known-answer
+// vectors published with Random123 (kat_vectors, philox4x32_10), and
+// a random host source filled on the current process grid is compared
+// with the field a single rank fills for the same global lattice,
+// where the site counter is simply the lexicographical site index.
+
+using namespace quda;
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaPrecision prec;
+
+extern void usage(char** );
+
+void display_test_info()
+{
+  printfQuda("running the following test:\n");
+
+  printfQuda("prec    S_dimension T_dimension\n");
+  printfQuda("%s   %d/%d/%d          %d\n", get_prec_str(prec), xdim, ydim, zdim, tdim);
+
+  printfQuda("Grid partition info:     X  Y  Z  T\n");
+  printfQuda("                         %d  %d  %d  %d\n",
+	     dimPartitioned(0),
+	     dimPartitioned(1),
+	     dimPartitioned(2),
+	     dimPartitioned(3));
+}
+
+static int knownAnswerTest()
+{
+  struct { uint64_t key; uint32_t ctr[4]; uint32_t out[4]; } kat[] = {
+    { 0x0000000000000000ull,
+      { 0x00000000, 0x00000000, 0x00000000, 0x00000000 },
+      { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 } },
+    { 0xffffffffffffffffull,
+      { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff },
+      { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd } },
+    { 0x299f31d0a4093822ull, // key = { 0xa4093822, 0x299f31d0 }
+      { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 },
+      { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } }
+  };
+
+  int fails = 0;
+  for (unsigned int i = 0; i < sizeof(kat)/sizeof(kat[0]); i++) {
+    uint32_t out[4];
+    Philox(kat[i].key)(out, kat[i].ctr);
+    bool pass = true;
+    for (int j = 0; j < 4; j++) if (out[j] != kat[i].out[j]) pass = false;
+    printfQuda("Known-answer vector %u: %08x %08x %08x %08x %s\n", i, out[0], out[1], out[2], out[3], pass ? "PASSED" : "FAILED");
+    if (!pass) fails++;
+  }
+  return fails;
+}
+
+// compare the first random source of this process with the values a
+// single rank generates from the global lexicographical site index
+template <typename Float>
+static int decompositionTest(const cpuColorSpinorField &field)
+{
+  const Philox rng(137); // seed and stream of the first field filled by genericSource
+  const uint32_t stream = 0;
+  const int X[4] = { xdim, ydim, zdim, tdim };
+  const int nSpin = field.Nspin(), nColor = field.Ncolor();
+  const Float *v = static_cast<const Float*>(field.V());
+
+  int mismatch = 0;
+  for (int parity = 0; parity < 2; parity++) {
+    for (int x_cb = 0; x_cb < Vh; x_cb++) {
+      int idx = fullLatticeIndex(x_cb, parity);
+      uint64_t index = 0, stride = 1;
+      for (int d = 0; d < 4; d++) {
+	index += (uint64_t)(idx % X[d] + comm_coord(d) * X[d]) * stride;
+	stride *= (uint64_t)X[d] * comm_dim(d);
+	idx /= X[d];
+      }
+
+      for (int s = 0; s < nSpin; s++) {
+	for (int c = 0; c < nColor; c++) {
+	  double u[2];
+	  rng.uniform(u, index, s*nColor + c, stream);
+	  const Float *z = v + (((size_t)(parity*Vh + x_cb)*nSpin + s)*nColor + c)*2;
+	  if (z[0] != (Float)u[0] || z[1] != (Float)u[1]) mismatch++;
+	}
+      }
+    }
+  }
+
+  comm_allreduce_int(&mismatch);
+  printfQuda("Random source vs single-rank fill: %d mismatched elements\n", mismatch);
+  return mismatch ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+  for (int i = 1; i < argc; i++){
+    if(process_command_line_option(argc, argv, &i) == 0){
+      continue;
+    }
+    printf("ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  // initialize QMP/MPI, QUDA comms grid and RNG (test_util.cpp)
+  initComms(argc, argv, gridsize_from_cmdline);
+
+  display_test_info();
+
+  if (prec != QUDA_DOUBLE_PRECISION && prec != QUDA_SINGLE_PRECISION) {
+    printfQuda("Precision %d not supported\n", prec);
+    finalizeComms();
+    return 0;
+  }
+
+  initQuda(device);
+
+  int X[4] = { xdim, ydim, zdim, tdim };
+  setDims(X);
+
+  int fails = knownAnswerTest();
+
+  ColorSpinorParam csParam;
+  csParam.nColor = 3;
+  csParam.nSpin = 4;
+  csParam.nDim = 4;
+  for (int d = 0; d < 4; d++) csParam.x[d] = X[d];
+  csParam.precision = prec;
+  csParam.pad = 0;
+  csParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+  csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  csParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  csParam.create = QUDA_ZERO_FIELD_CREATE;
+
+  {
+    cpuColorSpinorField field(csParam);
+    field.Source(QUDA_RANDOM_SOURCE);
+    fails += (prec == QUDA_DOUBLE_PRECISION) ? decompositionTest<double>(field) : decompositionTest<float>(field);
+  }
+
+  printfQuda("%s: %d failures\n", fails ? "FAILED" : "PASSED", fails);
+
+  endQuda();
+  finalizeComms();
+
+  return fails;
+}
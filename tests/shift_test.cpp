@@ -0,0 +1,213 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <util_quda.h>
+#include <comm_quda.h>
+
+#include <test_util.h>
+#include "misc.h"
+
+// Tests shiftColorSpinorField.  Every component of the input encodes
+// its global site, so the shifted field on the host is checked against
+// out(x) = in(x + s mu) computed from the global coordinates.  For
+// spin-1 and spin-4 fields, a shift by +s followed by a shift by -s
+// along each dimension must recover the input exactly, and the shift
+// on the device must reproduce the host result.  In multi-GPU builds
+// every dimension is marked as partitioned, so the shifts always go
+// through the ghost zones.
+
+using namespace quda;
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaPrecision prec;
+
+extern void usage(char** );
+
+static const int parity = 0;
+
+void display_test_info()
+{
+  printfQuda("running the following test:\n");
+
+  printfQuda("prec    S_dimension T_dimension\n");
+  printfQuda("%s   %d/%d/%d          %d\n", get_prec_str(prec), xdim, ydim, zdim, tdim);
+
+  printfQuda("Grid partition info:     X  Y  Z  T\n");
+  printfQuda("                         %d  %d  %d  %d\n",
+	     dimPartitioned(0),
+	     dimPartitioned(1),
+	     dimPartitioned(2),
+	     dimPartitioned(3));
+}
+
+// value of complex component k of global site g, exact in single precision
+static inline void siteValue(double z[2], uint64_t g, int k)
+{
+  z[0] = (double)((g % 4096) * 32 + k);
+  z[1] = (double)(g / 4096);
+}
+
+// global lexicographical index of the site at local coordinates x displaced by shift along dim
+static uint64_t globalIndex(const int x[4], int dim, int shift)
+{
+  const int X[4] = { xdim, ydim, zdim, tdim };
+  uint64_t index = 0, stride = 1;
+  for (int d = 0; d < 4; d++) {
+    const int G = X[d] * comm_dim(d);
+    int g = x[d] + comm_coord(d) * X[d];
+    if (d == dim) g = ((g + shift) % G + G) % G;
+    index += (uint64_t)g * stride;
+    stride *= G;
+  }
+  return index;
+}
+
+// fill every site with its global coordinates (shift = 0), or count the
+// components that differ from those of the site displaced by shift
+template <typename Float>
+static int globalSites(ColorSpinorField &field, int dim, int shift, bool fill)
+{
+  const int X[4] = { xdim, ydim, zdim, tdim };
+  const int nComplex = field.Nspin() * field.Ncolor();
+  Float *v = static_cast<Float*>(field.V());
+
+  int mismatch = 0;
+  for (int parity = 0; parity < 2; parity++) {
+    for (int x_cb = 0; x_cb < Vh; x_cb++) {
+      int x[4], idx = fullLatticeIndex(x_cb, parity);
+      for (int d = 0; d < 4; d++) { x[d] = idx % X[d]; idx /= X[d]; }
+      const uint64_t g = globalIndex(x, dim, shift);
+
+      Float *site = v + (size_t)(parity*Vh + x_cb) * nComplex * 2;
+      for (int k = 0; k < nComplex; k++) {
+	double z[2];
+	siteValue(z, g, k);
+	if (fill) {
+	  site[2*k+0] = (Float)z[0];
+	  site[2*k+1] = (Float)z[1];
+	} else if (site[2*k+0] != (Float)z[0] || site[2*k+1] != (Float)z[1]) {
+	  mismatch++;
+	}
+      }
+    }
+  }
+
+  comm_allreduce_int(&mismatch);
+  return mismatch;
+}
+
+static int globalSites(ColorSpinorField &field, int dim, int shift, bool fill)
+{
+  return field.Precision() == QUDA_DOUBLE_PRECISION ? globalSites<double>(field, dim, shift, fill) :
+    globalSites<float>(field, dim, shift, fill);
+}
+
+// number of ranks on which the two host fields differ
+static int differ(const ColorSpinorField &a, const ColorSpinorField &b)
+{
+  int rc = memcmp(a.V(), b.V(), a.Bytes()) != 0 ? 1 : 0;
+  comm_allreduce_int(&rc);
+  return rc;
+}
+
+int main(int argc, char **argv)
+{
+  for (int i = 1; i < argc; i++){
+    if(process_command_line_option(argc, argv, &i) == 0){
+      continue;
+    }
+    printf("ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  // initialize QMP/MPI, QUDA comms grid and RNG (test_util.cpp)
+  initComms(argc, argv, gridsize_from_cmdline);
+
+  display_test_info();
+
+  if (prec != QUDA_DOUBLE_PRECISION && prec != QUDA_SINGLE_PRECISION) {
+    printfQuda("Precision %d not supported\n", prec);
+    finalizeComms();
+    return 0;
+  }
+
+  initQuda(device);
+  setVerbosity(QUDA_VERBOSE);
+
+  int X[4] = { xdim, ydim, zdim, tdim };
+  setDims(X);
+
+#ifdef MULTI_GPU
+  for (int d = 0; d < 4; d++) comm_dim_partitioned_set(d);
+#endif
+
+  int fails = 0;
+
+  const int nSpins[] = { 1, 4 };
+  for (int s = 0; s < 2; s++) {
+    const int nSpin = nSpins[s];
+
+    ColorSpinorParam csParam;
+    csParam.nColor = 3;
+    csParam.nSpin = nSpin;
+    csParam.nDim = 4;
+    for (int d = 0; d < 4; d++) csParam.x[d] = X[d];
+    csParam.precision = prec;
+    csParam.pad = 0;
+    csParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+    csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+    csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+    csParam.gammaBasis = QUDA_UKQCD_GAMMA_BASIS;
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+
+    cpuColorSpinorField in(csParam), shifted(csParam), back(csParam), shifted_d(csParam);
+    globalSites(in, 0, 0, true);
+
+    ColorSpinorParam cudaParam(csParam);
+    cudaParam.create = QUDA_NULL_FIELD_CREATE;
+    cudaParam.fieldOrder = (prec == QUDA_DOUBLE_PRECISION || nSpin == 1) ?
+      QUDA_FLOAT2_FIELD_ORDER : QUDA_FLOAT4_FIELD_ORDER;
+    cudaColorSpinorField in_d(cudaParam), out_d(cudaParam);
+    in_d = in;
+
+    for (int dim = 0; dim < 4; dim++) {
+      for (int shift = 1; shift <= 2; shift++) {
+	shiftColorSpinorField(shifted, in, parity, dim, shift);
+	shiftColorSpinorField(back, shifted, parity, dim, -shift);
+
+	shiftColorSpinorField(out_d, in_d, parity, dim, shift);
+	shifted_d = out_d;
+
+	// a shift by less than the global extent must move the field
+	const bool moved = differ(shifted, in) > 0 || shift % (X[dim] * comm_dim(dim)) == 0;
+	const int mismatch = globalSites(shifted, dim, shift, false);
+	const bool restored = differ(back, in) == 0;
+	const bool device_agrees = differ(shifted_d, shifted) == 0;
+
+	printfQuda("nSpin = %d dim = %d shift = %d: moved %s, %d mismatches with the reference, restored %s, device agrees %s\n",
+		   nSpin, dim, shift, moved ? "yes" : "no", mismatch, restored ? "yes" : "no", device_agrees ? "yes" : "no");
+	if (!moved || mismatch || !restored || !device_agrees) {
+	  warningQuda("Shift of nSpin = %d field by %d in dimension %d failed", nSpin, shift, dim);
+	  fails++;
+	}
+      }
+    }
+  }
+
+  printfQuda("%s: %d failures\n", fails ? "FAILED" : "PASSED", fails);
+
+  endQuda();
+  finalizeComms();
+
+  return fails;
+}
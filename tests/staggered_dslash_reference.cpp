@@ -60,6 +60,10 @@ void dslashReference(sFloat *res, gFloat **fatlink, gFloat** longlink, sFloat *s
     longlinkOdd[dir] = longlink[dir] + Vh*gaugeSiteSize;    
   }
 
+  // each site only writes its own output, so threading over sites is deterministic
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2)
+#endif
   for (int xs=0; xs<nSrc; xs++) {
 
     for (int i = 0; i < Vh; i++) {
@@ -293,6 +297,10 @@ void dslashReference_mg4dir(sFloat *res, gFloat **fatlink, gFloat** longlink,
     ghostLonglinkOdd[dir] = ghostLonglink[dir] + 3*(faceVolume[dir]/2)*gaugeSiteSize;
   }
 
+  // each site only writes its own output, so threading over sites is deterministic
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2)
+#endif
   for (int xs=0; xs<nSrc; xs++) {
 
     for (int i = 0; i < Vh; i++) {
@@ -0,0 +1,182 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <color_spinor_field.h>
+#include <staggered_oprod.h>
+#include <util_quda.h>
+#include <comm_quda.h>
+
+#include <test_util.h>
+#include "misc.h"
+
+// Tests the host staggered outer-product kernels.  The one- and
+// three-hop outer products of a random staggered field are computed
+// by computeStaggeredOprod on the host and on a device copy of the
+// same field, and the resulting fields are compared.  In multi-GPU
+// builds every dimension is marked as partitioned, so the exterior
+// kernels, which read the host ghost zones, are always exercised.
+
+using namespace quda;
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaPrecision prec;
+
+extern void usage(char** );
+
+static const double coeffs[2] = { 0.7, -0.3 }; // one- and three-hop coefficients
+
+void display_test_info()
+{
+  printfQuda("running the following test:\n");
+
+  printfQuda("prec    S_dimension T_dimension\n");
+  printfQuda("%s   %d/%d/%d          %d\n", get_prec_str(prec), xdim, ydim, zdim, tdim);
+
+  printfQuda("Grid partition info:     X  Y  Z  T\n");
+  printfQuda("                         %d  %d  %d  %d\n",
+	     dimPartitioned(0),
+	     dimPartitioned(1),
+	     dimPartitioned(2),
+	     dimPartitioned(3));
+}
+
+// relative deviation |a-b|/|b| of two host QDP-ordered outer-product fields, summed over all ranks
+template <typename Float>
+static double relativeDeviation(const cpuGaugeField &a, const cpuGaugeField &b)
+{
+  double diff = 0.0, norm = 0.0;
+  for (int dir = 0; dir < 4; dir++) {
+    const Float *a_ = static_cast<const Float*>(((void* const*)a.Gauge_p())[dir]);
+    const Float *b_ = static_cast<const Float*>(((void* const*)b.Gauge_p())[dir]);
+    for (int i = 0; i < a.Volume()*gaugeSiteSize; i++) {
+      diff += ((double)a_[i] - (double)b_[i]) * ((double)a_[i] - (double)b_[i]);
+      norm += (double)b_[i] * (double)b_[i];
+    }
+  }
+  comm_allreduce(&diff);
+  comm_allreduce(&norm);
+  return norm > 0.0 ? sqrt(diff / norm) : sqrt(diff);
+}
+
+static double relativeDeviation(const cpuGaugeField &a, const cpuGaugeField &b)
+{
+  return a.Precision() == QUDA_DOUBLE_PRECISION ? relativeDeviation<double>(a, b) : relativeDeviation<float>(a, b);
+}
+
+static int staggeredOprodTest(int nFace)
+{
+  QudaGaugeParam gauge_param = newQudaGaugeParam();
+  gauge_param.X[0] = xdim;
+  gauge_param.X[1] = ydim;
+  gauge_param.X[2] = zdim;
+  gauge_param.X[3] = tdim;
+  gauge_param.cpu_prec = prec;
+  gauge_param.cuda_prec = prec;
+  gauge_param.reconstruct = QUDA_RECONSTRUCT_NO;
+  gauge_param.type = QUDA_GENERAL_LINKS;
+  gauge_param.gauge_order = QUDA_QDP_GAUGE_ORDER;
+  gauge_param.t_boundary = QUDA_PERIODIC_T;
+  gauge_param.gauge_fix = QUDA_GAUGE_FIXED_NO;
+  gauge_param.anisotropy = 1.0;
+  gauge_param.tadpole_coeff = 1.0;
+  gauge_param.scale = 1.0;
+
+  // outer-product fields
+  GaugeFieldParam gParam(0, gauge_param);
+  gParam.create = QUDA_ZERO_FIELD_CREATE;
+  gParam.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+  cpuGaugeField cpuOprod(gParam), cpuLongOprod(gParam);
+  cpuGaugeField refOprod(gParam), refLongOprod(gParam);
+
+  gParam.order = QUDA_FLOAT2_GAUGE_ORDER;
+  cudaGaugeField cudaOprod(gParam), cudaLongOprod(gParam);
+
+  ColorSpinorParam csParam;
+  csParam.nColor = 3;
+  csParam.nSpin = 1;
+  csParam.nDim = 4;
+  for (int d = 0; d < 4; d++) csParam.x[d] = gauge_param.X[d];
+  csParam.precision = prec;
+  csParam.pad = 0;
+  csParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+  csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  csParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS; // meaningless for staggered
+  csParam.create = QUDA_ZERO_FIELD_CREATE;
+  cpuColorSpinorField in(csParam);
+  in.Source(QUDA_RANDOM_SOURCE);
+
+  ColorSpinorParam cudaParam(csParam);
+  cudaParam.create = QUDA_NULL_FIELD_CREATE;
+  cudaParam.fieldOrder = QUDA_FLOAT2_FIELD_ORDER;
+  cudaColorSpinorField in_d(cudaParam);
+  in_d = in;
+
+  GaugeField *cpuOut[2] = { &cpuOprod, &cpuLongOprod };
+  GaugeField *cudaOut[2] = { &cudaOprod, &cudaLongOprod };
+  computeStaggeredOprod(cpuOut, in, coeffs, nFace);
+  computeStaggeredOprod(cudaOut, in_d, coeffs, nFace);
+  cudaOprod.saveCPUField(refOprod);
+  cudaLongOprod.saveCPUField(refLongOprod);
+
+  const double tol = (prec == QUDA_DOUBLE_PRECISION) ? 1e-10 : 1e-5;
+  const double dev = relativeDeviation(cpuOprod, refOprod);
+  int fails = dev > tol ? 1 : 0;
+  printfQuda("nFace = %d: host vs device one-hop outer product deviation %e\n", nFace, dev);
+
+  if (nFace == 3) {
+    const double dev_long = relativeDeviation(cpuLongOprod, refLongOprod);
+    if (dev_long > tol) fails++;
+    printfQuda("nFace = %d: host vs device three-hop outer product deviation %e\n", nFace, dev_long);
+  }
+
+  return fails;
+}
+
+int main(int argc, char **argv)
+{
+  for (int i = 1; i < argc; i++){
+    if(process_command_line_option(argc, argv, &i) == 0){
+      continue;
+    }
+    printf("ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  // initialize QMP/MPI, QUDA comms grid and RNG (test_util.cpp)
+  initComms(argc, argv, gridsize_from_cmdline);
+
+  display_test_info();
+
+  if (prec != QUDA_DOUBLE_PRECISION && prec != QUDA_SINGLE_PRECISION) {
+    printfQuda("Precision %d not supported\n", prec);
+    finalizeComms();
+    return 0;
+  }
+
+  initQuda(device);
+  setVerbosity(QUDA_VERBOSE);
+
+#ifdef MULTI_GPU
+  for (int d = 0; d < 4; d++) comm_dim_partitioned_set(d);
+#endif
+
+  int fails = staggeredOprodTest(1);
+  fails += staggeredOprodTest(3);
+  printfQuda("%s: %d failures\n", fails ? "FAILED" : "PASSED", fails);
+
+  endQuda();
+  finalizeComms();
+
+  return fails;
+}
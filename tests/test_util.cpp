@@ -14,6 +14,7 @@
 #include <test_util.h>
 
 #include <dslash_quda.h>
+#include <philox.h>
 #include "misc.h"
 
 using namespace std;
@@ -905,6 +906,41 @@ static void orthogonalize(complex<Float> *a, complex<Float> *b, int len) {
   for (int i=0; i<len; i++) b[i] -= (complex<Float>)dot*a[i];
 }
 
+// Random gauge fields are generated with a counter-based generator
+// keyed on the global site index, direction, row and column, so that
+// they can be generated in parallel and are independent of the
+// process grid.  Each generated field uses a new stream.
+static const quda::Philox gauge_rng(137);
+static uint32_t gauge_stream = 0;
+
+// global lexicographical site index of checkerboard site i with parity oddBit
+static uint64_t globalSiteIndex(int i, int oddBit) {
+  int full_idx = fullLatticeIndex(i, oddBit);
+  int x[4];
+  for (int d=0; d<4; d++) {
+    x[d] = full_idx % Z[d];
+    full_idx /= Z[d];
+  }
+
+  uint64_t index = 0;
+  for (int d=3; d>=0; d--) index = index*(commDim(d)*Z[d]) + (commCoords(d)*Z[d] + x[d]);
+  return index;
+}
+
+// fill rows row_begin to 2 of the link with uniform random numbers
+template <typename Float>
+static void randomLink(Float *link, uint64_t site, int dir, int row_begin, uint32_t stream,
+		       double re_scale=1.0, double im_scale=1.0) {
+  for (int m = row_begin; m < 3; m++) {
+    for (int n = 0; n < 3; n++) {
+      double u[2];
+      gauge_rng.uniform(u, site, (dir*3 + m)*3 + n, stream);
+      link[m*(3*2) + n*(2) + 0] = re_scale * u[0];
+      link[m*(3*2) + n*(2) + 1] = im_scale * u[1];
+    }
+  }
+}
+
 template <typename Float> 
 static void constructGaugeField(Float **res, QudaGaugeParam *param, QudaDslashType dslash_type=QUDA_WILSON_DSLASH) {
   Float *resOdd[4], *resEven[4];
@@ -913,16 +949,15 @@ static void constructGaugeField(Float **res, QudaGaugeParam *param, QudaDslashTy
     resOdd[dir]  = res[dir]+Vh*gaugeSiteSize;
   }
     
+  const uint32_t stream = gauge_stream++;
   for (int dir = 0; dir < 4; dir++) {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (int i = 0; i < Vh; i++) {
-      for (int m = 1; m < 3; m++) { // last 2 rows
-	for (int n = 0; n < 3; n++) { // 3 columns
-	  resEven[dir][i*(3*3*2) + m*(3*2) + n*(2) + 0] = rand() / (Float)RAND_MAX;
-	  resEven[dir][i*(3*3*2) + m*(3*2) + n*(2) + 1] = rand() / (Float)RAND_MAX;
-	  resOdd[dir][i*(3*3*2) + m*(3*2) + n*(2) + 0] = rand() / (Float)RAND_MAX;
-	  resOdd[dir][i*(3*3*2) + m*(3*2) + n*(2) + 1] = rand() / (Float)RAND_MAX;                    
-	}
-      }
+      // last 2 rows
+      randomLink(resEven[dir] + i*(3*3*2), globalSiteIndex(i, 0), dir, 1, stream);
+      randomLink(resOdd[dir] + i*(3*3*2), globalSiteIndex(i, 1), dir, 1, stream);
       normalize((complex<Float>*)(resEven[dir] + (i*3+1)*3*2), 3);
       orthogonalize((complex<Float>*)(resEven[dir] + (i*3+1)*3*2), (complex<Float>*)(resEven[dir] + (i*3+2)*3*2), 3);
       normalize((complex<Float>*)(resEven[dir] + (i*3 + 2)*3*2), 3);
@@ -967,16 +1002,14 @@ static void constructGaugeField(Float **res, QudaGaugeParam *param, QudaDslashTy
   } else if (param->type == QUDA_ASQTAD_LONG_LINKS){
     applyGaugeFieldScaling_long(res, Vh, param, dslash_type);
   } else if (param->type == QUDA_ASQTAD_FAT_LINKS){
+    const uint32_t fat_stream = gauge_stream++;
     for (int dir = 0; dir < 4; dir++){ 
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
       for (int i = 0; i < Vh; i++) {
-	for (int m = 0; m < 3; m++) { // last 2 rows
-	  for (int n = 0; n < 3; n++) { // 3 columns
-	    resEven[dir][i*(3*3*2) + m*(3*2) + n*(2) + 0] =1.0* rand() / (Float)RAND_MAX;
-	    resEven[dir][i*(3*3*2) + m*(3*2) + n*(2) + 1] = 2.0* rand() / (Float)RAND_MAX;
-	    resOdd[dir][i*(3*3*2) + m*(3*2) + n*(2) + 0] = 3.0*rand() / (Float)RAND_MAX;
-	    resOdd[dir][i*(3*3*2) + m*(3*2) + n*(2) + 1] = 4.0*rand() / (Float)RAND_MAX;
-	  }
-	}
+	randomLink(resEven[dir] + i*(3*3*2), globalSiteIndex(i, 0), dir, 0, fat_stream, 1.0, 2.0);
+	randomLink(resOdd[dir] + i*(3*3*2), globalSiteIndex(i, 1), dir, 0, fat_stream, 3.0, 4.0);
       }
     }
     
@@ -993,16 +1026,15 @@ void constructUnitaryGaugeField(Float **res)
     resOdd[dir]  = res[dir]+Vh*gaugeSiteSize;
   }
   
+  const uint32_t stream = gauge_stream++;
   for (int dir = 0; dir < 4; dir++) {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (int i = 0; i < Vh; i++) {
-      for (int m = 1; m < 3; m++) { // last 2 rows
-	for (int n = 0; n < 3; n++) { // 3 columns
-	  resEven[dir][i*(3*3*2) + m*(3*2) + n*(2) + 0] = rand() / (Float)RAND_MAX;
-	  resEven[dir][i*(3*3*2) + m*(3*2) + n*(2) + 1] = rand() / (Float)RAND_MAX;
-	  resOdd[dir][i*(3*3*2) + m*(3*2) + n*(2) + 0] = rand() / (Float)RAND_MAX;
-	  resOdd[dir][i*(3*3*2) + m*(3*2) + n*(2) + 1] = rand() / (Float)RAND_MAX;                    
-	}
-      }
+      // last 2 rows
+      randomLink(resEven[dir] + i*(3*3*2), globalSiteIndex(i, 0), dir, 1, stream);
+      randomLink(resOdd[dir] + i*(3*3*2), globalSiteIndex(i, 1), dir, 1, stream);
       normalize((complex<Float>*)(resEven[dir] + (i*3+1)*3*2), 3);
       orthogonalize((complex<Float>*)(resEven[dir] + (i*3+1)*3*2), (complex<Float>*)(resEven[dir] + (i*3+2)*3*2), 3);
       normalize((complex<Float>*)(resEven[dir] + (i*3 + 2)*3*2), 3);
@@ -1089,7 +1121,9 @@ construct_fat_long_gauge_field(void **fatlink, void** longlink, int type,
   if (param->reconstruct == QUDA_RECONSTRUCT_9 || param->reconstruct == QUDA_RECONSTRUCT_13) {
     // incorporate non-trivial phase into long links
 
-    const double phase = (M_PI * rand())/RAND_MAX;
+    double u[2];
+    gauge_rng.uniform(u, 0, 0, gauge_stream++);
+    const double phase = M_PI * u[0];
     const complex<double> z = polar(1.0, phase);
     for (int dir=0; dir<4; ++dir) {
       for (int i=0; i<V; ++i) {
@@ -1609,6 +1643,7 @@ QudaPrecision prec = QUDA_SINGLE_PRECISION;
 QudaPrecision  prec_sloppy = QUDA_INVALID_PRECISION;
 QudaPrecision  prec_precondition = QUDA_INVALID_PRECISION;
 QudaPrecision  prec_ritz = QUDA_INVALID_PRECISION;
+QudaPrecision  prec_ritz_storage = QUDA_INVALID_PRECISION;
 
 int xdim = 24;
 int ydim = 24;
@@ -1669,6 +1704,8 @@ int max_restart_num = 3;
 double inc_tol = 1e-2;
 double eigenval_tol = 1e-1;
 
+int eig_max_restarts = 100;
+
 QudaExtLibType solver_ext_lib     = QUDA_EIGEN_EXTLIB;
 QudaExtLibType deflation_ext_lib  = QUDA_EIGEN_EXTLIB;
 QudaFieldLocation location_ritz   = QUDA_CUDA_FIELD_LOCATION;
@@ -1694,6 +1731,7 @@ void usage(char** argv )
   printf("    --prec-sloppy <double/single/half>        # Sloppy precision in GPU\n");
   printf("    --prec-precondition <double/single/half>  # Preconditioner precision in GPU\n");
   printf("    --prec-ritz <double/single/half>  # Eigenvector precision in GPU\n");
+  printf("    --prec-ritz-storage <double/single/half>  # Storage precision of the deflation space (default prec-ritz)\n");
   printf("    --recon <8/9/12/13/18>                    # Link reconstruction type\n");
   printf("    --recon-sloppy <8/9/12/13/18>             # Sloppy link reconstruction type\n");
   printf("    --recon-precondition <8/9/12/13/18>       # Preconditioner link reconstruction type\n");
@@ -1762,6 +1800,7 @@ void usage(char** argv )
   printf("    --df-tol-inc <tol>                        # Set tolerance for the subsequent restarts in the initCG solver  (default 1e-2)\n");
   printf("    --df-max-restart-num <n>                  # Set maximum number of the initCG restarts in the deflation stage (default 3)\n");
   printf("    --df-tol-eigenval <tol>                   # Set maximum eigenvalue residual norm (default 1e-1)\n");
+  printf("    --eig-max-restarts <n>                    # Set maximum number of restarts of the thick-restart Lanczos (default 100)\n");
 
 
   printf("    --solver-ext-lib-type <eigen/magma>       # Set external library for the solvers  (default Eigen library)\n");
@@ -1874,6 +1913,16 @@ int process_command_line_option(int argc, char** argv, int* idx)
     goto out;
   }
 
+  if( strcmp(argv[i], "--prec-ritz-storage") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+    prec_ritz_storage =  get_prec(argv[i+1]);
+    i++;
+    ret = 0;
+    goto out;
+  }
+
   if( strcmp(argv[i], "--recon") == 0){
     if (i+1 >= argc){
       usage(argv);
@@ -2713,6 +2762,17 @@ int process_command_line_option(int argc, char** argv, int* idx)
   } 
 
 
+  if( strcmp(argv[i], "--eig-max-restarts") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+
+    eig_max_restarts = atoi(argv[i+1]);
+    i++;
+    ret = 0;
+    goto out;
+  }
+
   if( strcmp(argv[i], "--df-tol-restart") == 0){
     if (i+1 >= argc){
       usage(argv);
@@ -0,0 +1,278 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <color_spinor_field.h>
+#include <util_quda.h>
+#include <comm_quda.h>
+
+#include <test_util.h>
+#include "misc.h"
+
+// Tests the batched Wuppertal smearing step on host fields.  Each
+// vector of the batch is compared with the single-vector smearing
+// step applied on the device, and with the single-vector step on the
+// host, for spin-1 and spin-4 fields.  The multi-vector interface
+// call, which goes through the batched step, is compared with the
+// single-vector interface call for every vector of the set.
+
+using namespace quda;
+
+#define MAX(a,b) ((a)>(b)?(a):(b))
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaReconstructType link_recon;
+extern QudaPrecision prec;
+
+extern void usage(char** );
+
+static const int nvec = 4;        // number of vectors in the batch
+static const double alpha = 0.3;  // smearing parameter
+static const int parity = 0;
+static const int nSteps = 3;      // smearing steps of the interface calls
+
+void display_test_info()
+{
+  printfQuda("running the following test:\n");
+
+  printfQuda("prec    link_recon  S_dimension T_dimension\n");
+  printfQuda("%s   %s            %d/%d/%d          %d\n",
+	     get_prec_str(prec), get_recon_str(link_recon), xdim, ydim, zdim, tdim);
+
+  printfQuda("Grid partition info:     X  Y  Z  T\n");
+  printfQuda("                         %d  %d  %d  %d\n",
+	     dimPartitioned(0),
+	     dimPartitioned(1),
+	     dimPartitioned(2),
+	     dimPartitioned(3));
+}
+
+// relative deviation |a-b|/|b| of two host fields, summed over all ranks
+template <typename Float>
+static double relativeDeviation(const ColorSpinorField &a, const ColorSpinorField &b)
+{
+  const Float *a_ = static_cast<const Float*>(a.V());
+  const Float *b_ = static_cast<const Float*>(b.V());
+  double diff = 0.0, norm = 0.0;
+  for (size_t i=0; i<a.Length(); i++) {
+    diff += ((double)a_[i] - (double)b_[i]) * ((double)a_[i] - (double)b_[i]);
+    norm += (double)b_[i] * (double)b_[i];
+  }
+  comm_allreduce(&diff);
+  comm_allreduce(&norm);
+  return norm > 0.0 ? sqrt(diff / norm) : sqrt(diff);
+}
+
+static double relativeDeviation(const ColorSpinorField &a, const ColorSpinorField &b)
+{
+  return a.Precision() == QUDA_DOUBLE_PRECISION ? relativeDeviation<double>(a, b) : relativeDeviation<float>(a, b);
+}
+
+int main(int argc, char **argv)
+{
+  for (int i = 1; i < argc; i++){
+    if(process_command_line_option(argc, argv, &i) == 0){
+      continue;
+    }
+    printf("ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  // initialize QMP/MPI, QUDA comms grid and RNG (test_util.cpp)
+  initComms(argc, argv, gridsize_from_cmdline);
+
+  display_test_info();
+
+  if (prec != QUDA_DOUBLE_PRECISION && prec != QUDA_SINGLE_PRECISION) {
+    printfQuda("Precision %d not supported\n", prec);
+    finalizeComms();
+    return 0;
+  }
+
+  initQuda(device);
+  setVerbosity(QUDA_VERBOSE);
+
+  QudaGaugeParam gauge_param = newQudaGaugeParam();
+  gauge_param.X[0] = xdim;
+  gauge_param.X[1] = ydim;
+  gauge_param.X[2] = zdim;
+  gauge_param.X[3] = tdim;
+  gauge_param.cpu_prec = prec;
+  gauge_param.cuda_prec = prec;
+  gauge_param.reconstruct = QUDA_RECONSTRUCT_NO;
+  gauge_param.type = QUDA_SU3_LINKS;
+  gauge_param.gauge_order = QUDA_QDP_GAUGE_ORDER;
+  gauge_param.t_boundary = QUDA_PERIODIC_T;
+  gauge_param.gauge_fix = QUDA_GAUGE_FIXED_NO;
+  gauge_param.anisotropy = 1.0;
+  gauge_param.tadpole_coeff = 1.0;
+  gauge_param.scale = 1.0;
+
+  setDims(gauge_param.X);
+
+  size_t gSize = (prec == QUDA_DOUBLE_PRECISION) ? sizeof(double) : sizeof(float);
+  void *links[4];
+  for (int dir = 0; dir < 4; dir++) links[dir] = malloc(V*gaugeSiteSize*gSize);
+  construct_gauge_field(links, 1, prec, &gauge_param);
+
+  // host gauge field with the backward ghost links filled in
+  GaugeFieldParam gParam(links, gauge_param);
+  gParam.ghostExchange = QUDA_GHOST_EXCHANGE_PAD;
+  cpuGaugeField *cpuGauge = new cpuGaugeField(gParam);
+
+  // device copy, with the ghost links in the pad
+  int pad = MAX(xdim*ydim*zdim/2, xdim*ydim*tdim/2);
+  pad = MAX(pad, xdim*zdim*tdim/2);
+  pad = MAX(pad, ydim*zdim*tdim/2);
+  gParam.create = QUDA_NULL_FIELD_CREATE;
+  gParam.reconstruct = link_recon;
+  gParam.pad = pad;
+  gParam.order = (prec == QUDA_DOUBLE_PRECISION || link_recon == QUDA_RECONSTRUCT_NO) ?
+    QUDA_FLOAT2_GAUGE_ORDER : QUDA_FLOAT4_GAUGE_ORDER;
+  cudaGaugeField *cudaGauge = new cudaGaugeField(gParam);
+  cudaGauge->copy(*cpuGauge);
+  cudaGauge->exchangeGhost();
+
+  const double tol = (prec == QUDA_DOUBLE_PRECISION) ? 1e-12 : 1e-5;
+  int fails = 0;
+
+  const int nSpins[] = { 1, 4 };
+  for (int s = 0; s < 2; s++) {
+    const int nSpin = nSpins[s];
+
+    ColorSpinorParam csParam;
+    csParam.nColor = 3;
+    csParam.nSpin = nSpin;
+    csParam.nDim = 4;
+    for (int d = 0; d < 4; d++) csParam.x[d] = gauge_param.X[d];
+    csParam.precision = prec;
+    csParam.pad = 0;
+    csParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+    csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+    csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+    csParam.gammaBasis = QUDA_UKQCD_GAMMA_BASIS;
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+
+    std::vector<ColorSpinorField*> in, out;
+    for (int i = 0; i < nvec; i++) {
+      in.push_back(new cpuColorSpinorField(csParam));
+      out.push_back(new cpuColorSpinorField(csParam));
+      in[i]->Source(QUDA_RANDOM_SOURCE);
+    }
+    cpuColorSpinorField ref(csParam);
+
+    wuppertalStep(out, in, parity, *cpuGauge, alpha);
+
+    ColorSpinorParam cudaParam(csParam);
+    cudaParam.create = QUDA_NULL_FIELD_CREATE;
+    cudaParam.fieldOrder = (prec == QUDA_DOUBLE_PRECISION || nSpin == 1) ?
+      QUDA_FLOAT2_FIELD_ORDER : QUDA_FLOAT4_FIELD_ORDER;
+    cudaColorSpinorField in_d(cudaParam);
+    cudaColorSpinorField out_d(cudaParam);
+
+    for (int i = 0; i < nvec; i++) {
+      // single-vector step on the device
+      in_d = *in[i];
+      wuppertalStep(out_d, in_d, parity, *cudaGauge, alpha);
+      ref = out_d;
+      double dev_device = relativeDeviation(*out[i], ref);
+
+      // single-vector step on the host
+      wuppertalStep(ref, *in[i], parity, *cpuGauge, alpha);
+      double dev_host = relativeDeviation(*out[i], ref);
+
+      printfQuda("nSpin = %d vector %d: batched vs device deviation %e, vs host deviation %e\n",
+		 nSpin, i, dev_device, dev_host);
+      if (dev_device > tol || dev_host > tol) {
+	warningQuda("Batched Wuppertal step of vector %d with nSpin = %d does not agree", i, nSpin);
+	fails++;
+      }
+    }
+
+    for (int i = 0; i < nvec; i++) {
+      delete in[i];
+      delete out[i];
+    }
+  }
+
+  {
+    gauge_param.type = QUDA_WILSON_LINKS;
+    gauge_param.reconstruct = link_recon;
+    gauge_param.cuda_prec_sloppy = prec;
+    gauge_param.reconstruct_sloppy = link_recon;
+    gauge_param.ga_pad = pad;
+    loadGaugeQuda(links, &gauge_param);
+
+    QudaInvertParam inv_param = newQudaInvertParam();
+    inv_param.dslash_type = QUDA_WILSON_DSLASH;
+    inv_param.cpu_prec = prec;
+    inv_param.cuda_prec = prec;
+    inv_param.dirac_order = QUDA_DIRAC_ORDER;
+    inv_param.gamma_basis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+    inv_param.input_location = QUDA_CPU_FIELD_LOCATION;
+    inv_param.output_location = QUDA_CPU_FIELD_LOCATION;
+    inv_param.verbosity = QUDA_VERBOSE;
+
+    ColorSpinorParam csParam;
+    csParam.nColor = 3;
+    csParam.nSpin = 4;
+    csParam.nDim = 4;
+    for (int d = 0; d < 4; d++) csParam.x[d] = gauge_param.X[d];
+    csParam.precision = prec;
+    csParam.pad = 0;
+    csParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+    csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+    csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+    csParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+
+    std::vector<ColorSpinorField*> in, out;
+    void *h_in[nvec], *h_out[nvec];
+    for (int i = 0; i < nvec; i++) {
+      in.push_back(new cpuColorSpinorField(csParam));
+      out.push_back(new cpuColorSpinorField(csParam));
+      in[i]->Source(QUDA_RANDOM_SOURCE);
+      h_in[i] = in[i]->V();
+      h_out[i] = out[i]->V();
+    }
+    cpuColorSpinorField ref(csParam);
+
+    performWuppertalnStepMulti(h_out, h_in, nvec, &inv_param, nSteps, alpha);
+
+    for (int i = 0; i < nvec; i++) {
+      performWuppertalnStep(ref.V(), in[i]->V(), &inv_param, nSteps, alpha);
+      double dev = relativeDeviation(*out[i], ref);
+      printfQuda("Interface vector %d: multi-vector vs single-vector deviation %e\n", i, dev);
+      if (dev > tol) {
+	warningQuda("Multi-vector Wuppertal smearing of vector %d does not agree", i);
+	fails++;
+      }
+    }
+
+    for (int i = 0; i < nvec; i++) {
+      delete in[i];
+      delete out[i];
+    }
+  }
+
+  printfQuda("%s: %d failures\n", fails ? "FAILED" : "PASSED", fails);
+
+  delete cudaGauge;
+  delete cpuGauge;
+  for (int dir = 0; dir < 4; dir++) free(links[dir]);
+
+  endQuda();
+  finalizeComms();
+
+  return fails;
+}